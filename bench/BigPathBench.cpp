@@ -7,7 +7,14 @@
 
 #include "bench/Benchmark.h"
 #include "include/core/SkCanvas.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkPath.h"
+#include "src/core/SkArenaAlloc.h"
+#include "src/core/SkAutoPixmapStorage.h"
+#include "src/core/SkBlitter.h"
+#include "src/core/SkMatrixProvider.h"
+#include "src/core/SkRasterClip.h"
+#include "src/core/SkScan.h"
 #include "tools/ToolUtils.h"
 
 enum Align {
@@ -82,3 +89,63 @@ DEF_BENCH( return new BigPathBench(kRight_Align,    false); )
 DEF_BENCH( return new BigPathBench(kLeft_Align,     true); )
 DEF_BENCH( return new BigPathBench(kMiddle_Align,   true); )
 DEF_BENCH( return new BigPathBench(kRight_Align,    true); )
+
+// Fills a map-tile sized outline with many points into an A8 pixmap through analytic AA, in one
+// pass or in bands rasterized in parallel on fThreads threads.
+class BigFillPathBench : public Benchmark {
+    static constexpr int kSize   = 1024;
+    static constexpr int kPoints = 1 << 17;
+
+    SkPath                      fPath;
+    SkString                    fName;
+    int                         fThreads;
+    std::unique_ptr<SkExecutor> fExecutor;
+    SkAutoPixmapStorage         fPixmap;
+    SkRasterClip                fRC;
+
+public:
+    BigFillPathBench(int threads = -1) : fThreads(threads) {
+        fName.printf("bigpath_fill_aaa");
+        if (fThreads >= 0) {
+            fName.appendf("_banded_threads_%d", fThreads);
+        }
+    }
+
+protected:
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        // A ragged coastline around the tile: non-convex, but without self-intersections.
+        fPath = ToolUtils::make_coastline({kSize / 2, kSize / 2}, 0.3f * kSize, kPoints, 0);
+
+        if (fThreads >= 0) {
+            fExecutor = ToolUtils::make_executor(fThreads);
+        }
+        fPixmap.alloc(SkImageInfo::MakeA8(kSize, kSize));
+        fPixmap.erase(0);
+        fRC.setRect(SkIRect::MakeWH(kSize, kSize));
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        SkSimpleMatrixProvider identity(SkMatrix::I());
+        SkPaint                paint;
+        paint.setAntiAlias(true);
+        SkSTArenaAlloc<2048> alloc;
+        SkBlitter* blitter = SkBlitter::Choose(fPixmap, identity, paint, &alloc, false, nullptr);
+        for (int i = 0; i < loops; i++) {
+            SkScan::AnalyticAntiFillPath(fPath, fRC, blitter, fExecutor.get());
+        }
+    }
+
+private:
+    using INHERITED = Benchmark;
+};
+
+DEF_BENCH( return new BigFillPathBench(); )
+DEF_BENCH( return new BigFillPathBench(0); )
+DEF_BENCH( return new BigFillPathBench(1); )
+DEF_BENCH( return new BigFillPathBench(2); )
+DEF_BENCH( return new BigFillPathBench(4); )
+DEF_BENCH( return new BigFillPathBench(8); )
@@ -6,12 +6,14 @@
  */
 #include "bench/Benchmark.h"
 #include "include/core/SkCanvas.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkMaskFilter.h"
 #include "include/core/SkPaint.h"
 #include "include/core/SkShader.h"
 #include "include/core/SkString.h"
 #include "include/utils/SkRandom.h"
 #include "src/core/SkBlurMask.h"
+#include "tools/ToolUtils.h"
 
 #define MINI    0.01f
 #define SMALL   SkIntToScalar(2)
@@ -101,3 +103,65 @@ DEF_BENCH(return new BlurBench(REAL, kOuter_SkBlurStyle);)
 DEF_BENCH(return new BlurBench(REAL, kInner_SkBlurStyle);)
 
 DEF_BENCH(return new BlurBench(0, kNormal_SkBlurStyle);)
+
+// Blurs one large mask directly, splitting the passes into bands on an executor with the given
+// number of threads (0 meaning none), to measure how the mask blur scales.
+class BlurMaskThreadsBench : public Benchmark {
+    SkScalar                    fRadius;
+    int                         fThreads;
+    SkString                    fName;
+    SkMask                      fSrcMask;
+    std::unique_ptr<SkExecutor> fExecutor;
+
+public:
+    BlurMaskThreadsBench(SkScalar rad, int threads) : fRadius(rad), fThreads(threads) {
+        fName.printf("blur_mask_%.2f_threads_%d", SkScalarToFloat(rad), threads);
+        fSrcMask.fImage = nullptr;
+    }
+
+    ~BlurMaskThreadsBench() override {
+        SkMask::FreeImage(fSrcMask.fImage);
+    }
+
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+    void onDelayedSetup() override {
+        fSrcMask.fBounds.setWH(1024, 1024);
+        fSrcMask.fFormat = SkMask::kA8_Format;
+        fSrcMask.fRowBytes = fSrcMask.fBounds.width();
+        fSrcMask.fImage = SkMask::AllocImage(fSrcMask.computeTotalImageSize());
+        SkRandom rand;
+        for (size_t i = 0; i < fSrcMask.computeTotalImageSize(); i++) {
+            fSrcMask.fImage[i] = rand.nextU() & 0xff;
+        }
+        fExecutor = ToolUtils::make_executor(fThreads);
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        for (int i = 0; i < loops; i++) {
+            SkMask mask;
+            if (!SkBlurMask::BoxBlur(&mask, fSrcMask, SkBlurMask::ConvertRadiusToSigma(fRadius),
+                                     kNormal_SkBlurStyle, nullptr, fExecutor.get())) {
+                return;
+            }
+            SkMask::FreeImage(mask.fImage);
+        }
+    }
+
+private:
+    using INHERITED = Benchmark;
+};
+
+DEF_BENCH(return new BlurMaskThreadsBench(BIG, 0);)
+DEF_BENCH(return new BlurMaskThreadsBench(BIG, 1);)
+DEF_BENCH(return new BlurMaskThreadsBench(BIG, 3);)
+DEF_BENCH(return new BlurMaskThreadsBench(REALBIG, 0);)
+DEF_BENCH(return new BlurMaskThreadsBench(REALBIG, 1);)
+DEF_BENCH(return new BlurMaskThreadsBench(REALBIG, 3);)
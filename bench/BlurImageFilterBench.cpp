@@ -8,11 +8,14 @@
 #include "bench/Benchmark.h"
 #include "include/core/SkBitmap.h"
 #include "include/core/SkCanvas.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkPaint.h"
 #include "include/core/SkShader.h"
 #include "include/core/SkString.h"
 #include "include/effects/SkImageFilters.h"
 #include "include/utils/SkRandom.h"
+#include "src/effects/imagefilters/SkBlurImageFilterPriv.h"
+#include "tools/ToolUtils.h"
 
 #define FILTER_WIDTH_SMALL  32
 #define FILTER_HEIGHT_SMALL 32
@@ -161,3 +164,53 @@ DEF_BENCH(return new BlurImageFilterBench(BLUR_SIGMA_LARGE, BLUR_SIGMA_LARGE, tr
 DEF_BENCH(return new BlurImageFilterBench(BLUR_SIGMA_LARGE, BLUR_SIGMA_LARGE, false, true, true);)
 DEF_BENCH(return new BlurImageFilterBench(BLUR_SIGMA_HUGE, BLUR_SIGMA_HUGE, true, true, true);)
 DEF_BENCH(return new BlurImageFilterBench(BLUR_SIGMA_HUGE, BLUR_SIGMA_HUGE, false, true, true);)
+
+// Runs the raster blur on the large checkerboard directly, splitting the passes into bands on an
+// executor with the given number of threads (0 meaning none), to measure how it scales.
+class BlurImageFilterThreadsBench : public Benchmark {
+public:
+    BlurImageFilterThreadsBench(SkScalar sigma, int threads) : fSigma(sigma), fThreads(threads) {
+        fName.printf("blur_image_filter_raster_%.2f_threads_%d", SkScalarToFloat(sigma), threads);
+    }
+
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+    void onDelayedSetup() override {
+        sk_sp<SkImage> checkerboard = make_checkerboard(FILTER_WIDTH_LARGE, FILTER_HEIGHT_LARGE);
+        checkerboard->asLegacyBitmap(&fCheckerboard);
+        fExecutor = ToolUtils::make_executor(fThreads);
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        const SkIRect srcBounds = fCheckerboard.bounds();
+        const int border = SkScalarCeilToInt(3 * fSigma);
+        const SkIRect dstBounds = srcBounds.makeOutset(border, border);
+        for (int i = 0; i < loops; i++) {
+            SkBitmap dst;
+            SkBlurImageFilterPriv::BlurBitmap({fSigma, fSigma}, fCheckerboard, srcBounds,
+                                              dstBounds, &dst, fExecutor.get());
+        }
+    }
+
+private:
+    SkString fName;
+    SkScalar fSigma;
+    int fThreads;
+    SkBitmap fCheckerboard;
+    std::unique_ptr<SkExecutor> fExecutor;
+    using INHERITED = Benchmark;
+};
+
+DEF_BENCH(return new BlurImageFilterThreadsBench(BLUR_SIGMA_LARGE, 0);)
+DEF_BENCH(return new BlurImageFilterThreadsBench(BLUR_SIGMA_LARGE, 1);)
+DEF_BENCH(return new BlurImageFilterThreadsBench(BLUR_SIGMA_LARGE, 3);)
+DEF_BENCH(return new BlurImageFilterThreadsBench(BLUR_SIGMA_HUGE, 0);)
+DEF_BENCH(return new BlurImageFilterThreadsBench(BLUR_SIGMA_HUGE, 1);)
+DEF_BENCH(return new BlurImageFilterThreadsBench(BLUR_SIGMA_HUGE, 3);)
@@ -9,13 +9,24 @@
 #include "bench/CodecBenchPriv.h"
 #include "include/codec/SkCodec.h"
 #include "include/core/SkBitmap.h"
+#include "include/core/SkCanvas.h"
+#include "include/core/SkExecutor.h"
+#include "include/core/SkImage.h"
+#include "include/core/SkStream.h"
+#include "include/encode/SkJpegEncoder.h"
+#include "include/encode/SkPngEncoder.h"
 #include "src/core/SkOSFile.h"
+#include "src/utils/SkOSPath.h"
+#include "tools/Resources.h"
 #include "tools/flags/CommandLineFlags.h"
 
 // Actually zeroing the memory would throw off timing, so we just lie.
 static DEFINE_bool(zero_init, false,
                    "Pretend our destination is zero-intialized, simulating Android?");
 
+static DEFINE_int(codec_threads, 0,
+                  "If > 0, pass a thread pool of this size as SkCodec::Options::fExecutor.");
+
 CodecBench::CodecBench(SkString baseName, SkData* encoded, SkColorType colorType,
         SkAlphaType alphaType)
     : fColorType(colorType)
@@ -25,10 +36,15 @@ CodecBench::CodecBench(SkString baseName, SkData* encoded, SkColorType colorType
     // Parse filename and the color type to give the benchmark a useful name
     fName.printf("Codec_%s_%s%s", baseName.c_str(), color_type_to_str(colorType),
             alpha_type_to_str(alphaType));
+    if (FLAGS_codec_threads > 0) {
+        fName.appendf("_threads_%d", FLAGS_codec_threads);
+    }
     // Ensure that we can create an SkCodec from this data.
     SkASSERT(SkCodec::MakeFromData(fData));
 }
 
+CodecBench::~CodecBench() = default;
+
 const char* CodecBench::onGetName() {
     return fName.c_str();
 }
@@ -45,6 +61,10 @@ void CodecBench::onDelayedSetup() {
                             .makeColorSpace(nullptr);
 
     fPixelStorage.reset(fInfo.computeMinByteSize());
+
+    if (FLAGS_codec_threads > 0) {
+        fExecutor = SkExecutor::MakeFIFOThreadPool(FLAGS_codec_threads);
+    }
 }
 
 void CodecBench::onDraw(int n, SkCanvas* canvas) {
@@ -53,6 +73,7 @@ void CodecBench::onDraw(int n, SkCanvas* canvas) {
     if (FLAGS_zero_init) {
         options.fZeroInitialized = SkCodec::kYes_ZeroInitialized;
     }
+    options.fExecutor = fExecutor.get();
     for (int i = 0; i < n; i++) {
         codec = SkCodec::MakeFromData(fData);
 #ifdef SK_DEBUG
@@ -64,3 +85,149 @@ void CodecBench::onDraw(int n, SkCanvas* canvas) {
                  || result == SkCodec::kIncompleteInput);
     }
 }
+
+// Decodes a large image on a pool of this many threads (0 for no executor), to measure how
+// SkCodec::Options::fExecutor scales without needing suitable images on disk.
+class ExecutorDecodeBench : public Benchmark {
+public:
+    enum class Format {
+        kJpegRestart,  // A JPEG with a restart marker after every MCU row.
+        kPng,
+    };
+
+    ExecutorDecodeBench(Format format, int threads)
+        : fFormat(format)
+        , fThreads(threads)
+        , fName(SkStringPrintf("Codec_%s_threads_%d",
+                               format == Format::kPng ? "png" : "jpeg_restart", threads)) {}
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    bool isSuitableFor(Backend backend) override { return kNonRendering_Backend == backend; }
+
+    void onDelayedSetup() override {
+        SkBitmap src;
+        SkAssertResult(GetResourceAsBitmap("images/mandrill_512.png", &src));
+
+        SkBitmap large;
+        large.allocN32Pixels(4096, 3072, true);
+        SkCanvas(large).drawImageRect(src.asImage(), SkRect::Make(large.bounds()),
+                                      SkSamplingOptions(SkFilterMode::kLinear));
+
+        SkDynamicMemoryWStream stream;
+        if (fFormat == Format::kPng) {
+            SkAssertResult(SkPngEncoder::Encode(&stream, large.pixmap(), {}));
+        } else {
+            SkJpegEncoder::Options options;
+            options.fQuality = 90;
+            options.fRestartRows = 1;
+            SkAssertResult(SkJpegEncoder::Encode(&stream, large.pixmap(), options));
+        }
+        fData = stream.detachAsData();
+
+        fInfo = large.info();
+        fPixelStorage.reset(fInfo.computeMinByteSize());
+        if (fThreads > 0) {
+            fExecutor = SkExecutor::MakeFIFOThreadPool(fThreads);
+        }
+    }
+
+    void onDraw(int n, SkCanvas*) override {
+        SkCodec::Options options;
+        options.fExecutor = fExecutor.get();
+        for (int i = 0; i < n; i++) {
+            std::unique_ptr<SkCodec> codec = SkCodec::MakeFromData(fData);
+            SkAssertResult(SkCodec::kSuccess == codec->getPixels(fInfo, fPixelStorage.get(),
+                                                                 fInfo.minRowBytes(), &options));
+        }
+    }
+
+private:
+    const Format                fFormat;
+    const int                   fThreads;
+    SkString                    fName;
+    sk_sp<SkData>               fData;
+    SkImageInfo                 fInfo;
+    SkAutoMalloc                fPixelStorage;
+    std::unique_ptr<SkExecutor> fExecutor;
+};
+
+DEF_BENCH(return new ExecutorDecodeBench(ExecutorDecodeBench::Format::kJpegRestart, 0));
+DEF_BENCH(return new ExecutorDecodeBench(ExecutorDecodeBench::Format::kJpegRestart, 1));
+DEF_BENCH(return new ExecutorDecodeBench(ExecutorDecodeBench::Format::kJpegRestart, 2));
+DEF_BENCH(return new ExecutorDecodeBench(ExecutorDecodeBench::Format::kJpegRestart, 4));
+DEF_BENCH(return new ExecutorDecodeBench(ExecutorDecodeBench::Format::kJpegRestart, 8));
+
+DEF_BENCH(return new ExecutorDecodeBench(ExecutorDecodeBench::Format::kPng, 0));
+DEF_BENCH(return new ExecutorDecodeBench(ExecutorDecodeBench::Format::kPng, 1));
+DEF_BENCH(return new ExecutorDecodeBench(ExecutorDecodeBench::Format::kPng, 2));
+DEF_BENCH(return new ExecutorDecodeBench(ExecutorDecodeBench::Format::kPng, 4));
+DEF_BENCH(return new ExecutorDecodeBench(ExecutorDecodeBench::Format::kPng, 8));
+
+namespace {
+// An SkMemoryStream that does not expose its memory, so codecs must copy out of it.
+class UnmappedMemoryStream final : public SkMemoryStream {
+public:
+    explicit UnmappedMemoryStream(sk_sp<SkData> data) : SkMemoryStream(std::move(data)) {}
+    const void* getMemoryBase() override { return nullptr; }
+};
+}  // namespace
+
+// Decodes an image from memory, either read in place (as codecs do for an mmap'd SkData) or
+// through a stream that hides its memory, to measure what reading in place saves.
+class InputDecodeBench : public Benchmark {
+public:
+    InputDecodeBench(const char* resource, bool inPlace)
+        : fResource(resource)
+        , fInPlace(inPlace)
+        , fName(SkStringPrintf("Codec_input_%s_%s", SkOSPath::Basename(resource).c_str(),
+                               inPlace ? "in_place" : "copied")) {}
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    bool isSuitableFor(Backend backend) override { return kNonRendering_Backend == backend; }
+
+    void onDelayedSetup() override {
+        fData = GetResourceAsData(fResource);
+        SkASSERT(fData);
+        fInfo = SkCodec::MakeFromData(fData)->getInfo().makeColorType(kN32_SkColorType)
+                                                         .makeAlphaType(kPremul_SkAlphaType);
+        fPixelStorage.reset(fInfo.computeMinByteSize());
+    }
+
+    void onDraw(int n, SkCanvas*) override {
+        for (int i = 0; i < n; i++) {
+            std::unique_ptr<SkStream> stream =
+                    fInPlace ? std::make_unique<SkMemoryStream>(fData)
+                             : std::make_unique<UnmappedMemoryStream>(fData);
+            std::unique_ptr<SkCodec> codec = SkCodec::MakeFromStream(std::move(stream));
+            codec->getPixels(fInfo, fPixelStorage.get(), fInfo.minRowBytes());
+        }
+    }
+
+private:
+    const char*   fResource;
+    const bool    fInPlace;
+    SkString      fName;
+    sk_sp<SkData> fData;
+    SkImageInfo   fInfo;
+    SkAutoMalloc  fPixelStorage;
+};
+
+static const char* kInputBenchResources[] = {
+    "images/gamut.png",
+    "images/index8.png",
+    "images/test640x479.gif",
+    "images/randPixels.bmp",
+};
+
+DEF_BENCH(return new InputDecodeBench(kInputBenchResources[0], true));
+DEF_BENCH(return new InputDecodeBench(kInputBenchResources[0], false));
+DEF_BENCH(return new InputDecodeBench(kInputBenchResources[1], true));
+DEF_BENCH(return new InputDecodeBench(kInputBenchResources[1], false));
+DEF_BENCH(return new InputDecodeBench(kInputBenchResources[2], true));
+DEF_BENCH(return new InputDecodeBench(kInputBenchResources[2], false));
+DEF_BENCH(return new InputDecodeBench(kInputBenchResources[3], true));
+DEF_BENCH(return new InputDecodeBench(kInputBenchResources[3], false));
@@ -15,6 +15,10 @@
 #include "include/core/SkString.h"
 #include "src/core/SkAutoMalloc.h"
 
+#include <memory>
+
+class SkExecutor;
+
 /**
  *  Time SkCodec.
  */
@@ -22,6 +26,7 @@ class CodecBench : public Benchmark {
 public:
     // Calls encoded->ref()
     CodecBench(SkString basename, SkData* encoded, SkColorType colorType, SkAlphaType alphaType);
+    ~CodecBench() override;
 
 protected:
     const char* onGetName() override;
@@ -36,6 +41,7 @@ private:
     sk_sp<SkData>           fData;
     SkImageInfo             fInfo;          // Set in onDelayedSetup.
     SkAutoMalloc            fPixelStorage;
+    std::unique_ptr<SkExecutor> fExecutor;  // Set in onDelayedSetup if --codec_threads > 0.
     using INHERITED = Benchmark;
 };
 #endif // CodecBench_DEFINED
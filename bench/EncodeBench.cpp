@@ -7,6 +7,7 @@
 
 #include "bench/Benchmark.h"
 #include "include/core/SkBitmap.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkStream.h"
 #include "include/encode/SkJpegEncoder.h"
 #include "include/encode/SkPngEncoder.h"
@@ -123,3 +124,51 @@ DEF_BENCH(return new EncodeBench(srcs[1], PNG(kNone, 3), "PNG_3n"));
 DEF_BENCH(return new EncodeBench(srcs[1], PNG(kNone, 1), "PNG_1n"));
 
 #undef PNG
+
+// Parallel PNG encoding (SkPngEncoder::Options::fExecutor) on a pool of this many threads.
+// Compare with the serial "PNG" benches above.
+class PngThreadsEncodeBench : public Benchmark {
+public:
+    PngThreadsEncodeBench(const char* filename, int threads)
+        : fSourceFilename(filename)
+        , fThreads(threads)
+        , fName(SkStringPrintf("Encode_%s_PNG_threads_%d", filename, threads)) {}
+
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        SkAssertResult(GetResourceAsBitmap(fSourceFilename, &fBitmap));
+        fExecutor = SkExecutor::MakeFIFOThreadPool(fThreads);
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        SkPngEncoder::Options opts;
+        opts.fExecutor = fExecutor.get();
+        while (loops-- > 0) {
+            SkPixmap pixmap;
+            SkAssertResult(fBitmap.peekPixels(&pixmap));
+            SkNullWStream dst;
+            SkAssertResult(SkPngEncoder::Encode(&dst, pixmap, opts));
+            SkASSERT(dst.bytesWritten() > 0);
+        }
+    }
+
+private:
+    const char*                 fSourceFilename;
+    int                         fThreads;
+    SkString                    fName;
+    SkBitmap                    fBitmap;
+    std::unique_ptr<SkExecutor> fExecutor;
+};
+
+DEF_BENCH(return new PngThreadsEncodeBench(srcs[0], 1));
+DEF_BENCH(return new PngThreadsEncodeBench(srcs[0], 2));
+DEF_BENCH(return new PngThreadsEncodeBench(srcs[0], 4));
+DEF_BENCH(return new PngThreadsEncodeBench(srcs[0], 8));
+
+DEF_BENCH(return new PngThreadsEncodeBench(srcs[1], 1));
+DEF_BENCH(return new PngThreadsEncodeBench(srcs[1], 2));
+DEF_BENCH(return new PngThreadsEncodeBench(srcs[1], 4));
+DEF_BENCH(return new PngThreadsEncodeBench(srcs[1], 8));
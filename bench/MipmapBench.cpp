@@ -8,20 +8,23 @@
 #include "bench/Benchmark.h"
 #include "include/core/SkBitmap.h"
 #include "src/core/SkMipmap.h"
+#include "tools/ToolUtils.h"
 
 class MipmapBench: public Benchmark {
     SkBitmap fBitmap;
     SkString fName;
     const int fW, fH;
-    bool fHalfFoat;
+    const SkColorType fColorType;
 
 public:
-    MipmapBench(int w, int h, bool halfFloat = false)
-        : fW(w), fH(h), fHalfFoat(halfFloat)
+    MipmapBench(int w, int h, SkColorType ct = kN32_SkColorType)
+        : fW(w), fH(h), fColorType(ct)
     {
         fName.printf("mipmap_build_%dx%d", w, h);
-        if (halfFloat) {
+        if (ct == kRGBA_F16_SkColorType) {
             fName.append("_f16");
+        } else if (ct != kN32_SkColorType) {
+            fName.appendf("_%s", ToolUtils::colortype_name(ct));
         }
     }
 
@@ -33,8 +36,7 @@ protected:
     const char* onGetName() override { return fName.c_str(); }
 
     void onDelayedSetup() override {
-        SkColorType ct = fHalfFoat ? kRGBA_F16_SkColorType : kN32_SkColorType;
-        SkImageInfo info = SkImageInfo::Make(fW, fH, ct, kPremul_SkAlphaType,
+        SkImageInfo info = SkImageInfo::Make(fW, fH, fColorType, kPremul_SkAlphaType,
                                              SkColorSpace::MakeSRGB());
         fBitmap.allocPixels(info);
         fBitmap.eraseColor(SK_ColorWHITE);  // so we don't read uninitialized memory
@@ -58,10 +60,21 @@ DEF_BENCH( return new MipmapBench(512, 511); )
 DEF_BENCH( return new MipmapBench(511, 512); )
 DEF_BENCH( return new MipmapBench(512, 512); )
 
-DEF_BENCH( return new MipmapBench(512, 512, true); )
-DEF_BENCH( return new MipmapBench(511, 511, true); )
+DEF_BENCH( return new MipmapBench(512, 512, kRGBA_F16_SkColorType); )
+DEF_BENCH( return new MipmapBench(511, 511, kRGBA_F16_SkColorType); )
 
 DEF_BENCH( return new MipmapBench(2048, 2048); )
 DEF_BENCH( return new MipmapBench(2047, 2047); )
 DEF_BENCH( return new MipmapBench(2048, 2047); )
 DEF_BENCH( return new MipmapBench(2047, 2048); )
+
+// The other color types with vectorized box (even) and triangle (odd) filters, at a size big
+// enough for the largest levels to be filtered in parallel bands.
+//
+#define DEF_MIPMAP_BENCHES(ct)                                  \
+    DEF_BENCH( return new MipmapBench(2048, 2048, ct); )        \
+    DEF_BENCH( return new MipmapBench(2047, 2047, ct); )
+
+DEF_MIPMAP_BENCHES(kAlpha_8_SkColorType)
+DEF_MIPMAP_BENCHES(kRGBA_1010102_SkColorType)
+DEF_MIPMAP_BENCHES(kRGBA_F16_SkColorType)
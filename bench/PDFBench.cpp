@@ -76,6 +76,7 @@ DEF_BENCH(return new PDFScalarBench("PDFScalar_random", next_any);)
 
 #ifdef SK_SUPPORT_PDF
 
+#include "src/pdf/SkDeflate.h"
 #include "src/pdf/SkPDFBitmap.h"
 #include "src/pdf/SkPDFDocumentPriv.h"
 #include "src/pdf/SkPDFShader.h"
@@ -302,6 +303,69 @@ struct PDFClipPathBenchmark : public Benchmark {
     }
 };
 
+/** DEFLATE on its own, for comparing levels, strategies, and the one-shot
+    SkDeflateWStream::Compress() against streaming.  Each loop compresses the
+    same input, so MB/s is the input size over the time per loop. */
+class PDFDeflateBench : public Benchmark {
+public:
+    using Strategy = SkDeflateWStream::Strategy;
+
+    PDFDeflateBench(const char* input, int level, Strategy strategy, bool oneShot)
+        : fInput(input), fLevel(level), fStrategy(strategy), fOneShot(oneShot) {
+        static const char* kStrategyNames[] = {"default", "filtered", "rle", "huffman"};
+        fName.printf("PDFDeflate_%s_%d_%s%s", input, level,
+                     kStrategyNames[(int)strategy], oneShot ? "_oneshot" : "");
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+    void onDelayedSetup() override {
+        if (0 == strcmp(fInput, "content")) {
+            fData = GetResourceAsData("pdf_command_stream.txt");
+        } else {
+            // Deflated images are written as packed RGB.
+            SkBitmap bitmap;
+            if (GetResourceAsBitmap("images/mandrill_512.png", &bitmap)) {
+                SkDynamicMemoryWStream rgb;
+                for (int y = 0; y < bitmap.height(); ++y) {
+                    for (int x = 0; x < bitmap.width(); ++x) {
+                        SkColor color = bitmap.getColor(x, y);
+                        uint8_t bytes[] = {(uint8_t)SkColorGetR(color),
+                                           (uint8_t)SkColorGetG(color),
+                                           (uint8_t)SkColorGetB(color)};
+                        rgb.write(bytes, sizeof(bytes));
+                    }
+                }
+                fData = rgb.detachAsData();
+            }
+        }
+    }
+    void onDraw(int loops, SkCanvas*) override {
+        SkASSERT(fData);
+        if (!fData) { return; }
+        while (loops-- > 0) {
+            SkNullWStream dst;
+            if (fOneShot) {
+                SkDeflateWStream::Compress(fData->data(), fData->size(), &dst, fLevel, fStrategy);
+            } else {
+                SkDeflateWStream deflateWStream(&dst, fLevel, false, fStrategy);
+                deflateWStream.write(fData->data(), fData->size());
+            }
+        }
+    }
+
+private:
+    const char*   fInput;
+    int           fLevel;
+    Strategy      fStrategy;
+    bool          fOneShot;
+    SkString      fName;
+    sk_sp<SkData> fData;
+};
+
 }  // namespace
 DEF_BENCH(return new PDFImageBench;)
 DEF_BENCH(return new PDFJpegImageBench;)
@@ -311,6 +375,18 @@ DEF_BENCH(return new PDFShaderBench;)
 DEF_BENCH(return new WritePDFTextBenchmark;)
 DEF_BENCH(return new PDFClipPathBenchmark;)
 
+using DeflateStrategy = SkDeflateWStream::Strategy;
+DEF_BENCH(return new PDFDeflateBench("content", -1, DeflateStrategy::kDefault, false);)
+DEF_BENCH(return new PDFDeflateBench("content", -1, DeflateStrategy::kDefault, true);)
+DEF_BENCH(return new PDFDeflateBench("content",  1, DeflateStrategy::kDefault, true);)
+DEF_BENCH(return new PDFDeflateBench("content",  9, DeflateStrategy::kDefault, true);)
+DEF_BENCH(return new PDFDeflateBench("image", -1, DeflateStrategy::kDefault, false);)
+DEF_BENCH(return new PDFDeflateBench("image", -1, DeflateStrategy::kDefault, true);)
+DEF_BENCH(return new PDFDeflateBench("image",  1, DeflateStrategy::kDefault, true);)
+DEF_BENCH(return new PDFDeflateBench("image", -1, DeflateStrategy::kFiltered, true);)
+DEF_BENCH(return new PDFDeflateBench("image", -1, DeflateStrategy::kRLE, true);)
+DEF_BENCH(return new PDFDeflateBench("image", -1, DeflateStrategy::kHuffmanOnly, true);)
+
 #ifdef SK_PDF_ENABLE_SLOW_TESTS
 #include "include/core/SkExecutor.h"
 namespace {
@@ -13,10 +13,12 @@
 #include "include/core/SkPath.h"
 #include "include/core/SkShader.h"
 #include "include/core/SkString.h"
+#include "include/core/SkSurface.h"
 #include "include/private/SkTArray.h"
 #include "include/utils/SkRandom.h"
 
 #include "src/core/SkDraw.h"
+#include "src/core/SkSurfacePriv.h"
 
 enum Flags {
     kStroke_Flag = 1 << 0,
@@ -1145,6 +1147,81 @@ private:
 };
 
 
+// Fills the same anti-aliased paths on raster surfaces with the default scan converters and with
+// the sparse scanline rasterizer (kSparseScanlineAA_SkSurfacePropsPrivateFlag).
+class SparseScanlinePathBench : public Benchmark {
+public:
+    enum Shape { kConcave_Shape, kCurves_Shape, kStar_Shape };
+
+    SparseScanlinePathBench(Shape shape, bool sparse) : fShape(shape), fSparse(sparse) {
+        static const char* gShapeNames[] = { "concave", "curves", "star" };
+        fName.printf("path_fill_aa_%s_%s", gShapeNames[shape], sparse ? "sparse" : "default");
+    }
+
+protected:
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        switch (fShape) {
+            case kConcave_Shape:
+                fPath.moveTo(10, 10);
+                fPath.lineTo(150, 10);
+                fPath.lineTo(150, 50);
+                fPath.lineTo(400, 400);
+                fPath.close();
+                break;
+            case kCurves_Shape:
+                fPath.addCircle(256, 256, 200);
+                fPath.addCircle(256, 256, 120, SkPathDirection::kCCW);
+                fPath.moveTo(40, 480);
+                fPath.cubicTo(100, 20, 400, 20, 480, 480);
+                fPath.quadTo(256, 300, 40, 480);
+                break;
+            case kStar_Shape: {
+                const int kPoints = 500;
+                for (int i = 0; i < kPoints; ++i) {
+                    const SkScalar r = (i & 1) ? 240 : 40,
+                                   t = 2 * SK_ScalarPI * i / kPoints;
+                    const SkPoint  p = {256 + r * SkScalarCos(t), 256 + r * SkScalarSin(t)};
+                    if (i == 0) {
+                        fPath.moveTo(p);
+                    } else {
+                        fPath.lineTo(p);
+                    }
+                }
+                fPath.close();
+            } break;
+        }
+
+        const SkSurfaceProps props(fSparse ? kSparseScanlineAA_SkSurfacePropsPrivateFlag : 0,
+                                   kUnknown_SkPixelGeometry);
+        fSurface = SkSurface::MakeRaster(SkImageInfo::MakeN32Premul(512, 512), &props);
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        SkCanvas* canvas = fSurface->getCanvas();
+        for (int i = 0; i < loops; ++i) {
+            canvas->drawPath(fPath, paint);
+        }
+    }
+
+private:
+    Shape            fShape;
+    bool             fSparse;
+    SkString         fName;
+    SkPath           fPath;
+    sk_sp<SkSurface> fSurface;
+
+    using INHERITED = Benchmark;
+};
+
+
 const SkRect ConservativelyContainsBench::kBounds = SkRect::MakeWH(SkIntToScalar(100), SkIntToScalar(100));
 const SkSize ConservativelyContainsBench::kQueryMin = {SkIntToScalar(1), SkIntToScalar(1)};
 const SkSize ConservativelyContainsBench::kQueryMax = {SkIntToScalar(40), SkIntToScalar(40)};
@@ -1184,6 +1261,13 @@ DEF_BENCH( return new AAAConcavePathBench(FLAGS10); )
 DEF_BENCH( return new AAAConvexPathBench(FLAGS00); )
 DEF_BENCH( return new AAAConvexPathBench(FLAGS10); )
 
+DEF_BENCH( return new SparseScanlinePathBench(SparseScanlinePathBench::kConcave_Shape, false); )
+DEF_BENCH( return new SparseScanlinePathBench(SparseScanlinePathBench::kConcave_Shape, true); )
+DEF_BENCH( return new SparseScanlinePathBench(SparseScanlinePathBench::kCurves_Shape, false); )
+DEF_BENCH( return new SparseScanlinePathBench(SparseScanlinePathBench::kCurves_Shape, true); )
+DEF_BENCH( return new SparseScanlinePathBench(SparseScanlinePathBench::kStar_Shape, false); )
+DEF_BENCH( return new SparseScanlinePathBench(SparseScanlinePathBench::kStar_Shape, true); )
+
 DEF_BENCH( return new SawToothPathBench(FLAGS00); )
 DEF_BENCH( return new SawToothPathBench(FLAGS01); )
 
@@ -6,12 +6,14 @@
  */
 
 #include "bench/Benchmark.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkPath.h"
 #include "include/core/SkShader.h"
 #include "include/core/SkString.h"
 #include "include/pathops/SkPathOps.h"
 #include "include/private/SkTArray.h"
 #include "include/utils/SkRandom.h"
+#include "tools/ToolUtils.h"
 
 class PathOpsBench : public Benchmark {
     SkString    fName;
@@ -94,6 +96,139 @@ static SkPath makerects() {
 }
 DEF_BENCH( return new PathOpsSimplifyBench("rects", makerects()); )
 
+// Unions many small overlapping shapes, like the features of a map tile, with resolve() or with
+// resolveInParallel() on fThreads threads.
+class PathOpsUnionBench : public Benchmark {
+    static constexpr int kPaths = 2048;
+
+    SkString                    fName;
+    SkTArray<SkPath>            fPaths;
+    bool                        fParallel;
+    int                         fThreads;
+    std::unique_ptr<SkExecutor> fExecutor;
+
+public:
+    PathOpsUnionBench(bool parallel, int threads = -1) : fParallel(parallel), fThreads(threads) {
+        fName.printf("pathops_union%s", parallel ? "_parallel" : "");
+        if (fThreads >= 0) {
+            fName.appendf("_threads_%d", fThreads);
+        }
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    void onDelayedSetup() override {
+        SkRandom rand;
+        for (int i = 0; i < kPaths; ++i) {
+            // Clusters of 32 rects and circles, scattered over a 1024 square.
+            if (i % 32 == 0) {
+                fPaths.push_back().addCircle(rand.nextRangeF(0, 1024), rand.nextRangeF(0, 1024), 8);
+                continue;
+            }
+            const SkRect& seed = fPaths[i / 32 * 32].getBounds();
+            const float x = seed.centerX() + rand.nextRangeF(-24, 24),
+                        y = seed.centerY() + rand.nextRangeF(-24, 24),
+                        r = rand.nextRangeF(2, 8);
+            if (i & 1) {
+                fPaths.push_back().addRect({x - r, y - r / 2, x + r, y + r / 2});
+            } else {
+                fPaths.push_back().addCircle(x, y, r);
+            }
+        }
+
+        if (fThreads >= 0) {
+            fExecutor = ToolUtils::make_executor(fThreads);
+        }
+    }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        for (int i = 0; i < loops; ++i) {
+            SkOpBuilder builder;
+            for (const SkPath& path : fPaths) {
+                builder.add(path, kUnion_SkPathOp);
+            }
+            SkPath result;
+            if (fParallel) {
+                builder.resolveInParallel(&result, fExecutor.get());
+            } else {
+                builder.resolve(&result);
+            }
+        }
+    }
+
+private:
+    using INHERITED = Benchmark;
+};
+DEF_BENCH( return new PathOpsUnionBench(false); )
+DEF_BENCH( return new PathOpsUnionBench(true, 0); )
+DEF_BENCH( return new PathOpsUnionBench(true, 1); )
+DEF_BENCH( return new PathOpsUnionBench(true, 2); )
+DEF_BENCH( return new PathOpsUnionBench(true, 4); )
+DEF_BENCH( return new PathOpsUnionBench(true, 8); )
+
+// Ops on two ragged coastlines of fPoints segments each, which cross each other many times.
+class PathOpsBigPathBench : public Benchmark {
+    SkString    fName;
+    SkPath      fPath1, fPath2;
+    int         fPoints;
+    bool        fSimplify;
+    SkPathOp    fOp;
+
+public:
+    PathOpsBigPathBench(const char suffix[], int points, bool simplify,
+                        SkPathOp op = kUnion_SkPathOp)
+            : fPoints(points), fSimplify(simplify), fOp(op) {
+        fName.printf("pathops_bigpath_%s_%d", suffix, points);
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    void onDelayedSetup() override {
+        fPath1 = ToolUtils::make_coastline({500, 500}, 300, fPoints, 1);
+        fPath2 = ToolUtils::make_coastline({560, 530}, 280, fPoints, 2);
+        if (fSimplify) {
+            fPath1.addPath(fPath2);
+        }
+    }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        for (int i = 0; i < loops; i++) {
+            SkPath result;
+            if (fSimplify) {
+                Simplify(fPath1, &result);
+            } else {
+                Op(fPath1, fPath2, fOp, &result);
+            }
+        }
+    }
+
+private:
+    using INHERITED = Benchmark;
+};
+DEF_BENCH( return new PathOpsBigPathBench("simplify",   256, true); )
+DEF_BENCH( return new PathOpsBigPathBench("simplify",  1024, true); )
+DEF_BENCH( return new PathOpsBigPathBench("simplify",  4096, true); )
+DEF_BENCH( return new PathOpsBigPathBench("union",      256, false, kUnion_SkPathOp); )
+DEF_BENCH( return new PathOpsBigPathBench("union",     1024, false, kUnion_SkPathOp); )
+DEF_BENCH( return new PathOpsBigPathBench("union",     4096, false, kUnion_SkPathOp); )
+DEF_BENCH( return new PathOpsBigPathBench("intersect",  256, false, kIntersect_SkPathOp); )
+DEF_BENCH( return new PathOpsBigPathBench("intersect", 1024, false, kIntersect_SkPathOp); )
+DEF_BENCH( return new PathOpsBigPathBench("intersect", 4096, false, kIntersect_SkPathOp); )
+
 #include "include/core/SkPathBuilder.h"
 
 template <size_t N> struct ArrayPath {
@@ -24,7 +24,7 @@
 // Chrome draws into small tiles with impl-side painting.
 // This benchmark measures the relative performance of our bounding-box hierarchies,
 // both when querying tiles perfectly and when not.
-enum BBH  { kNone, kRTree };
+enum BBH  { kNone, kRTree, kPackedRTree };
 enum Mode { kTiled, kRandom };
 class TiledPlaybackBench : public Benchmark {
 public:
@@ -32,6 +32,7 @@ public:
         switch (fBBH) {
             case kNone:     fName.append("_none"    ); break;
             case kRTree:    fName.append("_rtree"   ); break;
+            case kPackedRTree: fName.append("_packedrtree"); break;
         }
         switch (fMode) {
             case kTiled:  fName.append("_tiled" ); break;
@@ -47,6 +48,7 @@ public:
         switch (fBBH) {
             case kNone:                                                   break;
             case kRTree:    factory = std::make_unique<SkRTreeFactory>(); break;
+            case kPackedRTree: factory = std::make_unique<SkPackedRTreeFactory>(); break;
         }
 
         SkPictureRecorder recorder;
@@ -97,3 +99,5 @@ DEF_BENCH( return new TiledPlaybackBench(kNone,     kRandom); )
 DEF_BENCH( return new TiledPlaybackBench(kNone,     kTiled ); )
 DEF_BENCH( return new TiledPlaybackBench(kRTree,    kRandom); )
 DEF_BENCH( return new TiledPlaybackBench(kRTree,    kTiled ); )
+DEF_BENCH( return new TiledPlaybackBench(kPackedRTree, kRandom); )
+DEF_BENCH( return new TiledPlaybackBench(kPackedRTree, kTiled ); )
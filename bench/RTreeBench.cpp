@@ -10,6 +10,7 @@
 #include "include/core/SkString.h"
 #include "include/private/SkTemplates.h"
 #include "include/utils/SkRandom.h"
+#include "src/core/SkPackedRTree.h"
 #include "src/core/SkRTree.h"
 
 // confine rectangles to a smallish area, so queries generally hit something, and overlap occurs:
@@ -17,14 +18,20 @@ static const SkScalar GENERATE_EXTENTS = 1000.0f;
 static const int NUM_BUILD_RECTS = 500;
 static const int NUM_QUERY_RECTS = 5000;
 static const int GRID_WIDTH = 100;
+// A tall page recorded top to bottom, as when scrolling a long document.
+static const int NUM_SCROLL_RECTS = 100000;
+static const SkScalar SCROLL_HEIGHT = 100000.0f;
 
 typedef SkRect (*MakeRectProc)(SkRandom&, int, int);
 
 // Time how long it takes to build an R-Tree.
+template <typename Tree>
 class RTreeBuildBench : public Benchmark {
 public:
-    RTreeBuildBench(const char* name, MakeRectProc proc) : fProc(proc) {
-        fName.printf("rtree_%s_build", name);
+    RTreeBuildBench(const char* prefix, const char* name, MakeRectProc proc,
+                    int numRects = NUM_BUILD_RECTS)
+            : fProc(proc), fNumRects(numRects) {
+        fName.printf("%s_%s_build", prefix, name);
     }
 
     bool isSuitableFor(Backend backend) override {
@@ -37,28 +44,32 @@ protected:
     }
     void onDraw(int loops, SkCanvas* canvas) override {
         SkRandom rand;
-        SkAutoTMalloc<SkRect> rects(NUM_BUILD_RECTS);
-        for (int i = 0; i < NUM_BUILD_RECTS; ++i) {
-            rects[i] = fProc(rand, i, NUM_BUILD_RECTS);
+        SkAutoTMalloc<SkRect> rects(fNumRects);
+        for (int i = 0; i < fNumRects; ++i) {
+            rects[i] = fProc(rand, i, fNumRects);
         }
 
         for (int i = 0; i < loops; ++i) {
-            SkRTree tree;
-            tree.insert(rects.get(), NUM_BUILD_RECTS);
+            Tree tree;
+            tree.insert(rects.get(), fNumRects);
             SkASSERT(rects != nullptr);  // It'd break this bench if the tree took ownership of rects.
         }
     }
 private:
     MakeRectProc fProc;
+    int fNumRects;
     SkString fName;
     using INHERITED = Benchmark;
 };
 
 // Time how long it takes to perform queries on an R-Tree.
+template <typename Tree>
 class RTreeQueryBench : public Benchmark {
 public:
-    RTreeQueryBench(const char* name, MakeRectProc proc) : fProc(proc) {
-        fName.printf("rtree_%s_query", name);
+    RTreeQueryBench(const char* prefix, const char* name, MakeRectProc proc,
+                    int numRects = NUM_QUERY_RECTS, SkScalar queryHeight = GENERATE_EXTENTS)
+            : fProc(proc), fNumRects(numRects), fQueryHeight(queryHeight) {
+        fName.printf("%s_%s_query", prefix, name);
     }
 
     bool isSuitableFor(Backend backend) override {
@@ -70,11 +81,11 @@ protected:
     }
     void onDelayedSetup() override {
         SkRandom rand;
-        SkAutoTMalloc<SkRect> rects(NUM_QUERY_RECTS);
-        for (int i = 0; i < NUM_QUERY_RECTS; ++i) {
-            rects[i] = fProc(rand, i, NUM_QUERY_RECTS);
+        SkAutoTMalloc<SkRect> rects(fNumRects);
+        for (int i = 0; i < fNumRects; ++i) {
+            rects[i] = fProc(rand, i, fNumRects);
         }
-        fTree.insert(rects.get(), NUM_QUERY_RECTS);
+        fTree.insert(rects.get(), fNumRects);
     }
 
     void onDraw(int loops, SkCanvas* canvas) override {
@@ -83,15 +94,17 @@ protected:
             std::vector<int> hits;
             SkRect query;
             query.fLeft   = rand.nextRangeF(0, GENERATE_EXTENTS);
-            query.fTop    = rand.nextRangeF(0, GENERATE_EXTENTS);
+            query.fTop    = rand.nextRangeF(0, fQueryHeight);
             query.fRight  = query.fLeft + 1 + rand.nextRangeF(0, GENERATE_EXTENTS/2);
             query.fBottom = query.fTop  + 1 + rand.nextRangeF(0, GENERATE_EXTENTS/2);
             fTree.search(query, &hits);
         }
     }
 private:
-    SkRTree fTree;
+    Tree fTree;
     MakeRectProc fProc;
+    int fNumRects;
+    SkScalar fQueryHeight;
     SkString fName;
     using INHERITED = Benchmark;
 };
@@ -126,14 +139,30 @@ static inline SkRect make_concentric_rects(SkRandom&, int index, int numRects) {
     return SkRect::MakeWH(SkIntToScalar(index+1), SkIntToScalar(index+1));
 }
 
-///////////////////////////////////////////////////////////////////////////////
+static inline SkRect make_scroll_rects(SkRandom& rand, int index, int numRects) {
+    SkRect out;
+    out.fLeft   = rand.nextRangeF(0, GENERATE_EXTENTS);
+    out.fTop    = index * SCROLL_HEIGHT / numRects;
+    out.fRight  = out.fLeft + 1 + rand.nextRangeF(0, GENERATE_EXTENTS/10);
+    out.fBottom = out.fTop  + 1 + rand.nextRangeF(0, GENERATE_EXTENTS/10);
+    return out;
+}
 
-DEF_BENCH(return new RTreeBuildBench("XY", &make_XYordered_rects));
-DEF_BENCH(return new RTreeBuildBench("YX", &make_YXordered_rects));
-DEF_BENCH(return new RTreeBuildBench("random", &make_random_rects));
-DEF_BENCH(return new RTreeBuildBench("concentric", &make_concentric_rects));
+///////////////////////////////////////////////////////////////////////////////
 
-DEF_BENCH(return new RTreeQueryBench("XY", &make_XYordered_rects));
-DEF_BENCH(return new RTreeQueryBench("YX", &make_YXordered_rects));
-DEF_BENCH(return new RTreeQueryBench("random", &make_random_rects));
-DEF_BENCH(return new RTreeQueryBench("concentric", &make_concentric_rects));
+#define DEF_RTREE_BENCHES(Tree, prefix)                                                          \
+    DEF_BENCH(return new RTreeBuildBench<Tree>(prefix, "XY", &make_XYordered_rects));            \
+    DEF_BENCH(return new RTreeBuildBench<Tree>(prefix, "YX", &make_YXordered_rects));            \
+    DEF_BENCH(return new RTreeBuildBench<Tree>(prefix, "random", &make_random_rects));           \
+    DEF_BENCH(return new RTreeBuildBench<Tree>(prefix, "concentric", &make_concentric_rects));   \
+    DEF_BENCH(return new RTreeBuildBench<Tree>(prefix, "scroll", &make_scroll_rects,             \
+                                               NUM_SCROLL_RECTS));                               \
+    DEF_BENCH(return new RTreeQueryBench<Tree>(prefix, "XY", &make_XYordered_rects));            \
+    DEF_BENCH(return new RTreeQueryBench<Tree>(prefix, "YX", &make_YXordered_rects));            \
+    DEF_BENCH(return new RTreeQueryBench<Tree>(prefix, "random", &make_random_rects));           \
+    DEF_BENCH(return new RTreeQueryBench<Tree>(prefix, "concentric", &make_concentric_rects));   \
+    DEF_BENCH(return new RTreeQueryBench<Tree>(prefix, "scroll", &make_scroll_rects,             \
+                                               NUM_SCROLL_RECTS, SCROLL_HEIGHT));
+
+DEF_RTREE_BENCHES(SkRTree, "rtree")
+DEF_RTREE_BENCHES(SkPackedRTree, "packedrtree")
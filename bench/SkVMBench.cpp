@@ -0,0 +1,99 @@
+/*
+ * Copyright 2021 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "bench/Benchmark.h"
+#include "include/core/SkString.h"
+#include "src/core/SkVM.h"
+
+#include <vector>
+
+extern bool gSkVMAllowAVX512;
+
+// Runs a couple typical blitter inner loops over n pixels, JITted with or without AVX-512,
+// so we can compare the 16-lane and 8-lane x86 code.  Without AVX-512 (or without the JIT)
+// both variants run the same code.
+
+namespace {
+
+    enum class Kind { SrcOver8888, ScaleF16 };
+
+    void build(skvm::Builder* b, Kind kind) {
+        switch (kind) {
+            case Kind::SrcOver8888: {
+                skvm::PixelFormat f = skvm::SkColorType_to_PixelFormat(kRGBA_8888_SkColorType);
+                skvm::Ptr src = b->varying<uint32_t>(),
+                          dst = b->varying<uint32_t>();
+                skvm::Color s = b->load(f, src),
+                            d = b->load(f, dst);
+                skvm::F32 inv = 1.0f - s.a;
+                b->store(f, dst, {s.r + d.r*inv,
+                                  s.g + d.g*inv,
+                                  s.b + d.b*inv,
+                                  s.a + d.a*inv});
+            } break;
+
+            case Kind::ScaleF16: {
+                skvm::PixelFormat f = skvm::SkColorType_to_PixelFormat(kRGBA_F16_SkColorType);
+                skvm::Ptr src = b->varying<uint64_t>(),
+                          dst = b->varying<uint64_t>();
+                skvm::Color c = b->load(f, src);
+                skvm::F32 k = c.a * 0.5f + 0.25f;
+                b->store(f, dst, {c.r*k, c.g*k, c.b*k, c.a});
+            } break;
+        }
+    }
+
+    class SkVMBench : public Benchmark {
+    public:
+        SkVMBench(Kind kind, int n, bool avx512) : fKind(kind), fN(n), fAVX512(avx512) {
+            fName.printf("SkVM_%s_%d_%s", kind == Kind::SrcOver8888 ? "srcover_8888" : "scale_f16",
+                         n, avx512 ? "avx512" : "avx2");
+        }
+
+    private:
+        const char* onGetName() override { return fName.c_str(); }
+
+        bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+
+        void onDelayedSetup() override {
+            skvm::Builder b;
+            build(&b, fKind);
+
+            bool prev = gSkVMAllowAVX512;
+            gSkVMAllowAVX512 = fAVX512;
+            fProgram = b.done();
+            gSkVMAllowAVX512 = prev;
+
+            fSrc.assign(2*fN, 0x80402010);
+            fDst.assign(2*fN, 0xff00ff00);
+        }
+
+        void onDraw(int loops, SkCanvas*) override {
+            while (loops --> 0) {
+                fProgram.eval(fN, fSrc.data(), fDst.data());
+            }
+        }
+
+        Kind                  fKind;
+        int                   fN;
+        bool                  fAVX512;
+        SkString              fName;
+        skvm::Program         fProgram;
+        std::vector<uint32_t> fSrc, fDst;
+    };
+
+}  // namespace
+
+// 1024 pixels measures the main loop; 37 adds a 5-lane tail at either width.
+DEF_BENCH(return new SkVMBench(Kind::SrcOver8888, 1024, false);)
+DEF_BENCH(return new SkVMBench(Kind::SrcOver8888, 1024, true );)
+DEF_BENCH(return new SkVMBench(Kind::SrcOver8888,   37, false);)
+DEF_BENCH(return new SkVMBench(Kind::SrcOver8888,   37, true );)
+DEF_BENCH(return new SkVMBench(Kind::ScaleF16   , 1024, false);)
+DEF_BENCH(return new SkVMBench(Kind::ScaleF16   , 1024, true );)
+DEF_BENCH(return new SkVMBench(Kind::ScaleF16   ,   37, false);)
+DEF_BENCH(return new SkVMBench(Kind::ScaleF16   ,   37, true );)
@@ -25,6 +25,7 @@
 #include "src/core/SkLeanWindows.h"
 #include "src/core/SkMD5.h"
 #include "src/core/SkOSFile.h"
+#include "src/core/SkSurfacePriv.h"
 #include "src/core/SkTaskGroup.h"
 #include "src/utils/SkOSPath.h"
 #include "tests/Test.h"
@@ -989,6 +990,10 @@ static Sink* create_sink(const GrContextOptions& grCtxOptions, const SkCommandLi
         SINK("101010x",     RasterSink, kRGB_101010x_SkColorType);
         SINK("bgra1010102", RasterSink, kBGRA_1010102_SkColorType);
         SINK("bgr101010x",  RasterSink, kBGR_101010x_SkColorType);
+        SINK("sparse8888",  RasterSink, kN32_SkColorType, nullptr,
+                                        kSparseScanlineAA_SkSurfacePropsPrivateFlag);
+        SINK("banded8888",  RasterSink, kN32_SkColorType, nullptr,
+                                        kBandedAnalyticAA_SkSurfacePropsPrivateFlag);
         SINK("pdf",         PDFSink, false, SK_ScalarDefaultRasterDPI);
         SINK("skp",         SKPSink);
         SINK("svg",         SVGSink);
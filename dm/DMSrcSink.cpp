@@ -2090,9 +2090,11 @@ Result SVGSink::draw(const Src& src, SkBitmap*, SkWStream* dst, SkString*) const
 
 /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
 
-RasterSink::RasterSink(SkColorType colorType, sk_sp<SkColorSpace> colorSpace)
+RasterSink::RasterSink(SkColorType colorType, sk_sp<SkColorSpace> colorSpace,
+                       uint32_t surfaceFlags)
     : fColorType(colorType)
-    , fColorSpace(std::move(colorSpace)) {}
+    , fColorSpace(std::move(colorSpace))
+    , fSurfaceFlags(surfaceFlags) {}
 
 Result RasterSink::draw(const Src& src, SkBitmap* dst, SkWStream*, SkString*) const {
     const SkISize size = src.size();
@@ -2103,7 +2105,7 @@ Result RasterSink::draw(const Src& src, SkBitmap* dst, SkWStream*, SkString*) co
     dst->allocPixelsFlags(SkImageInfo::Make(size, fColorType, alphaType, fColorSpace),
                           SkBitmap::kZeroPixels_AllocFlag);
 
-    SkCanvas canvas(*dst, SkSurfaceProps(0, kRGB_H_SkPixelGeometry));
+    SkCanvas canvas(*dst, SkSurfaceProps(fSurfaceFlags, kRGB_H_SkPixelGeometry));
     return src.draw(nullptr, &canvas);
 }
 
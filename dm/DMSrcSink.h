@@ -535,7 +535,7 @@ public:
 
 class RasterSink : public Sink {
 public:
-    explicit RasterSink(SkColorType, sk_sp<SkColorSpace> = nullptr);
+    explicit RasterSink(SkColorType, sk_sp<SkColorSpace> = nullptr, uint32_t surfaceFlags = 0);
 
     Result draw(const Src&, SkBitmap*, SkWStream*, SkString*) const override;
     const char* fileExtension() const override { return "png"; }
@@ -544,6 +544,7 @@ public:
 private:
     SkColorType         fColorType;
     sk_sp<SkColorSpace> fColorSpace;
+    uint32_t            fSurfaceFlags;
 };
 
 class ThreadedSink : public RasterSink {
@@ -27,6 +27,7 @@
 class SkAndroidCodec;
 class SkColorSpace;
 class SkData;
+class SkExecutor;
 class SkFrameHolder;
 class SkImage;
 class SkPngChunkReader;
@@ -289,6 +290,7 @@ public:
             , fSubset(nullptr)
             , fFrameIndex(0)
             , fPriorFrame(kNoFrame)
+            , fExecutor(nullptr)
         {}
 
         ZeroInitialized            fZeroInitialized;
@@ -332,6 +334,18 @@ public:
          *  If set to kNoFrame, the codec will decode any necessary required frame(s) first.
          */
         int                        fPriorFrame;
+
+        /**
+         *  If not NULL, getPixels() may split the decode into independent pieces and run
+         *  them concurrently on this executor.  The result is identical to a decode
+         *  without an executor.  getPixels() does not return until all of the work is done.
+         *
+         *  Currently used by JPEG, for full-size decodes of baseline images that contain
+         *  restart markers, and by PNG, which swizzles and color transforms rows on the
+         *  executor while libpng inflates the next ones.  Ignored by scanline and incremental
+         *  decodes.
+         */
+        SkExecutor*                fExecutor;
     };
 
     /**
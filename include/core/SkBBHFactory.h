@@ -60,4 +60,14 @@ public:
     sk_sp<SkBBoxHierarchy> operator()() const override;
 };
 
+/**
+ *  Creates an R-tree packed along a Hilbert curve into flat arrays. It takes longer to build than
+ *  SkRTreeFactory's tree, but is faster to query for pictures with very many draws, and does not
+ *  depend on draws being recorded in spatial order.
+ */
+class SK_API SkPackedRTreeFactory : public SkBBHFactory {
+public:
+    sk_sp<SkBBoxHierarchy> operator()() const override;
+};
+
 #endif
@@ -2342,6 +2342,7 @@ private:
     friend class SkNoDrawCanvas;    // needs resetForNextPicture()
     friend class SkNWayCanvas;
     friend class SkPictureRecord;   // predrawNotify (why does it need it? <reed>)
+    friend class SkRecorder;        // predrawNotify, so recording surfaces drop stale snapshots
     friend class SkOverdrawCanvas;
     friend class SkRasterHandleAllocator;
 protected:
@@ -22,6 +22,14 @@ public:
     static std::unique_ptr<SkExecutor> MakeLIFOThreadPool(int threads = 0,
                                                           bool allowBorrowing = true);
 
+    // Create a thread pool SkExecutor where each thread has its own deque of work.
+    // Work added from inside a running task stays on that thread's deque; idle threads steal.
+    // This scales better than the FIFO/LIFO pools when tasks spawn many small tasks.
+    // The pool's own threads always borrow(), so SkTaskGroup::wait() inside a task never blocks.
+    // Like the other pools, destroying it first runs all the work still queued.
+    static std::unique_ptr<SkExecutor> MakeWorkStealingThreadPool(int threads = 0,
+                                                                  bool allowBorrowing = true);
+
     // There is always a default SkExecutor available by calling SkExecutor::GetDefault().
     static SkExecutor& GetDefault();
     static void SetDefault(SkExecutor*);  // Does not take ownership.  Not thread safe.
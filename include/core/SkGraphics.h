@@ -103,6 +103,40 @@ public:
     static size_t GetResourceCacheSingleAllocationByteLimit();
     static size_t SetResourceCacheSingleAllocationByteLimit(size_t newLimit);
 
+    /**
+     *  Return the max number of bytes used by the cache of programs compiled to draw with the
+     *  CPU backend.  This cache is shared by all threads, so each program is compiled once.
+     */
+    static size_t GetProgramCacheLimit();
+
+    /**
+     *  Specify the max number of bytes used by the program cache, purging programs as needed to
+     *  meet it.  Returns the previous limit.
+     */
+    static size_t SetProgramCacheLimit(size_t bytes);
+
+    /**
+     *  Return the number of bytes currently used by the program cache.
+     */
+    static size_t GetProgramCacheUsed();
+
+    struct ProgramCacheStats {
+        uint64_t fHits         = 0;  // Lookups that found a program already in the cache.
+        uint64_t fMisses       = 0;  // Lookups that had to compile (or load) a new program.
+        uint64_t fCompileNanos = 0;  // Total time spent compiling those programs.
+    };
+
+    /**
+     *  Return counters describing the program cache's use since the process started.
+     */
+    static ProgramCacheStats GetProgramCacheStats();
+
+    /**
+     *  For debugging purposes, this will attempt to purge the program cache.  It does not change
+     *  the limit or the stats.
+     */
+    static void PurgeProgramCache();
+
     /**
      *  Dumps memory usage of caches using the SkTraceMemoryDump interface. See SkTraceMemoryDump
      *  for usage of this method.
@@ -144,6 +178,33 @@ public:
      *  Call early in main() to allow Skia to use a JIT to accelerate CPU-bound operations.
      */
     static void AllowJIT();
+
+    /**
+     *  Abstract interface for persisting the programs Skia compiles to draw with the CPU backend,
+     *  so a later run of the process can skip compiling them again.  This plays the same role
+     *  for raster drawing as GrContextOptions::PersistentCache plays for the GPU backends.
+     *
+     *  Both methods may be called from any thread, concurrently; implementations must be thread
+     *  safe.  Entries are only valid for the Skia build that stored them.
+     */
+    class SK_API PersistentProgramCache {
+    public:
+        virtual ~PersistentProgramCache() = default;
+
+        /**
+         *  Returns the data for the key if it exists in the cache, otherwise returns null.
+         */
+        virtual sk_sp<SkData> load(const SkData& key) = 0;
+
+        virtual void store(const SkData& key, const SkData& data) = 0;
+    };
+
+    /**
+     *  Set the cache consulted when a CPU program is not already in memory.  Skia does not take
+     *  ownership; the cache must outlive all drawing, or be unset by passing nullptr.
+     *  Not thread safe; call before drawing.
+     */
+    static void SetPersistentProgramCache(PersistentProgramCache*);
 };
 
 class SkAutoGraphics {
@@ -177,6 +177,12 @@ protected:
     virtual bool onQueryYUVAInfo(const SkYUVAPixmapInfo::SupportedDataTypes&,
                                  SkYUVAPixmapInfo*) const { return false; }
     virtual bool onGetYUVAPlanes(const SkYUVAPixmaps&) { return false; }
+    // Returns the size closest to desiredScale * getInfo().dimensions() that onGetPixels() can
+    // produce directly (e.g. by scaling during decode), or the full size if it cannot scale.
+    // Lazy images use this to decode less when they are drawn minified.
+    virtual SkISize onGetScaledDimensions(float /*desiredScale*/) const {
+        return fInfo.dimensions();
+    }
 #if SK_SUPPORT_GPU
     // returns nullptr
     virtual GrSurfaceProxyView onGenerateTexture(GrRecordingContext*, const SkImageInfo&,
@@ -25,6 +25,7 @@
 
 class SkCanvas;
 class SkDeferredDisplayList;
+class SkExecutor;
 class SkPaint;
 class SkSurfaceCharacterization;
 class GrBackendRenderTarget;
@@ -170,6 +171,33 @@ public:
     static sk_sp<SkSurface> MakeRasterN32Premul(int width, int height,
                                                 const SkSurfaceProps* surfaceProps = nullptr);
 
+    /** Allocates raster SkSurface whose SkCanvas records draws instead of rasterizing them
+        immediately. Recorded draws are rasterized in parallel on executor, split into
+        horizontal bands of the surface, when the pixels are next needed: by
+        makeImageSnapshot(), peekPixels(), readPixels(), writePixels(), draw(), or flush().
+        The result matches drawing the same commands into MakeRaster(), except that
+        anti-aliased paths crossing a band boundary may differ slightly in edge coverage.
+
+        Use for very large surfaces where rasterization dominates recording cost.
+        Reading pixels through the SkCanvas itself, as with SkCanvas::readPixels(), is not
+        supported; use the SkSurface methods instead.
+
+        SkSurface is returned if all parameters are valid.
+        Valid parameters include:
+        info dimensions are greater than zero;
+        info contains SkColorType and SkAlphaType supported by raster surface.
+
+        @param imageInfo     width, height, SkColorType, SkAlphaType, SkColorSpace,
+                             of raster surface; width and height must be greater than zero
+        @param executor      runs the rasterization tasks; if nullptr, uses
+                             SkExecutor::GetDefault()
+        @param surfaceProps  LCD striping orientation and setting for device independent fonts;
+                             may be nullptr
+        @return              SkSurface if all parameters are valid; otherwise, nullptr
+    */
+    static sk_sp<SkSurface> MakeRasterThreaded(const SkImageInfo& imageInfo, SkExecutor* executor,
+                                               const SkSurfaceProps* surfaceProps = nullptr);
+
     /** Caller data passed to RenderTarget/TextureReleaseProc; may be nullptr. */
     typedef void* ReleaseContext;
 
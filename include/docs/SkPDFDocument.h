@@ -196,7 +196,9 @@ struct Metadata {
     /** Executor to handle threaded work within PDF Backend. If this is nullptr,
         then all work will be done serially on the main thread. To have worker
         threads assist with various tasks, set this to a valid SkExecutor
-        instance. Currently used for executing Deflate algorithm in parallel.
+        instance. Currently used for drawing pages and executing the Deflate
+        algorithm in parallel: each page's canvas records its draws, which are
+        played back into the page's content on the executor once the page ends.
 
         If set, the PDF output will be non-reproducible in the order and
         internal numbering of objects, but should render the same.
@@ -215,6 +217,62 @@ struct Metadata {
         kHarfbuzz_Subsetter,
         kSfntly_Subsetter,
     } fSubsetter = kHarfbuzz_Subsetter;
+
+    /** Deflate compression levels, trading output size for speed.  None
+        leaves streams uncompressed where the format allows it.
+    */
+    enum class CompressionLevel : int {
+        Default = -1,
+        None = 0,
+        LowButFast = 1,
+        Average = 6,
+        HighButSlow = 9,
+    };
+
+    /** Compression level for page contents and all other streams not
+        covered by the settings below.
+    */
+    CompressionLevel fCompressionLevel = CompressionLevel::Default;
+
+    /** Compression level for losslessly encoded images.  Large images
+        are usually most of the time spent compressing a document, so
+        LowButFast here often pays off even where the other streams are
+        kept at Default.
+    */
+    CompressionLevel fImageCompressionLevel = CompressionLevel::Default;
+
+    /** Compression level for embedded font programs.
+    */
+    CompressionLevel fFontCompressionLevel = CompressionLevel::Default;
+
+    /** How deflate searches for matches; see zlib's deflateInit2().  RLE
+        only looks for runs of a repeated byte and HuffmanOnly does no
+        matching at all; both are much faster than Default, but compress
+        anything except very repetitive data less well.
+    */
+    enum class CompressionStrategy : int {
+        Default,
+        Filtered,
+        RLE,
+        HuffmanOnly,
+    };
+
+    /** Compression strategies for the same three kinds of stream as the
+        levels above.
+    */
+    CompressionStrategy fCompressionStrategy = CompressionStrategy::Default;
+    CompressionStrategy fImageCompressionStrategy = CompressionStrategy::Default;
+    CompressionStrategy fFontCompressionStrategy = CompressionStrategy::Default;
+
+    /** If true, encoded images and subsetted fonts are kept in Skia's global
+        resource cache, and reused by later documents that also set this.
+        Drawing the same SkImage at the same fEncodingQuality does not encode
+        it again, and embedding the same glyphs of a typeface does not subset
+        its font again.  The entries count against the cache's byte budget
+        (see SkGraphics::SetResourceCacheTotalByteLimit()) and are purged
+        least recently used first.
+    */
+    bool fCacheAcrossDocuments = false;
 };
 
 /** Associate a node ID with subsequent drawing commands in an
@@ -11,6 +11,7 @@
 #include "include/core/SkData.h"
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkMatrix.h"
+#include "include/core/SkPaint.h"
 #include "include/core/SkShader.h"
 #include "include/core/SkString.h"
 #include "include/private/SkOnce.h"
@@ -21,6 +22,7 @@
 class GrFragmentProcessor;
 class GrRecordingContext;
 class SkColorFilter;
+class SkExecutor;
 class SkFilterColorProgram;
 class SkImage;
 class SkShader;
@@ -153,6 +155,29 @@ public:
 
     const SkString& source() const { return fSkSL; }
 
+    // One way a runtime effect will be drawn on the CPU backend: with this paint (normally holding
+    // a shader or color filter made by makeShader() or makeColorFilter(), with representative
+    // children), under this transform, into a destination with this color type, alpha type, and
+    // color space.  Uniform values, the transform's exact values, and info's size don't matter,
+    // only the structure they imply.
+    struct PrecompileTarget {
+        SkPaint     paint;
+        SkImageInfo info;
+        SkMatrix    ctm = SkMatrix::I();
+    };
+
+    // Compiles and caches the CPU backend programs that the first aliased and anti-aliased draws
+    // with each target would otherwise build, so that first draw runs at full speed.
+    //
+    // With an executor, the work is queued there and Precompile() returns immediately.  A draw
+    // that needs a program still being compiled waits for it instead of compiling it again.
+    // Without an executor, the work is done before returning.
+    //
+    // GPU programs depend on the context and render target, so they are not built here; see
+    // GrContextOptions::fPersistentCache and GrDirectContext::precompileShader().
+    static void Precompile(const PrecompileTarget targets[], size_t count,
+                           SkExecutor* executor = nullptr);
+
     template <typename T>
     class ConstIterable {
     public:
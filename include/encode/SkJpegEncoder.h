@@ -10,6 +10,8 @@
 
 #include "include/encode/SkEncoder.h"
 
+#include <functional>
+
 class SkJpegEncoderMgr;
 class SkWStream;
 
@@ -61,6 +63,16 @@ public:
          *  In the second case, the encoder supports linear or legacy blending.
          */
         AlphaOption fAlphaOption = AlphaOption::kIgnore;
+
+        /**
+         *  If positive, a restart marker is written after every |fRestartRows| rows of MCUs
+         *  (8 or 16 pixel rows each, depending on |fDownsample|).  This makes the file slightly
+         *  larger, but lets decoders that support it, such as SkCodec with
+         *  SkCodec::Options::fExecutor set, decode horizontal stripes of the image in parallel.
+         *
+         *  The default is to write no restart markers.
+         */
+        int fRestartRows = 0;
     };
 
     /**
@@ -82,6 +94,28 @@ public:
     static std::unique_ptr<SkEncoder> Make(SkWStream* dst, const SkPixmap& src,
                                            const Options& options);
 
+    /**
+     *  Fills |rows| with the |rows.height()| rows of the image that start at row |y|.
+     *  Returns false to stop the encode.
+     */
+    using RowSource = std::function<bool(int y, const SkPixmap& rows)>;
+
+    /**
+     *  Encode an image described by |info| to the |dst| stream, pulling its pixels from
+     *  |rows| from top to bottom, a strip of at most 16 rows at a time, instead of reading
+     *  them from a single SkPixmap.  Memory use is bounded by a few strips however tall the
+     *  image is.  For example, to transcode, |rows| may call SkCodec::getScanlines() after
+     *  SkCodec::startScanlineDecode().
+     *
+     *  Unlike the Encode() above, this does not compute optimal Huffman tables for the image,
+     *  since that requires holding all of it, so the output is slightly larger.
+     *
+     *  Returns true on success.  Returns false on an invalid or unsupported |info|, or if
+     *  |rows| returns false.
+     */
+    static bool Encode(SkWStream* dst, const SkImageInfo& info, const RowSource& rows,
+                       const Options& options);
+
     ~SkJpegEncoder() override;
 
 protected:
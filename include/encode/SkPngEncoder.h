@@ -11,6 +11,7 @@
 #include "include/core/SkDataTable.h"
 #include "include/encode/SkEncoder.h"
 
+class SkExecutor;
 class SkPngEncoderMgr;
 class SkWStream;
 
@@ -59,6 +60,18 @@ public:
          *  and the (2i + 1)-th entry is the text for the i-th comment.
          */
         sk_sp<SkDataTable> fComments;
+
+        /**
+         *  If set, rows are filtered and compressed in independent chunks in parallel on this
+         *  executor, pigz-style: each chunk is deflated with the 32KB before it as a dictionary
+         *  and ends in a sync flush, so together they still form one standard zlib stream.
+         *  Files are typically a little larger than a serial encode at the same fZLibLevel.
+         *
+         *  Opaque kRGBA_F16 sources are always encoded serially.
+         *
+         *  The executor is unowned and must remain valid for the lifetime of the encoder.
+         */
+        SkExecutor* fExecutor = nullptr;
     };
 
     /**
@@ -11,6 +11,7 @@
 #include "include/private/SkTArray.h"
 #include "include/private/SkTDArray.h"
 
+class SkExecutor;
 class SkPath;
 struct SkRect;
 
@@ -101,6 +102,20 @@ public:
       */
     bool resolve(SkPath* result);
 
+    /** Like resolve(), but when every operand is a union, groups nearby paths by their bounds
+        and unions each group on executor, or on SkExecutor::GetDefault() if it is null.
+        Unions of groups whose paths' bounds intersect are then merged pairwise, also in
+        parallel, and the rest concatenated.
+        The result depends on the paths, not on how many threads the executor has, but may
+        have different contours than resolve()'s.
+        Falls back to resolve() when any operand is not a union, or is inverse filled.
+
+        @param result   The union of the operands.
+        @param executor Runs the groups' unions and merges; null for the default executor.
+        @return True if the operation succeeded.
+      */
+    bool resolveInParallel(SkPath* result, SkExecutor* executor = nullptr);
+
 private:
     SkTArray<SkPath> fPathRefs;
     SkTDArray<SkPathOp> fOps;
@@ -6,6 +6,7 @@
  */
 #include "include/private/SkMalloc.h"
 #include "src/codec/SkBmpBaseCodec.h"
+#include "src/codec/SkCodecPriv.h"
 
 SkBmpBaseCodec::~SkBmpBaseCodec() {}
 
@@ -14,3 +15,13 @@ SkBmpBaseCodec::SkBmpBaseCodec(SkEncodedInfo&& info, std::unique_ptr<SkStream> s
     : INHERITED(std::move(info), std::move(stream), bitsPerPixel, rowOrder)
     , fSrcBuffer(sk_malloc_canfail(this->srcRowBytes()))
 {}
+
+const uint8_t* SkBmpBaseCodec::readSrcRow(size_t* bytesRead) {
+    size_t alignment = 1;
+    switch (this->bitsPerPixel()) {
+        case 16: alignment = 2; break;
+        case 32: alignment = 4; break;
+    }
+    return read_in_place(this->stream(), this->srcBuffer(), this->srcRowBytes(), bytesRead,
+                         alignment);
+}
@@ -30,6 +30,14 @@ protected:
 
     uint8_t* srcBuffer() { return reinterpret_cast<uint8_t*>(fSrcBuffer.get()); }
 
+    /*
+     * Reads the next srcRowBytes() of encoded pixels, setting bytesRead.
+     *
+     * The swizzlers read 16- and 32-bit pixels through uint16_t and uint32_t pointers, so the
+     * row is read in place only if it is aligned for that; otherwise it is copied to srcBuffer().
+     */
+    const uint8_t* readSrcRow(size_t* bytesRead);
+
 private:
     SkAutoFree fSrcBuffer;
 
@@ -103,6 +103,10 @@ protected:
 
     bool onGetYUVAPlanes(const SkYUVAPixmaps& yuvaPixmaps) override;
 
+    SkISize onGetScaledDimensions(float desiredScale) const override {
+        return this->getScaledDimensions(desiredScale);
+    }
+
 private:
     /*
      * Takes ownership of codec
@@ -10,11 +10,14 @@
 
 #include "include/codec/SkEncodedOrigin.h"
 #include "include/core/SkImageInfo.h"
+#include "include/core/SkStream.h"
 #include "include/core/SkTypes.h"
 #include "include/private/SkColorData.h"
 #include "include/private/SkEncodedInfo.h"
 #include "src/codec/SkColorTable.h"
 
+#include <algorithm>
+
 #ifdef SK_PRINT_CODEC_MESSAGES
     #define SkCodecPrintf SkDebugf
 #else
@@ -108,6 +111,29 @@ static inline const SkPMColor* get_color_ptr(SkColorTable* colorTable) {
      return nullptr != colorTable ? colorTable->readColors() : nullptr;
 }
 
+/*
+ * Reads up to size bytes from stream, returning a pointer to them and setting bytesRead.
+ * A stream backed by memory (e.g. an SkMemoryStream over an mmap'd SkData) is read in place:
+ * the result points into that memory and nothing is copied, as long as it is aligned to
+ * alignment bytes.  Otherwise the bytes are read into buffer, which must hold size bytes and be
+ * suitably aligned itself.  Either way the stream advances by bytesRead.
+ */
+static inline const uint8_t* read_in_place(SkStream* stream, void* buffer, size_t size,
+                                           size_t* bytesRead, size_t alignment = 1) {
+    const void* memoryBase = stream->getMemoryBase();
+    if (memoryBase && stream->hasPosition() && stream->hasLength()) {
+        const size_t position = stream->getPosition();
+        const size_t length = stream->getLength();
+        const uint8_t* inPlace = static_cast<const uint8_t*>(memoryBase) + position;
+        if (reinterpret_cast<uintptr_t>(inPlace) % alignment == 0) {
+            *bytesRead = stream->skip(position < length ? std::min(size, length - position) : 0);
+            return inPlace;
+        }
+    }
+    *bytesRead = stream->read(buffer, size);
+    return static_cast<const uint8_t*>(buffer);
+}
+
 /*
  * Compute row bytes for an image using pixels per byte
  */
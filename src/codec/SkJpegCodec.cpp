@@ -8,6 +8,8 @@
 #include "src/codec/SkJpegCodec.h"
 
 #include "include/codec/SkCodec.h"
+#include "include/core/SkData.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkStream.h"
 #include "include/core/SkTypes.h"
 #include "include/private/SkColorData.h"
@@ -16,8 +18,13 @@
 #include "src/codec/SkCodecPriv.h"
 #include "src/codec/SkJpegDecoderMgr.h"
 #include "src/codec/SkParseEncodedOrigin.h"
+#include "src/core/SkTaskGroup.h"
 #include "src/pdf/SkJpegInfo.h"
 
+#include <atomic>
+#include <numeric>
+#include <vector>
+
 // stdio is needed for libjpeg-turbo
 #include <stdio.h>
 #include "src/codec/SkJpegUtility.h"
@@ -519,6 +526,198 @@ static inline bool needs_swizzler_to_convert_from_cmyk(J_COLOR_SPACE jpegColorTy
     return !hasCMYKColorSpace || !hasColorSpaceXform;
 }
 
+// Stripes decoded in parallel cover at least this many pixels, so that the per-stripe setup
+// (parsing the header, building the color transform) and the overlap stay small in comparison.
+static constexpr int kMinStripePixels = 1 << 20;
+
+namespace {
+
+// Where the pieces of a single-scan JPEG live in its encoded data.
+struct JpegScanLayout {
+    size_t              fHeightOffset;  // Offset of the frame height in the SOF segment.
+    size_t              fScanStart;     // First byte of entropy-coded data.
+    size_t              fScanEnd;       // Offset of the EOI marker that ends the scan.
+    std::vector<size_t> fRestarts;      // Offset of each RSTn marker in the scan, in order.
+};
+
+}  // namespace
+
+/*
+ * Finds the frame header and every restart marker of a baseline JPEG whose header (through the
+ * SOS segment) occupies [0, scanStart).  Returns false if the scan is not followed by EOI.
+ */
+static bool find_restart_markers(const uint8_t* data, size_t length, size_t scanStart,
+                                 JpegScanLayout* layout) {
+    layout->fHeightOffset = 0;
+    size_t i = 2;  // Skip SOI.
+    while (i + 4 <= scanStart) {
+        if (data[i] != 0xFF) {
+            return false;
+        }
+        const uint8_t marker = data[i + 1];
+        if (marker == 0xFF) {
+            i++;  // Fill byte.
+            continue;
+        }
+        if (marker == 0xC0 || marker == 0xC1) {
+            // SOF0/SOF1: FF Cn, length (2), precision (1), height (2), ...
+            layout->fHeightOffset = i + 5;
+        }
+        i += 2 + ((data[i + 2] << 8) | data[i + 3]);
+    }
+    if (layout->fHeightOffset == 0 || layout->fHeightOffset + 2 > scanStart) {
+        return false;
+    }
+
+    // Any 0xFF in entropy-coded data is either stuffed (FF 00), fill (FF FF), or a marker.
+    layout->fScanStart = scanStart;
+    layout->fRestarts.clear();
+    i = scanStart;
+    while (i + 1 < length) {
+        const void* ff = memchr(data + i, 0xFF, length - 1 - i);
+        if (!ff) {
+            return false;
+        }
+        i = static_cast<const uint8_t*>(ff) - data;
+        const uint8_t marker = data[i + 1];
+        if (marker == 0x00) {
+            i += 2;
+        } else if (marker == 0xFF) {
+            i += 1;
+        } else if (marker >= JPEG_RST0 && marker <= JPEG_RST0 + 7) {
+            layout->fRestarts.push_back(i);
+            i += 2;
+        } else {
+            layout->fScanEnd = i;
+            return marker == JPEG_EOI;
+        }
+    }
+    return false;
+}
+
+bool SkJpegCodec::decodeStripesInParallel(const SkImageInfo& dstInfo, void* dst, size_t rowBytes,
+                                          const Options& options) {
+    jpeg_decompress_struct* dinfo = fDecoderMgr->dinfo();
+    if (dstInfo.dimensions() != this->dimensions() || dinfo->progressive_mode ||
+        dinfo->arith_code || dinfo->restart_interval == 0 ||
+        dinfo->comps_in_scan != dinfo->num_components) {
+        return false;
+    }
+
+    // We need the whole file in memory, and skjpeg_source_mgr reads it in place, so the source
+    // now points just past the SOS segment.
+    SkStream* stream = this->stream();
+    const uint8_t* data = static_cast<const uint8_t*>(stream->getMemoryBase());
+    if (!data || !stream->hasLength()) {
+        return false;
+    }
+    const size_t length = stream->getLength();
+    const uint8_t* scanStart = dinfo->src->next_input_byte;
+    if (scanStart < data || scanStart > data + length) {
+        return false;
+    }
+
+    // In an interleaved scan each MCU covers max_h_samp_factor x max_v_samp_factor blocks of
+    // the image.  A single component scan codes one block per MCU.
+    const int mcuWidth = dinfo->num_components > 1 ? DCTSIZE * dinfo->max_h_samp_factor
+                                                   : DCTSIZE;
+    const int mcuHeight = dinfo->num_components > 1 ? DCTSIZE * dinfo->max_v_samp_factor
+                                                    : DCTSIZE;
+    const int width = this->dimensions().width();
+    const int height = this->dimensions().height();
+    const int mcusPerRow = (width + mcuWidth - 1) / mcuWidth;
+    const int mcuRows = (height + mcuHeight - 1) / mcuHeight;
+    const int interval = dinfo->restart_interval;
+
+    // A stripe must start on a restart marker that is also the start of an MCU row.
+    const int rowsPerGroup = interval / std::gcd(interval, mcusPerRow);
+    const int groups = (mcuRows + rowsPerGroup - 1) / rowsPerGroup;
+    const int maxStripes = SkToInt((int64_t)width * height / kMinStripePixels);
+    const int stripes = std::min(groups, maxStripes);
+    if (stripes < 2) {
+        return false;
+    }
+
+    JpegScanLayout layout;
+    if (!find_restart_markers(data, length, scanStart - data, &layout)) {
+        return false;
+    }
+    const int64_t totalMCUs = (int64_t)mcusPerRow * mcuRows;
+    if ((int64_t)layout.fRestarts.size() != (totalMCUs - 1) / interval) {
+        return false;
+    }
+
+    // Vertically upsampled chroma is interpolated from the rows above and below, so each stripe
+    // also decodes one group of MCU rows on either side of the rows it keeps.
+    bool needsContext = false;
+    for (int i = 0; i < dinfo->num_components; i++) {
+        needsContext |= dinfo->comp_info[i].v_samp_factor < dinfo->max_v_samp_factor;
+    }
+    const int overlap = needsContext ? rowsPerGroup : 0;
+
+    const int rowsPerStripe = (groups + stripes - 1) / stripes * rowsPerGroup;
+    const int stripeCount = (mcuRows + rowsPerStripe - 1) / rowsPerStripe;
+
+    // Each stripe falls back on our color profile, just as we may have fallen back on a default.
+    const skcms_ICCProfile* srcProfile = this->getEncodedInfo().profile();
+    std::atomic<bool> succeeded{true};
+    SkTaskGroup(*options.fExecutor).batch(stripeCount, [&](int s) {
+        const int keepTop = s * rowsPerStripe;
+        const int keepBottom = std::min(mcuRows, keepTop + rowsPerStripe);
+        const int decodeTop = std::max(0, keepTop - overlap);
+        const int decodeBottom = std::min(mcuRows, keepBottom + overlap);
+
+        // Build a standalone JPEG from the original header, with the frame height patched, and
+        // the restart intervals that make up [decodeTop, decodeBottom).  libjpeg-turbo expects
+        // restart markers to count up from RST0, so renumber them.
+        const int firstInterval = SkToInt((int64_t)decodeTop * mcusPerRow / interval);
+        const int endInterval = SkToInt((decodeBottom * (int64_t)mcusPerRow + interval - 1) /
+                                        interval);
+        const size_t begin = firstInterval == 0 ? layout.fScanStart
+                                                : layout.fRestarts[firstInterval - 1] + 2;
+        const size_t end = decodeBottom == mcuRows ? layout.fScanEnd
+                                                   : layout.fRestarts[endInterval - 1];
+        const int pixelTop = decodeTop * mcuHeight;
+        const int pixelHeight = std::min(height, decodeBottom * mcuHeight) - pixelTop;
+
+        sk_sp<SkData> stripeData =
+                SkData::MakeUninitialized(layout.fScanStart + (end - begin) + 2);
+        uint8_t* ptr = static_cast<uint8_t*>(stripeData->writable_data());
+        memcpy(ptr, data, layout.fScanStart);
+        ptr[layout.fHeightOffset + 0] = (uint8_t)(pixelHeight >> 8);
+        ptr[layout.fHeightOffset + 1] = (uint8_t)(pixelHeight >> 0);
+        ptr += layout.fScanStart;
+        memcpy(ptr, data + begin, end - begin);
+        for (int r = firstInterval; r < endInterval - 1; r++) {
+            ptr[layout.fRestarts[r] + 1 - begin] =
+                    (uint8_t)(JPEG_RST0 + ((r - firstInterval) & 7));
+        }
+        ptr += end - begin;
+        ptr[0] = 0xFF;
+        ptr[1] = JPEG_EOI;
+
+        Result result;
+        std::unique_ptr<SkCodec> codec = SkJpegCodec::MakeFromStream(
+                std::make_unique<SkMemoryStream>(std::move(stripeData)), &result,
+                srcProfile ? SkEncodedInfo::ICCProfile::Make(*srcProfile) : nullptr);
+        if (!codec || codec->dimensions() != SkISize::Make(width, pixelHeight)) {
+            succeeded = false;
+            return;
+        }
+
+        const int keepPixelTop = keepTop * mcuHeight;
+        const int keepPixelBottom = std::min(height, keepBottom * mcuHeight);
+        const int keepPixelHeight = keepPixelBottom - keepPixelTop;
+        void* stripeDst = SkTAddOffset<void>(dst, rowBytes * keepPixelTop);
+        if (kSuccess != codec->startScanlineDecode(dstInfo.makeWH(width, pixelHeight)) ||
+            !codec->skipScanlines(keepPixelTop - pixelTop) ||
+            keepPixelHeight != codec->getScanlines(stripeDst, keepPixelHeight, rowBytes)) {
+            succeeded = false;
+        }
+    });
+    return succeeded;
+}
+
 /*
  * Performs the jpeg decode
  */
@@ -531,6 +730,10 @@ SkCodec::Result SkJpegCodec::onGetPixels(const SkImageInfo& dstInfo,
         return kUnimplemented;
     }
 
+    if (options.fExecutor && this->decodeStripesInParallel(dstInfo, dst, dstRowBytes, options)) {
+        return kSuccess;
+    }
+
     // Get a pointer to the decompress info since we will use it quite frequently
     jpeg_decompress_struct* dinfo = fDecoderMgr->dinfo();
 
@@ -109,6 +109,14 @@ private:
     bool SK_WARN_UNUSED_RESULT allocateStorage(const SkImageInfo& dstInfo);
     int readRows(const SkImageInfo& dstInfo, void* dst, size_t rowBytes, int count, const Options&);
 
+    /*
+     * Decodes horizontal stripes of the image concurrently on options.fExecutor, splitting the
+     * entropy-coded data at restart markers.  Returns false without decoding if the image is not
+     * eligible, or if any stripe fails, in which case the caller should decode serially.
+     */
+    bool decodeStripesInParallel(const SkImageInfo& dstInfo, void* dst, size_t rowBytes,
+                                 const Options& options);
+
     /*
      * Scanline decoding.
      */
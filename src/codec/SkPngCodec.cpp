@@ -14,16 +14,21 @@
 #include "include/private/SkColorData.h"
 #include "include/private/SkMacros.h"
 #include "include/private/SkTemplates.h"
+#include "include/private/SkTo.h"
 #include "src/codec/SkCodecPriv.h"
 #include "src/codec/SkColorTable.h"
 #include "src/codec/SkPngCodec.h"
 #include "src/codec/SkPngPriv.h"
 #include "src/codec/SkSwizzler.h"
+#include "src/core/SkAutoMalloc.h"
 #include "src/core/SkOpts.h"
+#include "src/core/SkTaskGroup.h"
 #include "src/core/SkUtils.h"
 
 #include "png.h"
 #include <algorithm>
+#include <atomic>
+#include <memory>
 
 #ifdef SK_BUILD_FOR_ANDROID_FRAMEWORK
     #include "include/android/SkAndroidFrameworkUtils.h"
@@ -136,8 +141,10 @@ static inline bool process_data(png_structp png_ptr, png_infop info_ptr,
         SkStream* stream, void* buffer, size_t bufferSize, size_t length) {
     while (length > 0) {
         const size_t bytesToProcess = std::min(bufferSize, length);
-        const size_t bytesRead = stream->read(buffer, bytesToProcess);
-        png_process_data(png_ptr, info_ptr, (png_bytep) buffer, bytesRead);
+        size_t bytesRead;
+        // libpng only reads from this, so it is safe to pass it memory-mapped input directly.
+        const uint8_t* data = read_in_place(stream, buffer, bytesToProcess, &bytesRead);
+        png_process_data(png_ptr, info_ptr, const_cast<png_bytep>(data), bytesRead);
         if (bytesRead < bytesToProcess) {
             return false;
         }
@@ -432,6 +439,7 @@ std::unique_ptr<SkEncodedInfo::ICCProfile> read_color_profile(png_structp png_pt
 void SkPngCodec::allocateStorage(const SkImageInfo& dstInfo) {
     switch (fXformMode) {
         case kSwizzleOnly_XformMode:
+            fColorXformSrcRowBytes = 0;
             break;
         case kColorOnly_XformMode:
             // Intentional fall through.  A swizzler hasn't been created yet, but one will
@@ -446,6 +454,7 @@ void SkPngCodec::allocateStorage(const SkImageInfo& dstInfo) {
             const size_t colorXformBytes = dstInfo.width() * bytesPerPixel;
             fStorage.reset(colorXformBytes);
             fColorXformSrcRow = fStorage.get();
+            fColorXformSrcRowBytes = colorXformBytes;
             break;
         }
     }
@@ -467,6 +476,10 @@ static skcms_PixelFormat png_select_xform_format(const SkEncodedInfo& info) {
 }
 
 void SkPngCodec::applyXformRow(void* dst, const void* src) {
+    this->applyXformRow(dst, src, fColorXformSrcRow);
+}
+
+void SkPngCodec::applyXformRow(void* dst, const void* src, void* colorXformSrcRow) {
     switch (fXformMode) {
         case kSwizzleOnly_XformMode:
             fSwizzler->swizzle(dst, (const uint8_t*) src);
@@ -475,8 +488,8 @@ void SkPngCodec::applyXformRow(void* dst, const void* src) {
             this->applyColorXform(dst, src, fXformWidth);
             break;
         case kSwizzleColor_XformMode:
-            fSwizzler->swizzle(fColorXformSrcRow, (const uint8_t*) src);
-            this->applyColorXform(dst, fColorXformSrcRow, fXformWidth);
+            fSwizzler->swizzle(colorXformSrcRow, (const uint8_t*) src);
+            this->applyColorXform(dst, colorXformSrcRow, fXformWidth);
             break;
     }
 }
@@ -499,6 +512,11 @@ public:
         , fRowBytes(0)
         , fFirstRow(0)
         , fLastRow(0)
+        , fTaskGroup(nullptr)
+        , fPngRowBytes(0)
+        , fBatchRows(0)
+        , fRowsInBatch(0)
+        , fBatchCount(0)
     {}
 
     static void AllRowsCallback(png_structp png_ptr, png_bytep row, png_uint_32 rowNum, int /*pass*/) {
@@ -509,7 +527,19 @@ public:
         GetDecoder(png_ptr)->rowCallback(row, rowNum);
     }
 
+    static void PipelinedRowCallback(png_structp png_ptr, png_bytep row, png_uint_32 rowNum,
+                                     int /*pass*/) {
+        GetDecoder(png_ptr)->pipelinedRowCallback(row, rowNum);
+    }
+
 private:
+    // With an executor, decodeAllRows() runs libpng (inflating and unfiltering) on the calling
+    // thread, copying finished rows into batches of about kBatchBytes.  Each batch is then
+    // swizzled and color transformed into the dst on the executor while libpng carries on.
+    // kBatchSlots batches may be in flight at once.
+    static constexpr size_t kBatchBytes = 64 * 1024;
+    static constexpr int    kBatchSlots = 8;
+
     int                         fRowsWrittenToOutput;
     void*                       fDst;
     size_t                      fRowBytes;
@@ -519,6 +549,15 @@ private:
     int                         fLastRow;
     int                         fRowsNeeded;
 
+    // Variables for pipelined decode
+    SkTaskGroup*                fTaskGroup;
+    SkAutoTMalloc<png_byte>     fBatchStorage;
+    std::atomic<bool>           fBatchSlotBusy[kBatchSlots];
+    size_t                      fPngRowBytes;
+    int                         fBatchRows;
+    int                         fRowsInBatch;
+    int                         fBatchCount;
+
     using INHERITED = SkPngCodec;
 
     static SkPngNormalDecoder* GetDecoder(png_structp png_ptr) {
@@ -527,7 +566,6 @@ private:
 
     Result decodeAllRows(void* dst, size_t rowBytes, int* rowsDecoded) override {
         const int height = this->dimensions().height();
-        png_set_progressive_read_fn(this->png_ptr(), this, nullptr, AllRowsCallback, nullptr);
         fDst = dst;
         fRowBytes = rowBytes;
 
@@ -535,7 +573,32 @@ private:
         fFirstRow = 0;
         fLastRow = height - 1;
 
+        // Only pipeline when there are enough rows to keep both sides busy.
+        fPngRowBytes = png_get_rowbytes(this->png_ptr(), this->info_ptr());
+        fBatchRows = std::max(1, SkToInt(kBatchBytes / fPngRowBytes));
+        std::unique_ptr<SkTaskGroup> taskGroup;
+        if (this->executor() && height >= 2 * fBatchRows) {
+            taskGroup = std::make_unique<SkTaskGroup>(*this->executor());
+            fTaskGroup = taskGroup.get();
+            fBatchStorage.reset(kBatchSlots * fBatchRows * fPngRowBytes);
+            for (std::atomic<bool>& busy : fBatchSlotBusy) {
+                busy = false;
+            }
+            fRowsInBatch = 0;
+            fBatchCount = 0;
+            png_set_progressive_read_fn(this->png_ptr(), this, nullptr, PipelinedRowCallback,
+                                        nullptr);
+        } else {
+            png_set_progressive_read_fn(this->png_ptr(), this, nullptr, AllRowsCallback, nullptr);
+        }
+
         const bool success = this->processData();
+        if (taskGroup) {
+            // Finish any partial batch, even after an error, so that rowsDecoded is accurate.
+            this->submitBatch();
+            taskGroup->wait();
+            fTaskGroup = nullptr;
+        }
         if (success && fRowsWrittenToOutput == height) {
             return kSuccess;
         }
@@ -554,6 +617,47 @@ private:
         fDst = SkTAddOffset<void>(fDst, fRowBytes);
     }
 
+    void pipelinedRowCallback(png_bytep row, int rowNum) {
+        SkASSERT(rowNum == fRowsWrittenToOutput);
+        const int slot = fBatchCount % kBatchSlots;
+        if (0 == fRowsInBatch && fBatchSlotBusy[slot]) {
+            // The executor has fallen behind.  Help it catch up, which also frees this slot.
+            fTaskGroup->wait();
+        }
+
+        const size_t batchRow = slot * fBatchRows + fRowsInBatch;
+        memcpy(fBatchStorage.get() + batchRow * fPngRowBytes, row, fPngRowBytes);
+        fRowsWrittenToOutput++;
+        if (++fRowsInBatch == fBatchRows) {
+            this->submitBatch();
+        }
+    }
+
+    void submitBatch() {
+        if (0 == fRowsInBatch) {
+            return;
+        }
+
+        const int slot = fBatchCount % kBatchSlots;
+        const png_byte* src = fBatchStorage.get() + slot * fBatchRows * fPngRowBytes;
+        void* dst = fDst;
+        const int count = fRowsInBatch;
+        fBatchSlotBusy[slot] = true;
+        fTaskGroup->add([this, slot, src, dst, count] {
+            // Each batch needs its own scratch row, since batches run concurrently.
+            SkAutoMalloc colorXformSrcRow(this->colorXformSrcRowBytes());
+            for (int i = 0; i < count; i++) {
+                this->applyXformRow(SkTAddOffset<void>(dst, i * fRowBytes),
+                                    src + i * fPngRowBytes, colorXformSrcRow.get());
+            }
+            fBatchSlotBusy[slot] = false;
+        });
+
+        fDst = SkTAddOffset<void>(fDst, count * fRowBytes);
+        fRowsInBatch = 0;
+        fBatchCount++;
+    }
+
     void setRange(int firstRow, int lastRow, void* dst, size_t rowBytes) override {
         png_set_progressive_read_fn(this->png_ptr(), this, nullptr, RowCallback, nullptr);
         fFirstRow = firstRow;
@@ -625,6 +729,9 @@ public:
     }
 
 private:
+    // With an executor, decodeAllRows() transforms rows in bands of about this many bytes.
+    static constexpr size_t kParallelXformBytes = 64 * 1024;
+
     const int               fNumberPasses;
     int                     fFirstRow;
     int                     fLastRow;
@@ -682,12 +789,26 @@ private:
         fLinesDecoded = 0;
 
         const bool success = this->processData();
-        png_bytep srcRow = fInterlaceBuffer.get();
-        // FIXME: When resuming, this may rewrite rows that did not change.
-        for (int rowNum = 0; rowNum < fLinesDecoded; rowNum++) {
-            this->applyXformRow(dst, srcRow);
-            dst = SkTAddOffset<void>(dst, rowBytes);
-            srcRow = SkTAddOffset<png_byte>(srcRow, fPng_rowbytes);
+        if (this->executor()) {
+            // Every row is in fInterlaceBuffer by now, so transform bands of them in parallel.
+            const int grain = std::max(1, SkToInt(kParallelXformBytes / fPng_rowbytes));
+            SkTaskGroup(*this->executor()).parallel_for(0, fLinesDecoded, grain,
+                                                        [&](int begin, int end) {
+                SkAutoMalloc colorXformSrcRow(this->colorXformSrcRowBytes());
+                for (int rowNum = begin; rowNum < end; rowNum++) {
+                    this->applyXformRow(SkTAddOffset<void>(dst, rowNum * rowBytes),
+                                        fInterlaceBuffer.get() + rowNum * fPng_rowbytes,
+                                        colorXformSrcRow.get());
+                }
+            });
+        } else {
+            png_bytep srcRow = fInterlaceBuffer.get();
+            // FIXME: When resuming, this may rewrite rows that did not change.
+            for (int rowNum = 0; rowNum < fLinesDecoded; rowNum++) {
+                this->applyXformRow(dst, srcRow);
+                dst = SkTAddOffset<void>(dst, rowBytes);
+                srcRow = SkTAddOffset<png_byte>(srcRow, fPng_rowbytes);
+            }
         }
         if (success && fInterlacedComplete) {
             return kSuccess;
@@ -975,6 +1096,8 @@ SkPngCodec::SkPngCodec(SkEncodedInfo&& encodedInfo, std::unique_ptr<SkStream> st
     , fPng_ptr(png_ptr)
     , fInfo_ptr(info_ptr)
     , fColorXformSrcRow(nullptr)
+    , fColorXformSrcRowBytes(0)
+    , fExecutor(nullptr)
     , fBitDepth(bitDepth)
     , fIdatLength(0)
     , fDecodedIdat(false)
@@ -1148,7 +1271,10 @@ SkCodec::Result SkPngCodec::onGetPixels(const SkImageInfo& dstInfo, void* dst,
 
     this->allocateStorage(dstInfo);
     this->initializeXformParams();
-    return this->decodeAllRows(dst, rowBytes, rowsDecoded);
+    fExecutor = options.fExecutor;
+    Result decodeResult = this->decodeAllRows(dst, rowBytes, rowsDecoded);
+    fExecutor = nullptr;
+    return decodeResult;
 }
 
 SkCodec::Result SkPngCodec::onStartIncrementalDecode(const SkImageInfo& dstInfo,
@@ -15,6 +15,7 @@
 #include "src/codec/SkColorTable.h"
 #include "src/codec/SkSwizzler.h"
 
+class SkExecutor;
 class SkStream;
 
 class SkPngCodec : public SkCodec {
@@ -54,6 +55,14 @@ protected:
 
     SkSampler* getSampler(bool createIfNecessary) override;
     void applyXformRow(void* dst, const void* src);
+    // Like applyXformRow(dst, src), but swizzles into the caller's scratch row instead of
+    // fColorXformSrcRow, so that several threads may transform rows at once.  The scratch row
+    // must hold at least colorXformSrcRowBytes().
+    void applyXformRow(void* dst, const void* src, void* colorXformSrcRow);
+    size_t colorXformSrcRowBytes() const { return fColorXformSrcRowBytes; }
+
+    // Set by onGetPixels() from Options::fExecutor; null for incremental decodes.
+    SkExecutor* executor() const { return fExecutor; }
 
     voidp png_ptr() { return fPng_ptr; }
     voidp info_ptr() { return fInfo_ptr; }
@@ -84,6 +93,8 @@ protected:
     std::unique_ptr<SkSwizzler> fSwizzler;
     SkAutoTMalloc<uint8_t>      fStorage;
     void*                       fColorXformSrcRow;
+    size_t                      fColorXformSrcRowBytes;
+    SkExecutor*                 fExecutor;
     const int                   fBitDepth;
 
 private:
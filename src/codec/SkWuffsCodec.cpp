@@ -20,6 +20,7 @@
 #include "src/core/SkUtils.h"
 
 #include <limits.h>
+#include <algorithm>
 
 // Documentation on the Wuffs language and standard library (in general) and
 // its image decoding API (in particular) is at:
@@ -59,7 +60,33 @@
 #define SK_WUFFS_INITIALIZE_FLAGS WUFFS_INITIALIZE__DEFAULT_OPTIONS
 #endif
 
+// If the SkStream is backed by memory (e.g. an SkMemoryStream over an mmap'd SkData), point the
+// io_buffer at all of it, so that Wuffs reads the encoded bytes in place instead of through
+// fBuffer.  The io_buffer is closed, as there is nothing more to read.
+static bool map_buffer(wuffs_base__io_buffer* b, SkStream* s) {
+    const void* base = s->getMemoryBase();
+    if (!base || !s->hasLength() || !s->hasPosition()) {
+        return false;
+    }
+    // Wuffs never writes to an io_buffer that it reads from, so the memory may be read-only.
+    b->data = wuffs_base__make_slice_u8(static_cast<uint8_t*>(const_cast<void*>(base)),
+                                        s->getLength());
+    b->meta = wuffs_base__empty_io_buffer_meta();
+    b->meta.wi = s->getLength();
+    b->meta.ri = std::min(s->getPosition(), s->getLength());
+    b->meta.closed = true;
+    return true;
+}
+
+static bool is_mapped(const wuffs_base__io_buffer* b, SkStream* s) {
+    return b->data.ptr && b->data.ptr == s->getMemoryBase();
+}
+
 static bool fill_buffer(wuffs_base__io_buffer* b, SkStream* s) {
+    if (is_mapped(b, s)) {
+        // Everything is already in b. Compacting would also write to the stream's memory.
+        return false;
+    }
     b->compact();
     size_t num_read = s->read(b->data.ptr + b->meta.wi, b->data.len - b->meta.wi);
     b->meta.wi += num_read;
@@ -75,7 +102,7 @@ static bool seek_buffer(wuffs_base__io_buffer* b, SkStream* s, uint64_t pos) {
         return true;
     }
     // Seek in the backing SkStream.
-    if ((pos > SIZE_MAX) || (!s->seek(pos))) {
+    if (is_mapped(b, s) || (pos > SIZE_MAX) || (!s->seek(pos))) {
         return false;
     }
     b->meta.wi = 0;
@@ -373,6 +400,12 @@ SkWuffsCodec::SkWuffsCodec(SkEncodedInfo&&
       } {
     fFrameHolder.init(this, imgcfg.pixcfg.width(), imgcfg.pixcfg.height());
 
+    // A mapped iobuf reads from fStream's memory, which lives as long as we do.
+    if (is_mapped(&iobuf, fStream.get())) {
+        fIOBuffer = iobuf;
+        return;
+    }
+
     // Initialize fIOBuffer's fields, copying any outstanding data from iobuf to
     // fIOBuffer, as iobuf's backing array may not be valid for the lifetime of
     // this SkWuffsCodec object, but fIOBuffer's backing array (fBuffer) is.
@@ -863,7 +896,9 @@ SkCodec::Result SkWuffsCodec::resetDecoder(WhichDecoder which) {
     if (!fStream->rewind()) {
         return SkCodec::kInternalError;
     }
-    fIOBuffer.meta = wuffs_base__empty_io_buffer_meta();
+    if (!map_buffer(&fIOBuffer, fStream.get())) {
+        fIOBuffer.meta = wuffs_base__empty_io_buffer_meta();
+    }
 
     SkCodec::Result result =
         reset_and_decode_image_config(fDecoders[which].get(), nullptr, &fIOBuffer, fStream.get());
@@ -931,6 +966,7 @@ std::unique_ptr<SkCodec> SkWuffsCodec_MakeFromStream(std::unique_ptr<SkStream> s
         wuffs_base__make_io_buffer(wuffs_base__make_slice_u8(buffer, SK_WUFFS_CODEC_BUFFER_SIZE),
                                    wuffs_base__empty_io_buffer_meta());
     wuffs_base__image_config imgcfg = wuffs_base__null_image_config();
+    map_buffer(&iobuf, stream.get());
 
     // Wuffs is primarily a C library, not a C++ one. Furthermore, outside of
     // the wuffs_base__etc types, the sizeof a file format specific type like
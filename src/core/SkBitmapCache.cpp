@@ -30,7 +30,7 @@ void SkNotifyBitmapGenIDIsStale(uint32_t bitmapGenID) {
 SkBitmapCacheDesc SkBitmapCacheDesc::Make(uint32_t imageID, const SkIRect& subset) {
     SkASSERT(imageID);
     SkASSERT(subset.width() > 0 && subset.height() > 0);
-    return { imageID, subset };
+    return { imageID, subset, subset.size() };
 }
 
 SkBitmapCacheDesc SkBitmapCacheDesc::Make(const SkImage* image) {
@@ -38,6 +38,13 @@ SkBitmapCacheDesc SkBitmapCacheDesc::Make(const SkImage* image) {
     return Make(image->uniqueID(), bounds);
 }
 
+SkBitmapCacheDesc SkBitmapCacheDesc::MakeScaled(const SkImage* image, SkISize scaledSize) {
+    SkASSERT(!scaledSize.isEmpty());
+    SkBitmapCacheDesc desc = Make(image);
+    desc.fScaledSize = scaledSize;
+    return desc;
+}
+
 namespace {
 static unsigned gBitmapKeyNamespaceLabel;
 
@@ -175,9 +182,9 @@ void SkBitmapCache::PrivateDeleteRec(Rec* rec) { delete rec; }
 
 SkBitmapCache::RecPtr SkBitmapCache::Alloc(const SkBitmapCacheDesc& desc, const SkImageInfo& info,
                                            SkPixmap* pmap) {
-    // Ensure that the info matches the subset (i.e. the subset is the entire image)
-    SkASSERT(info.width() == desc.fSubset.width());
-    SkASSERT(info.height() == desc.fSubset.height());
+    // Ensure that the info matches the (possibly downscaled) subset
+    SkASSERT(info.width() == desc.fScaledSize.width());
+    SkASSERT(info.height() == desc.fScaledSize.height());
 
     const size_t rb = info.minRowBytes();
     size_t size = info.computeByteSize(rb);
@@ -26,15 +26,19 @@ void SkNotifyBitmapGenIDIsStale(uint32_t bitmapGenID);
 struct SkBitmapCacheDesc {
     uint32_t    fImageID;       // != 0
     SkIRect     fSubset;        // always set to a valid rect (entire or subset)
+    SkISize     fScaledSize;    // fSubset's size, unless the pixels were decoded downscaled
 
     void validate() const {
         SkASSERT(fImageID);
         SkASSERT(fSubset.fLeft >= 0 && fSubset.fTop >= 0);
         SkASSERT(fSubset.width() > 0 && fSubset.height() > 0);
+        SkASSERT(fScaledSize.width() > 0 && fScaledSize.height() > 0);
     }
 
     static SkBitmapCacheDesc Make(const SkImage*);
     static SkBitmapCacheDesc Make(uint32_t genID, const SkIRect& subset);
+    // The whole image, decoded at scaledSize rather than its own dimensions.
+    static SkBitmapCacheDesc MakeScaled(const SkImage*, SkISize scaledSize);
 };
 
 class SkBitmapCache {
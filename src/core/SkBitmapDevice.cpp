@@ -5,6 +5,7 @@
  * found in the LICENSE file.
  */
 
+#include "include/core/SkExecutor.h"
 #include "include/core/SkImageFilter.h"
 #include "include/core/SkMatrix.h"
 #include "include/core/SkPaint.h"
@@ -22,6 +23,7 @@
 #include "src/core/SkRasterClip.h"
 #include "src/core/SkSpecialImage.h"
 #include "src/core/SkStrikeCache.h"
+#include "src/core/SkSurfacePriv.h"
 #include "src/core/SkTLazy.h"
 #include "src/image/SkImage_Base.h"
 
@@ -73,6 +75,11 @@ public:
             // NoDrawDevice uses us (why?) so we have to catch this case w/ no pixels
             fRootPixmap.reset(dev->imageInfo(), nullptr, 0);
         }
+        fDraw.fSparseScanlineAA = dev->surfaceProps().flags() &
+                                  kSparseScanlineAA_SkSurfacePropsPrivateFlag;
+        if (dev->surfaceProps().flags() & kBandedAnalyticAA_SkSurfacePropsPrivateFlag) {
+            fDraw.fAnalyticAABandExecutor = &SkExecutor::GetDefault();
+        }
 
         // do a quick check, so we don't even have to process "bounds" if there is no need
         const SkIRect clipR = dev->fRCStack.rc().getBounds();
@@ -195,6 +202,11 @@ public:
         fMatrixProvider = dev;
         fRC = &dev->fRCStack.rc();
         fCoverage = dev->accessCoverage();
+        fSparseScanlineAA = dev->surfaceProps().flags() &
+                            kSparseScanlineAA_SkSurfacePropsPrivateFlag;
+        if (dev->surfaceProps().flags() & kBandedAnalyticAA_SkSurfacePropsPrivateFlag) {
+            fAnalyticAABandExecutor = &SkExecutor::GetDefault();
+        }
     }
 };
 
@@ -431,10 +443,23 @@ void SkBitmapDevice::drawImageRect(const SkImage* image, const SkRect* src, cons
     SkBitmap bitmap;
     // TODO: Elevate direct context requirement to public API and remove cheat.
     auto dContext = as_IB(image)->directContext();
-    if (!as_IB(image)->getROPixels(dContext, &bitmap)) {
+    // Lazy images may decode smaller than their dimensions when drawn heavily minified.
+    const SkRect imageBounds = SkRect::Make(image->bounds());
+    const SkScalar drawScale = SkMatrix::Concat(this->localToDevice(),
+                                                SkMatrix::RectToRect(src ? *src : imageBounds, dst))
+                               .getMaxScale();
+    if (!as_IB(image)->getROPixelsAtScale(dContext, drawScale > 0 ? drawScale : 1, &bitmap)) {
         return;
     }
 
+    // If we got smaller pixels, map the src rect onto them.
+    SkRect scaledSrc;
+    if (src && bitmap.dimensions() != image->dimensions()) {
+        scaledSrc = SkMatrix::Scale(SkIntToScalar(bitmap.width())  / image->width(),
+                                    SkIntToScalar(bitmap.height()) / image->height()).mapRect(*src);
+        src = &scaledSrc;
+    }
+
     SkRect      bitmapBounds, tmpSrc, tmpDst;
     SkBitmap    tmpBitmap;
 
@@ -141,6 +141,7 @@ private:
     friend class SkDraw;
     friend class SkDrawTiler;
     friend class SkSurface_Raster;
+    friend class SkSurface_RasterThreaded;
 
     class BDDraw;
 
@@ -8,6 +8,7 @@
 #ifndef SkCoreBlitters_DEFINED
 #define SkCoreBlitters_DEFINED
 
+#include "include/core/SkGraphics.h"
 #include "include/core/SkPaint.h"
 #include "src/core/SkBlitRow.h"
 #include "src/core/SkBlitter.h"
@@ -186,4 +187,8 @@ SkBlitter* SkCreateSkVMSpriteBlitter(const SkPixmap& dst,
                                      SkArenaAlloc*,
                                      sk_sp<SkShader> clipShader);
 
+// Like SkGraphics::GetProgramCacheStats(), counting only lookups made on the calling thread,
+// so tests can attribute hits and misses exactly while other threads share the cache.
+SkGraphics::ProgramCacheStats SkVMBlitterThreadProgramCacheStats();
+
 #endif
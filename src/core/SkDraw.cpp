@@ -838,9 +838,16 @@ void SkDraw::drawDevPath(const SkPath& devPath, const SkPaint& paint, bool drawC
         }
     }
 
+    if (doFill && paint.isAntiAlias() && fAnalyticAABandExecutor) {
+        SkScan::AnalyticAntiFillPath(devPath, *fRC, blitter, fAnalyticAABandExecutor);
+        return;
+    }
+
     void (*proc)(const SkPath&, const SkRasterClip&, SkBlitter*);
     if (doFill) {
-        if (paint.isAntiAlias()) {
+        if (paint.isAntiAlias() && fSparseScanlineAA) {
+            proc = SkScan::SparseAntiFillPath;
+        } else if (paint.isAntiAlias()) {
             proc = SkScan::AntiFillPath;
         } else {
             proc = SkScan::FillPath;
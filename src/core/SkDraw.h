@@ -19,6 +19,7 @@
 
 class SkBitmap;
 class SkClipStack;
+class SkExecutor;
 class SkBaseDevice;
 class SkBlitter;
 class SkMatrix;
@@ -161,6 +162,12 @@ public:
     // optional, will be same dimensions as fDst if present
     const SkPixmap* fCoverage{nullptr};
 
+    // fill anti-aliased paths with SkScan::SparseAntiFillPath()
+    bool fSparseScanlineAA{false};
+
+    // optional, fill anti-aliased paths with SkScan::AnalyticAntiFillPath() banded on this
+    SkExecutor* fAnalyticAABandExecutor{nullptr};
+
 #ifdef SK_DEBUG
     void validate() const;
 #else
@@ -10,8 +10,11 @@
 #include "include/private/SkSemaphore.h"
 #include "include/private/SkSpinlock.h"
 #include "include/private/SkTArray.h"
+#include <atomic>
 #include <deque>
+#include <memory>
 #include <thread>
+#include <vector>
 
 #if defined(SK_BUILD_FOR_WIN)
     #include "src/core/SkLeanWindows.h"
@@ -139,6 +142,257 @@ private:
     bool                  fAllowBorrowing;
 };
 
+// A Chase-Lev work-stealing deque, following the C11 formulation in
+//     'Correct and Efficient Work-Stealing for Weak Memory Models' (Le et al., PPoPP 2013).
+// Only the owning thread may push() and pop(), at the bottom.  Any thread may steal() from the top.
+// We hold raw pointers to heap-allocated work; whoever removes a pointer takes ownership of it.
+class SkWorkStealingDeque {
+public:
+    using Work = std::function<void(void)>;
+
+    enum class StealResult { kSuccess, kEmpty, kAbort };
+
+    SkWorkStealingDeque() : fArray(new Array(kInitialCapacity)) {
+        fArrays.emplace_back(fArray.load(std::memory_order_relaxed));
+    }
+
+    ~SkWorkStealingDeque() {
+        // Anything left is work that never ran.
+        while (Work* work = this->pop()) {
+            delete work;
+        }
+    }
+
+    void push(Work* work) {
+        int64_t b = fBottom.load(std::memory_order_relaxed),
+                t = fTop   .load(std::memory_order_acquire);
+        Array* a = fArray.load(std::memory_order_relaxed);
+        if (b - t > a->capacity() - 1) {
+            a = this->grow(a, t, b);
+        }
+        a->put(b, work);
+        std::atomic_thread_fence(std::memory_order_release);
+        fBottom.store(b + 1, std::memory_order_relaxed);
+    }
+
+    Work* pop() {
+        int64_t b = fBottom.load(std::memory_order_relaxed) - 1;
+        Array* a = fArray.load(std::memory_order_relaxed);
+        fBottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t t = fTop.load(std::memory_order_relaxed);
+
+        if (t > b) {
+            // The deque was already empty.
+            fBottom.store(b + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+
+        Work* work = a->get(b);
+        if (t == b) {
+            // This is the last item; race any thieves for it.
+            if (!fTop.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                                        std::memory_order_relaxed)) {
+                work = nullptr;
+            }
+            fBottom.store(b + 1, std::memory_order_relaxed);
+        }
+        return work;
+    }
+
+    StealResult steal(Work** work) {
+        int64_t t = fTop.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t b = fBottom.load(std::memory_order_acquire);
+
+        if (t >= b) {
+            return StealResult::kEmpty;
+        }
+        // A consume load is what's called for here, but acquire is what compilers do anyway.
+        Array* a = fArray.load(std::memory_order_acquire);
+        *work = a->get(t);
+        if (!fTop.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                                    std::memory_order_relaxed)) {
+            return StealResult::kAbort;  // Lost the race to another thief or the owner.
+        }
+        return StealResult::kSuccess;
+    }
+
+private:
+    static constexpr int64_t kInitialCapacity = 64;
+
+    class Array {
+    public:
+        explicit Array(int64_t capacity)
+            : fMask(capacity - 1)
+            , fSlots(new std::atomic<Work*>[capacity]) {
+            SkASSERT(SkIsPow2(capacity));
+        }
+
+        int64_t capacity() const { return fMask + 1; }
+
+        Work* get(int64_t i) const { return fSlots[i & fMask].load(std::memory_order_relaxed); }
+        void put(int64_t i, Work* work) {
+            fSlots[i & fMask].store(work, std::memory_order_relaxed);
+        }
+
+    private:
+        const int64_t                          fMask;
+        std::unique_ptr<std::atomic<Work*>[]>  fSlots;
+    };
+
+    Array* grow(Array* a, int64_t t, int64_t b) {
+        auto bigger = std::make_unique<Array>(2 * a->capacity());
+        for (int64_t i = t; i < b; i++) {
+            bigger->put(i, a->get(i));
+        }
+        // Thieves may still be reading from the old array, so we keep every array until we die.
+        fArrays.push_back(std::move(bigger));
+        fArray.store(fArrays.back().get(), std::memory_order_release);
+        return fArrays.back().get();
+    }
+
+    std::atomic<int64_t>                fTop{0},
+                                        fBottom{0};
+    std::atomic<Array*>                 fArray;
+    std::vector<std::unique_ptr<Array>> fArrays;  // Only touched by the owner.
+};
+
+// An SkWorkStealingThreadPool gives each of its threads its own SkWorkStealingDeque.
+// Work added from one of the pool's own threads (i.e. by a running task) goes to that thread's
+// deque, where it will be run LIFO by its owner, or stolen FIFO by idle threads.
+// Work added from any other thread goes into a shared FIFO queue.
+//
+// Like SkThreadPool, fWorkAvailable counts work that has been added but not yet claimed,
+// and every thread must decrement it before claiming a piece of work.
+class SkWorkStealingThreadPool final : public SkExecutor {
+public:
+    explicit SkWorkStealingThreadPool(int threads, bool allowBorrowing)
+            : fDeques(new SkWorkStealingDeque[threads])
+            , fDequeCount(threads)
+            , fAllowBorrowing(allowBorrowing) {
+        for (int i = 0; i < threads; i++) {
+            fThreads.emplace_back(&Loop, this, i);
+        }
+    }
+
+    ~SkWorkStealingThreadPool() override {
+        // Wake each thread; once none of them can find any work, they'll shut down.
+        fShuttingDown.store(true, std::memory_order_release);
+        fWorkAvailable.signal(fThreads.count());
+        for (int i = 0; i < fThreads.count(); i++) {
+            fThreads[i].join();
+        }
+        // Delete any work left in our shared queue.  Each deque cleans up after itself.
+        for (Work* work : fSharedWork) {
+            delete work;
+        }
+    }
+
+    void add(std::function<void(void)> work) override {
+        auto boxed = new std::function<void(void)>(std::move(work));
+        if (int index = this->currentThreadIndex(); index >= 0) {
+            fDeques[index].push(boxed);
+        } else {
+            SkAutoMutexExclusive lock(fSharedWorkLock);
+            fSharedWork.push_back(boxed);
+        }
+        fWorkAvailable.signal(1);
+    }
+
+    void borrow() override {
+        // Our own threads always borrow: SkTaskGroup::wait() from inside a task must help out,
+        // not block a thread this pool is counting on to make progress.
+        int index = this->currentThreadIndex();
+        if ((fAllowBorrowing || index >= 0) && fWorkAvailable.try_wait()) {
+            this->do_work(index);
+        }
+    }
+
+private:
+    using Work = SkWorkStealingDeque::Work;
+
+    // The calling thread's index in fThreads, or -1 if it's not one of ours.
+    int currentThreadIndex() const {
+        return gCurrentPool == this ? gCurrentIndex : -1;
+    }
+
+    // Find and remove a piece of work: from our own deque first, then the shared queue,
+    // then by stealing from the other threads.  Returns nullptr only if there's no work to find.
+    Work* find_work(int index) {
+        for (;;) {
+            if (index >= 0) {
+                if (Work* work = fDeques[index].pop()) {
+                    return work;
+                }
+            }
+            {
+                SkAutoMutexExclusive lock(fSharedWorkLock);
+                if (!fSharedWork.empty()) {
+                    Work* work = fSharedWork.front();
+                    fSharedWork.pop_front();
+                    return work;
+                }
+            }
+
+            bool sawWork = false;
+            const int n = fDequeCount;
+            for (int i = 0; i < n; i++) {
+                // Start just past ourselves so threads don't all gang up on deque 0.
+                int victim = (index + 1 + i) % n;
+                if (victim == index) {
+                    continue;
+                }
+                Work* work = nullptr;
+                switch (fDeques[victim].steal(&work)) {
+                    case SkWorkStealingDeque::StealResult::kSuccess: return work;
+                    case SkWorkStealingDeque::StealResult::kAbort:   sawWork = true; break;
+                    case SkWorkStealingDeque::StealResult::kEmpty:   break;
+                }
+            }
+            if (!sawWork && fShuttingDown.load(std::memory_order_acquire)) {
+                return nullptr;
+            }
+            // Our decrement of fWorkAvailable guarantees there is work for us somewhere;
+            // it's either being pushed right now, or we lost a race for it.  Try again.
+            std::this_thread::yield();
+        }
+    }
+
+    // Returns false if there was no work to do, which only happens as we're shutting down.
+    bool do_work(int index) {
+        std::unique_ptr<Work> work(this->find_work(index));
+        if (!work) {
+            return false;
+        }
+        (*work)();
+        return true;
+    }
+
+    static void Loop(SkWorkStealingThreadPool* pool, int index) {
+        gCurrentPool  = pool;
+        gCurrentIndex = index;
+        do {
+            pool->fWorkAvailable.wait();
+        } while (pool->do_work(index));
+    }
+
+    static thread_local const SkWorkStealingThreadPool* gCurrentPool;
+    static thread_local int                             gCurrentIndex;
+
+    SkTArray<std::thread>                  fThreads;
+    std::unique_ptr<SkWorkStealingDeque[]> fDeques;
+    const int                              fDequeCount;
+    std::deque<Work*>                      fSharedWork;
+    SkMutex                                fSharedWorkLock;
+    SkSemaphore                            fWorkAvailable;
+    std::atomic<bool>                      fShuttingDown{false};
+    bool                                   fAllowBorrowing;
+};
+
+thread_local const SkWorkStealingThreadPool* SkWorkStealingThreadPool::gCurrentPool  = nullptr;
+thread_local int                             SkWorkStealingThreadPool::gCurrentIndex = -1;
+
 std::unique_ptr<SkExecutor> SkExecutor::MakeFIFOThreadPool(int threads, bool allowBorrowing) {
     using WorkList = std::deque<std::function<void(void)>>;
     return std::make_unique<SkThreadPool<WorkList>>(threads > 0 ? threads : num_cores(),
@@ -149,3 +403,9 @@ std::unique_ptr<SkExecutor> SkExecutor::MakeLIFOThreadPool(int threads, bool all
     return std::make_unique<SkThreadPool<WorkList>>(threads > 0 ? threads : num_cores(),
                                                     allowBorrowing);
 }
+
+std::unique_ptr<SkExecutor> SkExecutor::MakeWorkStealingThreadPool(int threads,
+                                                                   bool allowBorrowing) {
+    return std::make_unique<SkWorkStealingThreadPool>(threads > 0 ? threads : num_cores(),
+                                                      allowBorrowing);
+}
@@ -45,6 +45,7 @@ void SkGraphics::DumpMemoryStatistics(SkTraceMemoryDump* dump) {
 void SkGraphics::PurgeAllCaches() {
     SkGraphics::PurgeFontCache();
     SkGraphics::PurgeResourceCache();
+    SkGraphics::PurgeProgramCache();
     SkImageFilter_Base::PurgeCache();
 }
 
@@ -130,3 +131,9 @@ extern bool gSkVMAllowJIT;
 void SkGraphics::AllowJIT() {
     gSkVMAllowJIT = true;
 }
+
+extern SkGraphics::PersistentProgramCache* gSkVMPersistentProgramCache;
+
+void SkGraphics::SetPersistentProgramCache(PersistentProgramCache* cache) {
+    gSkVMPersistentProgramCache = cache;
+}
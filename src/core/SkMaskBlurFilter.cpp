@@ -15,6 +15,7 @@
 #include "include/private/SkTo.h"
 #include "src/core/SkArenaAlloc.h"
 #include "src/core/SkGaussFilter.h"
+#include "src/core/SkTaskGroup.h"
 
 #include <cmath>
 #include <climits>
@@ -952,9 +953,32 @@ static SkIPoint small_blur(double sigmaX, double sigmaY, const SkMask& src, SkMa
     return {radiusX, radiusY};
 }
 
+// Each scan of a pass is independent of the others, so large masks are blurred in bands of scans
+// on an SkExecutor without changing the result. Both passes write transposed, one byte per scan
+// into each output row, so bands are whole multiples of kBandAlign scans. The buffers are not
+// aligned, so neighbouring bands may still share the one cache line per row at their boundary,
+// but never more than that.
+static constexpr int kMinBandPixels = 1 << 16;
+static constexpr int kBandAlign     = 64;
+
+// Call fn(begin, end) over bands of [0, count) scans, each scanLength pixels long.
+template <typename Fn>
+static void for_each_band(SkExecutor* executor, int count, int scanLength, Fn&& fn) {
+    const int groups = (count + kBandAlign - 1) / kBandAlign;
+    const int grain  = std::max(1, kMinBandPixels / (kBandAlign * std::max(1, scanLength)));
+    if (groups <= grain) {
+        fn(0, count);
+        return;
+    }
+    SkTaskGroup tg(executor ? *executor : SkExecutor::GetDefault());
+    tg.parallel_for(0, groups, grain, [&](int first, int end) {
+        fn(first * kBandAlign, std::min(end * kBandAlign, count));
+    });
+}
+
 // TODO: assuming sigmaW = sigmaH. Allow different sigmas. Right now the
 // API forces the sigmas to be the same.
-SkIPoint SkMaskBlurFilter::blur(const SkMask& src, SkMask* dst) const {
+SkIPoint SkMaskBlurFilter::blur(const SkMask& src, SkMask* dst, SkExecutor* executor) const {
 
     if (fSigmaW < 2.0 && fSigmaH < 2.0) {
         return small_blur(fSigmaW, fSigmaH, src, dst);
@@ -985,9 +1009,6 @@ SkIPoint SkMaskBlurFilter::blur(const SkMask& src, SkMask* dst) const {
         dstH = dst->fBounds.height();
     SkASSERT(srcW >= 0 && srcH >= 0 && dstW >= 0 && dstH >= 0);
 
-    auto bufferSize = std::max(planW.bufferSize(), planH.bufferSize());
-    auto buffer = alloc.makeArrayDefault<uint32_t>(bufferSize);
-
     // Blur both directions.
     int tmpW = srcH,
         tmpH = dstW;
@@ -999,43 +1020,41 @@ SkIPoint SkMaskBlurFilter::blur(const SkMask& src, SkMask* dst) const {
     auto tmp = alloc.makeArrayDefault<uint8_t>(tmpW * tmpH);
 
     // Blur horizontally, and transpose.
-    const PlanGauss::Scan& scanW = planW.makeBlurScan(srcW, buffer);
+    auto blurRows = [&](auto start, auto end) {
+        for_each_band(executor, srcH, srcW, [&](int top, int bottom) {
+            SkAutoSTMalloc<256, uint32_t> buffer(planW.bufferSize());
+            const PlanGauss::Scan& scanW = planW.makeBlurScan(srcW, buffer.get());
+            auto rowStart = start,
+                 rowEnd   = end;
+            rowStart >>= top * src.fRowBytes;
+            rowEnd   >>= top * src.fRowBytes;
+            for (int y = top; y < bottom; ++y, rowStart >>= src.fRowBytes,
+                                               rowEnd   >>= src.fRowBytes) {
+                auto tmpStart = &tmp[y];
+                scanW.blur(rowStart, rowEnd, tmpStart, tmpW, tmpStart + tmpW * tmpH);
+            }
+        });
+    };
     switch (src.fFormat) {
         case SkMask::kBW_Format: {
             const uint8_t* bwStart = src.fImage;
-            auto start = SkMask::AlphaIter<SkMask::kBW_Format>(bwStart, 0);
-            auto end = SkMask::AlphaIter<SkMask::kBW_Format>(bwStart + (srcW / 8), srcW % 8);
-            for (int y = 0; y < srcH; ++y, start >>= src.fRowBytes, end >>= src.fRowBytes) {
-                auto tmpStart = &tmp[y];
-                scanW.blur(start, end, tmpStart, tmpW, tmpStart + tmpW * tmpH);
-            }
+            blurRows(SkMask::AlphaIter<SkMask::kBW_Format>(bwStart, 0),
+                     SkMask::AlphaIter<SkMask::kBW_Format>(bwStart + (srcW / 8), srcW % 8));
         } break;
         case SkMask::kA8_Format: {
             const uint8_t* a8Start = src.fImage;
-            auto start = SkMask::AlphaIter<SkMask::kA8_Format>(a8Start);
-            auto end = SkMask::AlphaIter<SkMask::kA8_Format>(a8Start + srcW);
-            for (int y = 0; y < srcH; ++y, start >>= src.fRowBytes, end >>= src.fRowBytes) {
-                auto tmpStart = &tmp[y];
-                scanW.blur(start, end, tmpStart, tmpW, tmpStart + tmpW * tmpH);
-            }
+            blurRows(SkMask::AlphaIter<SkMask::kA8_Format>(a8Start),
+                     SkMask::AlphaIter<SkMask::kA8_Format>(a8Start + srcW));
         } break;
         case SkMask::kARGB32_Format: {
             const uint32_t* argbStart = reinterpret_cast<const uint32_t*>(src.fImage);
-            auto start = SkMask::AlphaIter<SkMask::kARGB32_Format>(argbStart);
-            auto end = SkMask::AlphaIter<SkMask::kARGB32_Format>(argbStart + srcW);
-            for (int y = 0; y < srcH; ++y, start >>= src.fRowBytes, end >>= src.fRowBytes) {
-                auto tmpStart = &tmp[y];
-                scanW.blur(start, end, tmpStart, tmpW, tmpStart + tmpW * tmpH);
-            }
+            blurRows(SkMask::AlphaIter<SkMask::kARGB32_Format>(argbStart),
+                     SkMask::AlphaIter<SkMask::kARGB32_Format>(argbStart + srcW));
         } break;
         case SkMask::kLCD16_Format: {
             const uint16_t* lcdStart = reinterpret_cast<const uint16_t*>(src.fImage);
-            auto start = SkMask::AlphaIter<SkMask::kLCD16_Format>(lcdStart);
-            auto end = SkMask::AlphaIter<SkMask::kLCD16_Format>(lcdStart + srcW);
-            for (int y = 0; y < srcH; ++y, start >>= src.fRowBytes, end >>= src.fRowBytes) {
-                auto tmpStart = &tmp[y];
-                scanW.blur(start, end, tmpStart, tmpW, tmpStart + tmpW * tmpH);
-            }
+            blurRows(SkMask::AlphaIter<SkMask::kLCD16_Format>(lcdStart),
+                     SkMask::AlphaIter<SkMask::kLCD16_Format>(lcdStart + srcW));
         } break;
         default:
             SK_ABORT("Unhandled format.");
@@ -1043,14 +1062,17 @@ SkIPoint SkMaskBlurFilter::blur(const SkMask& src, SkMask* dst) const {
 
     // Blur vertically (scan in memory order because of the transposition),
     // and transpose back to the original orientation.
-    const PlanGauss::Scan& scanH = planH.makeBlurScan(tmpW, buffer);
-    for (int y = 0; y < tmpH; y++) {
-        auto tmpStart = &tmp[y * tmpW];
-        auto dstStart = &dst->fImage[y];
-
-        scanH.blur(tmpStart, tmpStart + tmpW,
-                   dstStart, dst->fRowBytes, dstStart + dst->fRowBytes * dstH);
-    }
+    for_each_band(executor, tmpH, tmpW, [&](int top, int bottom) {
+        SkAutoSTMalloc<256, uint32_t> buffer(planH.bufferSize());
+        const PlanGauss::Scan& scanH = planH.makeBlurScan(tmpW, buffer.get());
+        for (int y = top; y < bottom; y++) {
+            auto tmpStart = &tmp[y * tmpW];
+            auto dstStart = &dst->fImage[y];
+
+            scanH.blur(tmpStart, tmpStart + tmpW,
+                       dstStart, dst->fRowBytes, dstStart + dst->fRowBytes * dstH);
+        }
+    });
 
     return {SkTo<int32_t>(borderW), SkTo<int32_t>(borderH)};
 }
@@ -16,6 +16,8 @@
 #include "src/core/SkMathPriv.h"
 #include "src/core/SkMipmap.h"
 #include "src/core/SkMipmapBuilder.h"
+#include "src/core/SkOpts.h"
+#include "src/core/SkTaskGroup.h"
 #include <new>
 
 //
@@ -382,6 +384,10 @@ template <typename F> void downsample_3_3(void* dst, const void* src, size_t src
     }
 }
 
+// Levels with at least this many dst pixels are filtered in bands of about kParallelBandPixels.
+static constexpr int kMinParallelPixels  = 256 * 1024;
+static constexpr int kParallelBandPixels =  64 * 1024;
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
 size_t SkMipmap::AllocLevelsSize(int levelCount, size_t pixelSize) {
@@ -545,6 +551,32 @@ SkMipmap* SkMipmap::Build(const SkPixmap& src, SkDiscardableFactoryProc fact,
             return nullptr;
     }
 
+    // SkOpts may have vectorized box and triangle filters for the most common color types.
+    auto useOpts = [&](SkOpts::Downsample opt_2_2, SkOpts::Downsample opt_3_3) {
+        proc_2_2 = opt_2_2 ? opt_2_2 : proc_2_2;
+        proc_3_3 = opt_3_3 ? opt_3_3 : proc_3_3;
+    };
+    switch (ct) {
+        case kRGBA_8888_SkColorType:
+        case kBGRA_8888_SkColorType:
+            useOpts(SkOpts::downsample_2_2_8888, SkOpts::downsample_3_3_8888);
+            break;
+        case kAlpha_8_SkColorType:
+        case kGray_8_SkColorType:
+            useOpts(SkOpts::downsample_2_2_a8, SkOpts::downsample_3_3_a8);
+            break;
+        case kRGBA_F16Norm_SkColorType:
+        case kRGBA_F16_SkColorType:
+            useOpts(SkOpts::downsample_2_2_f16, SkOpts::downsample_3_3_f16);
+            break;
+        case kRGBA_1010102_SkColorType:
+        case kBGRA_1010102_SkColorType:
+            useOpts(SkOpts::downsample_2_2_1010102, SkOpts::downsample_3_3_1010102);
+            break;
+        default:
+            break;
+    }
+
     if (src.width() <= 1 && src.height() <= 1) {
         return nullptr;
     }
@@ -638,10 +670,22 @@ SkMipmap* SkMipmap::Build(const SkPixmap& src, SkDiscardableFactoryProc fact,
             void* dstBasePtr = dstPM.writable_addr();
 
             const size_t srcRB = srcPM.rowBytes();
-            for (int y = 0; y < height; y++) {
-                proc(dstBasePtr, srcBasePtr, srcRB, width);
-                srcBasePtr = (char*)srcBasePtr + srcRB * 2; // jump two rows
-                dstBasePtr = (char*)dstBasePtr + dstPM.rowBytes();
+            const size_t dstRB = dstPM.rowBytes();
+            auto filterRows = [=](int y, int yEnd) {
+                for (; y < yEnd; y++) {
+                    proc((char*)dstBasePtr + y * dstRB,
+                         (const char*)srcBasePtr + y * srcRB * 2,  // jump two rows
+                         srcRB, width);
+                }
+            };
+            // Each dst row reads only its own src rows, so large levels can be filtered in
+            // bands of rows on the default executor.  Smaller levels aren't worth the tasks.
+            if ((int64_t)width * height >= kMinParallelPixels) {
+                SkTaskGroup tg;
+                tg.parallel_for(0, height, std::max(1, kParallelBandPixels / width), filterRows);
+                tg.wait();
+            } else {
+                filterRows(0, height);
             }
         }
         srcPM = dstPM;
@@ -33,6 +33,8 @@ class SkMipmap : public SkCachedData {
 public:
     // Allocate and fill-in a mipmap. If computeContents is false, we just allocated
     // and compute the sizes/rowbytes, but leave the pixel-data uninitialized.
+    // Large levels are filtered in bands of rows on SkExecutor::GetDefault(), which runs
+    // them on the calling thread unless the embedder has installed a thread pool.
     static SkMipmap* Build(const SkPixmap& src, SkDiscardableFactoryProc,
                            bool computeContents = true);
 
@@ -31,10 +31,10 @@ SkMipmapAccessor::SkMipmapAccessor(const SkImage_Base* image, const SkMatrix& in
     fResolvedMode = requestedMode;
     fLowerWeight = 0;
 
-    auto load_upper_from_base = [&]() {
+    auto load_upper_from_base = [&](float scale) {
         // only do this once
         if (fBaseStorage.getPixels() == nullptr) {
-            (void)image->getROPixels(nullptr, &fBaseStorage);
+            (void)image->getROPixelsAtScale(nullptr, scale, &fBaseStorage);
             fUpper.reset(fBaseStorage.info(), fBaseStorage.getPixels(), fBaseStorage.rowBytes());
         }
     };
@@ -63,13 +63,19 @@ SkMipmapAccessor::SkMipmapAccessor(const SkImage_Base* image, const SkMatrix& in
     SkASSERT(levelNum >= 0);
 
     if (levelNum == 0) {
-        load_upper_from_base();
+        // Without mips to blend with, lazy images may decode smaller when we're minifying.
+        // (The inverse's smallest scale is one over the draw's largest.)
+        float drawScale = 1;
+        if (fResolvedMode == SkMipmapMode::kNone && inv.getMinScale() > 0) {
+            drawScale = 1 / inv.getMinScale();
+        }
+        load_upper_from_base(drawScale);
     }
     // load fCurrMip if needed
     if (levelNum > 0 || (fResolvedMode == SkMipmapMode::kLinear && lowerWeight > 0)) {
         fCurrMip = try_load_mips(image);
         if (!fCurrMip) {
-            load_upper_from_base();
+            load_upper_from_base(1);
             fResolvedMode = SkMipmapMode::kNone;
         } else {
             SkMipmap::Level levelRec;
@@ -79,7 +85,7 @@ SkMipmapAccessor::SkMipmapAccessor(const SkImage_Base* image, const SkMatrix& in
                 if (fCurrMip->getLevel(levelNum - 1, &levelRec)) {
                     fUpper = levelRec.fPixmap;
                 } else {
-                    load_upper_from_base();
+                    load_upper_from_base(1);
                     fResolvedMode = SkMipmapMode::kNone;
                 }
             }
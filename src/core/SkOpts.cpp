@@ -43,6 +43,7 @@
 #include "src/opts/SkBlitMask_opts.h"
 #include "src/opts/SkBlitRow_opts.h"
 #include "src/opts/SkChecksum_opts.h"
+#include "src/opts/SkMipmap_opts.h"
 #include "src/opts/SkRasterPipeline_opts.h"
 #include "src/opts/SkSwizzler_opts.h"
 #include "src/opts/SkUtils_opts.h"
@@ -83,6 +84,15 @@ namespace SkOpts {
 
     DEFINE_DEFAULT(cubic_solver);
 
+    DEFINE_DEFAULT(downsample_2_2_8888);
+    DEFINE_DEFAULT(downsample_3_3_8888);
+    DEFINE_DEFAULT(downsample_2_2_a8);
+    DEFINE_DEFAULT(downsample_3_3_a8);
+    DEFINE_DEFAULT(downsample_2_2_1010102);
+    DEFINE_DEFAULT(downsample_3_3_1010102);
+    DEFINE_DEFAULT(downsample_2_2_f16);
+    DEFINE_DEFAULT(downsample_3_3_f16);
+
     DEFINE_DEFAULT(hash_fn);
 
     DEFINE_DEFAULT(S32_alpha_D32_filter_DX);
@@ -56,6 +56,14 @@ namespace SkOpts {
 
     extern float (*cubic_solver)(float, float, float, float);
 
+    // SkMipmap box (2_2) and triangle (3_3) downsamplers, writing count pixels of one dst row.
+    // These are null unless the CPU has vectors wide enough to beat SkMipmap's own filters.
+    typedef void (*Downsample)(void* dst, const void* src, size_t srcRB, int count);
+    extern Downsample downsample_2_2_8888,    downsample_3_3_8888,
+                      downsample_2_2_a8,      downsample_3_3_a8,
+                      downsample_2_2_1010102, downsample_3_3_1010102,
+                      downsample_2_2_f16,     downsample_3_3_f16;
+
     static inline uint32_t hash(const void* data, size_t bytes, uint32_t seed=0) {
         return hash_fn(data, bytes, seed);
     }
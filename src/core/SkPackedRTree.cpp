@@ -0,0 +1,243 @@
+/*
+ * Copyright 2021 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "src/core/SkPackedRTree.h"
+
+#include "include/private/SkTemplates.h"
+#include "include/private/SkVx.h"
+#include "src/core/SkMathPriv.h"
+
+#include <algorithm>
+#include <limits>
+
+using F = skvx::Vec<SkPackedRTree::kFanout, float>;
+
+static constexpr float kInf = std::numeric_limits<float>::infinity();
+
+static uint32_t interleave_zero_bits(uint32_t x) {
+    x = (x | (x << 8)) & 0x00ff00ff;
+    x = (x | (x << 4)) & 0x0f0f0f0f;
+    x = (x | (x << 2)) & 0x33333333;
+    x = (x | (x << 1)) & 0x55555555;
+    return x;
+}
+
+// Distance along a Hilbert curve filling a 2^16 x 2^16 grid.  The classic loop walks down the
+// quadrants one level at a time, branching to rotate and reflect each one; this computes all
+// sixteen levels' transforms at once as a branch-free parallel prefix scan, as published in
+// github.com/rawrunprotected/hilbert_curves.
+static uint32_t hilbert_index(uint32_t x, uint32_t y) {
+    uint32_t A, B, C, D;
+    {
+        const uint32_t a = x ^ y,
+                       b = 0xffff ^ a,
+                       c = 0xffff ^ (x | y),
+                       d = x & (y ^ 0xffff);
+        A = a | (b >> 1);
+        B = (a >> 1) ^ a;
+        C = ((c >> 1) ^ (b & (d >> 1))) ^ c;
+        D = ((a & (c >> 1)) ^ (d >> 1)) ^ d;
+    }
+    for (int shift : {2, 4}) {
+        const uint32_t a = A, b = B, c = C, d = D;
+        A = (a & (a >> shift)) ^ (b & (b >> shift));
+        B = (a & (b >> shift)) ^ (b & ((a ^ b) >> shift));
+        C ^= (a & (c >> shift)) ^ (b & (d >> shift));
+        D ^= (b & (c >> shift)) ^ ((a ^ b) & (d >> shift));
+    }
+    {
+        const uint32_t a = A, b = B, c = C, d = D;
+        C ^= (a & (c >> 8)) ^ (b & (d >> 8));
+        D ^= (b & (c >> 8)) ^ ((a ^ b) & (d >> 8));
+    }
+
+    // Undo the scan's transform and recover the two index bits of each level.
+    const uint32_t a  = C ^ (C >> 1),
+                   b  = D ^ (D >> 1),
+                   i0 = x ^ y,
+                   i1 = b | (0xffff ^ (i0 | a));
+    return (interleave_zero_bits(i1) << 1) | interleave_zero_bits(i0);
+}
+
+// Map v in [0, 65535] onto the Hilbert grid; anything else (including NaN) is pinned.
+static uint32_t to_grid(float v) {
+    return v >= 0 ? (uint32_t)std::min(v, 65535.0f) : 0;
+}
+
+// Stable LSD radix sort of keys by their high 32 bits, 8 bits per pass.
+static void radix_sort_high32(std::vector<uint64_t>* keys) {
+    std::vector<uint64_t> tmp(keys->size());
+    for (int shift = 32; shift < 64; shift += 8) {
+        int offsets[256] = {};
+        for (uint64_t k : *keys) {
+            offsets[(k >> shift) & 0xff]++;
+        }
+        // A pass where every key shares this byte would copy keys over unchanged.
+        if (offsets[((*keys)[0] >> shift) & 0xff] == (int)keys->size()) {
+            continue;
+        }
+        for (int i = 0, sum = 0; i < 256; i++) {
+            int n = offsets[i];
+            offsets[i] = sum;
+            sum += n;
+        }
+        for (uint64_t k : *keys) {
+            tmp[offsets[(k >> shift) & 0xff]++] = k;
+        }
+        keys->swap(tmp);
+    }
+}
+
+SkPackedRTree::Level& SkPackedRTree::appendLevel(int count) {
+    const int offset = (int)fLefts.size();
+    const size_t padded = offset + (size_t)(count + kFanout - 1) / kFanout * kFanout;
+    fLefts  .resize(padded,  kInf);
+    fTops   .resize(padded,  kInf);
+    fRights .resize(padded, -kInf);
+    fBottoms.resize(padded, -kInf);
+    fLevels.push_back({offset, count});
+    return fLevels.back();
+}
+
+void SkPackedRTree::insert(const SkRect boundsArray[], int N) {
+    SkASSERT(fLevels.empty());
+
+    // Sort the non-empty rects by the Hilbert index of their centers, breaking ties by op index.
+    SkRect total = {kInf, kInf, -kInf, -kInf};
+    int count = 0;
+    for (int i = 0; i < N; i++) {
+        const SkRect& r = boundsArray[i];
+        if (!r.isEmpty()) {
+            total = {std::min(total.fLeft,  r.fLeft ), std::min(total.fTop,    r.fTop   ),
+                     std::max(total.fRight, r.fRight), std::max(total.fBottom, r.fBottom)};
+            count++;
+        }
+    }
+    if (count == 0) {
+        return;
+    }
+
+    // Scale both axes alike, so that nodes group rects into squarish regions even on tall pages.
+    const float extent = std::max(total.width(), total.height()),
+                scale  = extent > 0 ? 65535 / extent : 0;
+    std::vector<uint64_t> keys;
+    keys.reserve(count);
+    for (int i = 0; i < N; i++) {
+        const SkRect& r = boundsArray[i];
+        if (!r.isEmpty()) {
+            uint32_t h = hilbert_index(to_grid((r.centerX() - total.fLeft) * scale),
+                                       to_grid((r.centerY() - total.fTop ) * scale));
+            keys.push_back((uint64_t)h << 32 | (uint32_t)i);
+        }
+    }
+    radix_sort_high32(&keys);
+
+    fOps.resize(count);
+    appendLevel(count);
+    for (int i = 0; i < count; i++) {
+        const int op = (int)(keys[i] & 0xffffffff);
+        fOps[i]     = op;
+        fLefts[i]   = boundsArray[op].fLeft;
+        fTops[i]    = boundsArray[op].fTop;
+        fRights[i]  = boundsArray[op].fRight;
+        fBottoms[i] = boundsArray[op].fBottom;
+    }
+
+    // Each entry of the next level up bounds one whole node of the level below.
+    while (fLevels.back().fCount > kFanout) {
+        const Level child = fLevels.back();
+        const Level& parent = appendLevel((child.fCount + kFanout - 1) / kFanout);
+        for (int i = 0; i < parent.fCount; i++) {
+            const int base = child.fOffset + i * kFanout;
+            fLefts  [parent.fOffset + i] = min(F::Load(fLefts  .data() + base));
+            fTops   [parent.fOffset + i] = min(F::Load(fTops   .data() + base));
+            fRights [parent.fOffset + i] = max(F::Load(fRights .data() + base));
+            fBottoms[parent.fOffset + i] = max(F::Load(fBottoms.data() + base));
+        }
+    }
+    SkASSERT((int)fLevels.size() <= kMaxDepth);
+}
+
+void SkPackedRTree::search(const SkRect& query, std::vector<int>* results) const {
+    // An empty query intersects nothing, matching SkRect::Intersects().
+    if (fLevels.empty() || !(query.fLeft < query.fRight && query.fTop < query.fBottom)) {
+        return;
+    }
+    const size_t start = results->size();
+
+    // Nodes still to visit, as (level, index of the node within that level).  Each visit pops
+    // one node and pushes at most kFanout children a level down, bounding the stack's depth.
+    struct Node { int fLevel, fIndex; };
+    Node stack[kMaxDepth * (kFanout - 1) + 1];
+    int depth = 0;
+    stack[depth++] = {(int)fLevels.size() - 1, 0};
+
+    const F ql = query.fLeft, qt = query.fTop, qr = query.fRight, qb = query.fBottom;
+    while (depth > 0) {
+        const Node node = stack[--depth];
+        const int base = fLevels[node.fLevel].fOffset + node.fIndex * kFanout;
+        const auto hit = (F::Load(fLefts  .data() + base) < qr) &
+                         (F::Load(fTops   .data() + base) < qb) &
+                         (F::Load(fRights .data() + base) > ql) &
+                         (F::Load(fBottoms.data() + base) > qt);
+        if (!any(hit)) {
+            continue;
+        }
+        if (node.fLevel == 0) {
+            for (int i = 0; i < kFanout; i++) {
+                if (hit[i]) {
+                    results->push_back(fOps[base + i]);
+                }
+            }
+        } else {
+            // Push in reverse so children are visited in order, reading the arrays front to back.
+            for (int i = kFanout - 1; i >= 0; i--) {
+                if (hit[i]) {
+                    stack[depth++] = {node.fLevel - 1, node.fIndex * kFanout + i};
+                }
+            }
+        }
+    }
+
+    // The Hilbert sort reordered ops, but callers replay them in record order.  Hits inside one
+    // region of a picture usually span a narrow range of ops, so when that range is small
+    // relative to the number of hits, mark them in a bitset over it instead of sorting.
+    int* hits = results->data() + start;
+    const int count = (int)(results->size() - start);
+    if (count < 2) {
+        return;
+    }
+    const auto [lo, hi] = std::minmax_element(hits, hits + count);
+    const int first = *lo;
+    const size_t words = ((size_t)(*hi - first) >> 5) + 1;
+    if (words > (size_t)count * 4) {
+        std::sort(hits, hits + count);
+        return;
+    }
+    SkAutoSTMalloc<128, uint32_t> bits(words);
+    sk_bzero(bits.get(), words * sizeof(uint32_t));
+    for (int i = 0; i < count; i++) {
+        const int bit = hits[i] - first;
+        bits[bit >> 5] |= 1u << (bit & 31);
+    }
+    for (size_t w = 0; w < words; w++) {
+        for (uint32_t word = bits[w]; word; word &= word - 1) {
+            *hits++ = first + (int)(w << 5) + SkCTZ(word);
+        }
+    }
+}
+
+size_t SkPackedRTree::bytesUsed() const {
+    size_t byteCount = sizeof(SkPackedRTree);
+
+    byteCount += (fLefts.capacity() + fTops.capacity() + fRights.capacity() +
+                  fBottoms.capacity()) * sizeof(float);
+    byteCount += fOps.capacity() * sizeof(int);
+    byteCount += fLevels.capacity() * sizeof(Level);
+
+    return byteCount;
+}
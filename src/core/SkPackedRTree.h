@@ -0,0 +1,69 @@
+/*
+ * Copyright 2021 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkPackedRTree_DEFINED
+#define SkPackedRTree_DEFINED
+
+#include "include/core/SkBBHFactory.h"
+#include "include/core/SkRect.h"
+
+#include <vector>
+
+/**
+ * An R-Tree laid out flat for fast queries over very large pictures.
+ *
+ * Like SkRTree it only supports bulk-loading, but rather than trusting the caller's order it
+ * sorts the bounding rectangles along a Hilbert curve through their centers, then packs them
+ * bottom-up into full nodes of kFanout children. Because every node is full, the tree is
+ * implicit: the children of entry i at one level are entries [i*kFanout, (i+1)*kFanout) of the
+ * level below, so no child pointers are stored. Each level keeps its bounds as four parallel
+ * arrays (lefts, tops, rights, bottoms), letting search() test all of a node's children with a
+ * few vector compares while walking the tree iteratively.
+ *
+ * search() returns op indices in increasing order, as SkRTree does for in-order input.
+ *
+ * For more details see:
+ *
+ *  Kamel, I.; Faloutsos, C. (1994). "Hilbert R-tree: An improved R-tree using fractals"
+ */
+class SkPackedRTree : public SkBBoxHierarchy {
+public:
+    SkPackedRTree() = default;
+
+    void insert(const SkRect[], int N) override;
+    void search(const SkRect& query, std::vector<int>* results) const override;
+    size_t bytesUsed() const override;
+
+    // Methods and constants below here are only public for tests.
+
+    // Return the depth of the tree structure.
+    int getDepth() const { return (int)fLevels.size(); }
+    // Insertion count of non-empty rectangles.
+    int getCount() const { return fLevels.empty() ? 0 : fLevels[0].fCount; }
+
+    // Children per node: one 16-wide compare per bound covers a whole node.
+    static constexpr int kFanout = 16;
+    // kFanout^8 exceeds any int count of rectangles.
+    static constexpr int kMaxDepth = 8;
+
+private:
+    struct Level {
+        int fOffset;  // Index of this level's first entry in the bounds arrays.
+        int fCount;   // Entries in this level, not counting padding up to a multiple of kFanout.
+    };
+
+    // Append an empty level of count entries, with its padding bounds set to never intersect.
+    Level& appendLevel(int count);
+
+    // Bounds of every level's entries, leaves first; each level is padded to whole nodes.
+    std::vector<float> fLefts, fTops, fRights, fBottoms;
+    // The op index of each leaf entry.
+    std::vector<int>   fOps;
+    std::vector<Level> fLevels;
+};
+
+#endif
@@ -6,11 +6,16 @@
  */
 
 #include "include/core/SkBBHFactory.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkImage.h"
 #include "src/core/SkCanvasPriv.h"
+#include "src/core/SkMatrixPriv.h"
 #include "src/core/SkRecordDraw.h"
+#include "src/core/SkTaskGroup.h"
 #include "src/utils/SkPatchUtils.h"
 
+#include <vector>
+
 void SkRecordDraw(const SkRecord& record,
                   SkCanvas* canvas,
                   SkPicture const* const drawablePicts[],
@@ -69,6 +74,86 @@ void SkRecordPartialDraw(const SkRecord& record, SkCanvas* canvas,
     }
 }
 
+namespace {
+// How each op changes the canvas' save count.
+struct SaveCountDelta {
+    template <typename T> int operator()(const T&) { return 0; }
+    int operator()(const SkRecords::Save&)       { return +1; }
+    int operator()(const SkRecords::SaveLayer&)  { return +1; }
+    int operator()(const SkRecords::SaveBehind&) { return +1; }
+    int operator()(const SkRecords::Restore&)    { return -1; }
+};
+}  // namespace
+
+// Finds the control ops whose effect on the canvas outlives the record: Saves it leaves open, and
+// matrix and clip changes not undone by one of its Restores.
+// Every canvas must replay these, whatever their bounds, to end up in the same state.
+static std::vector<bool> find_lasting_ops(const SkRecord& record,
+                                          const SkBBoxHierarchy::Metadata meta[]) {
+    // The Save whose block each op belongs to (a Save or Restore belongs to its own), or -1.
+    std::vector<int> block(record.count(), -1);
+    std::vector<int> openSaves;
+    for (int i = 0; i < record.count(); i++) {
+        int delta = record.visit(i, SaveCountDelta());
+        if (delta > 0) {
+            block[i] = i;
+            openSaves.push_back(i);
+        } else if (delta < 0) {
+            SkASSERT(!openSaves.empty());
+            block[i] = openSaves.back();
+            openSaves.pop_back();
+        } else if (!openSaves.empty()) {
+            block[i] = openSaves.back();
+        }
+    }
+
+    std::vector<bool> stillOpen(record.count(), false);
+    for (int save : openSaves) {
+        stillOpen[save] = true;
+    }
+    std::vector<bool> lasting(record.count(), false);
+    for (int i = 0; i < record.count(); i++) {
+        lasting[i] = !meta[i].isDraw && (block[i] < 0 || stillOpen[block[i]]);
+    }
+    return lasting;
+}
+
+void SkRecordDrawThreaded(const SkRecord& record, const SkRect& cullRect,
+                          SkCanvas* const canvases[], const SkIRect tileBounds[],
+                          int canvasCount,
+                          SkPicture const* const drawablePicts[], int drawableCount,
+                          const SkM44& initialCTM, SkExecutor* executor) {
+    SkAutoTMalloc<SkRect> bounds(record.count());
+    SkAutoTMalloc<SkBBoxHierarchy::Metadata> meta(record.count());
+    SkRecordFillBounds(cullRect, record, bounds, meta);
+    const std::vector<bool> lasting = find_lasting_ops(record, meta);
+
+    SkM44 inverseCTM;
+    const bool invertible = initialCTM.invert(&inverseCTM);
+
+    SkTaskGroup(executor ? *executor : SkExecutor::GetDefault())
+            .batch(canvasCount, [&](int c) {
+        SkCanvas* canvas = canvases[c];
+
+        // Like SkRecordDraw() with a BBH, query with the canvas' tile in the record's space,
+        // outset by a pixel for antialiasing.
+        const SkIRect tile = tileBounds ? tileBounds[c] : canvas->getDeviceClipBounds();
+        SkRect query = SkRect::Make(tile).makeOutset(1, 1);
+        if (!invertible) {
+            query = cullRect;
+        } else if (!initialCTM.asM33().isIdentity()) {
+            query = SkMatrixPriv::MapRect(inverseCTM, query);
+        }
+
+        SkRecords::Draw draw(canvas, drawablePicts, nullptr, drawableCount, &initialCTM);
+        for (int i = 0; i < record.count(); i++) {
+            if (lasting[i] || SkRect::Intersects(bounds[i], query)) {
+                record.visit(i, draw);
+            }
+        }
+    });
+}
+
 namespace SkRecords {
 
 // NoOps draw nothing.
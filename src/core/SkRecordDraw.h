@@ -15,6 +15,7 @@
 #include "src/core/SkRecord.h"
 
 class SkDrawable;
+class SkExecutor;
 class SkLayerInfo;
 
 // Calculate conservative identity space bounds for each op in the record.
@@ -41,6 +42,18 @@ void SkRecordPartialDraw(const SkRecord&, SkCanvas*,
                          SkPicture const* const drawablePicts[], int drawableCount,
                          int start, int stop, const SkM44& initialCTM);
 
+// Draw an SkRecord into several canvases at once, concurrently on an SkExecutor (or the default
+// executor if null), typically one canvas per tile of a raster device.  Each canvas replays only
+// the ops whose bounds (see SkRecordFillBounds()) touch its tile, plus the ops whose matrix, clip,
+// or save state outlives the record, which all canvases need.  A canvas' tile is its entry in
+// tileBounds, in device space, or its clip if tileBounds is null.  The record must not restore
+// more than it saves.  As in SkRecordPartialDraw(), initialCTM must be the matrix each canvas had
+// when the record began; the canvases are left in whatever state the record leaves them.
+void SkRecordDrawThreaded(const SkRecord&, const SkRect& cullRect,
+                          SkCanvas* const canvases[], const SkIRect tileBounds[], int canvasCount,
+                          SkPicture const* const drawablePicts[], int drawableCount,
+                          const SkM44& initialCTM, SkExecutor*);
+
 namespace SkRecords {
 
 // This is an SkRecord visitor that will draw that SkRecord to an SkCanvas.
@@ -79,6 +79,13 @@ void SkRecorder::reset(SkRecord* record, const SkRect& bounds, SkMiniRecorder* m
     fMiniRecorder = mr;
 }
 
+void SkRecorder::continueRecording(SkRecord* record) {
+    SkASSERT(!fMiniRecorder);
+    fDrawableList.reset(nullptr);
+    fApproxBytesUsedBySubPictures = 0;
+    fRecord = record;
+}
+
 void SkRecorder::forgetRecord() {
     fDrawableList.reset(nullptr);
     fApproxBytesUsedBySubPictures = 0;
@@ -91,6 +98,10 @@ void SkRecorder::append(Args&&... args) {
     if (fMiniRecorder) {
         this->flushMiniRecorder();
     }
+    if (T::kTags & SkRecords::kDraw_Tag) {
+        // A surface that hands out a recording canvas must invalidate its cached snapshot.
+        this->predrawNotify();
+    }
     new (fRecord->append<T>()) T{std::forward<Args>(args)...};
 }
 
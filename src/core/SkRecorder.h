@@ -37,7 +37,7 @@ private:
 
 // SkRecorder provides an SkCanvas interface for recording into an SkRecord.
 
-class SkRecorder final : public SkCanvasVirtualEnforcer<SkNoDrawCanvas> {
+class SkRecorder : public SkCanvasVirtualEnforcer<SkNoDrawCanvas> {
 public:
     // Does not take ownership of the SkRecord.
     SkRecorder(SkRecord*, int width, int height, SkMiniRecorder* = nullptr);   // TODO: remove
@@ -53,6 +53,10 @@ public:
     // Make SkRecorder forget entirely about its SkRecord*; all calls to SkRecorder will fail.
     void forgetRecord();
 
+    // Continue recording into a new SkRecord without resetting the canvas matrix, clip,
+    // or save stack.  Does not take ownership of the SkRecord.
+    void continueRecording(SkRecord*);
+
     void onFlush() override;
 
     void willSave() override;
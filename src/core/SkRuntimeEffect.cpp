@@ -5,8 +5,10 @@
  * found in the LICENSE file.
  */
 
+#include "include/core/SkCanvas.h"
 #include "include/core/SkColorFilter.h"
 #include "include/core/SkData.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkSurface.h"
 #include "include/effects/SkRuntimeEffect.h"
 #include "include/private/SkChecksum.h"
@@ -1069,6 +1071,42 @@ sk_sp<SkColorFilter> SkRuntimeEffect::makeColorFilter(sk_sp<SkData> uniforms) co
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
+static void precompile(const SkRuntimeEffect::PrecompileTarget& target) {
+    // The simplest way to build exactly the programs a real draw will want is to draw for real,
+    // through the same blitter selection, into a tiny surface of the same kind.
+    sk_sp<SkSurface> surface = SkSurface::MakeRaster(target.info.makeWH(4, 4));
+    if (!surface) {
+        return;
+    }
+    SkCanvas* canvas = surface->getCanvas();
+
+    // An aliased draw fills whole spans...
+    canvas->save();
+    canvas->setMatrix(target.ctm);
+    canvas->drawPaint(target.paint);
+    canvas->restore();
+
+    // ... while an anti-aliased clip (in device space) gives us partially covered spans.
+    canvas->save();
+    canvas->clipRect(SkRect::MakeLTRB(0.5f, 0.5f, 3.5f, 3.5f), /*doAntiAlias=*/true);
+    canvas->setMatrix(target.ctm);
+    canvas->drawPaint(target.paint);
+    canvas->restore();
+}
+
+void SkRuntimeEffect::Precompile(const PrecompileTarget targets[], size_t count,
+                                 SkExecutor* executor) {
+    for (size_t i = 0; i < count; i++) {
+        if (executor) {
+            executor->add([target = targets[i]] { precompile(target); });
+        } else {
+            precompile(targets[i]);
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
 void SkRuntimeEffect::RegisterFlattenables() {
     SK_REGISTER_FLATTENABLE(SkRuntimeColorFilter);
     SK_REGISTER_FLATTENABLE(SkRTShader);
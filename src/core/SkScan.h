@@ -13,6 +13,7 @@
 #include "include/private/SkFixed.h"
 #include <atomic>
 
+class SkExecutor;
 class SkRasterClip;
 class SkRegion;
 class SkBlitter;
@@ -51,6 +52,13 @@ public:
     static void AntiFillXRect(const SkXRect&, const SkRasterClip&, SkBlitter*);
     static void FillPath(const SkPath&, const SkRasterClip&, SkBlitter*);
     static void AntiFillPath(const SkPath&, const SkRasterClip&, SkBlitter*);
+    // Like AntiFillPath(), but accumulating signed area into sparse rows of coverage.
+    static void SparseAntiFillPath(const SkPath&, const SkRasterClip&, SkBlitter*);
+    // Like AntiFillPath(), but always with analytic AA.  If bandExecutor is not null, paths with
+    // many points are rasterized in horizontal bands on it.  Bands start their edges afresh, so
+    // coverage may differ from a single pass by a fraction of a step, or more where edges cross.
+    static void AnalyticAntiFillPath(const SkPath&, const SkRasterClip&, SkBlitter*,
+                                     SkExecutor* bandExecutor = nullptr);
     static void FrameRect(const SkRect&, const SkPoint& strokeSize,
                           const SkRasterClip&, SkBlitter*);
     static void AntiFrameRect(const SkRect&, const SkPoint& strokeSize,
@@ -79,7 +87,9 @@ private:
     static void FillRect(const SkRect&, const SkRegion* clip, SkBlitter*);
     static void AntiFillRect(const SkRect&, const SkRegion* clip, SkBlitter*);
     static void AntiFillXRect(const SkXRect&, const SkRegion*, SkBlitter*);
-    static void AntiFillPath(const SkPath&, const SkRegion& clip, SkBlitter*, bool forceRLE);
+    enum class AntiFill { kDefault, kAnalytic, kSparse };
+    static void AntiFillPath(const SkPath&, const SkRegion& clip, SkBlitter*, bool forceRLE,
+                             AntiFill = AntiFill::kDefault, SkExecutor* bandExecutor = nullptr);
     static void FillTriangle(const SkPoint pts[], const SkRegion*, SkBlitter*);
 
     static void AntiFrameRect(const SkRect&, const SkPoint& strokeSize,
@@ -87,9 +97,12 @@ private:
     static void HairLineRgn(const SkPoint[], int count, const SkRegion*, SkBlitter*);
     static void AntiHairLineRgn(const SkPoint[], int count, const SkRegion*, SkBlitter*);
     static void AAAFillPath(const SkPath& path, SkBlitter* blitter, const SkIRect& pathIR,
-                            const SkIRect& clipBounds, bool forceRLE);
+                            const SkIRect& clipBounds, bool forceRLE,
+                            SkExecutor* bandExecutor = nullptr);
     static void SAAFillPath(const SkPath& path, SkBlitter* blitter, const SkIRect& pathIR,
                             const SkIRect& clipBounds, bool forceRLE);
+    static void SparseFillPath(const SkPath& path, SkBlitter* blitter, const SkIRect& pathIR,
+                               const SkIRect& clipBounds);
 };
 
 /** Assign an SkXRect from a SkIRect, by promoting the src rect's coordinates
@@ -11,6 +11,7 @@
 #include "include/private/SkTo.h"
 #include "src/core/SkAnalyticEdge.h"
 #include "src/core/SkAntiRun.h"
+#include "src/core/SkArenaAlloc.h"
 #include "src/core/SkAutoMalloc.h"
 #include "src/core/SkBlitter.h"
 #include "src/core/SkEdge.h"
@@ -21,11 +22,15 @@
 #include "src/core/SkScan.h"
 #include "src/core/SkScanPriv.h"
 #include "src/core/SkTSort.h"
+#include "src/core/SkTaskGroup.h"
 
+#include <algorithm>
 #include <utility>
+#include <vector>
 
 #if defined(SK_DISABLE_AAA)
-void SkScan::AAAFillPath(const SkPath&, SkBlitter*, const SkIRect&, const SkIRect&, bool) {
+void SkScan::AAAFillPath(const SkPath&, SkBlitter*, const SkIRect&, const SkIRect&, bool,
+                         SkExecutor*) {
     SkDEBUGFAIL("AAA Disabled");
     return;
 }
@@ -1554,7 +1559,8 @@ static void aaa_walk_edges(SkAnalyticEdge*  prevHead,
                            bool             isUsingMask,
                            bool             forceRLE,
                            bool             useDeferred,
-                           bool             skipIntersect) {
+                           bool             skipIntersect,
+                           bool             isBand) {
     prevHead->fX = prevHead->fUpperX = leftClip;
     nextTail->fX = nextTail->fUpperX = rightClip;
     SkFixed y                        = std::max(prevHead->fNext->fUpperY, SkIntToFixed(start_y));
@@ -1565,6 +1571,10 @@ static void aaa_walk_edges(SkAnalyticEdge*  prevHead,
         for (edge = prevHead->fNext; edge->fUpperY <= y; edge = edge->fNext) {
             edge->goY(y);
             update_next_next_y(edge->fLowerY, y, &nextNextY);
+            // A band's edges may already cross in its first row, as the walk above would know.
+            if (isBand && !skipIntersect) {
+                check_intersection(edge, y, &nextNextY);
+            }
         }
         update_next_next_y(edge->fUpperY, y, &nextNextY);
     }
@@ -1837,6 +1847,82 @@ static void aaa_walk_edges(SkAnalyticEdge*  prevHead,
     }
 }
 
+// Links the edges sorted from edge to last between the sentinels headEdge and tailEdge.
+static void link_sorted_edges(SkAnalyticEdge* headEdge,
+                              SkAnalyticEdge* tailEdge,
+                              SkAnalyticEdge* edge,
+                              SkAnalyticEdge* last) {
+    headEdge->fRiteE  = nullptr;
+    headEdge->fPrev   = nullptr;
+    headEdge->fNext   = edge;
+    headEdge->fUpperY = headEdge->fLowerY = SK_MinS32;
+    headEdge->fX                          = SK_MinS32;
+    headEdge->fDX                         = 0;
+    headEdge->fDY                         = SK_MaxS32;
+    headEdge->fUpperX                     = SK_MinS32;
+    edge->fPrev                           = headEdge;
+
+    tailEdge->fRiteE  = nullptr;
+    tailEdge->fPrev   = last;
+    tailEdge->fNext   = nullptr;
+    tailEdge->fUpperY = tailEdge->fLowerY = SK_MaxS32;
+    tailEdge->fX                          = SK_MaxS32;
+    tailEdge->fDX                         = 0;
+    tailEdge->fDY                         = SK_MaxS32;
+    tailEdge->fUpperX                     = SK_MaxS32;
+    last->fNext                           = tailEdge;
+}
+
+// Walks the count edges sorted from edge to last between start_y and stop_y.
+static void aaa_walk_sorted_edges(const SkPath&    path,
+                                  SkAnalyticEdge*  edge,
+                                  SkAnalyticEdge*  last,
+                                  int              count,
+                                  const SkIRect&   clipRect,
+                                  AdditiveBlitter* blitter,
+                                  int              start_y,
+                                  int              stop_y,
+                                  bool             isUsingMask,
+                                  bool             forceRLE,
+                                  bool             useDeferred,
+                                  bool             skipIntersect,
+                                  bool             isBand = false) {
+    SkAnalyticEdge headEdge, tailEdge;
+    link_sorted_edges(&headEdge, &tailEdge, edge, last);
+
+    // now edge is the head of the sorted linklist
+
+    SkFixed leftBound  = SkIntToFixed(clipRect.fLeft);
+    SkFixed rightBound = SkIntToFixed(clipRect.fRight);
+    if (isUsingMask) {
+        // If we're using mask, then we have to limit the bound within the path bounds.
+        // Otherwise, the edge drift may access an invalid address inside the mask.
+        SkIRect ir;
+        path.getBounds().roundOut(&ir);
+        leftBound  = std::max(leftBound, SkIntToFixed(ir.fLeft));
+        rightBound = std::min(rightBound, SkIntToFixed(ir.fRight));
+    }
+
+    if (!path.isInverseFillType() && path.isConvex() && count >= 2) {
+        aaa_walk_convex_edges(
+                &headEdge, blitter, start_y, stop_y, leftBound, rightBound, isUsingMask);
+    } else {
+        aaa_walk_edges(&headEdge,
+                       &tailEdge,
+                       path.getFillType(),
+                       blitter,
+                       start_y,
+                       stop_y,
+                       leftBound,
+                       rightBound,
+                       isUsingMask,
+                       forceRLE,
+                       useDeferred,
+                       skipIntersect,
+                       isBand);
+    }
+}
+
 static SK_ALWAYS_INLINE void aaa_fill_path(
         const SkPath&    path,
         const SkIRect&   clipRect,
@@ -1875,32 +1961,10 @@ static SK_ALWAYS_INLINE void aaa_fill_path(
         return;
     }
 
-    SkAnalyticEdge headEdge, tailEdge, *last;
+    SkAnalyticEdge* last;
     // this returns the first and last edge after they're sorted into a dlink list
     SkAnalyticEdge* edge = sort_edges(list, count, &last);
 
-    headEdge.fRiteE  = nullptr;
-    headEdge.fPrev   = nullptr;
-    headEdge.fNext   = edge;
-    headEdge.fUpperY = headEdge.fLowerY = SK_MinS32;
-    headEdge.fX                         = SK_MinS32;
-    headEdge.fDX                        = 0;
-    headEdge.fDY                        = SK_MaxS32;
-    headEdge.fUpperX                    = SK_MinS32;
-    edge->fPrev                         = &headEdge;
-
-    tailEdge.fRiteE  = nullptr;
-    tailEdge.fPrev   = last;
-    tailEdge.fNext   = nullptr;
-    tailEdge.fUpperY = tailEdge.fLowerY = SK_MaxS32;
-    tailEdge.fX                         = SK_MaxS32;
-    tailEdge.fDX                        = 0;
-    tailEdge.fDY                        = SK_MaxS32;
-    tailEdge.fUpperX                    = SK_MaxS32;
-    last->fNext                         = &tailEdge;
-
-    // now edge is the head of the sorted linklist
-
     if (!pathContainedInClip && start_y < clipRect.fTop) {
         start_y = clipRect.fTop;
     }
@@ -1908,42 +1972,244 @@ static SK_ALWAYS_INLINE void aaa_fill_path(
         stop_y = clipRect.fBottom;
     }
 
-    SkFixed leftBound  = SkIntToFixed(rect.fLeft);
-    SkFixed rightBound = SkIntToFixed(rect.fRight);
-    if (isUsingMask) {
-        // If we're using mask, then we have to limit the bound within the path bounds.
-        // Otherwise, the edge drift may access an invalid address inside the mask.
-        SkIRect ir;
-        path.getBounds().roundOut(&ir);
-        leftBound  = std::max(leftBound, SkIntToFixed(ir.fLeft));
-        rightBound = std::min(rightBound, SkIntToFixed(ir.fRight));
+    // Only use deferred blitting if there are many edges.
+    bool useDeferred = count > (SkFixedFloorToInt(last->fLowerY - edge->fUpperY) + 1) * 4;
+
+    // We skip intersection computation if there are many points which probably already
+    // give us enough fractional scan lines.
+    bool skipIntersect = path.countPoints() > (stop_y - start_y) * 2;
+
+    aaa_walk_sorted_edges(path, edge, last, count, clipRect, blitter, start_y, stop_y,
+                          isUsingMask, forceRLE, useDeferred, skipIntersect);
+}
+
+// Records what one band of a banded fill blits, so the bands can be rasterized in parallel and
+// then replayed into the real blitter in order on the calling thread.
+class BandRecorder : public SkBlitter {
+public:
+    void blitH(int x, int y, int width) override {
+        fOps.push_back({Op::kH, 0, 0, x, y, width, 1});
     }
 
-    if (!path.isInverseFillType() && path.isConvex() && count >= 2) {
-        aaa_walk_convex_edges(
-                &headEdge, blitter, start_y, stop_y, leftBound, rightBound, isUsingMask);
-    } else {
-        // Only use deferred blitting if there are many edges.
-        bool useDeferred =
-                count >
-                (SkFixedFloorToInt(tailEdge.fPrev->fLowerY - headEdge.fNext->fUpperY) + 1) * 4;
+    void blitAntiH(int x, int y, const SkAlpha antialias[], const int16_t runs[]) override {
+        int count = 0, width = 0;
+        for (int n; (n = runs[width]) > 0; width += n, count++) {
+            fRuns.push_back(SkToS16(n));
+            fAlphas.push_back(antialias[width]);
+        }
+        fOps.push_back({Op::kAntiH, 0, 0, x, y, count, 1});
+        fMaxRunsWidth = std::max(fMaxRunsWidth, width);
+    }
+
+    void blitAntiH2(int x, int y, U8CPU a0, U8CPU a1) override {
+        fOps.push_back({Op::kAntiH2, SkToU8(a0), SkToU8(a1), x, y, 2, 1});
+    }
 
-        // We skip intersection computation if there are many points which probably already
-        // give us enough fractional scan lines.
-        bool skipIntersect = path.countPoints() > (stop_y - start_y) * 2;
+    void blitV(int x, int y, int height, SkAlpha alpha) override {
+        fOps.push_back({Op::kV, alpha, 0, x, y, 1, height});
+    }
 
-        aaa_walk_edges(&headEdge,
-                       &tailEdge,
-                       path.getFillType(),
-                       blitter,
-                       start_y,
-                       stop_y,
-                       leftBound,
-                       rightBound,
-                       isUsingMask,
-                       forceRLE,
-                       useDeferred,
-                       skipIntersect);
+    void blitRect(int x, int y, int width, int height) override {
+        fOps.push_back({Op::kRect, 0, 0, x, y, width, height});
+    }
+
+    void blitAntiRect(int x, int y, int width, int height, SkAlpha leftAlpha,
+                      SkAlpha rightAlpha) override {
+        fOps.push_back({Op::kAntiRect, leftAlpha, rightAlpha, x, y, width, height});
+    }
+
+    void replay(SkBlitter* blitter) const {
+        // Real blitters may break up the runs they're handed, so replay each row from scratch.
+        SkAutoTMalloc<int16_t> runs(fMaxRunsWidth + 1);
+        SkAutoTMalloc<SkAlpha> alphas(fMaxRunsWidth + 1);
+        const int16_t* srcRuns   = fRuns.data();
+        const SkAlpha* srcAlphas = fAlphas.data();
+        for (const Op& op : fOps) {
+            switch (op.fKind) {
+                case Op::kH:        blitter->blitH(op.fX, op.fY, op.fW);               break;
+                case Op::kAntiH2:   blitter->blitAntiH2(op.fX, op.fY, op.fA0, op.fA1); break;
+                case Op::kV:        blitter->blitV(op.fX, op.fY, op.fH, op.fA0);       break;
+                case Op::kRect:     blitter->blitRect(op.fX, op.fY, op.fW, op.fH);     break;
+                case Op::kAntiRect:
+                    blitter->blitAntiRect(op.fX, op.fY, op.fW, op.fH, op.fA0, op.fA1);
+                    break;
+                case Op::kAntiH: {
+                    int x = 0;
+                    for (int i = 0; i < op.fW; i++) {
+                        runs[x]   = srcRuns[i];
+                        alphas[x] = srcAlphas[i];
+                        x += srcRuns[i];
+                    }
+                    runs[x] = 0;
+                    srcRuns   += op.fW;
+                    srcAlphas += op.fW;
+                    blitter->blitAntiH(op.fX, op.fY, alphas.get(), runs.get());
+                } break;
+            }
+        }
+    }
+
+private:
+    struct Op {
+        enum Kind : uint8_t { kH, kAntiH, kAntiH2, kV, kRect, kAntiRect } fKind;
+        SkAlpha fA0, fA1;
+        int     fX, fY, fW, fH;  // fW counts the runs of a kAntiH.
+    };
+
+    std::vector<Op>      fOps;
+    std::vector<int16_t> fRuns;
+    std::vector<SkAlpha> fAlphas;
+    int                  fMaxRunsWidth = 0;
+};
+
+// Banding pays off once the edge walk dominates.  Convex paths are walked two edges at a time, so
+// there's little to split among bands.
+static constexpr int kMinBandedPoints = 1024;
+static constexpr int kMinBandRows     = 32;
+static constexpr int kMaxBands        = 16;
+
+static int aaa_band_count(const SkPath& path, const SkIRect& bounds) {
+    if (path.isConvex() || path.countPoints() < kMinBandedPoints) {
+        return 1;
+    }
+    return std::min(bounds.height() / kMinBandRows, kMaxBands);
+}
+
+// The last y an edge reaches, through the lines of a curve not yet stepped to.
+static SkFixed edge_last_y(const SkAnalyticEdge* edge) {
+    if (edge->fCurveCount < 0) {
+        return ((const SkAnalyticCubicEdge*)edge)->fCEdge.fCLastY;
+    }
+    if (edge->fCurveCount > 0) {
+        return ((const SkAnalyticQuadraticEdge*)edge)->fQEdge.fQLastY;
+    }
+    return edge->fLowerY;
+}
+
+// Fill rows [top, bottom) of a non-inverse path from the edges reaching into them, which are shared
+// by all the bands.  The band copies those edges and steps the ones starting above down to top, so
+// its walk sees the same edges as the walk of the whole path does in those rows.  It doesn't see
+// how that walk stepped them, though, so coverage may differ from one pass near the band's top.
+static void aaa_fill_band(const SkPath&                       path,
+                          const std::vector<SkAnalyticEdge*>& edges,
+                          const SkIRect&                      clipRect,
+                          AdditiveBlitter*                    blitter,
+                          int                                 top,
+                          int                                 bottom,
+                          bool                                useDeferred,
+                          bool                                skipIntersect) {
+    const SkFixed topY = SkIntToFixed(top);
+
+    SkSTArenaAlloc<4096>         alloc;
+    std::vector<SkAnalyticEdge*> list;
+    list.reserve(edges.size());
+    for (const SkAnalyticEdge* src : edges) {
+        SkAnalyticEdge* edge;
+        if (src->fCurveCount < 0) {
+            edge = alloc.make<SkAnalyticCubicEdge>(*(const SkAnalyticCubicEdge*)src);
+        } else if (src->fCurveCount > 0) {
+            edge = alloc.make<SkAnalyticQuadraticEdge>(*(const SkAnalyticQuadraticEdge*)src);
+        } else {
+            edge = alloc.make<SkAnalyticEdge>(*src);
+        }
+
+        // Step curves through their lines as the walk does, each line continuing the last.
+        bool live = true;
+        while (live && edge->fLowerY <= topY) {
+            edge->goY(edge->fLowerY);
+            if (edge->fCurveCount < 0) {
+                SkAnalyticCubicEdge* cubicEdge = (SkAnalyticCubicEdge*)edge;
+                cubicEdge->keepContinuous();
+                live = cubicEdge->updateCubic();
+            } else if (edge->fCurveCount > 0) {
+                SkAnalyticQuadraticEdge* quadEdge = (SkAnalyticQuadraticEdge*)edge;
+                quadEdge->keepContinuous();
+                live = quadEdge->updateQuadratic();
+            } else {
+                live = false;
+            }
+        }
+        if (!live) {
+            continue;
+        }
+        if (edge->fUpperY < topY) {
+            edge->goY(topY);
+            edge->fUpperX = edge->fX;
+            edge->fUpperY = topY;
+        }
+        list.push_back(edge);
+    }
+    if (list.empty()) {
+        return;
+    }
+
+    SkAnalyticEdge* last;
+    SkAnalyticEdge* edge = sort_edges(list.data(), SkToInt(list.size()), &last);
+    aaa_walk_sorted_edges(path, edge, last, SkToInt(list.size()), clipRect, blitter, top, bottom,
+                          false, false, useDeferred, skipIntersect, true);
+}
+
+// Fill a non-inverse, non-convex path as horizontal bands of bounds, on executor.  The path's edges
+// are built and sorted once and bucketed by the bands they reach into.  Each band then walks its
+// own bucket independently with its own additive blitter, and the bands are replayed in order.
+static void aaa_fill_path_in_bands(const SkPath&  path,
+                                   SkBlitter*     blitter,
+                                   const SkIRect& ir,
+                                   const SkIRect& clipBounds,
+                                   const SkIRect& bounds,
+                                   int            bands,
+                                   SkExecutor*    executor) {
+    SkASSERT(!path.isInverseFillType() && !path.isConvex() && bands > 1);
+
+    SkAnalyticEdgeBuilder builder;
+    int count = builder.buildEdges(path, clipBounds.contains(ir) ? nullptr : &clipBounds);
+    if (0 == count) {
+        return;
+    }
+    SkAnalyticEdge** list = builder.analyticEdgeList();
+    SkAnalyticEdge*  last;
+    SkAnalyticEdge*  edge = sort_edges(list, count, &last);
+
+    // As aaa_fill_path() decides for the whole path, whose rows are bounds.
+    bool useDeferred   = count > (SkFixedFloorToInt(last->fLowerY - edge->fUpperY) + 1) * 4;
+    bool skipIntersect = path.countPoints() > bounds.height() * 2;
+
+    std::vector<int> bandTops(bands + 1);
+    for (int i = 0; i <= bands; i++) {
+        bandTops[i] = bounds.fTop + (int)((int64_t)bounds.height() * i / bands);
+    }
+    auto bandOf = [&](int y) {
+        auto next = std::upper_bound(bandTops.begin() + 1, bandTops.end() - 1, y);
+        return SkToInt(next - bandTops.begin()) - 1;
+    };
+
+    // Sorting left list in order too, so each bucket is already sorted by the edges' tops.
+    std::vector<std::vector<SkAnalyticEdge*>> buckets(bands);
+    for (int i = 0; i < count; i++) {
+        int firstBand = bandOf(SkFixedFloorToInt(list[i]->fUpperY)),
+            lastBand  = bandOf(SkFixedCeilToInt(edge_last_y(list[i])) - 1);
+        for (int band = firstBand; band <= lastBand; band++) {
+            buckets[band].push_back(list[i]);
+        }
+    }
+
+    std::vector<BandRecorder> recorders(bands);
+    SkTaskGroup taskGroup(*executor);
+    for (int i = 0; i < bands; i++) {
+        if (buckets[i].empty()) {
+            continue;
+        }
+        taskGroup.add([&, i] {
+            SkIRect band = {bounds.fLeft, bandTops[i], bounds.fRight, bandTops[i + 1]};
+            SafeRLEAdditiveBlitter additiveBlitter(&recorders[i], ir, band, false);
+            aaa_fill_band(path, buckets[i], clipBounds, &additiveBlitter, band.fTop, band.fBottom,
+                          useDeferred, skipIntersect);
+        });
+    }
+    taskGroup.wait();
+
+    for (const BandRecorder& recorder : recorders) {
+        recorder.replay(blitter);
     }
 }
 
@@ -1951,7 +2217,8 @@ void SkScan::AAAFillPath(const SkPath&  path,
                          SkBlitter*     blitter,
                          const SkIRect& ir,
                          const SkIRect& clipBounds,
-                         bool           forceRLE) {
+                         bool           forceRLE,
+                         SkExecutor*    bandExecutor) {
     bool containedInClip = clipBounds.contains(ir);
     bool isInverse       = path.isInverseFillType();
 
@@ -1962,6 +2229,16 @@ void SkScan::AAAFillPath(const SkPath&  path,
     // use the forceRLE flag to force not using the mask blitter. Also, when the path is a simple
     // rect, preparing a mask and blitting it might have too much overhead. Hence we'll use
     // blitFatAntiRect to avoid the mask and its overhead.
+    //
+    // Given a bandExecutor, larger fills with many edges may be split into bands rasterized in
+    // parallel on it. A forceRLE caller (SkAAClip) builds its clip row by row, so it always gets
+    // one band.
+    SkIRect bandBounds;
+    int     bands = 1;
+    if (bandExecutor && !isInverse && !forceRLE && bandBounds.intersect(ir, clipBounds)) {
+        bands = aaa_band_count(path, bandBounds);
+    }
+
     if (MaskAdditiveBlitter::CanHandleRect(ir) && !isInverse && !forceRLE) {
         // blitFatAntiRect is slower than the normal AAA flow without MaskAdditiveBlitter.
         // Hence only tryBlitFatAntiRect when MaskAdditiveBlitter would have been used.
@@ -1976,6 +2253,8 @@ void SkScan::AAAFillPath(const SkPath&  path,
                           true,
                           forceRLE);
         }
+    } else if (bands > 1) {
+        aaa_fill_path_in_bands(path, blitter, ir, clipBounds, bandBounds, bands, bandExecutor);
     } else if (!isInverse && path.isConvex()) {
         // If the filling area is convex (i.e., path.isConvex && !isInverse), our simpler
         // aaa_walk_convex_edges won't generate alphas above 255. Hence we don't need
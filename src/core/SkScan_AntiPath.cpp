@@ -712,7 +712,8 @@ static int rect_overflows_short_shift(SkIRect rect, int shift) {
 }
 
 void SkScan::AntiFillPath(const SkPath& path, const SkRegion& origClip,
-                          SkBlitter* blitter, bool forceRLE) {
+                          SkBlitter* blitter, bool forceRLE, AntiFill fill,
+                          SkExecutor* bandExecutor) {
     if (origClip.isEmpty()) {
         return;
     }
@@ -728,7 +729,7 @@ void SkScan::AntiFillPath(const SkPath& path, const SkRegion& origClip,
 
     // If the intersection of the path bounds and the clip bounds
     // will overflow 32767 when << by SHIFT, we can't supersample,
-    // so draw without antialiasing.
+    // so draw without antialiasing. Sparse accumulation doesn't supersample.
     SkIRect clippedIR;
     if (isInverse) {
        // If the path is an inverse fill, it's going to fill the entire
@@ -739,7 +740,7 @@ void SkScan::AntiFillPath(const SkPath& path, const SkRegion& origClip,
            return;
        }
     }
-    if (rect_overflows_short_shift(clippedIR, SHIFT)) {
+    if (fill != AntiFill::kSparse && rect_overflows_short_shift(clippedIR, SHIFT)) {
         SkScan::FillPath(path, origClip, blitter);
         return;
     }
@@ -782,15 +783,23 @@ void SkScan::AntiFillPath(const SkPath& path, const SkRegion& origClip,
         sk_blit_above(blitter, ir, *clipRgn);
     }
 
-    SkScalar avgLength, complexity;
-    compute_complexity(path, avgLength, complexity);
-
-    if (ShouldUseAAA(path, avgLength, complexity)) {
-        // Do not use AAA if path is too complicated:
-        // there won't be any speedup or significant visual improvement.
-        SkScan::AAAFillPath(path, blitter, ir, clipRgn->getBounds(), forceRLE);
+    if (fill == AntiFill::kSparse) {
+        SkScan::SparseFillPath(path, blitter, ir, clipRgn->getBounds());
     } else {
-        SkScan::SAAFillPath(path, blitter, ir, clipRgn->getBounds(), forceRLE);
+        SkScalar avgLength, complexity;
+        compute_complexity(path, avgLength, complexity);
+
+        bool useAAA = ShouldUseAAA(path, avgLength, complexity);
+#if !defined(SK_DISABLE_AAA)
+        useAAA = useAAA || fill == AntiFill::kAnalytic;
+#endif
+        if (useAAA) {
+            // Do not use AAA if path is too complicated:
+            // there won't be any speedup or significant visual improvement.
+            SkScan::AAAFillPath(path, blitter, ir, clipRgn->getBounds(), forceRLE, bandExecutor);
+        } else {
+            SkScan::SAAFillPath(path, blitter, ir, clipRgn->getBounds(), forceRLE);
+        }
     }
 
     if (isInverse) {
@@ -835,3 +844,38 @@ void SkScan::AntiFillPath(const SkPath& path, const SkRasterClip& clip, SkBlitte
         AntiFillPath(path, tmp, &aaBlitter, true); // SkAAClipBlitter can blitMask, why forceRLE?
     }
 }
+
+void SkScan::SparseAntiFillPath(const SkPath& path, const SkRasterClip& clip, SkBlitter* blitter) {
+    if (clip.isEmpty() || !path.isFinite()) {
+        return;
+    }
+
+    if (clip.isBW()) {
+        AntiFillPath(path, clip.bwRgn(), blitter, false, AntiFill::kSparse);
+    } else {
+        SkRegion        tmp;
+        SkAAClipBlitter aaBlitter;
+
+        tmp.setRect(clip.getBounds());
+        aaBlitter.init(blitter, &clip.aaRgn());
+        AntiFillPath(path, tmp, &aaBlitter, false, AntiFill::kSparse);
+    }
+}
+
+void SkScan::AnalyticAntiFillPath(const SkPath& path, const SkRasterClip& clip,
+                                  SkBlitter* blitter, SkExecutor* bandExecutor) {
+    if (clip.isEmpty() || !path.isFinite()) {
+        return;
+    }
+
+    if (clip.isBW()) {
+        AntiFillPath(path, clip.bwRgn(), blitter, false, AntiFill::kAnalytic, bandExecutor);
+    } else {
+        SkRegion        tmp;
+        SkAAClipBlitter aaBlitter;
+
+        tmp.setRect(clip.getBounds());
+        aaBlitter.init(blitter, &clip.aaRgn());
+        AntiFillPath(path, tmp, &aaBlitter, true, AntiFill::kAnalytic, bandExecutor);
+    }
+}
@@ -0,0 +1,340 @@
+/*
+ * Copyright 2021 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/core/SkPath.h"
+#include "include/private/SkTPin.h"
+#include "include/private/SkTemplates.h"
+#include "include/private/SkVx.h"
+#include "src/core/SkBlitter.h"
+#include "src/core/SkGeometry.h"
+#include "src/core/SkPathPriv.h"
+#include "src/core/SkScan.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+// Sparse scanline AA accumulates, for every pixel a line passes through, the signed area the line
+// adds to its left and the cover it carries to the pixels on its right.  A prefix sum along each
+// row then resolves winding, and so coverage, with no per-row edge lists or sorting.  Rows are
+// accumulated a strip at a time, and each row only resolves the columns its lines touched.
+
+// Curves are flattened to lines at most this far, in pixels, from the curve.
+static constexpr float kFlattenTolerance = 1 / 32.0f;
+static constexpr int   kMaxCurveLines    = 1024;
+
+// Rows are accumulated in strips of this many rows, bounding the accumulation buffer.
+static constexpr int kStripRows = 16;
+
+namespace {
+
+// A line from top to bottom, in pixels from the top left of the accumulated bounds.
+struct Line {
+    float fX0, fY0, fY1;
+    float fDxDy;
+    float fDir;  // +1 for a line down the path, -1 for a line up it
+};
+
+class SparseAccumulator {
+public:
+    SparseAccumulator(int width, int height)
+            : fWidth(width)
+            , fHeight(height)
+            // Lines spill up to two columns right of the bounds, and rows resolve 4 at a time.
+            , fStride(SkAlign4(width + 2))
+            , fAccum(kStripRows * fStride) {
+        sk_bzero(fAccum.get(), kStripRows * fStride * sizeof(float));
+    }
+
+    // Adds the line from p0 to p1, in pixels from the top left of the bounds.
+    void addLine(SkPoint p0, SkPoint p1) {
+        if (p0.fY == p1.fY || std::max(p0.fY, p1.fY) <= 0 || std::min(p0.fY, p1.fY) >= fHeight) {
+            return;
+        }
+        // Left or right of the bounds, a line only carries cover into (or past) them, so project
+        // those parts onto the left and right edges.
+        const float W = (float)fWidth;
+        float ts[4] = {0, 0, 0, 1};
+        int   n = 1;
+        for (float x : {0.0f, W}) {
+            if ((p0.fX < x) != (p1.fX < x)) {
+                ts[n++] = (x - p0.fX) / (p1.fX - p0.fX);
+            }
+        }
+        ts[n] = 1;
+        std::sort(ts + 1, ts + n);
+        SkPoint prev = p0;
+        for (int i = 1; i <= n; i++) {
+            SkPoint next = i == n ? p1 : SkPoint{p0.fX + ts[i] * (p1.fX - p0.fX),
+                                                 p0.fY + ts[i] * (p1.fY - p0.fY)};
+            this->addPinnedLine({SkTPin(prev.fX, 0.0f, W), prev.fY},
+                                {SkTPin(next.fX, 0.0f, W), next.fY});
+            prev = next;
+        }
+    }
+
+    void fill(SkBlitter* blitter, int left, int top, bool evenOdd, bool inverse) {
+        std::sort(fLines.begin(), fLines.end(),
+                  [](const Line& a, const Line& b) { return a.fY0 < b.fY0; });
+
+        SkAutoTMalloc<SkAlpha> alpha(fStride);
+        SkAutoTMalloc<int16_t> runs(fStride + 1);
+        std::vector<Line> active;
+        size_t next = 0;
+        for (int stripTop = 0; stripTop < fHeight; stripTop += kStripRows) {
+            const int stripRows = std::min(kStripRows, fHeight - stripTop);
+
+            active.erase(std::remove_if(active.begin(), active.end(),
+                                        [=](const Line& l) { return l.fY1 <= stripTop; }),
+                         active.end());
+            for (; next < fLines.size() && fLines[next].fY0 < stripTop + stripRows; next++) {
+                if (fLines[next].fY1 > stripTop) {
+                    active.push_back(fLines[next]);
+                }
+            }
+            if (active.empty() && !inverse) {
+                continue;
+            }
+
+            for (int y = 0; y < stripRows; y++) {
+                fMinX[y] = fStride;
+                fMaxX[y] = 0;
+            }
+            for (const Line& line : active) {
+                this->accumulate(line, stripTop, stripRows);
+            }
+            for (int y = 0; y < stripRows; y++) {
+                this->resolveRow(y, blitter, left, top + stripTop + y, evenOdd, inverse,
+                                 alpha.get(), runs.get());
+            }
+        }
+    }
+
+private:
+    // Adds a line lying within [0, fWidth] horizontally.
+    void addPinnedLine(SkPoint p0, SkPoint p1) {
+        if (p0.fY == p1.fY) {
+            return;
+        }
+        float dir = 1;
+        if (p0.fY > p1.fY) {
+            std::swap(p0, p1);
+            dir = -1;
+        }
+        fLines.push_back({p0.fX, p0.fY, p1.fY, (p1.fX - p0.fX) / (p1.fY - p0.fY), dir});
+    }
+
+    // Accumulates the area and cover of the line over rows [stripTop, stripTop + stripRows).
+    void accumulate(const Line& line, int stripTop, int stripRows) {
+        const float W  = (float)fWidth;
+        const float y0 = std::max(line.fY0 - stripTop, 0.0f),
+                    y1 = std::min(line.fY1 - stripTop, (float)stripRows);
+        if (y0 >= y1) {
+            return;
+        }
+        float x = line.fX0 + (y0 + stripTop - line.fY0) * line.fDxDy;
+        for (int y = (int)y0; y < y1; y++) {
+            const float dy    = std::min(y + 1.0f, y1) - std::max((float)y, y0),
+                        d     = dy * line.fDir;
+            const float xnext = x + dy * line.fDxDy;
+            // x may step a rounding error outside the bounds it was pinned to.
+            const float xa = SkTPin(std::min(x, xnext), 0.0f, W),
+                        xb = SkTPin(std::max(x, xnext), 0.0f, W);
+            const int   xa0 = (int)xa,
+                        xb1 = (int)std::ceil(xb);
+            float* row = fAccum.get() + y * fStride;
+
+            if (xb1 <= xa0 + 1) {
+                // Within one pixel: the area left of its midpoint there, the rest in the next.
+                const float xm = 0.5f * (xa + xb) - xa0;
+                row[xa0]     += d - d * xm;
+                row[xa0 + 1] += d * xm;
+            } else {
+                // Across pixels: a triangle in the first and last, and a trapezoid between.
+                const float s   = 1 / (xb - xa),
+                            xaf = xa - xa0,
+                            a0  = 0.5f * s * (1 - xaf) * (1 - xaf),
+                            xbf = xb - xb1 + 1,
+                            am  = 0.5f * s * xbf * xbf;
+                row[xa0] += d * a0;
+                if (xb1 == xa0 + 2) {
+                    row[xa0 + 1] += d * (1 - a0 - am);
+                } else {
+                    const float a1 = s * (1.5f - xaf);
+                    row[xa0 + 1] += d * (a1 - a0);
+                    for (int xi = xa0 + 2; xi < xb1 - 1; xi++) {
+                        row[xi] += d * s;
+                    }
+                    const float a2 = a1 + (xb1 - xa0 - 3) * s;
+                    row[xb1 - 1] += d * (1 - a2 - am);
+                }
+                row[xb1] += d * am;
+            }
+            fMinX[y] = std::min(fMinX[y], xa0);
+            fMaxX[y] = std::max(fMaxX[y], std::max(xa0 + 2, xb1 + 1));
+            x = xnext;
+        }
+    }
+
+    // Resolves row y of the strip into coverage, blits it, and clears it for the next strip.
+    void resolveRow(int y, SkBlitter* blitter, int left, int deviceY, bool evenOdd, bool inverse,
+                    SkAlpha alpha[], int16_t runs[]) {
+        using F = skvx::Vec<4, float>;
+
+        float*    row  = fAccum.get() + y * fStride;
+        const int minX = fMinX[y] & ~3,
+                  maxX = fMaxX[y];
+        if (maxX == 0 && !inverse) {
+            return;
+        }
+
+        F carry = 0;
+        for (int x = minX; x < maxX; x += 4) {
+            F v = F::Load(row + x);
+            F(0).store(row + x);
+
+            // A prefix sum of 4 lanes in two steps, carrying on from the last 4.
+            v += skvx::shuffle<0,0,1,2>(v) * F{0, 1, 1, 1};
+            v += skvx::shuffle<0,0,0,1>(v) * F{0, 0, 1, 1};
+            v += carry;
+            carry = v[3];
+
+            F c = max(v, -v);
+            if (evenOdd) {
+                c = c - 2 * skvx::cast<float>(skvx::cast<int>(c * 0.5f));
+                c = min(c, 2 - c);
+            } else {
+                c = min(c, 1);
+            }
+            skvx::cast<uint8_t>(c * 255 + 0.5f).store(alpha + x);
+        }
+
+        // The winding past the last line of a row is back to zero.
+        int x0 = minX, x1 = std::min(maxX, fWidth);
+        if (inverse) {
+            for (int x = 0; x < fWidth; x++) {
+                alpha[x] = x >= x0 && x < x1 ? 255 - alpha[x] : 255;
+            }
+            x0 = 0;
+            x1 = fWidth;
+        }
+
+        // Trim transparent ends, then run-length encode what's left.
+        while (x0 < x1 && alpha[x0] == 0) { x0++; }
+        while (x1 > x0 && alpha[x1 - 1] == 0) { x1--; }
+        if (x0 == x1) {
+            return;
+        }
+        for (int x = x0; x < x1;) {
+            int n = 1;
+            while (x + n < x1 && alpha[x + n] == alpha[x] && n < SK_MaxS16) {
+                n++;
+            }
+            runs[x] = SkToS16(n);
+            x += n;
+        }
+        runs[x1] = 0;
+        blitter->blitAntiH(left + x0, deviceY, alpha + x0, runs + x0);
+    }
+
+    const int fWidth, fHeight, fStride;
+    SkAutoTMalloc<float> fAccum;
+    int fMinX[kStripRows], fMaxX[kStripRows];
+    std::vector<Line> fLines;
+};
+
+// Flattens the path, relative to origin, into lines added to accum.
+static void add_path(const SkPath& path, SkPoint origin, SparseAccumulator* accum) {
+    SkPoint start = {0, 0}, last = {0, 0};
+    auto add_line = [&](SkPoint p) {
+        accum->addLine(last, p);
+        last = p;
+    };
+    // Wang's formula bounds how many lines keep a curve within tolerance.
+    auto curve_lines = [](float degreeTerm, SkVector maxSecondDiff) {
+        float n = std::ceil(std::sqrt(degreeTerm * maxSecondDiff.length() / kFlattenTolerance));
+        return n < kMaxCurveLines ? std::max((int)n, 1) : kMaxCurveLines;
+    };
+    auto add_quad = [&](const SkPoint q[3]) {
+        const SkVector A = q[0] - q[1] - q[1] + q[2],
+                       B = (q[1] - q[0]) * 2;
+        const int n = curve_lines(2 / 8.0f, A);
+        for (int i = 1; i < n; i++) {
+            const float t = (float)i / n;
+            add_line((A * t + B) * t + q[0]);
+        }
+        add_line(q[2]);
+    };
+
+    for (auto [verb, pts, weight] : SkPathPriv::Iterate(path)) {
+        switch (verb) {
+            case SkPathVerb::kMove:
+                if (last != start) {
+                    add_line(start);
+                }
+                start = last = pts[0] - origin;
+                break;
+            case SkPathVerb::kLine:
+                add_line(pts[1] - origin);
+                break;
+            case SkPathVerb::kQuad: {
+                const SkPoint q[3] = {pts[0] - origin, pts[1] - origin, pts[2] - origin};
+                add_quad(q);
+            } break;
+            case SkPathVerb::kConic: {
+                SkAutoConicToQuads converter;
+                const SkPoint* q = converter.computeQuads(pts, *weight, kFlattenTolerance);
+                for (int i = 0; i < converter.countQuads(); i++, q += 2) {
+                    const SkPoint quad[3] = {q[0] - origin, q[1] - origin, q[2] - origin};
+                    add_quad(quad);
+                }
+            } break;
+            case SkPathVerb::kCubic: {
+                const SkPoint c[4] = {pts[0] - origin, pts[1] - origin,
+                                      pts[2] - origin, pts[3] - origin};
+                const SkVector A = c[3] + (c[1] - c[2]) * 3 - c[0],
+                               B = (c[2] - c[1] - c[1] + c[0]) * 3,
+                               C = (c[1] - c[0]) * 3;
+                const SkVector d0 = c[0] - c[1] - c[1] + c[2],
+                               d1 = c[1] - c[2] - c[2] + c[3];
+                const int n = curve_lines(6 / 8.0f, d0.length() > d1.length() ? d0 : d1);
+                for (int i = 1; i < n; i++) {
+                    const float t = (float)i / n;
+                    add_line(((A * t + B) * t + C) * t + c[0]);
+                }
+                add_line(c[3]);
+            } break;
+            case SkPathVerb::kClose:
+                break;
+        }
+    }
+    if (last != start) {
+        add_line(start);
+    }
+}
+
+}  // namespace
+
+void SkScan::SparseFillPath(const SkPath& path, SkBlitter* blitter, const SkIRect& ir,
+                            const SkIRect& clipBounds) {
+    const bool isInverse = path.isInverseFillType();
+
+    // The rows of the path, and the columns it covers: all the clip's, when inverse.
+    SkIRect bounds;
+    if (!bounds.intersect(ir, clipBounds)) {
+        return;
+    }
+    if (isInverse) {
+        bounds.fLeft  = clipBounds.fLeft;
+        bounds.fRight = clipBounds.fRight;
+    }
+
+    SparseAccumulator accum(bounds.width(), bounds.height());
+    add_path(path, SkPoint::Make(bounds.fLeft, bounds.fTop), &accum);
+    accum.fill(blitter, bounds.fLeft, bounds.fTop, SkPathFillType_IsEvenOdd(path.getFillType()),
+               isInverse);
+}
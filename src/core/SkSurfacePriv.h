@@ -18,7 +18,13 @@ static inline SkSurfaceProps SkSurfacePropsCopyOrDefault(const SkSurfaceProps* p
 
 enum SkSurfacePropsPrivateFlags {
     // Use internal MSAA to render to non-MSAA GPU surfaces.
-    kDMSAA_SkSurfacePropsPrivateFlag = SkSurfaceProps::kLast_Flag << 1
+    kDMSAA_SkSurfacePropsPrivateFlag = SkSurfaceProps::kLast_Flag << 1,
+    // Fill anti-aliased paths on raster surfaces by accumulating signed area into sparse rows,
+    // rather than with the supersampling or analytic scan converters.
+    kSparseScanlineAA_SkSurfacePropsPrivateFlag = SkSurfaceProps::kLast_Flag << 2,
+    // Fill anti-aliased paths on raster surfaces with analytic AA, rasterizing those with many
+    // points in horizontal bands on SkExecutor::GetDefault().
+    kBandedAnalyticAA_SkSurfacePropsPrivateFlag = SkSurfaceProps::kLast_Flag << 3,
 };
 
 constexpr size_t kIgnoreRowBytesValue = static_cast<size_t>(~0);
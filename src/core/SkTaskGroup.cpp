@@ -8,6 +8,8 @@
 #include "include/core/SkExecutor.h"
 #include "src/core/SkTaskGroup.h"
 
+#include <algorithm>
+
 SkTaskGroup::SkTaskGroup(SkExecutor& executor) : fPending(0), fExecutor(executor) {}
 
 void SkTaskGroup::add(std::function<void(void)> fn) {
@@ -29,6 +31,31 @@ void SkTaskGroup::batch(int N, std::function<void(int)> fn) {
     }
 }
 
+void SkTaskGroup::parallel_for(int begin, int end, int grain, std::function<void(int, int)> fn) {
+    SkASSERT(begin <= end);
+    if (begin >= end) {
+        return;
+    }
+    grain = std::max(grain, 1);
+
+    // Every task shares this one copy of fn.
+    auto shared = std::make_shared<const RangeFn>(std::move(fn));
+    this->add([this, shared{std::move(shared)}, begin, end, grain] {
+        this->split(shared, begin, end, grain);
+    });
+}
+
+void SkTaskGroup::split(std::shared_ptr<const RangeFn> fn, int begin, int end, int grain) {
+    // Peel off the back half of the range as a new task until what's left fits in one grain.
+    // On a work-stealing executor the biggest halves get stolen first, spreading work quickly.
+    while (end - begin > grain) {
+        int mid = begin + (end - begin) / 2;
+        this->add([this, fn, mid, end, grain] { this->split(fn, mid, end, grain); });
+        end = mid;
+    }
+    (*fn)(begin, end);
+}
+
 bool SkTaskGroup::done() const {
     return fPending.load(std::memory_order_acquire) == 0;
 }
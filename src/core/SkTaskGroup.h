@@ -13,6 +13,7 @@
 #include "include/private/SkNoncopyable.h"
 #include <atomic>
 #include <functional>
+#include <memory>
 
 class SkTaskGroup : SkNoncopyable {
 public:
@@ -26,6 +27,12 @@ public:
     // Add a batch of N tasks, all calling fn with different arguments.
     void batch(int N, std::function<void(int)> fn);
 
+    // Call fn(chunkBegin, chunkEnd) over disjoint chunks covering [begin, end), each chunk at
+    // most grain long.  The range is split in halves recursively on the executor's threads,
+    // so adding the work costs the caller O(1), and there are about (end-begin)/grain tasks
+    // rather than one per index.  Loop over the chunk inside fn.
+    void parallel_for(int begin, int end, int grain, std::function<void(int, int)> fn);
+
     // Returns true if all Tasks previously add()ed to this SkTaskGroup have run.
     // It is safe to reuse this SkTaskGroup once done().
     bool done() const;
@@ -41,6 +48,9 @@ public:
     };
 
 private:
+    using RangeFn = std::function<void(int, int)>;
+    void split(std::shared_ptr<const RangeFn>, int begin, int end, int grain);
+
     std::atomic<int32_t> fPending;
     SkExecutor&          fExecutor;
 };
@@ -5,6 +5,7 @@
  * found in the LICENSE file.
  */
 
+#include "include/core/SkData.h"
 #include "include/core/SkStream.h"
 #include "include/core/SkString.h"
 #include "include/private/SkChecksum.h"
@@ -38,6 +39,7 @@
 
 bool gSkVMAllowJIT{false};
 bool gSkVMJITViaDylib{false};
+bool gSkVMAllowAVX512{true};  // Lets tests and benches compare the AVX-512 and AVX2 JITs.
 
 #if defined(SKVM_JIT)
     #if defined(SK_BUILD_FOR_WIN)
@@ -140,6 +142,8 @@ namespace skvm {
         int regs = 0;
         int loop = 0;
         std::vector<int> strides;
+        bool serializable = false;
+        std::vector<OptimizedInstruction> optimized;  // Kept for serialize() if serializable.
 
         std::atomic<void*> jit_entry{nullptr};   // TODO: minimal std::memory_orders
         size_t jit_size = 0;
@@ -515,14 +519,14 @@ namespace skvm {
         return    finalize           (std::move(program));
     }
 
-    Program Builder::done(const char* debug_name, bool allow_jit) const {
+    Program Builder::done(const char* debug_name, bool allow_jit, bool serializable) const {
         char buf[64] = "skvm-jit-";
         if (!debug_name) {
             *SkStrAppendU32(buf+9, this->hash()) = '\0';
             debug_name = buf;
         }
 
-        return {this->optimize(), fStrides, debug_name, allow_jit};
+        return {this->optimize(), fStrides, debug_name, allow_jit, serializable};
     }
 
     uint64_t Builder::hash() const {
@@ -1729,6 +1733,57 @@ namespace skvm {
         return vex;
     }
 
+    // The EVEX prefix extends VEX to AVX-512: 512-bit zmm registers and opmask registers.
+    // We only use zmm0-15, so the extra register bits R', X (for rm), and V' are never set.
+    struct EVEX {
+        uint8_t bytes[4];
+    };
+
+    static EVEX evex(bool  WE,   // As VEX.
+                     bool   R,   // As VEX.
+                     bool   X,   // As VEX.
+                     bool   B,   // As VEX.
+                     int  map,   // As VEX, 0x0f, 0x380f, or 0x3a0f.
+                     int vvvv,   // As VEX.
+                     int   pp,   // As VEX.
+                     int  aaa,   // Opmask register selecting active lanes, k0 for all lanes.
+                     bool   z) { // Zero inactive lanes (z) or leave them unchanged?
+        map = [map]{
+            switch (map) {
+                case   0x0f: return 0b01;
+                case 0x380f: return 0b10;
+                case 0x3a0f: return 0b11;
+            }
+            SkUNREACHABLE;
+        }();
+
+        pp = [pp]{
+            switch (pp) {
+                case 0x66: return 0b01;
+                case 0xf3: return 0b10;
+                case 0xf2: return 0b11;
+            }
+            return 0b00;
+        }();
+
+        EVEX evex = {{0,0,0,0}};
+        evex.bytes[0] = 0x62;
+        evex.bytes[1] = (map     & 3) << 0
+                      | (1          ) << 4    // ~R', high bit of 5-bit ModRM reg.
+                      | (~(int)B & 1) << 5
+                      | (~(int)X & 1) << 6
+                      | (~(int)R & 1) << 7;
+        evex.bytes[2] = (pp      &  3) << 0
+                      | (1           ) << 2   // Fixed 1.
+                      | (~vvvv   & 15) << 3
+                      | (WE      &  1) << 7;
+        evex.bytes[3] = (aaa     &  7) << 0
+                      | (1           ) << 3   // ~V', high bit of 5-bit vvvv or VSIB index.
+                      | (0b10        ) << 5   // L'L: 512-bit.
+                      | (z       &  1) << 7;
+        return evex;
+    }
+
     Assembler::Assembler(void* buf) : fCode((uint8_t*)buf), fSize(0) {}
 
     size_t Assembler::size() const { return fSize; }
@@ -1871,10 +1926,23 @@ namespace skvm {
     void Assembler::vpunpckldq(Ymm dst, Ymm x, Operand y) { this->op(0x66,0x0f,0x62, dst,x,y); }
     void Assembler::vpunpckhdq(Ymm dst, Ymm x, Operand y) { this->op(0x66,0x0f,0x6a, dst,x,y); }
 
-    void Assembler::vpcmpeqd(Ymm dst, Ymm x, Operand y) { this->op(0x66,0x0f,0x76, dst,x,y); }
-    void Assembler::vpcmpeqw(Ymm dst, Ymm x, Operand y) { this->op(0x66,0x0f,0x75, dst,x,y); }
-    void Assembler::vpcmpgtd(Ymm dst, Ymm x, Operand y) { this->op(0x66,0x0f,0x66, dst,x,y); }
-    void Assembler::vpcmpgtw(Ymm dst, Ymm x, Operand y) { this->op(0x66,0x0f,0x65, dst,x,y); }
+    // With use_zmm(true), EVEX compares write to an Opmask instead; see below.
+    void Assembler::vpcmpeqd(Ymm dst, Ymm x, Operand y) {
+        SkASSERT(!fZmm);
+        this->op(0x66,0x0f,0x76, dst,x,y);
+    }
+    void Assembler::vpcmpeqw(Ymm dst, Ymm x, Operand y) {
+        SkASSERT(!fZmm);
+        this->op(0x66,0x0f,0x75, dst,x,y);
+    }
+    void Assembler::vpcmpgtd(Ymm dst, Ymm x, Operand y) {
+        SkASSERT(!fZmm);
+        this->op(0x66,0x0f,0x66, dst,x,y);
+    }
+    void Assembler::vpcmpgtw(Ymm dst, Ymm x, Operand y) {
+        SkASSERT(!fZmm);
+        this->op(0x66,0x0f,0x65, dst,x,y);
+    }
 
 
     void Assembler::imm_byte_after_operand(const Operand& operand, int imm) {
@@ -1891,11 +1959,13 @@ namespace skvm {
     }
 
     void Assembler::vcmpps(Ymm dst, Ymm x, Operand y, int imm) {
+        SkASSERT(!fZmm);
         this->op(0,0x0f,0xc2, dst,x,y);
         this->imm_byte_after_operand(y, imm);
     }
 
     void Assembler::vpblendvb(Ymm dst, Ymm x, Operand y, Ymm z) {
+        SkASSERT(!fZmm);  // No EVEX encoding; see vpblendmd().
         this->op(0x66,0x3a0f,0x4c, dst,x,y);
         this->imm_byte_after_operand(y, z << 4);
     }
@@ -1933,6 +2003,7 @@ namespace skvm {
     }
 
     void Assembler::vperm2f128(Ymm dst, Ymm x, Operand y, int imm) {
+        SkASSERT(!fZmm);  // No EVEX encoding.
         this->op(0x66,0x3a0f,0x06, dst,x,y);
         this->imm_byte_after_operand(y, imm);
     }
@@ -1986,6 +2057,9 @@ namespace skvm {
     }
 
     void Assembler::op(int prefix, int map, int opcode, int dst, int x, Operand y, W w, L l) {
+        if (fZmm && l == L256) {
+            return this->evex_op(prefix, map, opcode, dst, x, y, w);
+        }
         switch (y.kind) {
             case Operand::REG: {
                 VEX v = vex(w, dst>>3, 0, y.reg>>3,
@@ -2028,9 +2102,55 @@ namespace skvm {
         }
     }
 
+    void Assembler::evex_op(int prefix, int map, int opcode, int dst, int x, Operand y, W w,
+                            Opmask mask, bool zero_masked) {
+        switch (y.kind) {
+            case Operand::REG: {
+                EVEX e = evex(w, dst>>3, 0, y.reg>>3,
+                              map, x, prefix, mask, zero_masked);
+                this->bytes(e.bytes, 4);
+                this->byte(opcode);
+                this->byte(mod_rm(Mod::Direct, dst&7, y.reg&7));
+            } return;
+
+            case Operand::MEM: {
+                // EVEX scales 8-bit displacements by the operand size (disp8*N), so rather than
+                // work that out per-instruction, we always use a 32-bit displacement.
+                const Mem& m = y.mem;
+                const bool need_SIB = m.base  == rsp
+                                   || m.index != rsp;
+                const Mod disp = m.disp ? Mod::FourByteImm : Mod::Indirect;
+
+                EVEX e = evex(w, dst>>3, m.index>>3, m.base>>3,
+                              map, x, prefix, mask, zero_masked);
+                this->bytes(e.bytes, 4);
+                this->byte(opcode);
+                this->byte(mod_rm(disp, dst&7, (need_SIB ? rsp : m.base)&7));
+                if (need_SIB) {
+                    this->byte(sib(m.scale, m.index&7, m.base&7));
+                }
+                this->bytes(&m.disp, imm_bytes(disp));
+            } return;
+
+            case Operand::LABEL: {
+                const int rip = rbp;
+
+                EVEX e = evex(w, dst>>3, 0, rip>>3,
+                              map, x, prefix, mask, zero_masked);
+                this->bytes(e.bytes, 4);
+                this->byte(opcode);
+                this->byte(mod_rm(Mod::Indirect, dst&7, rip&7));
+                this->word(this->disp32(y.label));
+            } return;
+        }
+    }
+
     void Assembler::vpshufb(Ymm dst, Ymm x, Operand y) { this->op(0x66,0x380f,0x00, dst,x,y); }
 
-    void Assembler::vptest(Ymm x, Operand y) { this->op(0x66, 0x380f, 0x17, x,y); }
+    void Assembler::vptest(Ymm x, Operand y) {
+        SkASSERT(!fZmm);  // No EVEX encoding.
+        this->op(0x66, 0x380f, 0x17, x,y);
+    }
 
     void Assembler::vbroadcastss(Ymm dst, Operand y) { this->op(0x66,0x380f,0x18, dst,y); }
 
@@ -2075,6 +2195,10 @@ namespace skvm {
         this->imm_byte_after_operand(y, imm);
     }
 
+    void Assembler::vinserti128(Ymm dst, Ymm x, Operand y, int imm) {
+        this->op(0x66,0x3a0f,0x38, dst,x,y);
+        this->imm_byte_after_operand(y, imm);
+    }
     void Assembler::vextracti128(Operand dst, Ymm src, int imm) {
         this->op(0x66,0x3a0f,0x39, src,dst);
         SkASSERT(dst.kind != Operand::LABEL);
@@ -2098,6 +2222,7 @@ namespace skvm {
 
     void Assembler::vgatherdps(Ymm dst, Scale scale, Ymm ix, GP64 base, Ymm mask) {
         // Unlike most instructions, no aliasing is permitted here.
+        SkASSERT(!fZmm);  // See vpgatherdd().
         SkASSERT(dst != ix);
         SkASSERT(dst != mask);
         SkASSERT(mask != ix);
@@ -2113,6 +2238,95 @@ namespace skvm {
         this->byte(sib(scale, ix&7, base&7));
     }
 
+    void Assembler::bzhi(GP64 dst, Operand x, GP64 index) {
+        this->op(0,0x380f,0xf5, dst,index,x, W1,L128);
+    }
+
+    void Assembler::kmovw(Opmask dst, GP64   src) { this->op(0,0x0f,0x92, dst,0,src, W0,L128); }
+    void Assembler::kmovw(Opmask dst, Opmask src) { this->op(0,0x0f,0x90, dst,0,src, W0,L128); }
+
+    void Assembler::vmovdqu32(Ymm dst, Operand src, Opmask k) {
+        SkASSERT(fZmm);
+        this->evex_op(0xf3,0x0f,0x6f, dst,0,src, W0, k,/*zero_masked=*/true);
+    }
+    void Assembler::vmovdqu32(Operand dst, Ymm src, Opmask k) {
+        SkASSERT(fZmm);
+        this->evex_op(0xf3,0x0f,0x7f, src,0,dst, W0, k);
+    }
+    void Assembler::vpmovzxbd(Ymm dst, Operand src, Opmask k) {
+        SkASSERT(fZmm);
+        this->evex_op(0x66,0x380f,0x31, dst,0,src, W0, k,/*zero_masked=*/true);
+    }
+    void Assembler::vpmovzxwd(Ymm dst, Operand src, Opmask k) {
+        SkASSERT(fZmm);
+        this->evex_op(0x66,0x380f,0x33, dst,0,src, W0, k,/*zero_masked=*/true);
+    }
+    void Assembler::vpmovdb(Operand dst, Ymm src, Opmask k) {
+        SkASSERT(fZmm);
+        this->evex_op(0xf3,0x380f,0x31, src,0,dst, W0, k);
+    }
+    void Assembler::vpmovdw(Operand dst, Ymm src, Opmask k) {
+        SkASSERT(fZmm);
+        this->evex_op(0xf3,0x380f,0x33, src,0,dst, W0, k);
+    }
+
+    void Assembler::vpcmpeqd(Opmask dst, Ymm x, Operand y) {
+        SkASSERT(fZmm);
+        this->evex_op(0x66,0x0f,0x76, dst,x,y, W0);
+    }
+    void Assembler::vpcmpgtd(Opmask dst, Ymm x, Operand y) {
+        SkASSERT(fZmm);
+        this->evex_op(0x66,0x0f,0x66, dst,x,y, W0);
+    }
+    void Assembler::vcmpps(Opmask dst, Ymm x, Operand y, int imm) {
+        SkASSERT(fZmm);
+        this->evex_op(0,0x0f,0xc2, dst,x,y, W0);
+        this->imm_byte_after_operand(y, imm);
+    }
+
+    void Assembler::vpmovm2d(Ymm dst, Opmask src) {
+        SkASSERT(fZmm);
+        this->evex_op(0xf3,0x380f,0x38, dst,0,src, W0);
+    }
+    void Assembler::vpmovd2m(Opmask dst, Ymm src) {
+        SkASSERT(fZmm);
+        this->evex_op(0xf3,0x380f,0x39, dst,0,src, W0);
+    }
+    void Assembler::vpblendmd(Ymm dst, Opmask k, Ymm x, Operand y) {
+        SkASSERT(fZmm);
+        this->evex_op(0x66,0x380f,0x64, dst,x,y, W0, k);
+    }
+
+    // VSIB addressing as in vgatherdps(), but the opmask is the only mask.
+    // A 32-bit displacement is used whenever disp is non-zero; see evex_op().
+    void Assembler::vpgatherdd(Ymm dst, Scale scale, Ymm ix, GP64 base, int disp, Opmask mask) {
+        SkASSERT(fZmm);
+        SkASSERT(dst != ix);
+        SkASSERT(mask != k0);
+        const Mod d = disp ? Mod::FourByteImm : Mod::Indirect;
+
+        EVEX e = evex(0, dst>>3, ix>>3, base>>3,
+                      0x380f, 0, 0x66, mask, false);
+        this->bytes(e.bytes, 4);
+        this->byte(0x90);
+        this->byte(mod_rm(d, dst&7, rsp/*use SIB*/));
+        this->byte(sib(scale, ix&7, base&7));
+        this->bytes(&disp, imm_bytes(d));
+    }
+    void Assembler::vpscatterdd(Scale scale, Ymm ix, GP64 base, int disp, Ymm src, Opmask mask) {
+        SkASSERT(fZmm);
+        SkASSERT(mask != k0);
+        const Mod d = disp ? Mod::FourByteImm : Mod::Indirect;
+
+        EVEX e = evex(0, src>>3, ix>>3, base>>3,
+                      0x380f, 0, 0x66, mask, false);
+        this->bytes(e.bytes, 4);
+        this->byte(0xa0);
+        this->byte(mod_rm(d, src&7, rsp/*use SIB*/));
+        this->byte(sib(scale, ix&7, base&7));
+        this->bytes(&disp, imm_bytes(d));
+    }
+
     // https://static.docs.arm.com/ddi0596/a/DDI_0596_ARM_a64_instruction_set_architecture.pdf
 
     static int operator"" _mask(unsigned long long bits) { return (1<<(int)bits)-1; }
@@ -2883,8 +3097,12 @@ namespace skvm {
 
     Program::Program(const std::vector<OptimizedInstruction>& instructions,
                      const std::vector<int>& strides,
-                     const char* debug_name, bool allow_jit) : Program() {
+                     const char* debug_name, bool allow_jit, bool serializable) : Program() {
         fImpl->strides = strides;
+        fImpl->serializable = serializable;
+        if (serializable) {
+            fImpl->optimized = instructions;
+        }
         if (gSkVMAllowJIT && allow_jit) {
         #if 1 && defined(SKVM_LLVM)
             this->setupLLVM(instructions, debug_name);
@@ -2903,6 +3121,193 @@ namespace skvm {
     int  Program::loop () const { return fImpl->loop; }
     bool Program::empty() const { return fImpl->instructions.empty(); }
 
+    size_t Program::approxBytesUsed() const {
+        return sizeof(Impl)
+             + fImpl->instructions.capacity() * sizeof(InterpreterInstruction)
+             + fImpl->optimized   .capacity() * sizeof(OptimizedInstruction)
+             + fImpl->strides     .capacity() * sizeof(int)
+             + fImpl->jit_size;
+    }
+
+    // Serialized Programs look like this, all in native byte order:
+    //    uint32_t magic, version
+    //    uint32_t nstrides,     int32_t strides[nstrides]
+    //    uint32_t ninstructions, then per instruction: op,x,y,z,w,immA,immB,death,can_hoist
+    //    uint32_t checksum of everything above
+    // They hold no machine code: Deserialize() JITs the instructions again.
+    static constexpr uint32_t kSerialMagic   = SkSetFourByteTag('s','k','v','m'),
+                              kSerialVersion = 3;
+
+    // Murmur3 over 32-bit words.  Unlike SkOpts::hash_fn(), this doesn't depend on the CPU, so a
+    // Program serialized on one machine checks out on any other running the same Skia.
+    static uint32_t serial_checksum(const void* data, size_t size) {
+        SkASSERT(SkIsAlign4(size));
+        auto rotl = [](uint32_t x, int r) { return (x << r) | (x >> (32 - r)); };
+        uint32_t hash = 0;
+        for (size_t i = 0; i < size; i += 4) {
+            uint32_t k;
+            memcpy(&k, SkTAddOffset<const void>(data, i), sizeof(k));
+            k = rotl(k * 0xcc9e2d51, 15) * 0x1b873593;
+            hash = rotl(hash ^ k, 13) * 5 + 0xe6546b64;
+        }
+        return SkChecksum::Mix(hash ^ SkToU32(size));
+    }
+
+    // How many of x,y,z,w each Op reads, matching the Builder methods that push() it.
+    static int op_args(Op op) {
+        switch (op) {
+            case Op::index:
+            case Op::load8: case Op::load16: case Op::load32: case Op::load64: case Op::load128:
+            case Op::uniform32:
+            case Op::splat:
+                return 0;
+
+            case Op::store8: case Op::store16: case Op::store32:
+            case Op::gather8: case Op::gather16: case Op::gather32:
+            case Op::sqrt_f32:
+            case Op::shl_i32: case Op::shr_i32: case Op::sra_i32:
+            case Op::ceil: case Op::floor: case Op::trunc: case Op::round:
+            case Op::to_fp16: case Op::from_fp16:
+            case Op::to_f32:
+                return 1;
+
+            case Op::fma_f32: case Op::fms_f32: case Op::fnma_f32:
+            case Op::select:
+                return 3;
+
+            case Op::store128:
+                return 4;
+
+            default:
+                return 2;
+        }
+    }
+
+    sk_sp<SkData> Program::serialize() const {
+        if (!fImpl->serializable) {
+            return nullptr;
+        }
+        SkDynamicMemoryWStream buf;
+        buf.write32(kSerialMagic);
+        buf.write32(kSerialVersion);
+
+        buf.write32(SkToU32(fImpl->strides.size()));
+        for (int stride : fImpl->strides) {
+            buf.write32(stride);
+        }
+
+        buf.write32(SkToU32(fImpl->optimized.size()));
+        for (const OptimizedInstruction& inst : fImpl->optimized) {
+            for (int field : {(int)inst.op, inst.x, inst.y, inst.z, inst.w, inst.immA, inst.immB,
+                              inst.death, (int)inst.can_hoist}) {
+                buf.write32(field);
+            }
+        }
+
+        sk_sp<SkData> payload = buf.detachAsData();
+        SkDynamicMemoryWStream out;
+        out.write(payload->data(), payload->size());
+        out.write32(serial_checksum(payload->data(), payload->size()));
+        return out.detachAsData();
+    }
+
+    Program Program::Deserialize(const void* data, size_t size,
+                                 const char* debug_name, bool allow_jit) {
+        if (!data || size < sizeof(uint32_t) || !SkIsAlign4(size)) {
+            return {};
+        }
+        size -= sizeof(uint32_t);
+        uint32_t checksum;
+        memcpy(&checksum, SkTAddOffset<const void>(data, size), sizeof(checksum));
+        if (checksum != serial_checksum(data, size)) {
+            return {};
+        }
+
+        SkMemoryStream stream(data, size, /*copyData=*/false);
+        auto read = [&](uint32_t* v) { return stream.readU32(v); };
+        auto read_int = [&](int* v) { return stream.readS32(v); };
+
+        uint32_t magic, version;
+        if (!read(&magic) || magic != kSerialMagic ||
+            !read(&version) || version != kSerialVersion) {
+            return {};
+        }
+
+        uint32_t nstrides;
+        if (!read(&nstrides) || nstrides > 7/*the most eval() handles*/) {
+            return {};
+        }
+        std::vector<int> strides(nstrides);
+        for (int& stride : strides) {
+            if (!read_int(&stride)) {
+                return {};
+            }
+        }
+
+        uint32_t ninstructions;
+        if (!read(&ninstructions) || ninstructions > stream.getLength() / (9 * sizeof(int))) {
+            return {};
+        }
+        const int n = (int)ninstructions;
+        std::vector<OptimizedInstruction> instructions(n);
+        for (Val id = 0; id < n; id++) {
+            OptimizedInstruction& inst = instructions[id];
+            int op, can_hoist;
+            if (!read_int(&op) || !read_int(&inst.x) || !read_int(&inst.y) ||
+                !read_int(&inst.z) || !read_int(&inst.w) || !read_int(&inst.immA) ||
+                !read_int(&inst.immB) || !read_int(&inst.death) || !read_int(&can_hoist)) {
+                return {};
+            }
+            // Structural sanity checks, so later passes can trust the instruction stream.
+            if (op < 0 || op > (int)Op::select) {
+                return {};
+            }
+            inst.op = (Op)op;
+            inst.can_hoist = can_hoist != 0;
+            // Each op reads exactly its first op_args() arguments, all earlier values.
+            const Val args[] = {inst.x, inst.y, inst.z, inst.w};
+            for (int i = 0; i < 4; i++) {
+                if (i < op_args(inst.op) ? args[i] < 0 || args[i] >= id : args[i] != NA) {
+                    return {};
+                }
+            }
+            if (inst.death < id || inst.death > n) {
+                return {};
+            }
+            bool uses_ptr = touches_varying_memory(inst.op)
+                         || inst.op == Op::gather8  || inst.op == Op::gather16
+                         || inst.op == Op::gather32 || inst.op == Op::uniform32;
+            if (uses_ptr && (inst.immA < 0 || inst.immA >= (int)nstrides)) {
+                return {};
+            }
+            // Immediates that address memory or pick lanes must be in range too.
+            switch (inst.op) {
+                case Op::uniform32:
+                case Op::gather8: case Op::gather16: case Op::gather32:
+                    if (inst.immB < 0 || !SkIsAlign4(inst.immB)) { return {}; }
+                    break;
+                case Op::load64:  if (inst.immB < 0 || inst.immB >= 2) { return {}; } break;
+                case Op::load128: if (inst.immB < 0 || inst.immB >= 4) { return {}; } break;
+                case Op::shl_i32: case Op::shr_i32: case Op::sra_i32:
+                    if (inst.immA < 0 || inst.immA >= 32) { return {}; }
+                    break;
+                default: break;
+            }
+        }
+
+        Program program;
+        program.fImpl->strides   = std::move(strides);
+        if (gSkVMAllowJIT && allow_jit) {
+        #if defined(SKVM_LLVM)
+            program.setupLLVM(instructions, debug_name ? debug_name : "skvm-deserialized");
+        #elif defined(SKVM_JIT)
+            program.setupJIT(instructions, debug_name ? debug_name : "skvm-deserialized");
+        #endif
+        }
+        program.setupInterpreter(instructions);
+        return program;
+    }
+
     // Translate OptimizedInstructions to InterpreterInstructions.
     void Program::setupInterpreter(const std::vector<OptimizedInstruction>& instructions) {
         // Register each instruction is assigned to.
@@ -3013,6 +3418,8 @@ namespace skvm {
         SkTHashMap<int, A::Label> constants;    // Constants (mostly splats) share the same pool.
         A::Label                  iota;         // Varies per lane, for Op::index.
         A::Label                  load64_index; // Used to load low or high half of 64-bit lanes.
+        A::Label                  stride2_index,  // 0,2,4,6,...  AVX-512 load64/store64 indices.
+                                  stride4_index;  // 0,4,8,12,... AVX-512 load128/store128 indices.
 
         // The `regs` array tracks everything we know about each register's state:
         //   - NA:   empty
@@ -3033,7 +3440,18 @@ namespace skvm {
         if (!SkCpu::Supports(SkCpu::HSW)) {
             return false;
         }
-        const int K = 8;
+        // With AVX-512 we run 16 lanes at a time in zmm registers, and handle the last N%16 lanes
+        // with one more pass through the loop body under an opmask rather than one at a time.
+        // k1 always holds the active lanes, and k2 is scratch.  assert_true's vptest has no
+        // AVX-512 equivalent, so we just stick to AVX2 for the (debug-only) programs using it.
+        const bool avx512 = gSkVMAllowAVX512
+                         && SkCpu::Supports(SkCpu::SKX)
+                         && std::none_of(instructions.begin(), instructions.end(),
+                                         [](const OptimizedInstruction& inst) {
+                                             return inst.op == Op::assert_true;
+                                         });
+        a->use_zmm(avx512);
+        const int K = avx512 ? 16 : 8;
         using Reg = A::Ymm;
         #if defined(_M_X64)  // Important to check this first; clang-cl defines both.
             const A::GP64 N = A::rcx,
@@ -3406,7 +3824,9 @@ namespace skvm {
                 } break;
 
                 case Op::store8:
-                    if (scalar) {
+                    if (avx512) {
+                        a->vpmovdb(A::Mem{arg[immA]}, r(x), A::k1);
+                    } else if (scalar) {
                         a->vpextrb(A::Mem{arg[immA]}, (A::Xmm)r(x), 0);
                     } else {
                         a->vpackusdw(dst(x), r(x), r(x));
@@ -3416,7 +3836,9 @@ namespace skvm {
                     } break;
 
                 case Op::store16:
-                    if (scalar) {
+                    if (avx512) {
+                        a->vpmovdw(A::Mem{arg[immA]}, r(x), A::k1);
+                    } else if (scalar) {
                         a->vpextrw(A::Mem{arg[immA]}, (A::Xmm)r(x), 0);
                     } else {
                         a->vpackusdw(dst(x), r(x), r(x));
@@ -3424,11 +3846,21 @@ namespace skvm {
                         a->vmovups  (A::Mem{arg[immA]}, (A::Xmm)dst());
                     } break;
 
-                case Op::store32: if (scalar) { a->vmovd  (A::Mem{arg[immA]}, (A::Xmm)r(x)); }
-                                  else        { a->vmovups(A::Mem{arg[immA]},         r(x)); }
+                case Op::store32: if (avx512) { a->vmovdqu32(A::Mem{arg[immA]}, r(x), A::k1); }
+                             else if (scalar) { a->vmovd    (A::Mem{arg[immA]}, (A::Xmm)r(x)); }
+                             else             { a->vmovups  (A::Mem{arg[immA]},         r(x)); }
                                   break;
 
-                case Op::store64: if (scalar) {
+                case Op::store64: if (avx512) {
+                                      // Scatter x and y to alternating 32-bit slots.
+                                      A::Ymm ix = alloc_tmp();
+                                      a->vmovups(ix, &stride2_index);
+                                      a->kmovw(A::k2, A::k1);
+                                      a->vpscatterdd(A::FOUR, ix, arg[immA], 0, r(x), A::k2);
+                                      a->kmovw(A::k2, A::k1);
+                                      a->vpscatterdd(A::FOUR, ix, arg[immA], 4, r(y), A::k2);
+                                      free_tmp(ix);
+                                  } else if (scalar) {
                                       a->vmovd(A::Mem{arg[immA],0}, (A::Xmm)r(x));
                                       a->vmovd(A::Mem{arg[immA],4}, (A::Xmm)r(y));
                                   } else {
@@ -3448,6 +3880,21 @@ namespace skvm {
                                   } break;
 
                 case Op::store128: {
+                    if (avx512) {
+                        // Just like store64, with four values each scattered to every 4th slot.
+                        A::Ymm ix = alloc_tmp();
+                        a->vmovups(ix, &stride4_index);
+                        a->kmovw(A::k2, A::k1);
+                        a->vpscatterdd(A::FOUR, ix, arg[immA],  0, r(x), A::k2);
+                        a->kmovw(A::k2, A::k1);
+                        a->vpscatterdd(A::FOUR, ix, arg[immA],  4, r(y), A::k2);
+                        a->kmovw(A::k2, A::k1);
+                        a->vpscatterdd(A::FOUR, ix, arg[immA],  8, r(z), A::k2);
+                        a->kmovw(A::k2, A::k1);
+                        a->vpscatterdd(A::FOUR, ix, arg[immA], 12, r(w), A::k2);
+                        free_tmp(ix);
+                        break;
+                    }
                     // TODO: >32-bit stores
                     a->vmovd  (A::Mem{arg[immA], 0*16 +  0}, (A::Xmm)r(x)   );
                     a->vmovd  (A::Mem{arg[immA], 0*16 +  4}, (A::Xmm)r(y)   );
@@ -3496,25 +3943,37 @@ namespace skvm {
                     a->vpextrd(A::Mem{arg[immA], 7*16 + 12}, (A::Xmm)dst(), 3);
                 } break;
 
-                case Op::load8:  if (scalar) {
+                case Op::load8:  if (avx512) {
+                                     a->vpmovzxbd(dst(), A::Mem{arg[immA]}, A::k1);
+                                 } else if (scalar) {
                                      a->vpxor  (dst(), dst(), dst());
                                      a->vpinsrb((A::Xmm)dst(), (A::Xmm)dst(), A::Mem{arg[immA]}, 0);
                                  } else {
                                      a->vpmovzxbd(dst(), A::Mem{arg[immA]});
                                  } break;
 
-                case Op::load16: if (scalar) {
+                case Op::load16: if (avx512) {
+                                     a->vpmovzxwd(dst(), A::Mem{arg[immA]}, A::k1);
+                                 } else if (scalar) {
                                      a->vpxor  (dst(), dst(), dst());
                                      a->vpinsrw((A::Xmm)dst(), (A::Xmm)dst(), A::Mem{arg[immA]}, 0);
                                  } else {
                                      a->vpmovzxwd(dst(), A::Mem{arg[immA]});
                                  } break;
 
-                case Op::load32: if (scalar) { a->vmovd  ((A::Xmm)dst(), A::Mem{arg[immA]}); }
-                                 else        { a->vmovups(        dst(), A::Mem{arg[immA]}); }
+                case Op::load32: if (avx512) { a->vmovdqu32(dst(), A::Mem{arg[immA]}, A::k1); }
+                            else if (scalar) { a->vmovd    ((A::Xmm)dst(), A::Mem{arg[immA]}); }
+                            else             { a->vmovups  (        dst(), A::Mem{arg[immA]}); }
                                  break;
 
-                case Op::load64: if (scalar) {
+                case Op::load64: if (avx512) {
+                                    // Gather every other 32-bit value, starting at immB.
+                                    A::Ymm ix = alloc_tmp();
+                                    a->vmovups(ix, &stride2_index);
+                                    a->kmovw(A::k2, A::k1);
+                                    a->vpgatherdd(dst(), A::FOUR, ix, arg[immA], 4*immB, A::k2);
+                                    free_tmp(ix);
+                                 } else if (scalar) {
                                     a->vmovd((A::Xmm)dst(), A::Mem{arg[immA], 4*immB});
                                  } else {
                                     A::Ymm tmp = alloc_tmp();
@@ -3526,7 +3985,13 @@ namespace skvm {
                                     free_tmp(tmp);
                                  } break;
 
-                case Op::load128: if (scalar) {
+                case Op::load128: if (avx512) {
+                                      A::Ymm ix = alloc_tmp();
+                                      a->vmovups(ix, &stride4_index);
+                                      a->kmovw(A::k2, A::k1);
+                                      a->vpgatherdd(dst(), A::FOUR, ix, arg[immA], 4*immB, A::k2);
+                                      free_tmp(ix);
+                                  } else if (scalar) {
                                       a->vmovd((A::Xmm)dst(), A::Mem{arg[immA], 4*immB});
                                   } else {
                                       // Load 4 low values into xmm tmp,
@@ -3549,7 +4014,25 @@ namespace skvm {
                                       free_tmp(tmp);
                                   } break;
 
-                case Op::gather8: {
+                case Op::gather8: if (avx512) {
+                    a->mov(GP0, A::Mem{arg[immA], immB});
+
+                    // Zero the indices of inactive lanes so we don't read out of bounds for them.
+                    A::Ymm ix  = alloc_tmp(),
+                           tmp = alloc_tmp();
+                    a->vmovdqu32(ix, any(x), A::k1);
+
+                    for (int i = 0; i < K; i++) {
+                        if (i % 4 == 0) {
+                            a->vextracti128((A::Xmm)tmp, ix, i/4);
+                        }
+                        a->vpextrd(GP1, (A::Xmm)tmp, i%4);
+                        a->vpinsrb((A::Xmm)dst(), (A::Xmm)dst(), A::Mem{GP0,0,GP1,A::ONE}, i);
+                    }
+                    a->vpmovzxbd(dst(), dst());
+                    free_tmp(ix);
+                    free_tmp(tmp);
+                } else {
                     // As usual, the gather base pointer is immB bytes off of uniform immA.
                     a->mov(GP0, A::Mem{arg[immA], immB});
 
@@ -3569,7 +4052,29 @@ namespace skvm {
                     free_tmp(tmp);
                 } break;
 
-                case Op::gather16: {
+                case Op::gather16: if (avx512) {
+                    // As gather8, but 16 16-bit values take two xmm registers, dst() and hi.
+                    a->mov(GP0, A::Mem{arg[immA], immB});
+
+                    A::Ymm ix  = alloc_tmp(),
+                           tmp = alloc_tmp(),
+                           hi  = alloc_tmp();
+                    a->vmovdqu32(ix, any(x), A::k1);
+
+                    for (int i = 0; i < K; i++) {
+                        if (i % 4 == 0) {
+                            a->vextracti128((A::Xmm)tmp, ix, i/4);
+                        }
+                        a->vpextrd(GP1, (A::Xmm)tmp, i%4);
+                        A::Xmm half = i < 8 ? (A::Xmm)dst() : (A::Xmm)hi;
+                        a->vpinsrw(half, half, A::Mem{GP0,0,GP1,A::TWO}, i%8);
+                    }
+                    a->vinserti128(dst(), dst(), (A::Xmm)hi, 1);
+                    a->vpmovzxwd(dst(), dst());
+                    free_tmp(ix);
+                    free_tmp(tmp);
+                    free_tmp(hi);
+                } else {
                     // Just as gather8 except vpinsrb->vpinsrw, ONE->TWO, and vpmovzxbd->vpmovzxwd.
                     a->mov(GP0, A::Mem{arg[immA], immB});
 
@@ -3588,7 +4093,11 @@ namespace skvm {
                 } break;
 
                 case Op::gather32:
-                if (scalar) {
+                if (avx512) {
+                    a->mov(GP0, A::Mem{arg[immA], immB});
+                    a->kmovw(A::k2, A::k1);
+                    a->vpgatherdd(dst(), A::FOUR, r(x), GP0, 0, A::k2);
+                } else if (scalar) {
                     // Our gather base pointer is immB bytes off of uniform immA.
                     a->mov(GP0, A::Mem{arg[immA], immB});
 
@@ -3692,6 +4201,10 @@ namespace skvm {
                 case Op::bit_clear: a->vpandn(dst(y), r(y), any(x)); break; // Notice, y then x.
 
                 case Op::select:
+                    if (avx512) {
+                        a->vpmovd2m(A::k2, r(x));
+                        a->vpblendmd(dst(x,z), A::k2, r(z), any(y));
+                    } else
                     if (try_alias(z)) { a->vpblendvb(dst(z), r(z), any(y), r(x)); }
                     else              { a->vpblendvb(dst(x), r(z), any(y), r(x)); }
                                         break;
@@ -3700,24 +4213,52 @@ namespace skvm {
                 case Op::shr_i32: a->vpsrld(dst(x), r(x), immA); break;
                 case Op::sra_i32: a->vpsrad(dst(x), r(x), immA); break;
 
+                // AVX-512 compares write to k2, which we then expand back out to a vector mask.
                 case Op::eq_i32:
+                    if (avx512) {
+                        if (in_reg(x)) { a->vpcmpeqd(A::k2, r(x), any(y)); }
+                        else           { a->vpcmpeqd(A::k2, r(y), any(x)); }
+                        a->vpmovm2d(dst(), A::k2);
+                    } else
                     if (in_reg(x)) { a->vpcmpeqd(dst(x), r(x), any(y)); }
                     else           { a->vpcmpeqd(dst(y), r(y), any(x)); }
                                      break;
 
-                case Op::gt_i32: a->vpcmpgtd(dst(), r(x), any(y)); break;
+                case Op::gt_i32:
+                    if (avx512) { a->vpcmpgtd(A::k2, r(x), any(y));
+                                  a->vpmovm2d(dst(), A::k2); }
+                    else        { a->vpcmpgtd(dst(), r(x), any(y)); }
+                                  break;
 
                 case Op::eq_f32:
+                    if (avx512) {
+                        if (in_reg(x)) { a->vcmpps(A::k2, r(x), any(y), 0); }
+                        else           { a->vcmpps(A::k2, r(y), any(x), 0); }
+                        a->vpmovm2d(dst(), A::k2);
+                    } else
                     if (in_reg(x)) { a->vcmpeqps(dst(x), r(x), any(y)); }
                     else           { a->vcmpeqps(dst(y), r(y), any(x)); }
                                      break;
                 case Op::neq_f32:
+                    if (avx512) {
+                        if (in_reg(x)) { a->vcmpps(A::k2, r(x), any(y), 4); }
+                        else           { a->vcmpps(A::k2, r(y), any(x), 4); }
+                        a->vpmovm2d(dst(), A::k2);
+                    } else
                     if (in_reg(x)) { a->vcmpneqps(dst(x), r(x), any(y)); }
                     else           { a->vcmpneqps(dst(y), r(y), any(x)); }
                                      break;
 
-                case Op:: gt_f32: a->vcmpltps (dst(y), r(y), any(x)); break;
-                case Op::gte_f32: a->vcmpleps (dst(y), r(y), any(x)); break;
+                case Op:: gt_f32:
+                    if (avx512) { a->vcmpps(A::k2, r(y), any(x), 1);
+                                  a->vpmovm2d(dst(), A::k2); }
+                    else        { a->vcmpltps (dst(y), r(y), any(x)); }
+                                  break;
+                case Op::gte_f32:
+                    if (avx512) { a->vcmpps(A::k2, r(y), any(x), 2);
+                                  a->vpmovm2d(dst(), A::k2); }
+                    else        { a->vcmpleps (dst(y), r(y), any(x)); }
+                                  break;
 
                 case Op::ceil:
                     if (in_reg(x)) { a->vroundps(dst(x),  r(x), Assembler::CEIL); }
@@ -3750,9 +4291,13 @@ namespace skvm {
                     break;
 
                 case Op::from_fp16:
-                    a->vpackusdw(dst(x), r(x), r(x));  // f16 ymm -> f16 xmm
-                    a->vpermq   (dst(), dst(), 0xd8);  // swap middle two 64-bit lanes
-                    a->vcvtph2ps(dst(), dst());        // f16 xmm -> f32 ymm
+                    if (avx512) {
+                        a->vpmovdw(dst(x), r(x), A::k0);   // f16 zmm -> f16 ymm
+                    } else {
+                        a->vpackusdw(dst(x), r(x), r(x));  // f16 ymm -> f16 xmm
+                        a->vpermq   (dst(), dst(), 0xd8);  // swap middle two 64-bit lanes
+                    }
+                    a->vcvtph2ps(dst(), dst());            // f16 xmm -> f32 ymm
                     break;
 
             #elif defined(__aarch64__)
@@ -4033,6 +4578,12 @@ namespace skvm {
                  done;
 
         enter();
+    #if defined(__x86_64__) || defined(_M_X64)
+        if (avx512) {
+            a->mov(GP0, -1);
+            a->kmovw(A::k1, GP0);  // All 16 lanes active until the tail.
+        }
+    #endif
         for (Val id = 0; id < (Val)instructions.size(); id++) {
             if (instructions[id].can_hoist && !emit(id, /*scalar=*/false)) {
                 return false;
@@ -4077,6 +4628,22 @@ namespace skvm {
         }
 
         a->label(&tail);
+    #if defined(__x86_64__) || defined(_M_X64)
+        if (avx512) {
+            // Run the last N<16 lanes through the body once more, with only N lanes active.
+            a->cmp(N, 1);
+            jump_if_less(&done);
+            a->mov (GP0, -1);
+            a->bzhi(GP0, GP0, N);
+            a->kmovw(A::k1, GP0);
+            for (Val id = 0; id < (Val)instructions.size(); id++) {
+                if (!instructions[id].can_hoist && !emit(id, /*scalar=*/false)) {
+                    return false;
+                }
+            }
+            restore_incoming_regs();
+        } else
+    #endif
         {
             a->cmp(N, 1);
             jump_if_less(&done);
@@ -4121,6 +4688,21 @@ namespace skvm {
             }
         }
 
+        if (!stride2_index.references.empty()) {
+            a->align(4);
+            a->label(&stride2_index);  // 0,2,4,6,...
+            for (int i = 0; i < K; i++) {
+                a->word(2*i);
+            }
+        }
+        if (!stride4_index.references.empty()) {
+            a->align(4);
+            a->label(&stride4_index);  // 0,4,8,12,...
+            for (int i = 0; i < K; i++) {
+                a->word(4*i);
+            }
+        }
+
         if (!load64_index.references.empty()) {
             a->align(4);
             a->label(&load64_index);  // {0,2,4,6|1,3,5,7}
@@ -10,6 +10,7 @@
 
 #include "include/core/SkBlendMode.h"
 #include "include/core/SkColor.h"
+#include "include/core/SkRefCnt.h"
 #include "include/core/SkSpan.h"
 #include "include/private/SkMacros.h"
 #include "include/private/SkTArray.h"
@@ -17,6 +18,7 @@
 #include "src/core/SkVM_fwd.h"
 #include <vector>      // std::vector
 
+class SkData;
 class SkWStream;
 
 #if defined(SKVM_JIT_WHEN_POSSIBLE) && !defined(SK_BUILD_FOR_IOS)
@@ -26,7 +28,7 @@ class SkWStream;
         #endif
     #endif
     #if defined(__aarch64__)
-        #if defined(__ANDROID__) || defined(__APPLE__)
+        #if defined(__ANDROID__) || defined(__APPLE__) || defined(__linux)
             #define SKVM_JIT
         #endif
     #endif
@@ -61,6 +63,7 @@ namespace skvm {
             ymm0, ymm1, ymm2 , ymm3 , ymm4 , ymm5 , ymm6 , ymm7 ,
             ymm8, ymm9, ymm10, ymm11, ymm12, ymm13, ymm14, ymm15,
         };
+        enum Opmask { k0, k1, k2, k3, k4, k5, k6, k7 };  // AVX-512 lane masks.
 
         // X and V values match 5-bit encoding for each (nothing tricky).
         enum X {
@@ -115,6 +118,7 @@ namespace skvm {
             Operand(GP64   r) : reg  (r), kind(REG  ) {}
             Operand(Xmm    r) : reg  (r), kind(REG  ) {}
             Operand(Ymm    r) : reg  (r), kind(REG  ) {}
+            Operand(Opmask r) : reg  (r), kind(REG  ) {}
             Operand(Mem    m) : mem  (m), kind(MEM  ) {}
             Operand(Label* l) : label(l), kind(LABEL) {}
         };
@@ -226,6 +230,7 @@ namespace skvm {
         void vpinsrw(Xmm dst, Xmm src, Operand y, int imm);  // dst = src; dst[imm] = y, 16-bit
         void vpinsrb(Xmm dst, Xmm src, Operand y, int imm);  // dst = src; dst[imm] = y,  8-bit
 
+        void vinserti128 (Ymm dst, Ymm x, Operand y, int imm);  // dst = x; dst[imm] = y, 128-bit
         void vextracti128(Operand dst, Ymm src, int imm);    // dst = src[imm], 128-bit
         void vpextrd     (Operand dst, Xmm src, int imm);    // dst = src[imm],  32-bit
         void vpextrw     (Operand dst, Xmm src, int imm);    // dst = src[imm],  16-bit
@@ -237,6 +242,46 @@ namespace skvm {
         // mask = 0;
         void vgatherdps(Ymm dst, Scale scale, Ymm ix, GP64 base, Ymm mask);
 
+        void bzhi(GP64 dst, Operand x, GP64 index);  // dst = x with bits index and above cleared
+
+        // AVX-512.  With use_zmm(true), every instruction above that takes Ymm registers
+        // instead operates on the 512-bit zmm register of the same number, EVEX encoded.
+        // Xmm instructions are unaffected.  The instructions below need use_zmm(true).
+        //
+        // Masked loads zero lanes that are off in the mask, masked stores leave them untouched,
+        // and neither touches memory for those lanes.  As a mask, k0 means all lanes.
+        void use_zmm(bool on) { fZmm = on; }
+
+        void kmovw(Opmask dst, GP64 src);    // dst = low 16 bits of src
+        void kmovw(Opmask dst, Opmask src);
+
+        void vmovdqu32(Ymm dst, Operand src, Opmask);
+        void vmovdqu32(Operand dst, Ymm src, Opmask);
+        void vpmovzxbd(Ymm dst, Operand src, Opmask);
+        void vpmovzxwd(Ymm dst, Operand src, Opmask);
+        void vpmovdb  (Operand dst, Ymm src, Opmask);  // dst = src, int -> uint8_t,  truncating
+        void vpmovdw  (Operand dst, Ymm src, Opmask);  // dst = src, int -> uint16_t, truncating
+
+        void vpcmpeqd(Opmask dst, Ymm x, Operand y);
+        void vpcmpgtd(Opmask dst, Ymm x, Operand y);
+        void vcmpps  (Opmask dst, Ymm x, Operand y, int imm);
+
+        void vpmovm2d (Ymm dst, Opmask src);               // dst[i] = src[i] ? ~0 : 0
+        void vpmovd2m (Opmask dst, Ymm src);               // dst[i] = src[i] < 0
+        void vpblendmd(Ymm dst, Opmask, Ymm x, Operand y);  // dst[i] = mask[i] ? y[i] : x[i]
+
+        // if (mask[i]) {
+        //     dst[i] = *(base + disp + scale*ix[i]);
+        // }
+        // mask = 0;
+        void vpgatherdd(Ymm dst, Scale, Ymm ix, GP64 base, int disp, Opmask mask);
+
+        // if (mask[i]) {
+        //     *(base + disp + scale*ix[i]) = src[i];
+        // }
+        // mask = 0;
+        void vpscatterdd(Scale, Ymm ix, GP64 base, int disp, Ymm src, Opmask mask);
+
 
         void label(Label*);
 
@@ -393,8 +438,12 @@ namespace skvm {
         enum W { W0, W1 };      // Are the lanes 64-bit (W1) or default (W0)?  Intel Vol 2A 2.3.5.5
         enum L { L128, L256 };  // Is this a 128- or 256-bit operation?        Intel Vol 2A 2.3.6.2
 
+        bool fZmm = false;      // Promote L256 operations to 512-bit EVEX?
+
         // Helpers for vector instructions.
         void op(int prefix, int map, int opcode, int dst, int x, Operand y, W,L);
+        void evex_op(int prefix, int map, int opcode, int dst, int x, Operand y, W,
+                     Opmask = k0, bool zero_masked = false);
         void op(int p, int m, int o, Ymm d, Ymm x, Operand y, W w=W0) { op(p,m,o, d,x,y,w,L256); }
         void op(int p, int m, int o, Ymm d,        Operand y, W w=W0) { op(p,m,o, d,0,y,w,L256); }
         void op(int p, int m, int o, Xmm d, Xmm x, Operand y, W w=W0) { op(p,m,o, d,x,y,w,L128); }
@@ -583,7 +632,9 @@ namespace skvm {
         Builder();
         explicit Builder(Features);
 
-        Program done(const char* debug_name = nullptr, bool allow_jit=true) const;
+        // Only a serializable Program keeps the instructions serialize() needs.
+        Program done(const char* debug_name = nullptr, bool allow_jit=true,
+                     bool serializable=false) const;
 
         // Mostly for debugging, tests, etc.
         std::vector<Instruction> program() const { return fProgram; }
@@ -956,7 +1007,7 @@ namespace skvm {
     public:
         Program(const std::vector<OptimizedInstruction>& instructions,
                 const std::vector<int>& strides,
-                const char* debug_name, bool allow_jit);
+                const char* debug_name, bool allow_jit, bool serializable = false);
 
         Program();
         ~Program();
@@ -985,8 +1036,20 @@ namespace skvm {
 
         bool hasJIT() const;  // Has this Program been JITted?
 
+        size_t approxBytesUsed() const;  // Roughly how much memory this Program holds on to.
+
         void dump(SkWStream* = nullptr) const;
 
+        // Serialize this Program's optimized instructions and pointer strides, never machine code.
+        // Returns null unless the Program was built serializable by Builder::done().
+        // Deserialize() validates every instruction, returns an empty() Program if the data is
+        // malformed or from an incompatible version of Skia, and JITs the instructions again,
+        // which is still much cheaper than Builder::done().  The checksum only catches accidents;
+        // callers must still check that uniform offsets fit the uniforms they will pass.
+        sk_sp<SkData> serialize() const;
+        static Program Deserialize(const void* data, size_t size,
+                                   const char* debug_name = nullptr, bool allow_jit = true);
+
     private:
         void setupInterpreter(const std::vector<OptimizedInstruction>&);
         void setupJIT        (const std::vector<OptimizedInstruction>&, const char* debug_name);
@@ -5,23 +5,32 @@
  * found in the LICENSE file.
  */
 
+#include "include/core/SkData.h"
+#include "include/core/SkGraphics.h"
+#include "include/core/SkTime.h"
 #include "include/private/SkImageInfoPriv.h"
 #include "include/private/SkMacros.h"
+#include "include/private/SkMutex.h"
+#include "include/private/SkOnce.h"
+#include "include/private/SkTHash.h"
 #include "src/core/SkArenaAlloc.h"
 #include "src/core/SkBlendModePriv.h"
 #include "src/core/SkColorFilterBase.h"
 #include "src/core/SkColorSpacePriv.h"
 #include "src/core/SkColorSpaceXformSteps.h"
 #include "src/core/SkCoreBlitters.h"
-#include "src/core/SkLRUCache.h"
 #include "src/core/SkMatrixProvider.h"
 #include "src/core/SkOpts.h"
 #include "src/core/SkPaintPriv.h"
+#include "src/core/SkTInternalLList.h"
 #include "src/core/SkVM.h"
 #include "src/shaders/SkColorFilterShader.h"
 
 #include <cinttypes>
 
+// Set by SkGraphics::SetPersistentProgramCache().
+SkGraphics::PersistentProgramCache* gSkVMPersistentProgramCache = nullptr;
+
 namespace {
 
     // Uniforms set by the Blitter itself,
@@ -95,19 +104,172 @@ namespace {
             key.coverage);
     }
 
-    static SkLRUCache<Key, skvm::Program>* try_acquire_program_cache() {
-    #if 1 && defined(SKVM_JIT)
-        thread_local static SkLRUCache<Key, skvm::Program> cache{64};
-        return &cache;
-    #else
-        // iOS in particular does not support thread_local until iOS 9.0.
-        // On the other hand, we'll never be able to JIT there anyway.
-        // It's probably fine to not cache any interpreted programs, anywhere.
-        return nullptr;
-    #endif
+    // Every thread shares the programs we compile through this process-wide cache.  It's split
+    // into shards by Key hash, each with its own lock and its share of the byte budget, so that
+    // blitters on different threads rarely contend.  An entry is inserted before its program is
+    // compiled, and anyone else who wants it waits for that compile rather than starting another.
+    class ProgramCache {
+    public:
+        struct Entry : public SkNVRefCnt<Entry> {
+            explicit Entry(const Key& k) : key(k) {}
+
+            const Key     key;
+            SkOnce        compiled;
+            skvm::Program program;     // Set once, inside compiled().
+            size_t        bytes = 0;   // Guarded by the shard's mutex; 0 until compiled.
+
+            SK_DECLARE_INTERNAL_LLIST_INTERFACE(Entry);
+        };
+
+        static ProgramCache* Get() {
+            static ProgramCache* cache = new ProgramCache;
+            return cache;
+        }
+
+        // Returns the Entry for key, creating it (with its program not yet compiled) if needed.
+        sk_sp<Entry> find(const Key& key) {
+            Shard& shard = this->shard(key);
+            SkAutoMutexExclusive lock(shard.mutex);
+            if (sk_sp<Entry>* found = shard.map.find(key)) {
+                if (found->get() != shard.lru.head()) {
+                    shard.lru.remove(found->get());
+                    shard.lru.addToHead(found->get());
+                }
+                fHits++;
+                gThreadHits++;
+                return *found;
+            }
+            sk_sp<Entry> entry = sk_make_sp<Entry>(key);
+            shard.map.set(key, entry);
+            shard.lru.addToHead(entry.get());
+            fMisses++;
+            gThreadMisses++;
+            return entry;
+        }
+
+        // Called once the program in entry has been compiled, taking compileNanos to do so.
+        void didCompile(Entry* entry, double compileNanos) {
+            fCompileNanos += (uint64_t)compileNanos;
+
+            Shard& shard = this->shard(entry->key);
+            SkAutoMutexExclusive lock(shard.mutex);
+            sk_sp<Entry>* found = shard.map.find(entry->key);
+            if (!found || found->get() != entry) {
+                return;  // Purged while we were compiling.
+            }
+            entry->bytes = entry->program.approxBytesUsed();
+            shard.bytes += entry->bytes;
+            this->purgeShard(&shard, fLimit.load(std::memory_order_relaxed) / kShards);
+        }
+
+        size_t getLimit() const { return fLimit.load(std::memory_order_relaxed); }
+
+        size_t setLimit(size_t bytes) {
+            size_t prev = fLimit.exchange(bytes, std::memory_order_relaxed);
+            if (bytes < prev) {
+                this->purge(bytes);
+            }
+            return prev;
+        }
+
+        size_t getUsed() {
+            size_t used = 0;
+            for (Shard& shard : fShards) {
+                SkAutoMutexExclusive lock(shard.mutex);
+                used += shard.bytes;
+            }
+            return used;
+        }
+
+        static SkGraphics::ProgramCacheStats ThreadStats() {
+            SkGraphics::ProgramCacheStats stats;
+            stats.fHits   = gThreadHits;
+            stats.fMisses = gThreadMisses;
+            return stats;
+        }
+
+        SkGraphics::ProgramCacheStats stats() const {
+            SkGraphics::ProgramCacheStats stats;
+            stats.fHits         = fHits.load(std::memory_order_relaxed);
+            stats.fMisses       = fMisses.load(std::memory_order_relaxed);
+            stats.fCompileNanos = fCompileNanos.load(std::memory_order_relaxed);
+            return stats;
+        }
+
+        void purge(size_t limit) {
+            for (Shard& shard : fShards) {
+                SkAutoMutexExclusive lock(shard.mutex);
+                this->purgeShard(&shard, limit / kShards);
+            }
+        }
+
+    private:
+        static constexpr int kShards = 16;
+        static constexpr size_t kDefaultLimit = 8*1024*1024;
+
+        struct Shard {
+            SkMutex                            mutex;
+            SkTHashMap<Key, sk_sp<Entry>>      map;
+            SkTInternalLList<Entry>            lru;
+            size_t                             bytes = 0;
+        };
+
+        Shard& shard(const Key& key) { return fShards[SkGoodHash()(key) % kShards]; }
+
+        void purgeShard(Shard* shard, size_t limit) {
+            while (shard->bytes > limit) {
+                Entry* victim = shard->lru.tail();
+                SkASSERT(victim);
+                shard->lru.remove(victim);
+                shard->bytes -= victim->bytes;
+                shard->map.remove(victim->key);  // Blitters still using victim keep it alive.
+            }
+        }
+
+        // fHits and fMisses count every thread; these count only the calling thread's finds.
+        static thread_local uint64_t gThreadHits,
+                                     gThreadMisses;
+
+        Shard                 fShards[kShards];
+        std::atomic<size_t>   fLimit{kDefaultLimit};
+        std::atomic<uint64_t> fHits{0},
+                              fMisses{0},
+                              fCompileNanos{0};
+    };
+
+    thread_local uint64_t ProgramCache::gThreadHits   = 0;
+    thread_local uint64_t ProgramCache::gThreadMisses = 0;
+
+    // The persistent cache sees the Key's bytes behind a tag, in case a client shares one store
+    // between us and other users.
+    static sk_sp<SkData> persistent_key(const Key& key) {
+        static constexpr uint32_t kTag = SkSetFourByteTag('s','k','v','b');
+        sk_sp<SkData> data = SkData::MakeUninitialized(sizeof(kTag) + sizeof(key));
+        auto bytes = static_cast<char*>(data->writable_data());
+        memcpy(bytes, &kTag, sizeof(kTag));
+        memcpy(bytes + sizeof(kTag), &key, sizeof(key));
+        return data;
     }
 
-    static void release_program_cache() { }
+    // A Program loaded from the persistent cache may only read uniforms we will actually pass:
+    // fUniforms through the first argument, and a lone float for Coverage::UniformF.
+    static bool uniforms_fit(const skvm::Program& program, size_t uniformBytes) {
+        for (const skvm::InterpreterInstruction& inst : program.instructions()) {
+            size_t size;
+            switch (inst.op) {
+                case skvm::Op::uniform32: size = sizeof(int);   break;
+                case skvm::Op::gather8:
+                case skvm::Op::gather16:
+                case skvm::Op::gather32:  size = sizeof(void*); break;
+                default: continue;
+            }
+            size_t limit = inst.immA == 0 ? uniformBytes : sizeof(float);
+            if (inst.immB < 0 || (size_t)inst.immB + size > limit) {
+                return false;
+            }
+        }
+        return true;
+    }
 
     static skvm::Coord device_coord(skvm::Builder* p, skvm::Uniforms* uniforms) {
         skvm::I32 dx = p->uniform32(uniforms->base, offsetof(BlitterUniforms, right))
@@ -553,23 +715,6 @@ namespace {
             , fKey(cache_key(fParams, &fUniforms, &fAlloc, ok))
         {}
 
-        ~Blitter() override {
-            if (SkLRUCache<Key, skvm::Program>* cache = try_acquire_program_cache()) {
-                auto cache_program = [&](skvm::Program&& program, Coverage coverage) {
-                    if (!program.empty()) {
-                        cache->insert_or_update(fKey.withCoverage(coverage), std::move(program));
-                    }
-                };
-                cache_program(std::move(fBlitH),         Coverage::Full);
-                cache_program(std::move(fBlitAntiH),     Coverage::UniformF);
-                cache_program(std::move(fBlitMaskA8),    Coverage::MaskA8);
-                cache_program(std::move(fBlitMask3D),    Coverage::Mask3D);
-                cache_program(std::move(fBlitMaskLCD16), Coverage::MaskLCD16);
-
-                release_program_cache();
-            }
-        }
-
     private:
         SkPixmap        fDevice;
         const SkPixmap  fSprite;                  // See isSprite().
@@ -578,24 +723,41 @@ namespace {
         SkArenaAlloc    fAlloc{2*sizeof(void*)};  // but a few effects need to ref large content.
         const Params    fParams;
         const Key       fKey;
-        skvm::Program   fBlitH,
-                        fBlitAntiH,
-                        fBlitMaskA8,
-                        fBlitMask3D,
-                        fBlitMaskLCD16;
-
-        skvm::Program buildProgram(Coverage coverage) {
+        const skvm::Program* fBlitH         = nullptr,
+                           * fBlitAntiH     = nullptr,
+                           * fBlitMaskA8    = nullptr,
+                           * fBlitMask3D    = nullptr,
+                           * fBlitMaskLCD16 = nullptr;
+        sk_sp<ProgramCache::Entry> fPrograms[5];  // Keeps the programs above alive, by Coverage.
+
+        const skvm::Program* buildProgram(Coverage coverage) {
             Key key = fKey.withCoverage(coverage);
-            {
-                skvm::Program p;
-                if (SkLRUCache<Key, skvm::Program>* cache = try_acquire_program_cache()) {
-                    if (skvm::Program* found = cache->find(key)) {
-                        p = std::move(*found);
+            ProgramCache* cache = ProgramCache::Get();
+            sk_sp<ProgramCache::Entry> entry = cache->find(key);
+
+            // Usually the thread that created the entry compiles it, but whoever gets here first
+            // does the work while any others wait.
+            entry->compiled([&]{
+                double start = SkTime::GetNSecs();
+                entry->program = this->compileProgram(key, coverage);
+                cache->didCompile(entry.get(), SkTime::GetNSecs() - start);
+            });
+            const skvm::Program* program = &entry->program;
+            fPrograms[(int)coverage] = std::move(entry);
+            return program;
+        }
+
+        skvm::Program compileProgram(const Key& key, Coverage coverage) {
+            SkGraphics::PersistentProgramCache* persistentCache = gSkVMPersistentProgramCache;
+            sk_sp<SkData> persistentKey;
+            if (persistentCache) {
+                persistentKey = persistent_key(key);
+                if (sk_sp<SkData> data = persistentCache->load(*persistentKey)) {
+                    skvm::Program p = skvm::Program::Deserialize(data->data(), data->size(),
+                                                                 debug_name(key).c_str());
+                    if (!p.empty() && uniforms_fit(p, fUniforms.buf.size() * sizeof(int))) {
+                        return p;
                     }
-                    release_program_cache();
-                }
-                if (!p.empty()) {
-                    return p;
                 }
             }
             // We don't really _need_ to rebuild fUniforms here.
@@ -609,7 +771,13 @@ namespace {
             SkASSERTF(fUniforms.buf.size() == prev,
                       "%zu, prev was %zu", fUniforms.buf.size(), prev);
 
-            skvm::Program program = builder.done(debug_name(key).c_str());
+            skvm::Program program = builder.done(debug_name(key).c_str(), /*allow_jit=*/true,
+                                                 /*serializable=*/persistentCache != nullptr);
+            if (persistentCache) {
+                if (sk_sp<SkData> data = program.serialize()) {
+                    persistentCache->store(*persistentKey, *data);
+                }
+            }
             if (false) {
                 static std::atomic<int> missed{0},
                                          total{0};
@@ -642,28 +810,28 @@ namespace {
         }
 
         void blitH(int x, int y, int w) override {
-            if (fBlitH.empty()) {
+            if (!fBlitH) {
                 fBlitH = this->buildProgram(Coverage::Full);
             }
             this->updateUniforms(x+w, y);
             if (const void* sprite = this->isSprite(x,y)) {
-                fBlitH.eval(w, fUniforms.buf.data(), fDevice.addr(x,y), sprite);
+                fBlitH->eval(w, fUniforms.buf.data(), fDevice.addr(x,y), sprite);
             } else {
-                fBlitH.eval(w, fUniforms.buf.data(), fDevice.addr(x,y));
+                fBlitH->eval(w, fUniforms.buf.data(), fDevice.addr(x,y));
             }
         }
 
         void blitAntiH(int x, int y, const SkAlpha cov[], const int16_t runs[]) override {
-            if (fBlitAntiH.empty()) {
+            if (!fBlitAntiH) {
                 fBlitAntiH = this->buildProgram(Coverage::UniformF);
             }
             for (int16_t run = *runs; run > 0; run = *runs) {
                 this->updateUniforms(x+run, y);
                 const float covF = *cov * (1/255.0f);
                 if (const void* sprite = this->isSprite(x,y)) {
-                    fBlitAntiH.eval(run, fUniforms.buf.data(), fDevice.addr(x,y), sprite, &covF);
+                    fBlitAntiH->eval(run, fUniforms.buf.data(), fDevice.addr(x,y), sprite, &covF);
                 } else {
-                    fBlitAntiH.eval(run, fUniforms.buf.data(), fDevice.addr(x,y), &covF);
+                    fBlitAntiH->eval(run, fUniforms.buf.data(), fDevice.addr(x,y), &covF);
                 }
                 x    += run;
                 runs += run;
@@ -681,24 +849,24 @@ namespace {
                 default: SkUNREACHABLE;     // ARGB and SDF masks shouldn't make it here.
 
                 case SkMask::k3D_Format:
-                    if (fBlitMask3D.empty()) {
+                    if (!fBlitMask3D) {
                         fBlitMask3D = this->buildProgram(Coverage::Mask3D);
                     }
-                    program = &fBlitMask3D;
+                    program = fBlitMask3D;
                     break;
 
                 case SkMask::kA8_Format:
-                    if (fBlitMaskA8.empty()) {
+                    if (!fBlitMaskA8) {
                         fBlitMaskA8 = this->buildProgram(Coverage::MaskA8);
                     }
-                    program = &fBlitMaskA8;
+                    program = fBlitMaskA8;
                     break;
 
                 case SkMask::kLCD16_Format:
-                    if (fBlitMaskLCD16.empty()) {
+                    if (!fBlitMaskLCD16) {
                         fBlitMaskLCD16 = this->buildProgram(Coverage::MaskLCD16);
                     }
-                    program = &fBlitMaskLCD16;
+                    program = fBlitMaskLCD16;
                     break;
             }
 
@@ -711,7 +879,7 @@ namespace {
                     auto  mptr = (const uint8_t*)mask.getAddr(x,y);
                     this->updateUniforms(x+w,y);
 
-                    if (program == &fBlitMask3D) {
+                    if (program == fBlitMask3D) {
                         size_t plane = mask.computeImageSize();
                         if (const void* sprite = this->isSprite(x,y)) {
                             program->eval(w, fUniforms.buf.data(), dptr, sprite, mptr + 1*plane
@@ -762,3 +930,29 @@ SkBlitter* SkCreateSkVMSpriteBlitter(const SkPixmap& device,
                                         SkSimpleMatrixProvider{SkMatrix{}}, std::move(clip), &ok);
     return ok ? blitter : nullptr;
 }
+
+///////////////////////////////////////////////////////////////////////////////
+
+size_t SkGraphics::GetProgramCacheLimit() {
+    return ProgramCache::Get()->getLimit();
+}
+
+size_t SkGraphics::SetProgramCacheLimit(size_t bytes) {
+    return ProgramCache::Get()->setLimit(bytes);
+}
+
+size_t SkGraphics::GetProgramCacheUsed() {
+    return ProgramCache::Get()->getUsed();
+}
+
+SkGraphics::ProgramCacheStats SkGraphics::GetProgramCacheStats() {
+    return ProgramCache::Get()->stats();
+}
+
+void SkGraphics::PurgeProgramCache() {
+    ProgramCache::Get()->purge(0);
+}
+
+SkGraphics::ProgramCacheStats SkVMBlitterThreadProgramCacheStats() {
+    return ProgramCache::ThreadStats();
+}
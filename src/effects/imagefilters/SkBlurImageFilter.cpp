@@ -14,6 +14,7 @@
 #include "include/private/SkNx.h"
 #include "include/private/SkTFitsIn.h"
 #include "include/private/SkTPin.h"
+#include "include/private/SkTemplates.h"
 #include "src/core/SkArenaAlloc.h"
 #include "src/core/SkAutoPixmapStorage.h"
 #include "src/core/SkGpuBlurUtils.h"
@@ -21,7 +22,9 @@
 #include "src/core/SkOpts.h"
 #include "src/core/SkReadBuffer.h"
 #include "src/core/SkSpecialImage.h"
+#include "src/core/SkTaskGroup.h"
 #include "src/core/SkWriteBuffer.h"
+#include "src/effects/imagefilters/SkBlurImageFilterPriv.h"
 
 #if SK_SUPPORT_GPU
 #include "src/gpu/GrTextureProxy.h"
@@ -340,6 +343,99 @@ static void blur_one_direction(Sk4u* buffer, int window,
     }
 }
 
+// Each row of a pass is blurred independently of the others, so a pass can be split into bands of
+// rows (or columns) that run in parallel on an SkExecutor and still produce the same pixels. Bands
+// smaller than this many pixels are not worth handing to another thread.
+static constexpr int kMinBandPixels = 1 << 15;
+
+// The vertical pass works on strips of this many columns, one 64 byte cache line of each row.
+// Once columns are too tall for those lines to stay cached from one column to the next, each
+// strip is copied into a transposed scratch buffer, blurred in memory order, and transposed back.
+static constexpr int kStripWidth         = 16;
+static constexpr int kMinTransposeHeight = 256;
+
+// Call fn(begin, end) over [0, count), in bands of at least grain, in parallel on executor when
+// there is more than one band.
+template <typename Fn>
+static void for_each_band(SkExecutor* executor, int count, int grain, Fn&& fn) {
+    if (count <= grain) {
+        fn(0, count);
+        return;
+    }
+    SkTaskGroup tg(executor ? *executor : SkExecutor::GetDefault());
+    tg.parallel_for(0, count, grain, fn);
+}
+
+static void blur_x(SkExecutor* executor, int window, int srcLeft, int srcRight, int dstRight,
+                   const uint32_t* src, int srcRowBytesAsPixels, int srcH,
+                         uint32_t* dst, int dstRowBytesAsPixels) {
+    const int bufferSize = calculate_buffer(window);
+    const int grain = std::max(1, kMinBandPixels / std::max(1, dstRight));
+    for_each_band(executor, srcH, grain, [&](int top, int bottom) {
+        // The amount 1024 is enough for buffers up to 10 sigma.
+        SkSTArenaAlloc<1024> alloc;
+        Sk4u* buffer = alloc.makeArrayDefault<Sk4u>(bufferSize);
+        blur_one_direction(buffer, window, srcLeft, srcRight, dstRight,
+                           src + (size_t)top * srcRowBytesAsPixels, 1, srcRowBytesAsPixels,
+                           bottom - top,
+                           dst + (size_t)top * dstRowBytesAsPixels, 1, dstRowBytesAsPixels);
+    });
+}
+
+static void blur_y(SkExecutor* executor, int window, int srcTop, int srcBottom, int dstBottom,
+                   const uint32_t* src, int srcRowBytesAsPixels, int srcW,
+                         uint32_t* dst, int dstRowBytesAsPixels) {
+    // Like blur_one_direction(), we read srcBottom - srcTop rows and write dstBottom rows.
+    const int srcH = srcBottom - srcTop,
+              dstH = dstBottom;
+    const int bufferSize = calculate_buffer(window);
+    const bool transpose = dstH >= kMinTransposeHeight;
+
+    const int strips = (srcW + kStripWidth - 1) / kStripWidth;
+    const int grain = std::max(1, kMinBandPixels / (kStripWidth * std::max(1, dstH)));
+    for_each_band(executor, strips, grain, [&](int firstStrip, int endStrip) {
+        SkSTArenaAlloc<1024> alloc;
+        Sk4u* buffer = alloc.makeArrayDefault<Sk4u>(bufferSize);
+
+        if (!transpose) {
+            const int left  = firstStrip * kStripWidth,
+                      right = std::min(endStrip * kStripWidth, srcW);
+            blur_one_direction(buffer, window, srcTop, srcBottom, dstBottom,
+                               src + left, srcRowBytesAsPixels, 1, right - left,
+                               dst + left, dstRowBytesAsPixels, 1);
+            return;
+        }
+
+        SkAutoTMalloc<uint32_t> transposed((size_t)kStripWidth * (srcH + dstH));
+        uint32_t* tSrc = transposed.get();
+        uint32_t* tDst = transposed.get() + (size_t)kStripWidth * srcH;
+
+        for (int strip = firstStrip; strip < endStrip; strip++) {
+            const int left  = strip * kStripWidth,
+                      width = std::min(kStripWidth, srcW - left);
+
+            // All of the strip is read before any of it is written, so src and dst may overlap.
+            const uint32_t* s = src + left;
+            for (int y = 0; y < srcH; y++, s += srcRowBytesAsPixels) {
+                for (int x = 0; x < width; x++) {
+                    tSrc[x * srcH + y] = s[x];
+                }
+            }
+
+            blur_one_direction(buffer, window, srcTop, srcBottom, dstBottom,
+                               tSrc, 1, srcH, width,
+                               tDst, 1, dstH);
+
+            uint32_t* d = dst + left;
+            for (int y = 0; y < dstH; y++, d += dstRowBytesAsPixels) {
+                for (int x = 0; x < width; x++) {
+                    d[x] = tDst[x * dstH + y];
+                }
+            }
+        }
+    });
+}
+
 static sk_sp<SkSpecialImage> copy_image_with_bounds(
         const SkImageFilter_Base::Context& ctx, const sk_sp<SkSpecialImage> &input,
         SkIRect srcBounds, SkIRect dstBounds) {
@@ -405,26 +501,18 @@ static sk_sp<SkSpecialImage> copy_image_with_bounds(
                                           dst, ctx.surfaceProps());
 }
 
-// TODO: Implement CPU backend for different fTileMode.
-static sk_sp<SkSpecialImage> cpu_blur(
-        const SkImageFilter_Base::Context& ctx,
-        SkVector sigma, const sk_sp<SkSpecialImage> &input,
-        SkIRect srcBounds, SkIRect dstBounds) {
+bool SkBlurImageFilterPriv::BlurBitmap(SkVector sigma, const SkBitmap& inputBM,
+                                       SkIRect srcBounds, SkIRect dstBounds, SkBitmap* dstBM,
+                                       SkExecutor* executor) {
     auto windowW = calculate_window(sigma.x()),
          windowH = calculate_window(sigma.y());
 
     if (windowW <= 1 && windowH <= 1) {
-        return copy_image_with_bounds(ctx, input, srcBounds, dstBounds);
-    }
-
-    SkBitmap inputBM;
-
-    if (!input->getROPixels(&inputBM)) {
-        return nullptr;
+        return false;
     }
 
     if (inputBM.colorType() != kN32_SkColorType) {
-        return nullptr;
+        return false;
     }
 
     SkBitmap src;
@@ -443,17 +531,9 @@ static sk_sp<SkSpecialImage> cpu_blur(
 
     SkBitmap dst;
     if (!dst.tryAllocPixels(dstInfo)) {
-        return nullptr;
+        return false;
     }
 
-    auto bufferSizeW = calculate_buffer(windowW),
-         bufferSizeH = calculate_buffer(windowH);
-
-    // The amount 1024 is enough for buffers up to 10 sigma. The tmp bitmap will be
-    // allocated on the heap.
-    SkSTArenaAlloc<1024> alloc;
-    Sk4u* buffer = alloc.makeArrayDefault<Sk4u>(std::max(bufferSizeW, bufferSizeH));
-
     // Basic Plan: The three cases to handle
     // * Horizontal and Vertical - blur horizontally while copying values from the source to
     //     the destination. Then, do an in-place vertical blur.
@@ -494,19 +574,41 @@ static sk_sp<SkSpecialImage> cpu_blur(
         intermediateWidth = dstW;
         intermediateDst = static_cast<uint32_t *>(dst.getPixels());
 
-        blur_one_direction(
-                buffer, windowW,
-                srcBounds.left(), srcBounds.right(), dstBounds.right(),
-                static_cast<uint32_t *>(src.getPixels()), 1, src.rowBytesAsPixels(), srcH,
-                intermediateSrc, 1, intermediateRowBytesAsPixels);
+        blur_x(executor, windowW,
+               srcBounds.left(), srcBounds.right(), dstBounds.right(),
+               static_cast<uint32_t *>(src.getPixels()), src.rowBytesAsPixels(), srcH,
+               intermediateSrc, intermediateRowBytesAsPixels);
     }
 
     if (windowH > 1) {
-        blur_one_direction(
-                buffer, windowH,
-                srcBounds.top(), srcBounds.bottom(), dstBounds.bottom(),
-                intermediateSrc, intermediateRowBytesAsPixels, 1, intermediateWidth,
-                intermediateDst, dst.rowBytesAsPixels(), 1);
+        blur_y(executor, windowH,
+               srcBounds.top(), srcBounds.bottom(), dstBounds.bottom(),
+               intermediateSrc, intermediateRowBytesAsPixels, intermediateWidth,
+               intermediateDst, dst.rowBytesAsPixels());
+    }
+
+    dstBM->swap(dst);
+    return true;
+}
+
+// TODO: Implement CPU backend for different fTileMode.
+static sk_sp<SkSpecialImage> cpu_blur(
+        const SkImageFilter_Base::Context& ctx,
+        SkVector sigma, const sk_sp<SkSpecialImage> &input,
+        SkIRect srcBounds, SkIRect dstBounds) {
+    if (calculate_window(sigma.x()) <= 1 && calculate_window(sigma.y()) <= 1) {
+        return copy_image_with_bounds(ctx, input, srcBounds, dstBounds);
+    }
+
+    SkBitmap inputBM;
+
+    if (!input->getROPixels(&inputBM)) {
+        return nullptr;
+    }
+
+    SkBitmap dst;
+    if (!SkBlurImageFilterPriv::BlurBitmap(sigma, inputBM, srcBounds, dstBounds, &dst)) {
+        return nullptr;
     }
 
     return SkSpecialImage::MakeFromRaster(SkIRect::MakeWH(dstBounds.width(),
@@ -0,0 +1,29 @@
+/*
+ * Copyright 2021 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkBlurImageFilterPriv_DEFINED
+#define SkBlurImageFilterPriv_DEFINED
+
+#include "include/core/SkPoint.h"
+#include "include/core/SkRect.h"
+
+class SkBitmap;
+class SkExecutor;
+
+namespace SkBlurImageFilterPriv {
+
+// The raster path of SkImageFilters::Blur(): blurs the pixels of src inside srcBounds into dst,
+// which is allocated to cover dstBounds. Both rects are in src's pixel coordinates. Large passes
+// are split into bands on executor, or SkExecutor::GetDefault() if it is null.
+// Returns false if src is not kN32_SkColorType, dst could not be allocated, or sigma is too
+// small to blur in either direction.
+bool BlurBitmap(SkVector sigma, const SkBitmap& src, SkIRect srcBounds, SkIRect dstBounds,
+                SkBitmap* dst, SkExecutor* executor = nullptr);
+
+}  // namespace SkBlurImageFilterPriv
+
+#endif
@@ -131,6 +131,15 @@ public:
     virtual bool getROPixels(GrDirectContext*, SkBitmap*,
                              CachingHint = kAllow_CachingHint) const = 0;
 
+    // Like getROPixels(), for a caller that will draw the pixels scaled by 'scale' (< 1 when
+    // minifying). Images that can produce smaller pixels cheaply (e.g. lazy JPEGs, via DCT
+    // scaling) may return a bitmap smaller than the image, so callers must map through the
+    // bitmap's own dimensions.
+    virtual bool getROPixelsAtScale(GrDirectContext* dContext, float /*scale*/, SkBitmap* bitmap,
+                                    CachingHint chint = kAllow_CachingHint) const {
+        return this->getROPixels(dContext, bitmap, chint);
+    }
+
     virtual sk_sp<SkImage> onMakeSubset(const SkIRect&, GrDirectContext*) const = 0;
 
     virtual sk_sp<SkData> onRefEncoded() const { return nullptr; }
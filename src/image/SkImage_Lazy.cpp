@@ -129,35 +129,76 @@ SkImage_Lazy::SkImage_Lazy(Validator* validator)
 
 bool SkImage_Lazy::getROPixels(GrDirectContext*, SkBitmap* bitmap,
                                SkImage::CachingHint chint) const {
-    auto check_output_bitmap = [bitmap]() {
+    auto desc = SkBitmapCacheDesc::Make(this);
+    if (SkBitmapCache::Find(desc, bitmap)) {
         SkASSERT(bitmap->isImmutable());
         SkASSERT(bitmap->getPixels());
-        (void)bitmap;
-    };
+        return true;
+    }
+    return this->decodeROPixels(desc, this->imageInfo(), bitmap, chint);
+}
 
-    auto desc = SkBitmapCacheDesc::Make(this);
-    if (SkBitmapCache::Find(desc, bitmap)) {
-        check_output_bitmap();
+bool SkImage_Lazy::getROPixelsAtScale(GrDirectContext* dContext, float scale, SkBitmap* bitmap,
+                                      SkImage::CachingHint chint) const {
+    SkISize scaledDims = this->scaledDimensions(scale);
+    if (scaledDims == this->dimensions()) {
+        return this->getROPixels(dContext, bitmap, chint);
+    }
+
+    // Any decode already in the cache beats decoding again, even if it is larger than needed.
+    if (SkBitmapCache::Find(SkBitmapCacheDesc::MakeScaled(this, scaledDims), bitmap) ||
+        SkBitmapCache::Find(SkBitmapCacheDesc::Make(this), bitmap)) {
+        SkASSERT(bitmap->isImmutable());
+        SkASSERT(bitmap->getPixels());
         return true;
     }
 
+    if (this->decodeROPixels(SkBitmapCacheDesc::MakeScaled(this, scaledDims),
+                             this->imageInfo().makeDimensions(scaledDims), bitmap, chint)) {
+        return true;
+    }
+    // The generator promised it could produce this size, but fall back to a full decode anyway.
+    return this->getROPixels(dContext, bitmap, chint);
+}
+
+SkISize SkImage_Lazy::scaledDimensions(float scale) const {
+    // Decode at twice the size the draw needs (one mip level up), so that filtering from the
+    // smaller decode looks like filtering from the full image. Only heavy minification qualifies.
+    static constexpr float kHeadroom = 2;
+    const float desiredScale = scale * kHeadroom;
+    if (!(desiredScale > 0 && desiredScale < 1)) {
+        return this->dimensions();
+    }
+
+    SkISize dims = ScopedGenerator(fSharedGenerator)->onGetScaledDimensions(desiredScale);
+    if (dims.isEmpty() ||
+        dims.width()  > this->width()  || dims.height() > this->height() ||
+        dims.width()  < scale * this->width() || dims.height() < scale * this->height()) {
+        return this->dimensions();
+    }
+    return dims;
+}
+
+bool SkImage_Lazy::decodeROPixels(const SkBitmapCacheDesc& desc, const SkImageInfo& info,
+                                  SkBitmap* bitmap, SkImage::CachingHint chint) const {
     if (SkImage::kAllow_CachingHint == chint) {
         SkPixmap pmap;
-        SkBitmapCache::RecPtr cacheRec = SkBitmapCache::Alloc(desc, this->imageInfo(), &pmap);
+        SkBitmapCache::RecPtr cacheRec = SkBitmapCache::Alloc(desc, info, &pmap);
         if (!cacheRec || !ScopedGenerator(fSharedGenerator)->getPixels(pmap)) {
             return false;
         }
         SkBitmapCache::Add(std::move(cacheRec), bitmap);
         this->notifyAddedToRasterCache();
     } else {
-        if (!bitmap->tryAllocPixels(this->imageInfo()) ||
+        if (!bitmap->tryAllocPixels(info) ||
             !ScopedGenerator(fSharedGenerator)->getPixels(bitmap->pixmap())) {
             return false;
         }
         bitmap->setImmutable();
     }
 
-    check_output_bitmap();
+    SkASSERT(bitmap->isImmutable());
+    SkASSERT(bitmap->getPixels());
     return true;
 }
 
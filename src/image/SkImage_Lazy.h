@@ -17,6 +17,7 @@
 #endif
 
 class SharedGenerator;
+struct SkBitmapCacheDesc;
 
 class SkImage_Lazy : public SkImage_Base {
 public:
@@ -44,6 +45,7 @@ public:
     sk_sp<SkData> onRefEncoded() const override;
     sk_sp<SkImage> onMakeSubset(const SkIRect&, GrDirectContext*) const override;
     bool getROPixels(GrDirectContext*, SkBitmap*, CachingHint) const override;
+    bool getROPixelsAtScale(GrDirectContext*, float scale, SkBitmap*, CachingHint) const override;
     bool onIsLazyGenerated() const override { return true; }
     sk_sp<SkImage> onMakeColorTypeAndColorSpace(SkColorType, sk_sp<SkColorSpace>,
                                                 GrDirectContext*) const override;
@@ -85,6 +87,14 @@ private:
 
     class ScopedGenerator;
 
+    // Returns the size to decode at when drawing scaled by 'scale', or our own dimensions if the
+    // generator cannot decode any smaller without losing detail the draw would show.
+    SkISize scaledDimensions(float scale) const;
+
+    // Decodes into 'info', which may be downscaled, caching the result under 'desc' if allowed.
+    bool decodeROPixels(const SkBitmapCacheDesc& desc, const SkImageInfo& info, SkBitmap*,
+                        CachingHint) const;
+
     // Note that this->imageInfo() is not necessarily the info from the generator. It may be
     // cropped by onMakeSubset and its color type/space may be changed by
     // onMakeColorTypeAndColorSpace.
@@ -74,6 +74,10 @@ void SkSurface_Base::onDraw(SkCanvas* canvas, SkScalar x, SkScalar y,
     }
 }
 
+bool SkSurface_Base::onReadPixels(const SkPixmap& dst, int srcX, int srcY) {
+    return this->getCachedCanvas()->readPixels(dst, srcX, srcY);
+}
+
 void SkSurface_Base::onAsyncRescaleAndReadPixels(const SkImageInfo& info,
                                                  const SkIRect& origSrcRect,
                                                  SkSurface::RescaleGamma rescaleGamma,
@@ -229,7 +233,7 @@ bool SkSurface::peekPixels(SkPixmap* pmap) {
 }
 
 bool SkSurface::readPixels(const SkPixmap& pm, int srcX, int srcY) {
-    return this->getCanvas()->readPixels(pm, srcX, srcY);
+    return asSB(this)->onReadPixels(pm, srcX, srcY);
 }
 
 bool SkSurface::readPixels(const SkImageInfo& dstInfo, void* dstPixels, size_t dstRowBytes,
@@ -52,6 +52,11 @@ public:
 
     virtual void onWritePixels(const SkPixmap&, int x, int y) = 0;
 
+    /**
+     *  Default implementation reads through the surface's canvas.
+     */
+    virtual bool onReadPixels(const SkPixmap&, int srcX, int srcY);
+
     /**
      * Default implementation does a rescale/read and then calls the callback.
      */
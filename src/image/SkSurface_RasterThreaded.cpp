@@ -0,0 +1,323 @@
+/*
+ * Copyright 2021 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/core/SkCanvas.h"
+#include "include/core/SkExecutor.h"
+#include "include/core/SkMallocPixelRef.h"
+#include "include/private/SkTo.h"
+#include "src/core/SkBitmapDevice.h"
+#include "src/core/SkCanvasPriv.h"
+#include "src/core/SkImagePriv.h"
+#include "src/core/SkRecordDraw.h"
+#include "src/core/SkRecorder.h"
+#include "src/core/SkTaskGroup.h"
+#include "src/image/SkSurface_Base.h"
+
+#include <utility>
+#include <vector>
+
+class SkSurface_RasterThreaded;
+
+namespace {
+// Finds the ops that read destination pixels.  A layer with a backdrop filter or
+// kInitWithPrevious_SaveLayerFlag copies what lies under it, outset by what the filter samples,
+// which can reach into neighboring bands.  SaveBehind copies only within its band's clip, but is
+// kept in step with the other bands all the same.
+struct ReadsDst {
+    bool operator()(const SkRecords::SaveLayer& op) {
+        return op.backdrop || (op.saveLayerFlags & SkCanvas::kInitWithPrevious_SaveLayerFlag);
+    }
+    bool operator()(const SkRecords::SaveBehind&) { return true; }
+    template <typename T> bool operator()(const T&) { return false; }
+};
+}  // namespace
+
+// Each band is a horizontal strip of the surface this many rows tall (the last may be shorter).
+// Bands are independent units of work, so this trades per-band replay overhead against balance.
+static constexpr int kBandHeight = 128;
+
+// The canvas handed out by SkSurface_RasterThreaded.  It records draws like any SkRecorder, but
+// answers questions about pixels (imageInfo(), peekPixels(), flush()) on behalf of its surface.
+class SkThreadedRasterRecorder final : public SkRecorder {
+public:
+    SkThreadedRasterRecorder(SkSurface_RasterThreaded* surface, SkRecord* record,
+                             const SkImageInfo& info, const SkSurfaceProps& props)
+            : SkRecorder(record, info.width(), info.height())
+            , fSurface(surface)
+            , fInfo(info)
+            , fProps(props) {}
+
+    void onFlush() override;
+    bool onPeekPixels(SkPixmap*) override;
+    SkImageInfo onImageInfo() const override { return fInfo; }
+    bool onGetProps(SkSurfaceProps* props) const override {
+        if (props) {
+            *props = fProps;
+        }
+        return true;
+    }
+    sk_sp<SkSurface> onNewSurface(const SkImageInfo& info, const SkSurfaceProps& props) override {
+        return SkSurface::MakeRaster(info, &props);
+    }
+    // Unroll pictures into the record, so that each band replays only those of their ops that
+    // touch it, rather than every band playing back the whole picture.
+    void onDrawPicture(const SkPicture* picture, const SkMatrix* matrix,
+                       const SkPaint* paint) override {
+        SkAutoCanvasMatrixPaint acmp(this, matrix, paint, picture->cullRect());
+        picture->playback(this);
+    }
+
+private:
+    SkSurface_RasterThreaded* fSurface;
+    const SkImageInfo         fInfo;
+    const SkSurfaceProps      fProps;
+};
+
+class SkSurface_RasterThreaded : public SkSurface_Base {
+public:
+    SkSurface_RasterThreaded(const SkImageInfo&, sk_sp<SkPixelRef>, SkExecutor*,
+                             const SkSurfaceProps*);
+
+    SkCanvas* onNewCanvas() override;
+    sk_sp<SkSurface> onNewSurface(const SkImageInfo&) override;
+    sk_sp<SkImage> onNewImageSnapshot(const SkIRect* subset) override;
+    void onWritePixels(const SkPixmap&, int x, int y) override;
+    bool onReadPixels(const SkPixmap&, int srcX, int srcY) override;
+    void onDraw(SkCanvas*, SkScalar, SkScalar, const SkSamplingOptions&, const SkPaint*) override;
+    void onCopyOnWrite(ContentChangeMode) override;
+    void onRestoreBackingMutability() override;
+    GrSemaphoresSubmitted onFlush(BackendSurfaceAccess, const GrFlushInfo&,
+                                  const GrBackendSurfaceMutableState*) override;
+
+    // Rasterize all draws recorded since the last call into fBitmap, in parallel by band.
+    void resolve();
+
+    const SkBitmap& bitmap() const { return fBitmap; }
+
+private:
+    struct Band {
+        SkIRect                   fBounds;
+        sk_sp<SkBitmapDevice>     fDevice;
+        std::unique_ptr<SkCanvas> fCanvas;
+    };
+
+    SkBitmap                     fBitmap;
+    SkExecutor*                  fExecutor;
+    sk_sp<SkRecord>              fRecord;
+    SkThreadedRasterRecorder*    fRecorder = nullptr;  // Owned by SkSurface_Base.
+    std::vector<Band>            fBands;
+    // Whether fRecord began with no saves open and an identity matrix.  If so, its op bounds are
+    // in device space and bands can skip the ops that miss them.
+    bool                         fRecordStartsAtRoot = true;
+
+    using INHERITED = SkSurface_Base;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+void SkThreadedRasterRecorder::onFlush() {
+    fSurface->resolve();
+}
+
+bool SkThreadedRasterRecorder::onPeekPixels(SkPixmap* pmap) {
+    fSurface->resolve();
+    return fSurface->bitmap().peekPixels(pmap);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+SkSurface_RasterThreaded::SkSurface_RasterThreaded(const SkImageInfo& info, sk_sp<SkPixelRef> pr,
+                                                   SkExecutor* executor,
+                                                   const SkSurfaceProps* props)
+        : INHERITED(info, props)
+        , fExecutor(executor)
+        , fRecord(sk_make_sp<SkRecord>()) {
+    fBitmap.setInfo(info, pr->rowBytes());
+    fBitmap.setPixelRef(std::move(pr), 0, 0);
+
+    // Every band draws into the full bitmap through its own device, clipped to the band's rows.
+    // Keeping device coordinates identical to a single SkBitmapDevice keeps dithering and shader
+    // sampling identical, while the clip keeps each band's scan conversion and layers to its rows.
+    // Anti-aliased path edges are chopped where they cross the clip, so coverage along band
+    // boundaries may differ slightly from a single device.
+    // Each band's canvas also keeps its own matrix, clip, and layer stack across resolve() calls.
+    for (int top = 0; top < info.height(); top += kBandHeight) {
+        Band band;
+        band.fBounds = SkIRect::MakeLTRB(0, top, info.width(),
+                                         std::min(top + kBandHeight, info.height()));
+        band.fDevice = sk_make_sp<SkBitmapDevice>(fBitmap, this->props(), nullptr, nullptr);
+        band.fCanvas = std::make_unique<SkCanvas>(band.fDevice);
+        band.fCanvas->clipRect(SkRect::Make(band.fBounds));
+        fBands.push_back(std::move(band));
+    }
+}
+
+SkCanvas* SkSurface_RasterThreaded::onNewCanvas() {
+    SkASSERT(!fRecorder);
+    fRecorder = new SkThreadedRasterRecorder(this, fRecord.get(), fBitmap.info(), this->props());
+    return fRecorder;
+}
+
+void SkSurface_RasterThreaded::resolve() {
+    if (fRecord->count() == 0) {
+        return;
+    }
+
+    // Give the recorder a fresh SkRecord; fRecorder's matrix and clip state carry over, just like
+    // the state in each band's canvas.
+    sk_sp<SkRecord> record = std::exchange(fRecord, sk_make_sp<SkRecord>());
+    std::unique_ptr<SkDrawableList> drawables = fRecorder->detachDrawableList();
+    fRecorder->continueRecording(fRecord.get());
+
+    // Drawables are not guaranteed to be thread safe, so snap them to pictures up front.
+    std::unique_ptr<SkBigPicture::SnapshotArray> drawablePicts;
+    if (drawables) {
+        drawablePicts.reset(drawables->newDrawableSnapshot());
+    }
+    const SkPicture* const* picts = drawablePicts ? drawablePicts->begin() : nullptr;
+    const int pictCount = drawablePicts ? drawablePicts->count() : 0;
+
+    // Fork our pixels away from any outstanding snapshot before any band writes to them.
+    this->notifyContentWillChange(kRetain_ContentChangeMode);
+
+    // Ops that read back destination pixels, possibly outside their band, must not run while
+    // other bands write.  Bands all finish the ops before such an op, run it, and all finish it
+    // before going on, so it reads exactly what a single device would have.
+    std::vector<int> dstReads;
+    for (int op = 0; op < record->count(); op++) {
+        if (record->visit(op, ReadsDst())) {
+            dstReads.push_back(op);
+        }
+    }
+
+    // Each band gets its own SkBitmapDevice, and so its own SkRasterClip and blitter arena.
+    const SkM44 identity;
+    const bool nextStartsAtRoot = fRecorder->getSaveCount() == 1 &&
+                                  fRecorder->getTotalMatrix().isIdentity();
+    if (std::exchange(fRecordStartsAtRoot, nextStartsAtRoot) && dstReads.empty()) {
+        std::vector<SkCanvas*> canvases;
+        std::vector<SkIRect> bandBounds;
+        for (Band& band : fBands) {
+            canvases.push_back(band.fCanvas.get());
+            bandBounds.push_back(band.fBounds);
+        }
+        SkRecordDrawThreaded(*record, SkRect::Make(fBitmap.bounds()),
+                             canvases.data(), bandBounds.data(), SkToInt(canvases.size()),
+                             picts, pictCount, identity, fExecutor);
+        return;
+    }
+
+    // Op bounds would be relative to the state the record began with, or the record has to be
+    // split at the ops reading the destination, so replay everything.
+    SkTaskGroup taskGroup(fExecutor ? *fExecutor : SkExecutor::GetDefault());
+    auto replay = [&](int begin, int end) {
+        taskGroup.batch(SkToInt(fBands.size()), [&](int i) {
+            SkRecords::Draw draw(fBands[i].fCanvas.get(), picts, nullptr, pictCount, &identity);
+            for (int op = begin; op < end; op++) {
+                record->visit(op, draw);
+            }
+        });
+        taskGroup.wait();
+    };
+    int begin = 0;
+    for (int op : dstReads) {
+        replay(begin, op);
+        replay(op, op + 1);
+        begin = op + 1;
+    }
+    replay(begin, record->count());
+}
+
+sk_sp<SkSurface> SkSurface_RasterThreaded::onNewSurface(const SkImageInfo& info) {
+    return SkSurface::MakeRasterThreaded(info, fExecutor, &this->props());
+}
+
+void SkSurface_RasterThreaded::onDraw(SkCanvas* canvas, SkScalar x, SkScalar y,
+                                      const SkSamplingOptions& sampling, const SkPaint* paint) {
+    this->resolve();
+    canvas->drawImage(fBitmap.asImage().get(), x, y, sampling, paint);
+}
+
+sk_sp<SkImage> SkSurface_RasterThreaded::onNewImageSnapshot(const SkIRect* subset) {
+    this->resolve();
+
+    if (subset) {
+        SkASSERT(SkIRect::MakeWH(fBitmap.width(), fBitmap.height()).contains(*subset));
+        SkBitmap dst;
+        dst.allocPixels(fBitmap.info().makeDimensions(subset->size()));
+        SkAssertResult(fBitmap.readPixels(dst.pixmap(), subset->left(), subset->top()));
+        dst.setImmutable(); // key, so MakeFromBitmap doesn't make a copy of the buffer
+        return dst.asImage();
+    }
+
+    // SkImage_raster requires these pixels are immutable for its full lifetime.
+    // We'll undo this via onRestoreBackingMutability() if we can avoid the COW.
+    if (SkPixelRef* pr = fBitmap.pixelRef()) {
+        pr->setTemporarilyImmutable();
+    }
+    return SkMakeImageFromRasterBitmap(fBitmap, kIfMutable_SkCopyPixelsMode);
+}
+
+void SkSurface_RasterThreaded::onWritePixels(const SkPixmap& src, int x, int y) {
+    this->resolve();
+    fBitmap.writePixels(src, x, y);
+}
+
+bool SkSurface_RasterThreaded::onReadPixels(const SkPixmap& dst, int srcX, int srcY) {
+    this->resolve();
+    return fBitmap.readPixels(dst, srcX, srcY);
+}
+
+GrSemaphoresSubmitted SkSurface_RasterThreaded::onFlush(BackendSurfaceAccess, const GrFlushInfo&,
+                                                        const GrBackendSurfaceMutableState*) {
+    this->resolve();
+    return GrSemaphoresSubmitted::kNo;
+}
+
+void SkSurface_RasterThreaded::onRestoreBackingMutability() {
+    SkASSERT(!this->hasCachedImage());  // Shouldn't be any snapshots out there.
+    if (SkPixelRef* pr = fBitmap.pixelRef()) {
+        pr->restoreMutability();
+    }
+}
+
+void SkSurface_RasterThreaded::onCopyOnWrite(ContentChangeMode mode) {
+    // are we sharing pixelrefs with the image?
+    sk_sp<SkImage> cached(this->refCachedImage());
+    SkASSERT(cached);
+    if (SkBitmapImageGetPixelRef(cached.get()) == fBitmap.pixelRef()) {
+        if (kDiscard_ContentChangeMode == mode) {
+            fBitmap.allocPixels();
+        } else {
+            SkBitmap prev(fBitmap);
+            fBitmap.allocPixels();
+            SkASSERT(prev.info() == fBitmap.info());
+            SkASSERT(prev.rowBytes() == fBitmap.rowBytes());
+            memcpy(fBitmap.getPixels(), prev.getPixels(), fBitmap.computeByteSize());
+        }
+
+        // Point every band at the new pixels, leaving their matrix and clip state untouched.
+        for (Band& band : fBands) {
+            band.fDevice->replaceBitmapBackendForRasterSurface(fBitmap);
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+sk_sp<SkSurface> SkSurface::MakeRasterThreaded(const SkImageInfo& info, SkExecutor* executor,
+                                               const SkSurfaceProps* props) {
+    if (!SkSurfaceValidateRasterInfo(info)) {
+        return nullptr;
+    }
+
+    sk_sp<SkPixelRef> pr = SkMallocPixelRef::MakeAllocate(info, 0);
+    if (!pr) {
+        return nullptr;
+    }
+    return sk_make_sp<SkSurface_RasterThreaded>(info, std::move(pr), executor, props);
+}
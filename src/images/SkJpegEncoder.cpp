@@ -14,11 +14,13 @@
 #include "include/private/SkColorData.h"
 #include "include/private/SkImageInfoPriv.h"
 #include "include/private/SkTemplates.h"
+#include "src/core/SkAutoPixmapStorage.h"
 #include "src/core/SkMSAN.h"
 #include "src/images/SkImageEncoderFns.h"
 #include "src/images/SkJPEGWriteUtility.h"
 
 #include <stdio.h>
+#include <algorithm>
 
 extern "C" {
     #include "jpeglib.h"
@@ -161,30 +163,32 @@ bool SkJpegEncoderMgr::setParams(const SkImageInfo& srcInfo, const SkJpegEncoder
     // for the image.  This improves compression at the cost of
     // slower encode performance.
     fCInfo.optimize_coding = TRUE;
-    return true;
-}
 
-std::unique_ptr<SkEncoder> SkJpegEncoder::Make(SkWStream* dst, const SkPixmap& src,
-                                               const Options& options) {
-    if (!SkPixmapIsValid(src)) {
-        return nullptr;
+    if (options.fRestartRows > 0) {
+        fCInfo.restart_in_rows = options.fRestartRows;
     }
+    return true;
+}
 
-    std::unique_ptr<SkJpegEncoderMgr> encoderMgr = SkJpegEncoderMgr::Make(dst);
-
+// Configures |encoderMgr| for pixels described by |info| and writes the JPEG header.
+static bool start_compress(SkJpegEncoderMgr* encoderMgr, const SkImageInfo& info,
+                           const SkJpegEncoder::Options& options, bool optimizeCoding) {
     skjpeg_error_mgr::AutoPushJmpBuf jmp(encoderMgr->errorMgr());
     if (setjmp(jmp)) {
-        return nullptr;
+        return false;
     }
 
-    if (!encoderMgr->setParams(src.info(), options)) {
-        return nullptr;
+    if (!encoderMgr->setParams(info, options)) {
+        return false;
+    }
+    if (!optimizeCoding) {
+        encoderMgr->cinfo()->optimize_coding = FALSE;
     }
 
     jpeg_set_quality(encoderMgr->cinfo(), options.fQuality, TRUE);
     jpeg_start_compress(encoderMgr->cinfo(), TRUE);
 
-    sk_sp<SkData> icc = icc_from_color_space(src.info());
+    sk_sp<SkData> icc = icc_from_color_space(info);
     if (icc) {
         // Create a contiguous block of memory with the icc signature followed by the profile.
         sk_sp<SkData> markerData =
@@ -198,36 +202,31 @@ std::unique_ptr<SkEncoder> SkJpegEncoder::Make(SkWStream* dst, const SkPixmap& s
 
         jpeg_write_marker(encoderMgr->cinfo(), kICCMarker, markerData->bytes(), markerData->size());
     }
-
-    return std::unique_ptr<SkJpegEncoder>(new SkJpegEncoder(std::move(encoderMgr), src));
+    return true;
 }
 
-SkJpegEncoder::SkJpegEncoder(std::unique_ptr<SkJpegEncoderMgr> encoderMgr, const SkPixmap& src)
-    : INHERITED(src, encoderMgr->proc() ? encoderMgr->cinfo()->input_components*src.width() : 0)
-    , fEncoderMgr(std::move(encoderMgr))
-{}
-
-SkJpegEncoder::~SkJpegEncoder() {}
-
-bool SkJpegEncoder::onEncodeRows(int numRows) {
-    skjpeg_error_mgr::AutoPushJmpBuf jmp(fEncoderMgr->errorMgr());
+// Compresses every row of |src|, converting through |storage| if the manager has a proc, and
+// finishes the image if |last|.
+static bool write_rows(SkJpegEncoderMgr* encoderMgr, const SkPixmap& src, uint8_t* storage,
+                       bool last) {
+    skjpeg_error_mgr::AutoPushJmpBuf jmp(encoderMgr->errorMgr());
     if (setjmp(jmp)) {
         return false;
     }
 
-    const size_t srcBytes = SkColorTypeBytesPerPixel(fSrc.colorType()) * fSrc.width();
-    const size_t jpegSrcBytes = fEncoderMgr->cinfo()->input_components * fSrc.width();
+    const size_t srcBytes = SkColorTypeBytesPerPixel(src.colorType()) * src.width();
+    const size_t jpegSrcBytes = encoderMgr->cinfo()->input_components * src.width();
 
-    const void* srcRow = fSrc.addr(0, fCurrRow);
-    for (int i = 0; i < numRows; i++) {
+    const void* srcRow = src.addr();
+    for (int i = 0; i < src.height(); i++) {
         JSAMPLE* jpegSrcRow = (JSAMPLE*) srcRow;
-        if (fEncoderMgr->proc()) {
+        if (encoderMgr->proc()) {
             sk_msan_assert_initialized(srcRow, SkTAddOffset<const void>(srcRow, srcBytes));
-            fEncoderMgr->proc()((char*)fStorage.get(),
-                                (const char*)srcRow,
-                                fSrc.width(),
-                                fEncoderMgr->cinfo()->input_components);
-            jpegSrcRow = fStorage.get();
+            encoderMgr->proc()((char*)storage,
+                               (const char*)srcRow,
+                               src.width(),
+                               encoderMgr->cinfo()->input_components);
+            jpegSrcRow = storage;
             sk_msan_assert_initialized(jpegSrcRow,
                                        SkTAddOffset<const void>(jpegSrcRow, jpegSrcBytes));
         } else {
@@ -237,15 +236,46 @@ bool SkJpegEncoder::onEncodeRows(int numRows) {
                                        SkTAddOffset<const void>(jpegSrcRow, jpegSrcBytes));
         }
 
-        jpeg_write_scanlines(fEncoderMgr->cinfo(), &jpegSrcRow, 1);
-        srcRow = SkTAddOffset<const void>(srcRow, fSrc.rowBytes());
+        jpeg_write_scanlines(encoderMgr->cinfo(), &jpegSrcRow, 1);
+        srcRow = SkTAddOffset<const void>(srcRow, src.rowBytes());
     }
 
-    fCurrRow += numRows;
-    if (fCurrRow == fSrc.height()) {
-        jpeg_finish_compress(fEncoderMgr->cinfo());
+    if (last) {
+        jpeg_finish_compress(encoderMgr->cinfo());
+    }
+    return true;
+}
+
+std::unique_ptr<SkEncoder> SkJpegEncoder::Make(SkWStream* dst, const SkPixmap& src,
+                                               const Options& options) {
+    if (!SkPixmapIsValid(src)) {
+        return nullptr;
     }
 
+    std::unique_ptr<SkJpegEncoderMgr> encoderMgr = SkJpegEncoderMgr::Make(dst);
+    if (!start_compress(encoderMgr.get(), src.info(), options, /*optimizeCoding=*/true)) {
+        return nullptr;
+    }
+
+    return std::unique_ptr<SkJpegEncoder>(new SkJpegEncoder(std::move(encoderMgr), src));
+}
+
+SkJpegEncoder::SkJpegEncoder(std::unique_ptr<SkJpegEncoderMgr> encoderMgr, const SkPixmap& src)
+    : INHERITED(src, encoderMgr->proc() ? encoderMgr->cinfo()->input_components*src.width() : 0)
+    , fEncoderMgr(std::move(encoderMgr))
+{}
+
+SkJpegEncoder::~SkJpegEncoder() {}
+
+bool SkJpegEncoder::onEncodeRows(int numRows) {
+    SkPixmap rows;
+    SkAssertResult(fSrc.extractSubset(&rows, SkIRect::MakeXYWH(0, fCurrRow,
+                                                                fSrc.width(), numRows)));
+    if (!write_rows(fEncoderMgr.get(), rows, fStorage.get(), fCurrRow + numRows == fSrc.height())) {
+        return false;
+    }
+
+    fCurrRow += numRows;
     return true;
 }
 
@@ -254,4 +284,38 @@ bool SkJpegEncoder::Encode(SkWStream* dst, const SkPixmap& src, const Options& o
     return encoder.get() && encoder->encodeRows(src.height());
 }
 
+bool SkJpegEncoder::Encode(SkWStream* dst, const SkImageInfo& info, const RowSource& rows,
+                           const Options& options) {
+    if (!SkImageInfoIsValid(info) || !rows) {
+        return false;
+    }
+
+    std::unique_ptr<SkJpegEncoderMgr> encoderMgr = SkJpegEncoderMgr::Make(dst);
+    if (!start_compress(encoderMgr.get(), info, options, /*optimizeCoding=*/false)) {
+        return false;
+    }
+
+    // Pull one row of MCUs at a time, which is what libjpeg compresses at once anyway.
+    const int stripHeight = std::min(encoderMgr->cinfo()->max_v_samp_factor * DCTSIZE,
+                                     info.height());
+    SkAutoPixmapStorage strip;
+    SkAutoTMalloc<uint8_t> storage(encoderMgr->proc()
+                                   ? encoderMgr->cinfo()->input_components * info.width() : 0);
+    if (!strip.tryAlloc(info.makeWH(info.width(), stripHeight))) {
+        return false;
+    }
+
+    for (int y = 0; y < info.height(); y += stripHeight) {
+        SkPixmap stripRows;
+        const int height = std::min(stripHeight, info.height() - y);
+        SkAssertResult(strip.extractSubset(&stripRows, SkIRect::MakeWH(info.width(), height)));
+        if (!rows(y, stripRows) ||
+            !write_rows(encoderMgr.get(), stripRows, storage.get(),
+                        y + stripRows.height() == info.height())) {
+            return false;
+        }
+    }
+    return true;
+}
+
 #endif
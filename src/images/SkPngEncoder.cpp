@@ -9,17 +9,24 @@
 
 #ifdef SK_ENCODE_PNG
 
+#include "include/core/SkExecutor.h"
 #include "include/core/SkStream.h"
 #include "include/core/SkString.h"
 #include "include/encode/SkPngEncoder.h"
 #include "include/private/SkImageInfoPriv.h"
+#include "include/private/SkTPin.h"
+#include "include/private/SkTemplates.h"
+#include "include/private/SkTo.h"
 #include "src/codec/SkColorTable.h"
 #include "src/codec/SkPngPriv.h"
 #include "src/core/SkMSAN.h"
+#include "src/core/SkTaskGroup.h"
 #include "src/images/SkImageEncoderFns.h"
+#include <atomic>
 #include <vector>
 
 #include "png.h"
+#include "zlib.h"
 
 static_assert(PNG_FILTER_NONE  == (int)SkPngEncoder::FilterFlag::kNone,  "Skia libpng filter err.");
 static_assert(PNG_FILTER_SUB   == (int)SkPngEncoder::FilterFlag::kSub,   "Skia libpng filter err.");
@@ -45,6 +52,285 @@ static void sk_write_fn(png_structp png_ptr, png_bytep data, png_size_t len) {
     }
 }
 
+// Filters and compresses rows in parallel, after pigz. Rows are split into chunks of about
+// kChunkBytes of filtered data. Each chunk is deflated on its own, primed with the (up to) 32KB
+// of filtered data before it as a dictionary, and ends in a sync flush so that the next chunk's
+// output can simply be appended. Concatenated, with a zlib header in front and the chunks'
+// combined adler32 at the end, they make one standard zlib stream, written out as IDAT chunks.
+class SkPngParallelDeflater final : SkNoncopyable {
+public:
+    SkPngParallelDeflater(SkExecutor* executor, int filters, int zlibLevel, int bytesPerPixel,
+                          int width)
+        : fExecutor(executor)
+        , fFilters(filters ? filters : PNG_FILTER_NONE)
+        , fZLibLevel(zlibLevel)
+        , fBytesPerPixel(bytesPerPixel)
+        , fRowBytes((size_t)bytesPerPixel * width) {}
+
+    bool encodeRows(SkWStream*, const SkPixmap& src, transform_scanline_proc, int startRow,
+                    int numRows);
+
+private:
+    static constexpr size_t kChunkBytes = 128 * 1024;
+    static constexpr size_t kWindowSize = 32 * 1024;
+
+    void filterRow(const uint8_t* row, const uint8_t* prev, uint8_t* dst, uint8_t* scratch) const;
+    bool deflateChunk(const uint8_t* dict, size_t dictLen, const uint8_t* src, size_t len,
+                      bool last, std::vector<uint8_t>* out) const;
+
+    SkExecutor*          fExecutor;
+    const int            fFilters;
+    const int            fZLibLevel;
+    const int            fBytesPerPixel;
+    const size_t         fRowBytes;
+    uLong                fAdler = adler32(0, nullptr, 0);
+    std::vector<uint8_t> fWindow;  // The last kWindowSize filtered bytes compressed so far.
+};
+
+static uint8_t paeth_predictor(int a, int b, int c) {
+    int p = a + b - c;
+    int pa = std::abs(p - a),
+        pb = std::abs(p - b),
+        pc = std::abs(p - c);
+    if (pa <= pb && pa <= pc) {
+        return a;
+    }
+    return pb <= pc ? b : c;
+}
+
+// Writes the filter type byte followed by the filtered row to dst. Returns the sum of the
+// filtered bytes' magnitudes as signed values, libpng's heuristic for choosing a filter.
+static uint32_t filter_row(int type, const uint8_t* row, const uint8_t* prev, size_t len,
+                           size_t bpp, uint8_t* dst) {
+    *dst++ = SkToU8(type);
+    bpp = std::min(bpp, len);
+    switch (type) {
+        case PNG_FILTER_VALUE_NONE:
+            memcpy(dst, row, len);
+            break;
+        case PNG_FILTER_VALUE_SUB:
+            memcpy(dst, row, bpp);
+            for (size_t i = bpp; i < len; i++) {
+                dst[i] = row[i] - row[i - bpp];
+            }
+            break;
+        case PNG_FILTER_VALUE_UP:
+            for (size_t i = 0; i < len; i++) {
+                dst[i] = row[i] - prev[i];
+            }
+            break;
+        case PNG_FILTER_VALUE_AVG:
+            for (size_t i = 0; i < bpp; i++) {
+                dst[i] = row[i] - (prev[i] >> 1);
+            }
+            for (size_t i = bpp; i < len; i++) {
+                dst[i] = row[i] - ((row[i - bpp] + prev[i]) >> 1);
+            }
+            break;
+        case PNG_FILTER_VALUE_PAETH:
+            for (size_t i = 0; i < bpp; i++) {
+                dst[i] = row[i] - prev[i];  // paeth_predictor(0, b, 0) is always b.
+            }
+            for (size_t i = bpp; i < len; i++) {
+                dst[i] = row[i] - paeth_predictor(row[i - bpp], prev[i], prev[i - bpp]);
+            }
+            break;
+    }
+
+    uint32_t sum = 0;
+    for (size_t i = 0; i < len; i++) {
+        sum += dst[i] < 128 ? dst[i] : 256 - dst[i];
+    }
+    return sum;
+}
+
+void SkPngParallelDeflater::filterRow(const uint8_t* row, const uint8_t* prev, uint8_t* dst,
+                                      uint8_t* scratch) const {
+    // Try each allowed filter, keeping the best so far in one buffer and trying the next in the
+    // other, then make sure the winner ends up in dst.
+    uint8_t* best = nullptr;
+    uint32_t bestSum = UINT32_MAX;
+    for (int type = PNG_FILTER_VALUE_NONE; type < PNG_FILTER_VALUE_LAST; type++) {
+        if (!(fFilters & (PNG_FILTER_NONE << type))) {
+            continue;
+        }
+        uint8_t* candidate = best == dst ? scratch : dst;
+        uint32_t sum = filter_row(type, row, prev, fRowBytes, fBytesPerPixel, candidate);
+        if (sum < bestSum || !best) {
+            best = candidate;
+            bestSum = sum;
+        }
+    }
+    if (best != dst) {
+        memcpy(dst, best, fRowBytes + 1);
+    }
+}
+
+bool SkPngParallelDeflater::deflateChunk(const uint8_t* dict, size_t dictLen,
+                                         const uint8_t* src, size_t len, bool last,
+                                         std::vector<uint8_t>* out) const {
+    // Like libpng, use Z_FILTERED unless the rows are unfiltered.
+    int strategy = fFilters == PNG_FILTER_NONE ? Z_DEFAULT_STRATEGY : Z_FILTERED;
+
+    z_stream zs;
+    sk_bzero(&zs, sizeof(zs));
+    if (Z_OK != deflateInit2(&zs, fZLibLevel, Z_DEFLATED, -MAX_WBITS, 8, strategy)) {
+        return false;
+    }
+    if (dictLen > 0 && Z_OK != deflateSetDictionary(&zs, dict, SkToUInt(dictLen))) {
+        deflateEnd(&zs);
+        return false;
+    }
+
+    // A sync flush ends with an empty stored block, which deflateBound() doesn't count.
+    size_t written = out->size();
+    out->resize(written + deflateBound(&zs, len) + 16);
+    zs.next_in  = const_cast<Bytef*>(src);
+    zs.avail_in = SkToUInt(len);
+
+    const int flush = last ? Z_FINISH : Z_SYNC_FLUSH;
+    bool done = false;
+    while (!done) {
+        zs.next_out  = out->data() + written;
+        zs.avail_out = SkToUInt(out->size() - written);
+        int result = deflate(&zs, flush);
+        if (result == Z_STREAM_ERROR) {
+            break;
+        }
+        written = out->size() - zs.avail_out;
+        // A flush is complete once deflate() returns with output space to spare.
+        done = last ? result == Z_STREAM_END : zs.avail_in == 0 && zs.avail_out > 0;
+        if (!done) {
+            out->resize(out->size() * 2);
+        }
+    }
+    out->resize(written);
+    deflateEnd(&zs);
+    return done;
+}
+
+static void append_be32(std::vector<uint8_t>* dst, uint32_t v) {
+    dst->insert(dst->end(), { (uint8_t)(v >> 24), (uint8_t)(v >> 16), (uint8_t)(v >> 8),
+                              (uint8_t)(v >>  0) });
+}
+
+static bool write_png_chunk(SkWStream* stream, const char type[4], const uint8_t* data,
+                            size_t len) {
+    std::vector<uint8_t> header;
+    append_be32(&header, SkToU32(len));
+    header.insert(header.end(), type, type + 4);
+
+    uLong crc = crc32(0, header.data() + 4, 4);
+    if (len > 0) {
+        crc = crc32(crc, data, SkToUInt(len));
+    }
+    std::vector<uint8_t> footer;
+    append_be32(&footer, (uint32_t)crc);
+
+    return stream->write(header.data(), header.size())
+        && stream->write(data, len)
+        && stream->write(footer.data(), footer.size());
+}
+
+bool SkPngParallelDeflater::encodeRows(SkWStream* stream, const SkPixmap& src,
+                                       transform_scanline_proc proc, int startRow, int numRows) {
+    if (numRows <= 0) {
+        return true;
+    }
+    const bool first = startRow == 0,
+               last  = startRow + numRows == src.height();
+    const size_t filteredRowBytes = fRowBytes + 1;
+    const int rowsPerChunk = std::max(1, SkToInt(kChunkBytes / filteredRowBytes));
+    const int chunks = (numRows + rowsPerChunk - 1) / rowsPerChunk;
+
+    // The window from earlier rows, then these rows filtered, so each chunk's dictionary is
+    // simply the (up to) kWindowSize bytes in front of it.
+    std::vector<uint8_t> filtered(fWindow);
+    filtered.resize(fWindow.size() + filteredRowBytes * numRows);
+    uint8_t* filteredRows = filtered.data() + fWindow.size();
+
+    auto chunkRows = [&](int chunk, int* top, int* bottom) {
+        *top    = chunk * rowsPerChunk;
+        *bottom = std::min(numRows, *top + rowsPerChunk);
+    };
+
+    // Filtering needs each row's predecessor, so each chunk converts the row before it too.
+    SkTaskGroup(*fExecutor).batch(chunks, [&](int chunk) {
+        int top, bottom;
+        chunkRows(chunk, &top, &bottom);
+
+        SkAutoTMalloc<uint8_t> storage(3 * fRowBytes + 1);
+        uint8_t* prev    = storage.get();
+        uint8_t* row     = prev + fRowBytes;
+        uint8_t* scratch = row + fRowBytes;
+
+        const int srcBpp = SkColorTypeBytesPerPixel(src.colorType());
+        const int y0 = startRow + top;
+        if (y0 > 0) {
+            proc((char*)prev, (const char*)src.addr(0, y0 - 1), src.width(), srcBpp);
+        } else {
+            sk_bzero(prev, fRowBytes);
+        }
+        for (int y = top; y < bottom; y++) {
+            const void* srcRow = src.addr(0, startRow + y);
+            sk_msan_assert_initialized(srcRow, (const uint8_t*)srcRow +
+                                               (src.width() << src.shiftPerPixel()));
+            proc((char*)row, (const char*)srcRow, src.width(), srcBpp);
+            this->filterRow(row, prev, filteredRows + y * filteredRowBytes, scratch);
+            std::swap(row, prev);
+        }
+    });
+
+    std::vector<std::vector<uint8_t>> outputs(chunks);
+    std::vector<uLong> adlers(chunks);
+    std::atomic<bool> ok{true};
+    SkTaskGroup(*fExecutor).batch(chunks, [&](int chunk) {
+        int top, bottom;
+        chunkRows(chunk, &top, &bottom);
+        const uint8_t* data = filteredRows + top * filteredRowBytes;
+        const size_t   len  = (bottom - top) * filteredRowBytes;
+        const size_t dictLen = std::min(kWindowSize, (size_t)(data - filtered.data()));
+
+        adlers[chunk] = adler32(adler32(0, nullptr, 0), data, SkToUInt(len));
+        if (!this->deflateChunk(data - dictLen, dictLen, data, len, last && chunk == chunks - 1,
+                                &outputs[chunk])) {
+            ok = false;
+        }
+    });
+    if (!ok) {
+        return false;
+    }
+
+    if (first) {
+        // A zlib header: deflate with a 32KB window, no dictionary, and zlib's level hint.
+        int levelHint = fZLibLevel < 2 ? 0 : fZLibLevel < 6 ? 1 : fZLibLevel == 6 ? 2 : 3;
+        int header = (0x78 << 8) | (levelHint << 6);
+        header += (31 - header % 31) % 31;
+        outputs.front().insert(outputs.front().begin(), { (uint8_t)(header >> 8),
+                                                          (uint8_t)(header >> 0) });
+    }
+    for (int chunk = 0; chunk < chunks; chunk++) {
+        int top, bottom;
+        chunkRows(chunk, &top, &bottom);
+        fAdler = adler32_combine(fAdler, adlers[chunk], (bottom - top) * filteredRowBytes);
+    }
+    if (last) {
+        append_be32(&outputs.back(), (uint32_t)fAdler);
+    }
+    for (const std::vector<uint8_t>& output : outputs) {
+        if (!output.empty() && !write_png_chunk(stream, "IDAT", output.data(), output.size())) {
+            return false;
+        }
+    }
+    if (last) {
+        return write_png_chunk(stream, "IEND", nullptr, 0);
+    }
+
+    const size_t windowLen = std::min(kWindowSize, filtered.size());
+    fWindow.assign(filtered.end() - windowLen, filtered.end());
+    return true;
+}
+
 class SkPngEncoderMgr final : SkNoncopyable {
 public:
 
@@ -58,11 +344,14 @@ public:
     bool setColorSpace(const SkImageInfo& info);
     bool writeInfo(const SkImageInfo& srcInfo);
     void chooseProc(const SkImageInfo& srcInfo);
+    void setParallel(const SkImageInfo& srcInfo, const SkPngEncoder::Options& options);
 
     png_structp pngPtr() { return fPngPtr; }
     png_infop infoPtr() { return fInfoPtr; }
+    SkWStream* stream() { return fStream; }
     int pngBytesPerPixel() const { return fPngBytesPerPixel; }
     transform_scanline_proc proc() const { return fProc; }
+    SkPngParallelDeflater* parallelDeflater() { return fParallelDeflater.get(); }
 
     ~SkPngEncoderMgr() {
         png_destroy_write_struct(&fPngPtr, &fInfoPtr);
@@ -70,15 +359,18 @@ public:
 
 private:
 
-    SkPngEncoderMgr(png_structp pngPtr, png_infop infoPtr)
+    SkPngEncoderMgr(png_structp pngPtr, png_infop infoPtr, SkWStream* stream)
         : fPngPtr(pngPtr)
         , fInfoPtr(infoPtr)
+        , fStream(stream)
     {}
 
-    png_structp             fPngPtr;
-    png_infop               fInfoPtr;
-    int                     fPngBytesPerPixel;
-    transform_scanline_proc fProc;
+    png_structp                            fPngPtr;
+    png_infop                              fInfoPtr;
+    SkWStream*                             fStream;
+    int                                    fPngBytesPerPixel;
+    transform_scanline_proc                fProc;
+    std::unique_ptr<SkPngParallelDeflater> fParallelDeflater;
 };
 
 std::unique_ptr<SkPngEncoderMgr> SkPngEncoderMgr::Make(SkWStream* stream) {
@@ -95,7 +387,7 @@ std::unique_ptr<SkPngEncoderMgr> SkPngEncoderMgr::Make(SkWStream* stream) {
     }
 
     png_set_write_fn(pngPtr, (void*)stream, sk_write_fn, nullptr);
-    return std::unique_ptr<SkPngEncoderMgr>(new SkPngEncoderMgr(pngPtr, infoPtr));
+    return std::unique_ptr<SkPngEncoderMgr>(new SkPngEncoderMgr(pngPtr, infoPtr, stream));
 }
 
 bool SkPngEncoderMgr::setHeader(const SkImageInfo& srcInfo, const SkPngEncoder::Options& options) {
@@ -392,6 +684,20 @@ void SkPngEncoderMgr::chooseProc(const SkImageInfo& srcInfo) {
     fProc = choose_proc(srcInfo);
 }
 
+void SkPngEncoderMgr::setParallel(const SkImageInfo& srcInfo,
+                                  const SkPngEncoder::Options& options) {
+    // The parallel path writes rows exactly as the transform procs produce them, so it can't
+    // handle the filler libpng strips from opaque F16.
+    if (!options.fExecutor || (kRGBA_F16_SkColorType == srcInfo.colorType() &&
+                               kOpaque_SkAlphaType == srcInfo.alphaType())) {
+        return;
+    }
+    int filters = (int)options.fFilterFlags & (int)SkPngEncoder::FilterFlag::kAll;
+    fParallelDeflater = std::make_unique<SkPngParallelDeflater>(
+            options.fExecutor, filters, SkTPin(options.fZLibLevel, 0, 9), fPngBytesPerPixel,
+            srcInfo.width());
+}
+
 std::unique_ptr<SkEncoder> SkPngEncoder::Make(SkWStream* dst, const SkPixmap& src,
                                               const Options& options) {
     if (!SkPixmapIsValid(src)) {
@@ -416,6 +722,7 @@ std::unique_ptr<SkEncoder> SkPngEncoder::Make(SkWStream* dst, const SkPixmap& sr
     }
 
     encoderMgr->chooseProc(src.info());
+    encoderMgr->setParallel(src.info(), options);
 
     return std::unique_ptr<SkPngEncoder>(new SkPngEncoder(std::move(encoderMgr), src));
 }
@@ -428,6 +735,15 @@ SkPngEncoder::SkPngEncoder(std::unique_ptr<SkPngEncoderMgr> encoderMgr, const Sk
 SkPngEncoder::~SkPngEncoder() {}
 
 bool SkPngEncoder::onEncodeRows(int numRows) {
+    if (SkPngParallelDeflater* deflater = fEncoderMgr->parallelDeflater()) {
+        if (!deflater->encodeRows(fEncoderMgr->stream(), fSrc, fEncoderMgr->proc(), fCurrRow,
+                                  numRows)) {
+            return false;
+        }
+        fCurrRow += numRows;
+        return true;
+    }
+
     if (setjmp(png_jmpbuf(fEncoderMgr->pngPtr()))) {
         return false;
     }
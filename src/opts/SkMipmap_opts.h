@@ -0,0 +1,347 @@
+/*
+ * Copyright 2021 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkMipmap_opts_DEFINED
+#define SkMipmap_opts_DEFINED
+
+#include "include/core/SkTypes.h"
+#include "include/private/SkVx.h"
+
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_AVX2
+    #include <immintrin.h>
+#endif
+
+// Box (2_2) and triangle (3_3) filters for SkMipmap::Build(), each producing count dst pixels
+// from the 2*count (or 2*count+1) src pixels of two (or three) rows.  They filter N dst pixels
+// at a time, then finish the row with the same code at N=1.  Each does exactly the per-channel
+// arithmetic of the scalar filters in SkMipmap.cpp, so the results are bit-identical.
+//
+// Dst pixel i comes from src pixels 2i and 2i+1, so rather than deinterleave even and odd src
+// pixels, the filters load each pair as one lane twice as wide as a pixel, and sum the pair's
+// channels by shifting the odd pixel down onto the even one.  Everything stays in lanes of one
+// width until the last step, which keeps the vectors cheap to shuffle on every compiler.
+//
+// They need 256-bit vectors to pay off.  Without AVX2, SkMipmap uses its own filters instead.
+
+namespace SK_OPTS_NS {
+
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_AVX2
+
+namespace mipmap {
+
+    template <int N, typename T> using V = skvx::Vec<N,T>;
+
+    template <typename T>
+    SK_ALWAYS_INLINE static const T* row(const void* src, size_t srcRB, int y) {
+        return (const T*)((const char*)src + y * srcRB);
+    }
+
+    // Load one full 256-bit vector in one go.  skvx::Vec::Load() copies into two 128-bit halves,
+    // which some compilers then spill and reload whole, stalling on every load.
+    template <int N, typename T>
+    SK_ALWAYS_INLINE static V<N,T> load(const void* p) {
+        if constexpr (sizeof(V<N,T>) == sizeof(__m256i)) {
+            return skvx::bit_pun<V<N,T>>(_mm256_loadu_si256((const __m256i*)p));
+        } else {
+            return V<N,T>::Load(p);
+        }
+    }
+
+    // The pair of pixels after each pair, i.e. src pixels 2i+2 and 2i+3.  The 3_3 filters only
+    // use pixel 2i+2, and at N=1 (the last dst pixel of a row) pixel 2i+3 may not exist.
+    template <int N, typename T>
+    SK_ALWAYS_INLINE static V<N,uint64_t> load_next_pairs(const T* p) {
+        return load<N,uint64_t>(p + 2);
+    }
+    template <>
+    V<1,uint64_t> load_next_pairs<1>(const uint32_t* p) {
+        return p[2];
+    }
+
+    // --- 8888 --- //
+
+    // Channels 0 and 2 (or 1 and 3, after shifting down 8) of a pair, in 16-bit fields.
+    static constexpr uint64_t k8888Fields = 0x00ff00ff00ff00ff;
+
+    template <int N>
+    SK_ALWAYS_INLINE static V<N,uint64_t> compact_8888(const V<N,uint64_t>& c02,
+                                                       const V<N,uint64_t>& c13) {
+        return (c02 & 0x00ff00ff) | ((c13 & 0x00ff00ff) << 8);
+    }
+
+    template <int N>
+    SK_ALWAYS_INLINE static V<N,uint64_t> filter_2_2_8888(const uint32_t* p0, const uint32_t* p1) {
+        auto r0 = load<N,uint64_t>(p0),
+             r1 = load<N,uint64_t>(p1);
+        auto c02 = (r0 & k8888Fields) + (r1 & k8888Fields),
+             c13 = ((r0 >> 8) & k8888Fields) + ((r1 >> 8) & k8888Fields);
+        c02 += c02 >> 32;
+        c13 += c13 >> 32;
+        return compact_8888<N>(c02 >> 2, c13 >> 2);
+    }
+
+    template <int N>
+    SK_ALWAYS_INLINE static V<N,uint64_t> filter_3_3_8888(const uint32_t* p0, const uint32_t* p1,
+                                                          const uint32_t* p2) {
+        auto add_121 = [](const V<N,uint64_t>& x0, const V<N,uint64_t>& x1,
+                          const V<N,uint64_t>& x2, int shift) {
+            return ((x0 >> shift) & k8888Fields) + ((x1 >> shift) & k8888Fields) +
+                   ((x1 >> shift) & k8888Fields) + ((x2 >> shift) & k8888Fields);
+        };
+        auto r0 = load<N,uint64_t>(p0),
+             r1 = load<N,uint64_t>(p1),
+             r2 = load<N,uint64_t>(p2);
+        auto n0 = load_next_pairs<N>(p0),
+             n1 = load_next_pairs<N>(p1),
+             n2 = load_next_pairs<N>(p2);
+
+        // Column sums a (even pixels) and b (odd) are the pair's halves, c is the next even.
+        auto sum = [&](int shift) {
+            auto ab = add_121(r0, r1, r2, shift),
+                 c  = add_121(n0, n1, n2, shift);
+            return ((ab & 0xffffffff) + ((ab >> 32) << 1) + (c & 0xffffffff)) >> 4;
+        };
+        return compact_8888<N>(sum(0), sum(8));
+    }
+
+    // --- 1010102 --- //
+
+    // Channels spread 20 bits apart in 64-bit lanes, as ColorTypeFilter_1010102 does.
+    template <int N>
+    SK_ALWAYS_INLINE static V<N,uint64_t> expand_1010102(const V<N,uint64_t>& px) {
+        return (((px      ) & 0x3ff)      ) |
+               (((px >> 10) & 0x3ff) << 20) |
+               (((px >> 20) & 0x3ff) << 40) |
+               (((px >> 30) & 0x3  ) << 60);
+    }
+    template <int N>
+    SK_ALWAYS_INLINE static V<N,uint64_t> compact_1010102(const V<N,uint64_t>& x) {
+        return (((x      ) & 0x3ff)      ) |
+               (((x >> 20) & 0x3ff) << 10) |
+               (((x >> 40) & 0x3ff) << 20) |
+               (((x >> 60) & 0x3  ) << 30);
+    }
+
+    template <int N>
+    SK_ALWAYS_INLINE static V<N,uint64_t> filter_2_2_1010102(const uint32_t* p0,
+                                                             const uint32_t* p1) {
+        auto r0 = load<N,uint64_t>(p0),
+             r1 = load<N,uint64_t>(p1);
+        auto c = expand_1010102<N>(r0 & 0xffffffff) + expand_1010102<N>(r1 & 0xffffffff) +
+                 expand_1010102<N>(r0 >> 32)        + expand_1010102<N>(r1 >> 32);
+        return compact_1010102<N>(c >> 2);
+    }
+
+    // Expanded x0 + 2*x1 + x2, taking the pixels in the low (shift 0) or high (32) half of pairs.
+    template <int N>
+    SK_ALWAYS_INLINE static V<N,uint64_t> add_121_1010102(const V<N,uint64_t>& x0,
+                                                          const V<N,uint64_t>& x1,
+                                                          const V<N,uint64_t>& x2, int shift) {
+        auto e0 = expand_1010102<N>((x0 >> shift) & 0xffffffff),
+             e1 = expand_1010102<N>((x1 >> shift) & 0xffffffff),
+             e2 = expand_1010102<N>((x2 >> shift) & 0xffffffff);
+        return e0 + e1 + e1 + e2;
+    }
+
+    template <int N>
+    SK_ALWAYS_INLINE static V<N,uint64_t> filter_3_3_1010102(const uint32_t* p0,
+                                                             const uint32_t* p1,
+                                                             const uint32_t* p2) {
+        auto r0 = load<N,uint64_t>(p0),
+             r1 = load<N,uint64_t>(p1),
+             r2 = load<N,uint64_t>(p2);
+        auto a = add_121_1010102<N>(r0, r1, r2, 0),
+             b = add_121_1010102<N>(r0, r1, r2, 32) << 1,
+             c = add_121_1010102<N>(load_next_pairs<N>(p0), load_next_pairs<N>(p1),
+                                    load_next_pairs<N>(p2), 0);
+        return compact_1010102<N>((a + b + c) >> 4);
+    }
+
+    // --- A8 --- //
+
+    // Here a pair is a 16-bit lane, and its pixels are the lane's low and high bytes.
+    template <int N>
+    SK_ALWAYS_INLINE static V<N,uint16_t> filter_2_2_a8(const uint8_t* p0, const uint8_t* p1) {
+        auto r0 = load<N,uint16_t>(p0),
+             r1 = load<N,uint16_t>(p1);
+        auto c = (r0 & 0xff) + (r1 & 0xff) + (r0 >> 8) + (r1 >> 8);
+        return c >> 2;
+    }
+
+    template <int N>
+    SK_ALWAYS_INLINE static V<N,uint16_t> filter_3_3_a8(const uint8_t* p0, const uint8_t* p1,
+                                                        const uint8_t* p2) {
+        auto r0 = load<N,uint16_t>(p0),
+             r1 = load<N,uint16_t>(p1),
+             r2 = load<N,uint16_t>(p2);
+        // At N=1, the last dst pixel of a row, only read the one next pixel that must exist.
+        V<N,uint16_t> n0 = p0[2], n1 = p1[2], n2 = p2[2];
+        if (N > 1) {
+            n0 = load<N,uint16_t>(p0 + 2);
+            n1 = load<N,uint16_t>(p1 + 2);
+            n2 = load<N,uint16_t>(p2 + 2);
+        }
+        auto a = (r0 & 0xff) + (r1 & 0xff) + (r1 & 0xff) + (r2 & 0xff),
+             b = (r0 >> 8) + (r1 >> 8) + (r1 >> 8) + (r2 >> 8),
+             c = (n0 & 0xff) + (n1 & 0xff) + (n1 & 0xff) + (n2 & 0xff);
+        return (a + (b << 1) + c) >> 4;
+    }
+
+    // --- F16 --- //
+
+    // The same conversions as SkHalfToFloat_finite_ftz() and SkFloatToHalf_finite_ftz(), for
+    // halves held in the low 16 bits of 32-bit lanes.
+    template <int N>
+    SK_ALWAYS_INLINE static V<N,float> half_to_float(const V<N,int32_t>& bits) {
+        V<N,int32_t> sign     = bits & 0x00008000,
+                     positive = bits ^ sign,
+                     is_norm  = 0x03ff < positive,
+                     norm     = (positive << 13) + ((127 - 15) << 23);
+        return skvx::bit_pun<V<N,float>>((sign << 16) | (norm & is_norm));
+    }
+    template <int N>
+    SK_ALWAYS_INLINE static V<N,int32_t> float_to_half(const V<N,float>& f) {
+        V<N,int32_t> bits         = skvx::bit_pun<V<N,int32_t>>(f),
+                     sign         = bits & 0x80000000,
+                     positive     = bits ^ sign,
+                     will_be_norm = 0x387fdfff < positive,
+                     norm         = (positive - ((127 - 15) << 23)) >> 13;
+        return ((sign >> 16) | (will_be_norm & norm)) & 0xffff;
+    }
+
+    // Every other F16 pixel starting at p, as 32-bit lanes holding two channels each.
+    template <int N>
+    SK_ALWAYS_INLINE static V<2*N,int32_t> load_every_other(const uint64_t* p) {
+        V<N,uint64_t> px;
+        for (int i = 0; i < N; i++) {
+            px[i] = p[2*i];
+        }
+        return skvx::bit_pun<V<2*N,int32_t>>(px);
+    }
+
+    // F16 pixels don't fit two to a lane, so the filters take even and odd pixels with
+    // load_every_other().  Each lane of those holds two channels, channel 0 and 1 or 2 and 3;
+    // the filters run once on the low halves of the lanes and once on the high.  Float sums
+    // are taken in the scalar filters' order so they round the same way.
+    template <int N>
+    SK_ALWAYS_INLINE static V<N,uint64_t> filter_2_2_f16(const uint64_t* p0, const uint64_t* p1) {
+        const V<2*N,int32_t> c00 = load_every_other<N>(p0), c01 = load_every_other<N>(p0 + 1),
+                             c10 = load_every_other<N>(p1), c11 = load_every_other<N>(p1 + 1);
+        auto filter = [&](int shift) {
+            auto f = [shift](const V<2*N,int32_t>& x) {
+                return half_to_float<2*N>((x >> shift) & 0xffff);
+            };
+            auto h = float_to_half<2*N>((f(c00) + f(c10) + f(c01) + f(c11)) * (1.0f / 4));
+            return skvx::bit_pun<V<2*N,uint32_t>>(h) << shift;
+        };
+        return skvx::bit_pun<V<N,uint64_t>>(filter(0) | filter(16));
+    }
+
+    template <int N>
+    SK_ALWAYS_INLINE static V<N,uint64_t> filter_3_3_f16(const uint64_t* p0, const uint64_t* p1,
+                                                         const uint64_t* p2) {
+        const V<2*N,int32_t> a0 = load_every_other<N>(p0    ), a1 = load_every_other<N>(p1    ),
+                             a2 = load_every_other<N>(p2    ), b0 = load_every_other<N>(p0 + 1),
+                             b1 = load_every_other<N>(p1 + 1), b2 = load_every_other<N>(p2 + 1),
+                             c0 = load_every_other<N>(p0 + 2), c1 = load_every_other<N>(p1 + 2),
+                             c2 = load_every_other<N>(p2 + 2);
+        auto filter = [&](int shift) {
+            auto f = [shift](const V<2*N,int32_t>& x) {
+                return half_to_float<2*N>((x >> shift) & 0xffff);
+            };
+            auto a = f(a0) + f(a1) + f(a1) + f(a2),
+                 b = (f(b0) + f(b1) + f(b1) + f(b2)) * 2,
+                 c = f(c0) + f(c1) + f(c1) + f(c2);
+            auto h = float_to_half<2*N>((a + b + c) * (1.0f / 16));
+            return skvx::bit_pun<V<2*N,uint32_t>>(h) << shift;
+        };
+        return skvx::bit_pun<V<N,uint64_t>>(filter(0) | filter(16));
+    }
+
+    // Store filtered pixels from the low bits of their lanes.  skvx::cast() would narrow the
+    // lanes one at a time on some compilers, so the full vectors narrow with AVX2 shuffles.
+    SK_ALWAYS_INLINE static void store(uint64_t* d, const V<4,uint64_t>& px) {
+        px.store(d);
+    }
+    SK_ALWAYS_INLINE static void store(uint64_t* d, const V<1,uint64_t>& px) {
+        px.store(d);
+    }
+    SK_ALWAYS_INLINE static void store(uint32_t* d, const V<4,uint64_t>& px) {
+        __m256i v = skvx::bit_pun<__m256i>(px);
+        v = _mm256_permutevar8x32_epi32(v, _mm256_setr_epi32(0,2,4,6, 0,2,4,6));
+        _mm_storeu_si128((__m128i*)d, _mm256_castsi256_si128(v));
+    }
+    SK_ALWAYS_INLINE static void store(uint32_t* d, const V<1,uint64_t>& px) {
+        *d = (uint32_t)px.val;
+    }
+    SK_ALWAYS_INLINE static void store(uint8_t* d, const V<16,uint16_t>& px) {
+        __m256i v = skvx::bit_pun<__m256i>(px);
+        _mm_storeu_si128((__m128i*)d, _mm_packus_epi16(_mm256_castsi256_si128(v),
+                                                       _mm256_extracti128_si256(v, 1)));
+    }
+    SK_ALWAYS_INLINE static void store(uint8_t* d, const V<1,uint16_t>& px) {
+        *d = (uint8_t)px.val;
+    }
+
+}  // namespace mipmap
+
+// The 3_3 filters read src pixel 2(i+N)+1 when filtering N pixels starting at i, which is only
+// there if i+N is not the last dst pixel.
+#define SK_MIPMAP_DOWNSAMPLE(name, T, kN, rows, ...)                              \
+    /*not static*/ inline                                                        \
+    void downsample_##name(void* dst, const void* src, size_t srcRB, int count) { \
+        auto p0 = mipmap::row<T>(src, srcRB, 0),                                 \
+             p1 = mipmap::row<T>(src, srcRB, 1),                                 \
+             p2 = mipmap::row<T>(src, srcRB, rows - 1);                          \
+        auto d  = (T*)dst;                                                       \
+        (void)p2;                                                                \
+        int i = 0;                                                               \
+        for (; i + kN + (rows - 2) <= count; i += kN) {                          \
+            mipmap::store(d + i, mipmap::filter_##name<kN>(__VA_ARGS__));        \
+        }                                                                        \
+        for (; i < count; i++) {                                                 \
+            mipmap::store(d + i, mipmap::filter_##name<1>(__VA_ARGS__));         \
+        }                                                                        \
+    }
+
+    // Each loop works on one 256-bit vector: 4 lanes of 64 bits, or 16 of 16 bits for A8.
+    static constexpr int kN64 = 4,
+                         kN16 = 16;
+
+    SK_MIPMAP_DOWNSAMPLE(2_2_8888,    uint32_t, kN64, 2, p0 + 2*i, p1 + 2*i)
+    SK_MIPMAP_DOWNSAMPLE(3_3_8888,    uint32_t, kN64, 3, p0 + 2*i, p1 + 2*i, p2 + 2*i)
+    SK_MIPMAP_DOWNSAMPLE(2_2_1010102, uint32_t, kN64, 2, p0 + 2*i, p1 + 2*i)
+    SK_MIPMAP_DOWNSAMPLE(3_3_1010102, uint32_t, kN64, 3, p0 + 2*i, p1 + 2*i, p2 + 2*i)
+    SK_MIPMAP_DOWNSAMPLE(2_2_a8,      uint8_t,  kN16, 2, p0 + 2*i, p1 + 2*i)
+    SK_MIPMAP_DOWNSAMPLE(3_3_a8,      uint8_t,  kN16, 3, p0 + 2*i, p1 + 2*i, p2 + 2*i)
+    SK_MIPMAP_DOWNSAMPLE(2_2_f16,     uint64_t, kN64, 2, p0 + 2*i, p1 + 2*i)
+    SK_MIPMAP_DOWNSAMPLE(3_3_f16,     uint64_t, kN64, 3, p0 + 2*i, p1 + 2*i, p2 + 2*i)
+
+#undef SK_MIPMAP_DOWNSAMPLE
+
+#else
+
+// Null, so SkMipmap falls back to its own filters.
+#define SK_MIPMAP_DOWNSAMPLE(name) \
+    static constexpr void (*downsample_##name)(void*, const void*, size_t, int) = nullptr;
+
+    SK_MIPMAP_DOWNSAMPLE(2_2_8888)
+    SK_MIPMAP_DOWNSAMPLE(3_3_8888)
+    SK_MIPMAP_DOWNSAMPLE(2_2_1010102)
+    SK_MIPMAP_DOWNSAMPLE(3_3_1010102)
+    SK_MIPMAP_DOWNSAMPLE(2_2_a8)
+    SK_MIPMAP_DOWNSAMPLE(3_3_a8)
+    SK_MIPMAP_DOWNSAMPLE(2_2_f16)
+    SK_MIPMAP_DOWNSAMPLE(3_3_f16)
+
+#undef SK_MIPMAP_DOWNSAMPLE
+
+#endif
+
+}  // namespace SK_OPTS_NS
+
+#endif//SkMipmap_opts_DEFINED
@@ -11,6 +11,7 @@
 #include "src/core/SkCubicSolver.h"
 #include "src/opts/SkBitmapProcState_opts.h"
 #include "src/opts/SkBlitRow_opts.h"
+#include "src/opts/SkMipmap_opts.h"
 #include "src/opts/SkRasterPipeline_opts.h"
 #include "src/opts/SkSwizzler_opts.h"
 #include "src/opts/SkUtils_opts.h"
@@ -25,6 +26,15 @@ namespace SkOpts {
 
         cubic_solver = SK_OPTS_NS::cubic_solver;
 
+        downsample_2_2_8888    = SK_OPTS_NS::downsample_2_2_8888;
+        downsample_3_3_8888    = SK_OPTS_NS::downsample_3_3_8888;
+        downsample_2_2_a8      = SK_OPTS_NS::downsample_2_2_a8;
+        downsample_3_3_a8      = SK_OPTS_NS::downsample_3_3_a8;
+        downsample_2_2_1010102 = SK_OPTS_NS::downsample_2_2_1010102;
+        downsample_3_3_1010102 = SK_OPTS_NS::downsample_3_3_1010102;
+        downsample_2_2_f16     = SK_OPTS_NS::downsample_2_2_f16;
+        downsample_3_3_f16     = SK_OPTS_NS::downsample_3_3_f16;
+
         RGBA_to_BGRA          = SK_OPTS_NS::RGBA_to_BGRA;
         RGBA_to_rgbA          = SK_OPTS_NS::RGBA_to_rgbA;
         RGBA_to_bgrA          = SK_OPTS_NS::RGBA_to_bgrA;
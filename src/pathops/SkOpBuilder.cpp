@@ -7,11 +7,17 @@
 
 #include "include/core/SkMatrix.h"
 #include "include/pathops/SkPathOps.h"
+#include "include/private/SkTemplates.h"
 #include "src/core/SkArenaAlloc.h"
 #include "src/core/SkPathPriv.h"
+#include "src/core/SkTaskGroup.h"
 #include "src/pathops/SkOpEdgeBuilder.h"
 #include "src/pathops/SkPathOpsCommon.h"
 
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
 static bool one_contour(const SkPath& path) {
     SkSTArenaAlloc<256> allocator;
     int verbCount = path.countVerbs();
@@ -195,3 +201,170 @@ bool SkOpBuilder::resolve(SkPath* result) {
     }
     return success;
 }
+
+// resolveInParallel() unions groups of up to this many nearby paths on each task.
+static constexpr int kParallelGroupPaths = 16;
+
+// Orders paths so that each run of kParallelGroupPaths, and runs next to each other, lie close
+// together: splits the paths at the median of their centers along the longer axis, and recurses.
+static void sort_for_groups(const SkTArray<SkPath>& paths, int* begin, int* end) {
+    const int count = SkToInt(end - begin);
+    if (count <= kParallelGroupPaths) {
+        return;
+    }
+    float left = SK_ScalarInfinity, top = SK_ScalarInfinity,
+          right = SK_ScalarNegativeInfinity, bottom = SK_ScalarNegativeInfinity;
+    for (int* index = begin; index < end; ++index) {
+        const SkRect& bounds = paths[*index].getBounds();
+        left   = std::min(left,   bounds.centerX());
+        right  = std::max(right,  bounds.centerX());
+        top    = std::min(top,    bounds.centerY());
+        bottom = std::max(bottom, bounds.centerY());
+    }
+    const bool alongX = right - left >= bottom - top;
+    auto center = [&](int index) {
+        const SkRect& bounds = paths[index].getBounds();
+        return alongX ? bounds.centerX() : bounds.centerY();
+    };
+    // Split between groups, so each half's groups stay whole.
+    const int groups = (count + kParallelGroupPaths - 1) / kParallelGroupPaths;
+    int* mid = begin + (groups + 1) / 2 * kParallelGroupPaths;
+    std::nth_element(begin, mid, end, [&](int a, int b) { return center(a) < center(b); });
+    sort_for_groups(paths, begin, mid);
+    sort_for_groups(paths, mid, end);
+}
+
+// Lists the paths by component, runs of paths each linked to the rest of its run by intersecting
+// bounds, and returns the end of each run. Paths in different components can't overlap.
+static std::vector<int> sort_into_components(const SkTArray<SkPath>& paths, int order[]) {
+    const int count = paths.count();
+    std::vector<int> root(count);
+    std::iota(root.begin(), root.end(), 0);
+    auto find = [&](int index) {
+        while (root[index] != index) {
+            index = root[index] = root[root[index]];
+        }
+        return index;
+    };
+    std::iota(order, order + count, 0);
+    std::sort(order, order + count, [&](int a, int b) {
+        return paths[a].getBounds().fLeft < paths[b].getBounds().fLeft;
+    });
+    for (int i = 0; i < count; ++i) {
+        const SkRect& bounds = paths[order[i]].getBounds();
+        for (int j = i + 1; j < count && paths[order[j]].getBounds().fLeft < bounds.fRight; ++j) {
+            if (SkRect::Intersects(bounds, paths[order[j]].getBounds())) {
+                root[find(order[j])] = find(order[i]);
+            }
+        }
+    }
+    for (int index = 0; index < count; ++index) {
+        root[index] = find(index);
+    }
+    std::iota(order, order + count, 0);
+    std::sort(order, order + count, [&](int a, int b) {
+        return root[a] != root[b] ? root[a] < root[b] : a < b;
+    });
+    std::vector<int> ends;
+    for (int index = 1; index <= count; ++index) {
+        if (index == count || root[order[index]] != root[order[index - 1]]) {
+            ends.push_back(index);
+        }
+    }
+    return ends;
+}
+
+// Sets one to the union of one and two, each already the result of a union.
+static bool union_resolved(SkPath* one, const SkPath& two, bool disjoint) {
+    if (two.isEmpty()) {
+        return true;
+    }
+    if (one->isEmpty()) {
+        *one = two;
+        return true;
+    }
+    // Contours that can't overlap union by concatenation.
+    if (one->getFillType() == two.getFillType() &&
+        (disjoint || !SkRect::Intersects(one->getBounds(), two.getBounds()))) {
+        one->addPath(two);
+        return true;
+    }
+    return Op(*one, two, kUnion_SkPathOp, one);
+}
+
+bool SkOpBuilder::resolveInParallel(SkPath* result, SkExecutor* executor) {
+    const int count = fOps.count();
+    bool allUnion = count >= 2 * kParallelGroupPaths;
+    for (int index = 0; allUnion && index < count; ++index) {
+        allUnion = kUnion_SkPathOp == fOps[index] && !fPathRefs[index].isInverseFillType();
+    }
+    if (!allUnion) {
+        return this->resolve(result);
+    }
+
+    // Split components into groups of nearby paths, each unioned on its own task.
+    std::vector<int> order(count);
+    const std::vector<int> componentEnds = sort_into_components(fPathRefs, order.data());
+    std::vector<int> groupEnds;
+    std::vector<std::vector<int>> componentGroups(componentEnds.size());
+    int begin = 0;
+    for (size_t component = 0; component < componentEnds.size(); ++component) {
+        const int end = componentEnds[component];
+        sort_for_groups(fPathRefs, order.data() + begin, order.data() + end);
+        for (int group = begin; group < end; group += kParallelGroupPaths) {
+            componentGroups[component].push_back(SkToInt(groupEnds.size()));
+            groupEnds.push_back(std::min(end, group + kParallelGroupPaths));
+        }
+        begin = end;
+    }
+
+    // Each task resolves its own builder, and each op allocates from its own arena.
+    SkExecutor& tasks = executor ? *executor : SkExecutor::GetDefault();
+    const int groups = SkToInt(groupEnds.size());
+    std::vector<SkPath> unions(groups);
+    SkAutoTMalloc<bool> succeeded(groups);
+    SkTaskGroup(tasks).batch(groups, [&](int group) {
+        SkOpBuilder builder;
+        for (int index = group ? groupEnds[group - 1] : 0; index < groupEnds[group]; ++index) {
+            builder.add(fPathRefs[order[index]], kUnion_SkPathOp);
+        }
+        succeeded[group] = builder.resolve(&unions[group]);
+    });
+    reset();
+    if (!std::all_of(succeeded.get(), succeeded.get() + groups, [](bool ok) { return ok; })) {
+        return false;
+    }
+
+    // Merge neighboring groups' unions pairwise until each component has one.
+    std::vector<std::pair<int, int>> pairs;
+    do {
+        pairs.clear();
+        for (std::vector<int>& live : componentGroups) {
+            for (size_t index = 0; index + 1 < live.size(); index += 2) {
+                pairs.push_back({live[index], live[index + 1]});
+            }
+        }
+        SkTaskGroup(tasks).batch(SkToInt(pairs.size()), [&](int pair) {
+            const auto [one, two] = pairs[pair];
+            succeeded[one] = union_resolved(&unions[one], unions[two], false);
+        });
+        for (std::vector<int>& live : componentGroups) {
+            for (size_t index = 0; index < live.size(); index += 2) {
+                if (!succeeded[live[index]]) {
+                    return false;
+                }
+                live[index / 2] = live[index];
+            }
+            live.resize((live.size() + 1) / 2);
+        }
+    } while (!pairs.empty());
+
+    SkPath sum;
+    for (const std::vector<int>& live : componentGroups) {
+        if (!union_resolved(&sum, unions[live[0]], true)) {
+            return false;
+        }
+    }
+    *result = std::move(sum);
+    return true;
+}
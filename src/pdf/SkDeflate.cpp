@@ -40,7 +40,7 @@ static void do_deflate(int flush,
                        unsigned char* inBuffer,
                        size_t inBufferSize) {
     zStream->next_in = inBuffer;
-    zStream->avail_in = SkToInt(inBufferSize);
+    zStream->avail_in = SkToUInt(inBufferSize);
     unsigned char outBuffer[SKDEFLATEWSTREAM_OUTPUT_BUFFER_SIZE];
     SkDEBUGCODE(int returnValue;)
     do {
@@ -56,6 +56,42 @@ static void do_deflate(int flush,
                  : returnValue == Z_OK);
 }
 
+static int zlib_strategy(SkDeflateWStream::Strategy strategy) {
+    switch (strategy) {
+        case SkDeflateWStream::Strategy::kDefault:     return Z_DEFAULT_STRATEGY;
+        case SkDeflateWStream::Strategy::kFiltered:    return Z_FILTERED;
+        case SkDeflateWStream::Strategy::kRLE:         return Z_RLE;
+        case SkDeflateWStream::Strategy::kHuffmanOnly: return Z_HUFFMAN_ONLY;
+    }
+    SkUNREACHABLE;
+}
+
+static int init_zstream(z_stream* zStream, int compressionLevel, bool gzip,
+                        SkDeflateWStream::Strategy strategy) {
+    zStream->next_in = nullptr;
+    zStream->zalloc = &skia_alloc_func;
+    zStream->zfree = &skia_free_func;
+    zStream->opaque = nullptr;
+    SkASSERT(compressionLevel <= 9 && compressionLevel >= -1);
+    return deflateInit2(zStream, compressionLevel, Z_DEFLATED, gzip ? 0x1F : 0x0F,
+                        8, zlib_strategy(strategy));
+}
+
+bool SkDeflateWStream::Compress(const void* data,
+                                size_t length,
+                                SkWStream* out,
+                                int compressionLevel,
+                                Strategy strategy) {
+    TRACE_EVENT0("skia", TRACE_FUNC);
+    z_stream zStream;
+    if (!out || Z_OK != init_zstream(&zStream, compressionLevel, false, strategy)) {
+        return false;
+    }
+    do_deflate(Z_FINISH, &zStream, out, (unsigned char*)data, length);
+    (void)deflateEnd(&zStream);
+    return true;
+}
+
 // Hide all zlib impl details.
 struct SkDeflateWStream::Impl {
     SkWStream* fOut;
@@ -66,21 +102,15 @@ struct SkDeflateWStream::Impl {
 
 SkDeflateWStream::SkDeflateWStream(SkWStream* out,
                                    int compressionLevel,
-                                   bool gzip)
+                                   bool gzip,
+                                   Strategy strategy)
     : fImpl(std::make_unique<SkDeflateWStream::Impl>()) {
     fImpl->fOut = out;
     fImpl->fInBufferIndex = 0;
     if (!fImpl->fOut) {
         return;
     }
-    fImpl->fZStream.next_in = nullptr;
-    fImpl->fZStream.zalloc = &skia_alloc_func;
-    fImpl->fZStream.zfree = &skia_free_func;
-    fImpl->fZStream.opaque = nullptr;
-    SkASSERT(compressionLevel <= 9 && compressionLevel >= -1);
-    SkDEBUGCODE(int r =) deflateInit2(&fImpl->fZStream, compressionLevel,
-                                      Z_DEFLATED, gzip ? 0x1F : 0x0F,
-                                      8, Z_DEFAULT_STRATEGY);
+    SkDEBUGCODE(int r =) init_zstream(&fImpl->fZStream, compressionLevel, gzip, strategy);
     SkASSERT(Z_OK == r);
 }
 
@@ -103,6 +133,14 @@ bool SkDeflateWStream::write(const void* void_buffer, size_t len) {
         return false;
     }
     const char* buffer = (const char*)void_buffer;
+    // Whole blocks written to an empty input buffer go straight to zlib, without the copy.
+    if (0 == fImpl->fInBufferIndex && len >= sizeof(fImpl->fInBuffer)) {
+        size_t direct = len - len % sizeof(fImpl->fInBuffer);
+        do_deflate(Z_NO_FLUSH, &fImpl->fZStream, fImpl->fOut,
+                   (unsigned char*)buffer, direct);
+        len -= direct;
+        buffer += direct;
+    }
     while (len > 0) {
         size_t tocopy =
                 std::min(len, sizeof(fImpl->fInBuffer) - fImpl->fInBufferIndex);
@@ -19,6 +19,18 @@
   */
 class SkDeflateWStream final : public SkWStream {
 public:
+    /** How the compressor searches for matches; see zlib's deflateInit2().
+        kRLE only looks for runs of the previous byte, and kHuffmanOnly
+        does no matching at all.  Both are much faster than kDefault, at
+        the cost of a worse ratio on anything but very repetitive data.
+     */
+    enum class Strategy {
+        kDefault,
+        kFiltered,
+        kRLE,
+        kHuffmanOnly,
+    };
+
     /** Does not take ownership of the stream.
 
         @param compressionLevel - 0 is no compression; 1 is best
@@ -29,10 +41,25 @@ public:
         a wrapper, documented in RFC 1952, around a deflate stream."
         gzip adds a header with a magic number to the beginning of the
         stream, allowing a client to identify a gzip file.
+
+        @param strategy - see Strategy.
      */
     SkDeflateWStream(SkWStream*,
                      int compressionLevel = -1,
-                     bool gzip = false);
+                     bool gzip = false,
+                     Strategy strategy = Strategy::kDefault);
+
+    /** Compress a whole buffer already in memory with a single call into
+        zlib, writing the deflate stream straight to out.  This skips the
+        copy through SkDeflateWStream's input buffer and its per-block
+        calls, which matters most for the many small streams in a PDF.
+        Returns false if zlib could not be initialized.
+     */
+    static bool Compress(const void* data,
+                         size_t length,
+                         SkWStream* out,
+                         int compressionLevel = -1,
+                         Strategy strategy = Strategy::kDefault);
 
     /** The destructor calls finalize(). */
     ~SkDeflateWStream() override;
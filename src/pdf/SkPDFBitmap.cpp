@@ -15,12 +15,16 @@
 #include "include/private/SkColorData.h"
 #include "include/private/SkImageInfoPriv.h"
 #include "include/private/SkTo.h"
+#include "src/pdf/SkBitmapKey.h"
 #include "src/pdf/SkDeflate.h"
 #include "src/pdf/SkJpegInfo.h"
 #include "src/pdf/SkPDFDocumentPriv.h"
+#include "src/pdf/SkPDFResourceCache.h"
 #include "src/pdf/SkPDFTypes.h"
 #include "src/pdf/SkPDFUtils.h"
 
+#include <optional>
+
 ////////////////////////////////////////////////////////////////////////////////
 
 // write a single byte to a stream n times.
@@ -99,9 +103,19 @@ static void emit_image_stream(SkPDFDocument* doc,
     doc->emitStream(pdfDict, std::move(writeStream), ref);
 }
 
-static void do_deflated_alpha(const SkPixmap& pm, SkPDFDocument* doc, SkPDFIndirectReference ref) {
+using SerializedImage = SkPDFResourceCache::Image;
+
+static sk_sp<SkData> finish_stream(SkDynamicMemoryWStream* buffer) {
+    #ifdef SK_PDF_BASE85_BINARY
+    SkPDFUtils::Base85Encode(buffer->detachAsStream(), buffer);
+    #endif
+    return buffer->detachAsData();
+}
+
+static sk_sp<SkData> do_deflated_alpha(const SkPixmap& pm, int compressionLevel,
+                                       SkDeflateWStream::Strategy strategy) {
     SkDynamicMemoryWStream buffer;
-    SkDeflateWStream deflateWStream(&buffer);
+    SkDeflateWStream deflateWStream(&buffer, compressionLevel, false, strategy);
     if (kAlpha_8_SkColorType == pm.colorType()) {
         SkASSERT(pm.rowBytes() == (size_t)pm.width());
         buffer.write(pm.addr8(), pm.width() * pm.height());
@@ -112,7 +126,7 @@ static void do_deflated_alpha(const SkPixmap& pm, SkPDFDocument* doc, SkPDFIndir
         const uint32_t* ptr = pm.addr32();
         const uint32_t* stop = ptr + pm.height() * pm.width();
 
-        uint8_t byteBuffer[4092];
+        uint8_t byteBuffer[4096];
         uint8_t* bufferStop = byteBuffer + SK_ARRAY_COUNT(byteBuffer);
         uint8_t* dst = byteBuffer;
         while (ptr != stop) {
@@ -125,33 +139,20 @@ static void do_deflated_alpha(const SkPixmap& pm, SkPDFDocument* doc, SkPDFIndir
         deflateWStream.write(byteBuffer, dst - byteBuffer);
     }
     deflateWStream.finalize();
-
-    #ifdef SK_PDF_BASE85_BINARY
-    SkPDFUtils::Base85Encode(buffer.detachAsStream(), &buffer);
-    #endif
-    int length = SkToInt(buffer.bytesWritten());
-    emit_image_stream(doc, ref, [&buffer](SkWStream* stream) { buffer.writeToAndReset(stream); },
-                      pm.info().dimensions(), "DeviceGray", SkPDFIndirectReference(),
-                      length, false);
+    return finish_stream(&buffer);
 }
 
-static void do_deflated_image(const SkPixmap& pm,
-                              SkPDFDocument* doc,
-                              bool isOpaque,
-                              SkPDFIndirectReference ref) {
-    SkPDFIndirectReference sMask;
-    if (!isOpaque) {
-        sMask = doc->reserveRef();
-    }
+static void do_deflated_image(const SkPixmap& pm, bool isOpaque, int compressionLevel,
+                              SkDeflateWStream::Strategy strategy, SerializedImage* image) {
     SkDynamicMemoryWStream buffer;
-    SkDeflateWStream deflateWStream(&buffer);
+    SkDeflateWStream deflateWStream(&buffer, compressionLevel, false, strategy);
     const char* colorSpace = "DeviceGray";
     switch (pm.colorType()) {
         case kAlpha_8_SkColorType:
             fill_stream(&deflateWStream, '\x00', pm.width() * pm.height());
             break;
         case kGray_8_SkColorType:
-            SkASSERT(sMask.fValue = -1);
+            SkASSERT(isOpaque);
             SkASSERT(pm.rowBytes() == (size_t)pm.width());
             deflateWStream.write(pm.addr8(), pm.width() * pm.height());
             break;
@@ -160,7 +161,8 @@ static void do_deflated_image(const SkPixmap& pm,
             SkASSERT(pm.alphaType() == kUnpremul_SkAlphaType);
             SkASSERT(pm.colorType() == kBGRA_8888_SkColorType);
             SkASSERT(pm.rowBytes() == (size_t)pm.width() * 4);
-            uint8_t byteBuffer[3072];
+            // A whole number of SkDeflateWStream's blocks, so full buffers skip its copy.
+            uint8_t byteBuffer[3 * 4096];
             static_assert(SK_ARRAY_COUNT(byteBuffer) % 3 == 0, "");
             uint8_t* bufferStop = byteBuffer + SK_ARRAY_COUNT(byteBuffer);
             uint8_t* dst = byteBuffer;
@@ -183,19 +185,14 @@ static void do_deflated_image(const SkPixmap& pm,
             deflateWStream.write(byteBuffer, dst - byteBuffer);
     }
     deflateWStream.finalize();
-    #ifdef SK_PDF_BASE85_BINARY
-    SkPDFUtils::Base85Encode(buffer.detachAsStream(), &buffer);
-    #endif
-    int length = SkToInt(buffer.bytesWritten());
-    emit_image_stream(doc, ref, [&buffer](SkWStream* stream) { buffer.writeToAndReset(stream); },
-                      pm.info().dimensions(), colorSpace, sMask, length, false);
+    image->fSize = pm.info().dimensions();
+    image->fImage = {finish_stream(&buffer), colorSpace, false};
     if (!isOpaque) {
-        do_deflated_alpha(pm, doc, sMask);
+        image->fSMask = {do_deflated_alpha(pm, compressionLevel, strategy), "DeviceGray", false};
     }
 }
 
-static bool do_jpeg(sk_sp<SkData> data, SkPDFDocument* doc, SkISize size,
-                    SkPDFIndirectReference ref) {
+static bool do_jpeg(sk_sp<SkData> data, SkISize size, SerializedImage* image) {
     SkISize jpegSize;
     SkEncodedInfo::Color jpegColorType;
     SkEncodedOrigin exifOrientation;
@@ -216,13 +213,31 @@ static bool do_jpeg(sk_sp<SkData> data, SkPDFDocument* doc, SkISize size,
     data = buffer.detachAsData();
     #endif
 
-    emit_image_stream(doc, ref,
-                      [&data](SkWStream* dst) { dst->write(data->data(), data->size()); },
-                      jpegSize, yuv ? "DeviceRGB" : "DeviceGray",
-                      SkPDFIndirectReference(), SkToInt(data->size()), true);
+    image->fSize = jpegSize;
+    image->fImage = {std::move(data), yuv ? "DeviceRGB" : "DeviceGray", true};
     return true;
 }
 
+static void emit_image(const SerializedImage& image, SkPDFDocument* doc,
+                       SkPDFIndirectReference ref) {
+    SkPDFIndirectReference sMask;
+    if (image.fSMask.fData) {
+        sMask = doc->reserveRef();
+    }
+    auto emitStream = [&](const SerializedImage::Stream& stream, SkPDFIndirectReference ref,
+                          SkPDFIndirectReference sMask) {
+        const SkData* data = stream.fData.get();
+        emit_image_stream(doc, ref,
+                          [data](SkWStream* dst) { dst->write(data->data(), data->size()); },
+                          image.fSize, stream.fColorSpace, sMask, SkToInt(data->size()),
+                          stream.fIsJpeg);
+    };
+    emitStream(image.fImage, ref, sMask);
+    if (sMask) {
+        emitStream(image.fSMask, sMask, SkPDFIndirectReference());
+    }
+}
+
 static SkBitmap to_pixels(const SkImage* image) {
     SkBitmap bm;
     int w = image->width(),
@@ -247,46 +262,71 @@ static SkBitmap to_pixels(const SkImage* image) {
     return bm;
 }
 
-void serialize_image(const SkImage* img,
-                     int encodingQuality,
-                     SkPDFDocument* doc,
-                     SkPDFIndirectReference ref) {
-    SkASSERT(img);
-    SkASSERT(doc);
-    SkASSERT(encodingQuality >= 0);
+static SerializedImage encode_image(const SkImage* img, int encodingQuality,
+                                    int compressionLevel, SkDeflateWStream::Strategy strategy) {
+    SerializedImage image;
     SkISize dimensions = img->dimensions();
     sk_sp<SkData> data = img->refEncodedData();
-    if (data && do_jpeg(std::move(data), doc, dimensions, ref)) {
-        return;
+    if (data && do_jpeg(std::move(data), dimensions, &image)) {
+        return image;
     }
     SkBitmap bm = to_pixels(img);
     const SkPixmap& pm = bm.pixmap();
     bool isOpaque = pm.isOpaque() || pm.computeIsOpaque();
     if (encodingQuality <= 100 && isOpaque) {
         sk_sp<SkData> data = img->encodeToData(SkEncodedImageFormat::kJPEG, encodingQuality);
-        if (data && do_jpeg(std::move(data), doc, dimensions, ref)) {
-            return;
+        if (data && do_jpeg(std::move(data), dimensions, &image)) {
+            return image;
         }
     }
-    do_deflated_image(pm, doc, isOpaque, ref);
+    do_deflated_image(pm, isOpaque, compressionLevel, strategy, &image);
+    return image;
+}
+
+static void serialize_image(const SkImage* img,
+                            int encodingQuality,
+                            const SkBitmapKey* cacheKey,
+                            SkPDFDocument* doc,
+                            SkPDFIndirectReference ref) {
+    SkASSERT(img);
+    SkASSERT(doc);
+    SkASSERT(encodingQuality >= 0);
+    int compressionLevel = (int)doc->metadata().fImageCompressionLevel;
+    SkPDF::Metadata::CompressionStrategy strategy = doc->metadata().fImageCompressionStrategy;
+    SerializedImage image;
+    if (!cacheKey || !SkPDFResourceCache::FindImage(*cacheKey, encodingQuality, compressionLevel,
+                                                    (int)strategy, &image)) {
+        image = encode_image(img, encodingQuality, compressionLevel,
+                             SkPDFDeflateStrategy(strategy));
+        if (cacheKey) {
+            SkPDFResourceCache::AddImage(*cacheKey, encodingQuality, compressionLevel,
+                                         (int)strategy, image);
+        }
+    }
+    emit_image(image, doc, ref);
 }
 
 SkPDFIndirectReference SkPDFSerializeImage(const SkImage* img,
                                            SkPDFDocument* doc,
-                                           int encodingQuality) {
+                                           int encodingQuality,
+                                           const SkBitmapKey* key) {
     SkASSERT(img);
     SkASSERT(doc);
     SkPDFIndirectReference ref = doc->reserveRef();
+    std::optional<SkBitmapKey> cacheKey;
+    if (key && key->fID != 0 && doc->metadata().fCacheAcrossDocuments) {
+        cacheKey = *key;
+    }
     if (SkExecutor* executor = doc->executor()) {
         SkRef(img);
         doc->incrementJobCount();
-        executor->add([img, encodingQuality, doc, ref]() {
-            serialize_image(img, encodingQuality, doc, ref);
+        executor->add([img, encodingQuality, cacheKey, doc, ref]() {
+            serialize_image(img, encodingQuality, cacheKey ? &*cacheKey : nullptr, doc, ref);
             SkSafeUnref(img);
             doc->signalJobComplete();
         });
         return ref;
     }
-    serialize_image(img, encodingQuality, doc, ref);
+    serialize_image(img, encodingQuality, cacheKey ? &*cacheKey : nullptr, doc, ref);
     return ref;
 }
@@ -9,14 +9,18 @@
 
 class SkImage;
 class SkPDFDocument;
+struct SkBitmapKey;
 struct SkPDFIndirectReference;
 
 /**
  * Serialize a SkImage as an Image Xobject.
  *  quality > 100 means lossless
+ *  If key is given and the document sets fCacheAcrossDocuments, the encoded
+ *  streams are shared with other documents through SkPDFResourceCache.
  */
 SkPDFIndirectReference SkPDFSerializeImage(const SkImage* img,
                                            SkPDFDocument* doc,
-                                           int encodingQuality = 101);
+                                           int encodingQuality = 101,
+                                           const SkBitmapKey* key = nullptr);
 
 #endif  // SkPDFBitmap_DEFINED
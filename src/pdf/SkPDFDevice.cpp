@@ -71,11 +71,12 @@ namespace {
 // out of scope.
 class ScopedOutputMarkedContentTags {
 public:
-    ScopedOutputMarkedContentTags(int nodeId, SkPDFDocument* document, SkDynamicMemoryWStream* out)
+    ScopedOutputMarkedContentTags(int nodeId, SkPDFDocument* document, const SkPDFPage* page,
+                                  SkDynamicMemoryWStream* out)
         : fOut(out)
         , fMarkId(-1) {
-        if (nodeId) {
-            fMarkId = document->createMarkIdForNodeId(nodeId);
+        if (nodeId && page) {
+            fMarkId = document->createMarkIdForNodeId(nodeId, page->fIndex);
         }
 
         if (fMarkId != -1) {
@@ -221,7 +222,7 @@ SkBaseDevice* SkPDFDevice::onCreateDevice(const CreateInfo& cinfo, const SkPaint
         // need to return a raster device, which we will detect in drawDevice()
         return SkBitmapDevice::Create(cinfo.fInfo, SkSurfaceProps(0, kUnknown_SkPixelGeometry));
     }
-    return new SkPDFDevice(cinfo.fInfo.dimensions(), fDocument);
+    return new SkPDFDevice(cinfo.fInfo.dimensions(), fDocument, SkMatrix::I(), fPage);
 }
 
 // A helper class to automatically finish a ContentEntry at the end of a
@@ -306,12 +307,14 @@ private:
 
 ////////////////////////////////////////////////////////////////////////////////
 
-SkPDFDevice::SkPDFDevice(SkISize pageSize, SkPDFDocument* doc, const SkMatrix& transform)
+SkPDFDevice::SkPDFDevice(SkISize pageSize, SkPDFDocument* doc, const SkMatrix& transform,
+                         SkPDFPage* page)
     : INHERITED(SkImageInfo::MakeUnknown(pageSize.width(), pageSize.height()),
                 SkSurfaceProps(0, kUnknown_SkPixelGeometry))
     , fInitialTransform(transform)
     , fNodeId(0)
     , fDocument(doc)
+    , fPage(page)
 {
     SkASSERT(!pageSize.isEmpty());
 }
@@ -328,13 +331,13 @@ void SkPDFDevice::reset() {
 }
 
 void SkPDFDevice::drawAnnotation(const SkRect& rect, const char key[], SkData* value) {
-    if (!value) {
+    if (!value || !fPage) {
         return;
     }
     // Annotations are specified in absolute coordinates, so the page xform maps from device space
     // to the global space, and applies the document transform.
     SkMatrix pageXform = this->deviceToGlobal().asM33();
-    pageXform.postConcat(fDocument->currentPageTransform());
+    pageXform.postConcat(fPage->fTransform);
     if (rect.isEmpty()) {
         if (!strcmp(key, SkPDFGetNodeIdKey())) {
             int nodeID;
@@ -346,8 +349,9 @@ void SkPDFDevice::drawAnnotation(const SkRect& rect, const char key[], SkData* v
         if (!strcmp(SkAnnotationKeys::Define_Named_Dest_Key(), key)) {
             SkPoint p = this->localToDevice().mapXY(rect.x(), rect.y());
             pageXform.mapPoints(&p, 1);
-            auto pg = fDocument->currentPage();
-            fDocument->fNamedDestinations.push_back(SkPDFNamedDestination{sk_ref_sp(value), p, pg});
+            SkAutoMutexExclusive lock(fDocument->fCanonMutex);
+            fDocument->fNamedDestinations.push_back(
+                    SkPDFNamedDestination{sk_ref_sp(value), p, fPage->fRef});
         }
         return;
     }
@@ -372,7 +376,7 @@ void SkPDFDevice::drawAnnotation(const SkRect& rect, const char key[], SkData* v
     if (linkType != SkPDFLink::Type::kNone) {
         std::unique_ptr<SkPDFLink> link = std::make_unique<SkPDFLink>(
             linkType, value, transformedRect, fNodeId);
-        fDocument->fCurrentPageLinks.push_back(std::move(link));
+        fPage->fLinks.push_back(std::move(link));
     }
 }
 
@@ -546,11 +550,15 @@ void SkPDFDevice::setGraphicState(SkPDFIndirectReference gs, SkDynamicMemoryWStr
 
 void SkPDFDevice::clearMaskOnGraphicState(SkDynamicMemoryWStream* contentStream) {
     // The no-softmask graphic state is used to "turn off" the mask for later draw calls.
-    SkPDFIndirectReference& noSMaskGS = fDocument->fNoSmaskGraphicState;
-    if (!noSMaskGS) {
-        SkPDFDict tmp("ExtGState");
-        tmp.insertName("SMask", "None");
-        noSMaskGS = fDocument->emit(tmp);
+    SkPDFIndirectReference noSMaskGS;
+    {
+        SkAutoMutexExclusive lock(fDocument->fCanonMutex);
+        if (!fDocument->fNoSmaskGraphicState) {
+            SkPDFDict tmp("ExtGState");
+            tmp.insertName("SMask", "None");
+            fDocument->fNoSmaskGraphicState = fDocument->emit(tmp);
+        }
+        noSMaskGS = fDocument->fNoSmaskGraphicState;
     }
     this->setGraphicState(noSMaskGS, contentStream);
 }
@@ -857,7 +865,7 @@ void SkPDFDevice::internalDrawGlyphRun(
     out->writeText("BT\n");
     SK_AT_SCOPE_EXIT(out->writeText("ET\n"));
 
-    ScopedOutputMarkedContentTags mark(fNodeId, fDocument, out);
+    ScopedOutputMarkedContentTags mark(fNodeId, fDocument, fPage, out);
 
     const int numGlyphs = typeface->countGlyphs();
 
@@ -868,6 +876,20 @@ void SkPDFDevice::internalDrawGlyphRun(
     GlyphPositioner glyphPositioner(out, glyphRunFont.getSkewX(), offset);
     SkPDFFont* font = nullptr;
 
+    // Fonts are shared by every page, so note the glyphs used from each font under the lock,
+    // once per font change rather than once per glyph.
+    std::vector<SkGlyphID> usedGlyphs;
+    auto noteGlyphUsage = [&]() {
+        if (font && !usedGlyphs.empty()) {
+            SkAutoMutexExclusive lock(fDocument->fCanonMutex);
+            for (SkGlyphID gid : usedGlyphs) {
+                font->noteGlyphUsage(gid);
+            }
+        }
+        usedGlyphs.clear();
+    };
+    SK_AT_SCOPE_EXIT(noteGlyphUsage());
+
     SkBulkGlyphMetricsAndPaths paths{strikeSpec};
     auto glyphs = paths.glyphs(glyphRun.glyphsIDs());
 
@@ -930,6 +952,7 @@ void SkPDFDevice::internalDrawGlyphRun(
             }
             if (needs_new_font(font, glyphs[index], fontType)) {
                 // Not yet specified font or need to switch font.
+                noteGlyphUsage();
                 font = SkPDFFont::GetFontResource(fDocument, glyphs[index], typeface);
                 SkASSERT(font);  // All preconditions for SkPDFFont::GetFontResource are met.
                 glyphPositioner.flush();
@@ -941,7 +964,7 @@ void SkPDFDevice::internalDrawGlyphRun(
                 out->writeText(" Tf\n");
 
             }
-            font->noteGlyphUsage(gid);
+            usedGlyphs.push_back(gid);
             SkGlyphID encodedGlyph = font->multiByteGlyphs()
                                    ? gid : font->glyphToPDFFontEncoding(gid);
             SkScalar advance = advanceScale * glyphs[index]->advanceX();
@@ -965,7 +988,7 @@ void SkPDFDevice::drawVertices(const SkVertices*, SkBlendMode, const SkPaint&) {
 }
 
 void SkPDFDevice::drawFormXObject(SkPDFIndirectReference xObject, SkDynamicMemoryWStream* content) {
-    ScopedOutputMarkedContentTags mark(fNodeId, fDocument, content);
+    ScopedOutputMarkedContentTags mark(fNodeId, fDocument, fPage, content);
 
     SkASSERT(xObject);
     SkPDFWriteResourceName(content, SkPDFResourceType::kXObject,
@@ -1657,14 +1680,20 @@ void SkPDFDevice::internalDrawImageRect(SkKeyedImage imageSubset,
     }
 
     SkBitmapKey key = imageSubset.key();
-    SkPDFIndirectReference* pdfimagePtr = fDocument->fPDFBitmapMap.find(key);
-    SkPDFIndirectReference pdfimage = pdfimagePtr ? *pdfimagePtr : SkPDFIndirectReference();
-    if (!pdfimagePtr) {
-        SkASSERT(imageSubset);
-        pdfimage = SkPDFSerializeImage(imageSubset.image().get(), fDocument,
-                                       fDocument->metadata().fEncodingQuality);
-        SkASSERT((key != SkBitmapKey{{0, 0, 0, 0}, 0}));
-        fDocument->fPDFBitmapMap.set(key, pdfimage);
+    SkPDFIndirectReference pdfimage;
+    {
+        // Hold the lock while serializing, so pages drawing the same image at the same time
+        // share one copy of it.  With an executor, this only schedules the encode.
+        SkAutoMutexExclusive lock(fDocument->fCanonMutex);
+        SkPDFIndirectReference* pdfimagePtr = fDocument->fPDFBitmapMap.find(key);
+        pdfimage = pdfimagePtr ? *pdfimagePtr : SkPDFIndirectReference();
+        if (!pdfimagePtr) {
+            SkASSERT(imageSubset);
+            pdfimage = SkPDFSerializeImage(imageSubset.image().get(), fDocument,
+                                           fDocument->metadata().fEncodingQuality, &key);
+            SkASSERT((key != SkBitmapKey{{0, 0, 0, 0}, 0}));
+            fDocument->fPDFBitmapMap.set(key, pdfimage);
+        }
     }
     SkASSERT(pdfimage != SkPDFIndirectReference());
     this->drawFormXObject(pdfimage, content.stream());
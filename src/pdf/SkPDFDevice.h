@@ -34,6 +34,7 @@ class SkPDFDocument;
 class SkPDFFont;
 class SkPDFObject;
 class SkPath;
+struct SkPDFPage;
 class SkRRect;
 struct SkPDFIndirectReference;
 
@@ -54,12 +55,16 @@ public:
      *         for early serializing of large immutable objects, such
      *         as images (via SkPDFDocument::serialize()).
      *  @param initialTransform Transform to be applied to the entire page.
+     *  @param page The page this device's content ends up on, which collects
+     *         its links and marked content; nullptr for content that is not
+     *         part of a page, such as a pattern.
      */
     SkPDFDevice(SkISize pageSize, SkPDFDocument* document,
-                const SkMatrix& initialTransform = SkMatrix::I());
+                const SkMatrix& initialTransform = SkMatrix::I(),
+                SkPDFPage* page = nullptr);
 
     sk_sp<SkPDFDevice> makeCongruentDevice() {
-        return sk_make_sp<SkPDFDevice>(this->size(), fDocument);
+        return sk_make_sp<SkPDFDevice>(this->size(), fDocument, SkMatrix::I(), fPage);
     }
 
     ~SkPDFDevice() override;
@@ -136,6 +141,7 @@ private:
     bool fNeedsExtraSave = false;
     SkPDFGraphicStackState fActiveStackState;
     SkPDFDocument* fDocument;
+    SkPDFPage* fPage;
 
     ////////////////////////////////////////////////////////////////////////////
 
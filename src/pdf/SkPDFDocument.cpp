@@ -8,9 +8,12 @@
 #include "include/docs/SkPDFDocument.h"
 #include "src/pdf/SkPDFDocumentPriv.h"
 
+#include "include/core/SkExecutor.h"
 #include "include/core/SkStream.h"
 #include "include/docs/SkPDFDocument.h"
 #include "include/private/SkTo.h"
+#include "src/core/SkRecordDraw.h"
+#include "src/core/SkRecorder.h"
 #include "src/pdf/SkPDFDevice.h"
 #include "src/pdf/SkPDFFont.h"
 #include "src/pdf/SkPDFGradientShader.h"
@@ -248,6 +251,7 @@ static SkSize operator*(SkSize u, SkScalar s) { return SkSize{u.width() * s, u.h
 
 SkCanvas* SkPDFDocument::onBeginPage(SkScalar width, SkScalar height) {
     SkASSERT(fCanvas.imageInfo().dimensions().isZero());
+    SkASSERT(!fPageRecorder);
     if (fPages.empty()) {
         // if this is the first page if the document.
         {
@@ -277,10 +281,20 @@ SkCanvas* SkPDFDocument::onBeginPage(SkScalar width, SkScalar height) {
     // bottom left. This matrix corrects for that, as well as the raster scale.
     initialTransform.setScaleTranslate(fInverseRasterScale, -fInverseRasterScale,
                                        0, fInverseRasterScale * pageSize.height());
-    fPageDevice = sk_make_sp<SkPDFDevice>(pageSize, this, initialTransform);
+    fPages.push_back(std::make_unique<SkPDFPage>(SkToUInt(fPages.size()), this->reserveRef(),
+                                                 pageSize, initialTransform));
+    fPageRefs.push_back(fPages.back()->fRef);
+    if (fExecutor) {
+        // Record the page, to be drawn by a job on the executor once it ends.  This is a raw
+        // SkRecord rather than an SkPicture, so the page is drawn exactly as it would be serially.
+        fPageRecord = sk_make_sp<SkRecord>();
+        fPageRecorder = std::make_unique<SkRecorder>(fPageRecord.get(), SkRect::Make(pageSize));
+        fPageRecorder->scale(fRasterScale, fRasterScale);
+        return fPageRecorder.get();
+    }
+    fPageDevice = sk_make_sp<SkPDFDevice>(pageSize, this, initialTransform, fPages.back().get());
     reset_object(&fCanvas, fPageDevice);
     fCanvas.scale(fRasterScale, fRasterScale);
-    fPageRefs.push_back(this->reserveRef());
     return &fCanvas;
 }
 
@@ -312,15 +326,15 @@ static SkPDFIndirectReference append_destinations(
     return doc->emit(destinations);
 }
 
-std::unique_ptr<SkPDFArray> SkPDFDocument::getAnnotations() {
+std::unique_ptr<SkPDFArray> SkPDFDocument::getAnnotations(SkPDFPage* page) {
     std::unique_ptr<SkPDFArray> array;
-    size_t count = fCurrentPageLinks.size();
+    size_t count = page->fLinks.size();
     if (0 == count) {
         return array;  // is nullptr
     }
     array = SkPDFMakeArray();
     array->reserve(count);
-    for (const auto& link : fCurrentPageLinks) {
+    for (const auto& link : page->fLinks) {
         SkPDFDict annotation("Annot");
         populate_link_annotation(&annotation, link->fRect);
         if (link->fType == SkPDFLink::Type::kUrl) {
@@ -335,7 +349,7 @@ std::unique_ptr<SkPDFArray> SkPDFDocument::getAnnotations() {
         }
 
         if (link->fNodeId) {
-            int structParentKey = createStructParentKeyForNodeId(link->fNodeId);
+            int structParentKey = createStructParentKeyForNodeId(link->fNodeId, page->fIndex);
             if (structParentKey != -1) {
                 annotation.insertInt("StructParent", structParentKey);
             }
@@ -344,38 +358,70 @@ std::unique_ptr<SkPDFArray> SkPDFDocument::getAnnotations() {
         SkPDFIndirectReference annotationRef = emit(annotation);
         array->appendRef(annotationRef);
         if (link->fNodeId) {
-            fTagTree.addNodeAnnotation(link->fNodeId, annotationRef, SkToUInt(this->currentPageIndex()));
+            SkAutoMutexExclusive lock(fCanonMutex);
+            fTagTree.addNodeAnnotation(link->fNodeId, annotationRef, page->fIndex);
         }
     }
     return array;
 }
 
-void SkPDFDocument::onEndPage() {
-    SkASSERT(!fCanvas.imageInfo().dimensions().isZero());
-    reset_object(&fCanvas);
-    SkASSERT(fPageDevice);
+void SkPDFDocument::finishPage(SkPDFDevice* device, SkPDFPage* page) {
+    auto dict = SkPDFMakeDict("Page");
 
-    auto page = SkPDFMakeDict("Page");
+    SkSize mediaSize = device->imageInfo().dimensions() * fInverseRasterScale;
+    std::unique_ptr<SkStreamAsset> pageContent = device->content();
+    auto resourceDict = device->makeResourceDict();
 
-    SkSize mediaSize = fPageDevice->imageInfo().dimensions() * fInverseRasterScale;
-    std::unique_ptr<SkStreamAsset> pageContent = fPageDevice->content();
-    auto resourceDict = fPageDevice->makeResourceDict();
-    SkASSERT(fPageRefs.size() > 0);
-    fPageDevice = nullptr;
+    dict->insertObject("Resources", std::move(resourceDict));
+    dict->insertObject("MediaBox", SkPDFUtils::RectToArray(SkRect::MakeSize(mediaSize)));
 
-    page->insertObject("Resources", std::move(resourceDict));
-    page->insertObject("MediaBox", SkPDFUtils::RectToArray(SkRect::MakeSize(mediaSize)));
-
-    if (std::unique_ptr<SkPDFArray> annotations = getAnnotations()) {
-        page->insertObject("Annots", std::move(annotations));
-        fCurrentPageLinks.clear();
+    if (std::unique_ptr<SkPDFArray> annotations = this->getAnnotations(page)) {
+        dict->insertObject("Annots", std::move(annotations));
+        page->fLinks.clear();
     }
 
-    page->insertRef("Contents", SkPDFStreamOut(nullptr, std::move(pageContent), this));
+    dict->insertRef("Contents", SkPDFStreamOut(nullptr, std::move(pageContent), this));
     // The StructParents unique identifier for each page is just its
     // 0-based page index.
-    page->insertInt("StructParents", SkToInt(this->currentPageIndex()));
-    fPages.emplace_back(std::move(page));
+    dict->insertInt("StructParents", SkToInt(page->fIndex));
+    page->fDict = std::move(dict);
+}
+
+void SkPDFDocument::onEndPage() {
+    SkASSERT(!fPages.empty());
+    SkPDFPage* page = fPages.back().get();
+    if (fExecutor) {
+        SkASSERT(fPageRecorder);
+        sk_sp<SkRecord> record = std::move(fPageRecord);
+        // Drawables are not guaranteed to be thread safe, so snap them to pictures up front.
+        SkBigPicture::SnapshotArray* drawables = nullptr;
+        if (std::unique_ptr<SkDrawableList> list = fPageRecorder->detachDrawableList()) {
+            drawables = list->newDrawableSnapshot();
+        }
+        fPageRecorder = nullptr;
+        // Pages only share this document's canon, so each one is drawn, and its content
+        // deflated, independently of the others.  finishPage() leaves the page dictionary in
+        // the page; onClose() emits the page tree in order once all jobs are done.
+        // Pass ownership of drawables into a std::function, which should only be executed once.
+        this->incrementJobCount();
+        fExecutor->add([this, page, record, drawables]() {
+            auto device = sk_make_sp<SkPDFDevice>(page->fSize, this, page->fTransform, page);
+            {
+                SkCanvas canvas(device);
+                SkRecordDraw(*record, &canvas, drawables ? drawables->begin() : nullptr, nullptr,
+                             drawables ? drawables->count() : 0, nullptr, nullptr);
+            }
+            delete drawables;
+            this->finishPage(device.get(), page);
+            this->signalJobComplete();
+        });
+        return;
+    }
+    SkASSERT(!fCanvas.imageInfo().dimensions().isZero());
+    reset_object(&fCanvas);
+    SkASSERT(fPageDevice);
+    this->finishPage(fPageDevice.get(), page);
+    fPageDevice = nullptr;
 }
 
 void SkPDFDocument::onAbort() {
@@ -522,16 +568,14 @@ SkPDFIndirectReference SkPDFDocument::getPage(size_t pageIndex) const {
     return fPageRefs[pageIndex];
 }
 
-const SkMatrix& SkPDFDocument::currentPageTransform() const {
-    return fPageDevice->initialTransform();
-}
-
-int SkPDFDocument::createMarkIdForNodeId(int nodeId) {
-    return fTagTree.createMarkIdForNodeId(nodeId, SkToUInt(this->currentPageIndex()));
+int SkPDFDocument::createMarkIdForNodeId(int nodeId, unsigned pageIndex) {
+    SkAutoMutexExclusive lock(fCanonMutex);
+    return fTagTree.createMarkIdForNodeId(nodeId, pageIndex);
 }
 
-int SkPDFDocument::createStructParentKeyForNodeId(int nodeId) {
-    return fTagTree.createStructParentKeyForNodeId(nodeId, SkToUInt(this->currentPageIndex()));
+int SkPDFDocument::createStructParentKeyForNodeId(int nodeId, unsigned pageIndex) {
+    SkAutoMutexExclusive lock(fCanonMutex);
+    return fTagTree.createStructParentKeyForNodeId(nodeId, pageIndex);
 }
 
 static std::vector<const SkPDFFont*> get_fonts(const SkPDFDocument& canon) {
@@ -539,7 +583,7 @@ static std::vector<const SkPDFFont*> get_fonts(const SkPDFDocument& canon) {
     fonts.reserve(canon.fFontMap.count());
     // Sort so the output PDF is reproducible.
     for (const auto& [unused, font] : canon.fFontMap) {
-        fonts.push_back(&font);
+        fonts.push_back(font.get());
     }
     std::sort(fonts.begin(), fonts.end(), [](const SkPDFFont* u, const SkPDFFont* v) {
         return u->indirectReference().fValue < v->indirectReference().fValue;
@@ -549,8 +593,9 @@ static std::vector<const SkPDFFont*> get_fonts(const SkPDFDocument& canon) {
 
 void SkPDFDocument::onClose(SkWStream* stream) {
     SkASSERT(fCanvas.imageInfo().dimensions().isZero());
+    // Pages drawn on the executor must be finished before the page tree is built.
+    this->waitForJobs();
     if (fPages.empty()) {
-        this->waitForJobs();
         return;
     }
     auto docCatalog = SkPDFMakeDict("Catalog");
@@ -562,7 +607,13 @@ void SkPDFDocument::onClose(SkWStream* stream) {
         docCatalog->insertObject("OutputIntents", make_srgb_output_intents(this));
     }
 
-    docCatalog->insertRef("Pages", generate_page_tree(this, std::move(fPages), fPageRefs));
+    std::vector<std::unique_ptr<SkPDFDict>> pages;
+    pages.reserve(fPages.size());
+    for (const std::unique_ptr<SkPDFPage>& page : fPages) {
+        SkASSERT(page->fDict);
+        pages.push_back(std::move(page->fDict));
+    }
+    docCatalog->insertRef("Pages", generate_page_tree(this, std::move(pages), fPageRefs));
 
     if (!fNamedDestinations.empty()) {
         docCatalog->insertRef("Dests", append_destinations(this, fNamedDestinations));
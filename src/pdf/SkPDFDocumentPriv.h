@@ -12,6 +12,7 @@
 #include "include/docs/SkPDFDocument.h"
 #include "include/private/SkMutex.h"
 #include "include/private/SkTHash.h"
+#include "src/pdf/SkDeflate.h"
 #include "src/pdf/SkPDFMetadata.h"
 #include "src/pdf/SkPDFTag.h"
 
@@ -22,6 +23,8 @@
 class SkExecutor;
 class SkPDFDevice;
 class SkPDFFont;
+class SkRecord;
+class SkRecorder;
 struct SkAdvancedTypefaceMetrics;
 struct SkBitmapKey;
 struct SkPDFFillGraphicState;
@@ -35,6 +38,18 @@ struct KeyHash;
 
 const char* SkPDFGetNodeIdKey();
 
+static inline SkDeflateWStream::Strategy SkPDFDeflateStrategy(
+        SkPDF::Metadata::CompressionStrategy strategy) {
+    using S = SkPDF::Metadata::CompressionStrategy;
+    switch (strategy) {
+        case S::Default:     return SkDeflateWStream::Strategy::kDefault;
+        case S::Filtered:    return SkDeflateWStream::Strategy::kFiltered;
+        case S::RLE:         return SkDeflateWStream::Strategy::kRLE;
+        case S::HuffmanOnly: return SkDeflateWStream::Strategy::kHuffmanOnly;
+    }
+    SkUNREACHABLE;
+}
+
 // Logically part of SkPDFDocument, but separate to keep similar functionality together.
 class SkPDFOffsetMap {
 public:
@@ -75,6 +90,25 @@ struct SkPDFLink {
 };
 
 
+// A page of the document. The SkPDFDevice that draws the page, and any layer devices it creates,
+// collect the page's links here. fDict is set once the page has been drawn.
+struct SkPDFPage {
+    SkPDFPage(unsigned index, SkPDFIndirectReference ref, SkISize size, const SkMatrix& transform)
+        : fIndex(index)
+        , fRef(ref)
+        , fSize(size)
+        , fTransform(transform) {}
+    const unsigned fIndex;
+    const SkPDFIndirectReference fRef;
+    // Size of the page's device, in pixels at the document's raster scale.
+    const SkISize fSize;
+    // Maps the page's device space to PDF page space.
+    const SkMatrix fTransform;
+    std::vector<std::unique_ptr<SkPDFLink>> fLinks;
+    std::unique_ptr<SkPDFDict> fDict;
+};
+
+
 /** Concrete implementation of SkDocument that creates PDF files. This
     class does not produced linearized or optimized PDFs; instead it
     it attempts to use a minimum amount of RAM. */
@@ -113,52 +147,48 @@ public:
     const SkPDF::Metadata& metadata() const { return fMetadata; }
 
     SkPDFIndirectReference getPage(size_t pageIndex) const;
-    SkPDFIndirectReference currentPage() const {
-        return SkASSERT(!fPageRefs.empty()), fPageRefs.back();
-    }
     // Used to allow marked content to refer to its corresponding structure
     // tree node, via a page entry in the parent tree. Returns -1 if no
     // mark ID.
-    int createMarkIdForNodeId(int nodeId);
+    int createMarkIdForNodeId(int nodeId, unsigned pageIndex);
     // Used to allow annotations to refer to their corresponding structure
     // tree node, via the struct parent tree. Returns -1 if no struct parent
     // key.
-    int createStructParentKeyForNodeId(int nodeId);
-
-    std::unique_ptr<SkPDFArray> getAnnotations();
+    int createStructParentKeyForNodeId(int nodeId, unsigned pageIndex);
 
     SkPDFIndirectReference reserveRef() { return SkPDFIndirectReference{fNextObjectNumber++}; }
 
     SkExecutor* executor() const { return fExecutor; }
     void incrementJobCount();
     void signalJobComplete();
-    size_t currentPageIndex() { return fPages.size(); }
     size_t pageCount() { return fPageRefs.size(); }
 
-    const SkMatrix& currentPageTransform() const;
-
-    // Canonicalized objects
+    // Canonicalized objects.  With an executor, pages are drawn on it concurrently, so until
+    // onClose() these (and the tag tree and named destinations) are guarded by fCanonMutex.
+    SkMutex fCanonMutex;
     SkTHashMap<SkPDFImageShaderKey, SkPDFIndirectReference> fImageShaderMap;
     SkTHashMap<SkPDFGradientShader::Key, SkPDFIndirectReference, SkPDFGradientShader::KeyHash>
         fGradientPatternMap;
     SkTHashMap<SkBitmapKey, SkPDFIndirectReference> fPDFBitmapMap;
     SkTHashMap<uint32_t, std::unique_ptr<SkAdvancedTypefaceMetrics>> fTypefaceMetrics;
     SkTHashMap<uint32_t, std::vector<SkString>> fType1GlyphNames;
-    SkTHashMap<uint32_t, std::vector<SkUnichar>> fToUnicodeMap;
+    SkTHashMap<uint32_t, std::unique_ptr<std::vector<SkUnichar>>> fToUnicodeMap;
     SkTHashMap<uint32_t, SkPDFIndirectReference> fFontDescriptors;
     SkTHashMap<uint32_t, SkPDFIndirectReference> fType3FontDescriptors;
-    SkTHashMap<uint64_t, SkPDFFont> fFontMap;
+    SkTHashMap<uint64_t, std::unique_ptr<SkPDFFont>> fFontMap;
     SkTHashMap<SkPDFStrokeGraphicState, SkPDFIndirectReference> fStrokeGSMap;
     SkTHashMap<SkPDFFillGraphicState, SkPDFIndirectReference> fFillGSMap;
     SkPDFIndirectReference fInvertFunction;
     SkPDFIndirectReference fNoSmaskGraphicState;
-    std::vector<std::unique_ptr<SkPDFLink>> fCurrentPageLinks;
     std::vector<SkPDFNamedDestination> fNamedDestinations;
 
 private:
     SkPDFOffsetMap fOffsetMap;
     SkCanvas fCanvas;
-    std::vector<std::unique_ptr<SkPDFDict>> fPages;
+    // With an executor, pages are recorded here and drawn by a job in onEndPage().
+    sk_sp<SkRecord> fPageRecord;
+    std::unique_ptr<SkRecorder> fPageRecorder;
+    std::vector<std::unique_ptr<SkPDFPage>> fPages;
     std::vector<SkPDFIndirectReference> fPageRefs;
 
     sk_sp<SkPDFDevice> fPageDevice;
@@ -179,6 +209,8 @@ private:
     SkSemaphore fSemaphore;
 
     void waitForJobs();
+    void finishPage(SkPDFDevice*, SkPDFPage*);
+    std::unique_ptr<SkPDFArray> getAnnotations(SkPDFPage*);
     SkWStream* beginObject(SkPDFIndirectReference);
     void endObject();
 };
@@ -38,6 +38,7 @@
 #include "src/pdf/SkPDFFont.h"
 #include "src/pdf/SkPDFMakeCIDGlyphWidthsArray.h"
 #include "src/pdf/SkPDFMakeToUnicodeCmap.h"
+#include "src/pdf/SkPDFResourceCache.h"
 #include "src/pdf/SkPDFSubsetFont.h"
 #include "src/pdf/SkPDFType1Font.h"
 #include "src/pdf/SkPDFUtils.h"
@@ -107,6 +108,7 @@ const SkAdvancedTypefaceMetrics* SkPDFFont::GetMetrics(const SkTypeface* typefac
                                                        SkPDFDocument* canon) {
     SkASSERT(typeface);
     SkFontID id = typeface->uniqueID();
+    SkAutoMutexExclusive lock(canon->fCanonMutex);
     if (std::unique_ptr<SkAdvancedTypefaceMetrics>* ptr = canon->fTypefaceMetrics.find(id)) {
         return ptr->get();  // canon retains ownership.
     }
@@ -158,12 +160,13 @@ const std::vector<SkUnichar>& SkPDFFont::GetUnicodeMap(const SkTypeface* typefac
     SkASSERT(typeface);
     SkASSERT(canon);
     SkFontID id = typeface->uniqueID();
-    if (std::vector<SkUnichar>* ptr = canon->fToUnicodeMap.find(id)) {
-        return *ptr;
+    SkAutoMutexExclusive lock(canon->fCanonMutex);
+    if (std::unique_ptr<std::vector<SkUnichar>>* ptr = canon->fToUnicodeMap.find(id)) {
+        return **ptr;  // canon retains ownership.
     }
-    std::vector<SkUnichar> buffer(typeface->countGlyphs());
-    typeface->getGlyphToUnicodeMap(buffer.data());
-    return *canon->fToUnicodeMap.set(id, std::move(buffer));
+    auto buffer = std::make_unique<std::vector<SkUnichar>>(typeface->countGlyphs());
+    typeface->getGlyphToUnicodeMap(buffer->data());
+    return **canon->fToUnicodeMap.set(id, std::move(buffer));
 }
 
 SkAdvancedTypefaceMetrics::FontType SkPDFFont::FontType(const SkAdvancedTypefaceMetrics& metrics) {
@@ -197,9 +200,10 @@ SkPDFFont* SkPDFFont::GetFontResource(SkPDFDocument* doc,
             multibyte ? 0 : first_nonzero_glyph_for_single_byte_encoding(glyph->getGlyphID());
     uint64_t fontID = (static_cast<uint64_t>(SkTypeface::UniqueID(face)) << 16) | subsetCode;
 
-    if (SkPDFFont* found = doc->fFontMap.find(fontID)) {
-        SkASSERT(multibyte == found->multiByteGlyphs());
-        return found;
+    SkAutoMutexExclusive lock(doc->fCanonMutex);
+    if (std::unique_ptr<SkPDFFont>* found = doc->fFontMap.find(fontID)) {
+        SkASSERT(multibyte == (*found)->multiByteGlyphs());
+        return found->get();  // canon retains ownership.
     }
 
     sk_sp<SkTypeface> typeface(sk_ref_sp(face));
@@ -219,7 +223,8 @@ SkPDFFont* SkPDFFont::GetFontResource(SkPDFDocument* doc,
     }
     auto ref = doc->reserveRef();
     return doc->fFontMap.set(
-            fontID, SkPDFFont(std::move(typeface), firstNonZeroGlyph, lastGlyph, type, ref));
+            fontID, std::unique_ptr<SkPDFFont>(new SkPDFFont(std::move(typeface), firstNonZeroGlyph,
+                                                             lastGlyph, type, ref)))->get();
 }
 
 SkPDFFont::SkPDFFont(sk_sp<SkTypeface> typeface,
@@ -308,10 +313,23 @@ static void emit_subset_type0(const SkPDFFont& font, SkPDFDocument* doc) {
                 if (!SkToBool(metrics.fFlags &
                               SkAdvancedTypefaceMetrics::kNotSubsettable_FontFlag)) {
                     SkASSERT(font.firstGlyphID() == 1);
-                    sk_sp<SkData> subsetFontData = SkPDFSubsetFont(
-                            stream_to_data(std::move(fontAsset)), font.glyphUsage(),
-                            doc->metadata().fSubsetter,
-                            metrics.fFontName.c_str(), ttcIndex);
+                    const SkPDF::Metadata& docMetadata = doc->metadata();
+                    sk_sp<SkData> subsetFontData;
+                    if (docMetadata.fCacheAcrossDocuments) {
+                        subsetFontData = SkPDFResourceCache::FindSubsetFont(
+                                *face, ttcIndex, docMetadata.fSubsetter, font.glyphUsage());
+                    }
+                    if (!subsetFontData) {
+                        subsetFontData = SkPDFSubsetFont(
+                                stream_to_data(std::move(fontAsset)), font.glyphUsage(),
+                                docMetadata.fSubsetter,
+                                metrics.fFontName.c_str(), ttcIndex);
+                        if (subsetFontData && docMetadata.fCacheAcrossDocuments) {
+                            SkPDFResourceCache::AddSubsetFont(*face, ttcIndex,
+                                                              docMetadata.fSubsetter,
+                                                              font.glyphUsage(), subsetFontData);
+                        }
+                    }
                     if (subsetFontData) {
                         std::unique_ptr<SkPDFDict> tmp = SkPDFMakeDict();
                         tmp->insertInt("Length1", SkToInt(subsetFontData->size()));
@@ -319,7 +337,7 @@ static void emit_subset_type0(const SkPDFFont& font, SkPDFDocument* doc) {
                                 "FontFile2",
                                 SkPDFStreamOut(std::move(tmp),
                                                SkMemoryStream::Make(std::move(subsetFontData)),
-                                               doc, true));
+                                               doc, true, SkPDFStreamKind::kFont));
                         break;
                     }
                     // If subsetting fails, fall back to original font data.
@@ -332,7 +350,7 @@ static void emit_subset_type0(const SkPDFFont& font, SkPDFDocument* doc) {
                 tmp->insertInt("Length1", fontSize);
                 descriptor->insertRef("FontFile2",
                                       SkPDFStreamOut(std::move(tmp), std::move(fontAsset),
-                                                     doc, true));
+                                                     doc, true, SkPDFStreamKind::kFont));
                 break;
             }
             case SkAdvancedTypefaceMetrics::kType1CID_Font: {
@@ -340,7 +358,7 @@ static void emit_subset_type0(const SkPDFFont& font, SkPDFDocument* doc) {
                 tmp->insertName("Subtype", "CIDFontType0C");
                 descriptor->insertRef("FontFile3",
                                       SkPDFStreamOut(std::move(tmp), std::move(fontAsset),
-                                                     doc, true));
+                                                     doc, true, SkPDFStreamKind::kFont));
                 break;
             }
             default:
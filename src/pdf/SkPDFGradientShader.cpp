@@ -896,15 +896,23 @@ static SkPDFIndirectReference find_pdf_shader(SkPDFDocument* doc,
                                               bool keyHasAlpha) {
     SkASSERT(gradient_has_alpha(key) == keyHasAlpha);
     auto& gradientPatternMap = doc->fGradientPatternMap;
-    if (SkPDFIndirectReference* ptr = gradientPatternMap.find(key)) {
-        return *ptr;
+    {
+        SkAutoMutexExclusive lock(doc->fCanonMutex);
+        if (SkPDFIndirectReference* ptr = gradientPatternMap.find(key)) {
+            return *ptr;
+        }
     }
+    // Making an alpha shader finds its opaque shader, so make it without holding the lock.
     SkPDFIndirectReference pdfShader;
     if (keyHasAlpha) {
         pdfShader = make_alpha_function_shader(doc, key);
     } else {
         pdfShader = make_function_shader(doc, key);
     }
+    SkAutoMutexExclusive lock(doc->fCanonMutex);
+    if (SkPDFIndirectReference* ptr = gradientPatternMap.find(key)) {
+        return *ptr;  // Another page made the same shader first.
+    }
     gradientPatternMap.set(std::move(key), pdfShader);
     return pdfShader;
 }
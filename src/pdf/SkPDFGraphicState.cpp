@@ -56,6 +56,7 @@ static uint8_t pdf_blend_mode(SkBlendMode mode) {
 SkPDFIndirectReference SkPDFGraphicState::GetGraphicStateForPaint(SkPDFDocument* doc,
                                                                   const SkPaint& p) {
     SkASSERT(doc);
+    SkAutoMutexExclusive lock(doc->fCanonMutex);
     if (SkPaint::kFill_Style == p.getStyle()) {
         SkPDFFillGraphicState fillKey = {p.getColor4f().fA, pdf_blend_mode(p.getBlendMode())};
         auto& fillMap = doc->fFillGSMap;
@@ -129,6 +130,7 @@ SkPDFIndirectReference SkPDFGraphicState::GetSMaskGraphicState(SkPDFIndirectRefe
     sMaskDict->insertRef("G", sMask);
     if (invert) {
         // let the doc deduplicate this object.
+        SkAutoMutexExclusive lock(doc->fCanonMutex);
         if (doc->fInvertFunction == SkPDFIndirectReference()) {
             doc->fInvertFunction = make_invert_function(doc);
         }
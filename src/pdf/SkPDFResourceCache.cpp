@@ -0,0 +1,165 @@
+/*
+ * Copyright 2021 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "src/pdf/SkPDFResourceCache.h"
+
+#include "include/core/SkTypeface.h"
+#include "include/private/SkTo.h"
+#include "src/core/SkBitmapCache.h"
+#include "src/core/SkOpts.h"
+#include "src/core/SkResourceCache.h"
+#include "src/pdf/SkBitmapKey.h"
+#include "src/pdf/SkPDFGlyphUse.h"
+
+#include <vector>
+
+namespace {
+static unsigned gImageKeyNamespaceLabel;
+static unsigned gSubsetFontKeyNamespaceLabel;
+
+struct ImageKey : public SkResourceCache::Key {
+    ImageKey(const SkBitmapKey& key, int encodingQuality, int compressionLevel,
+             int compressionStrategy)
+        : fSubset(key.fSubset)
+        , fID(key.fID)
+        , fEncodingQuality(encodingQuality)
+        , fCompressionLevel(compressionLevel)
+        , fCompressionStrategy(compressionStrategy)
+    {
+        // Shares the source's purge ID, so it goes when the source's pixels are reported stale.
+        this->init(&gImageKeyNamespaceLabel, SkMakeResourceCacheSharedIDForBitmap(fID),
+                   sizeof(fSubset) + sizeof(fID) + sizeof(fEncodingQuality) +
+                   sizeof(fCompressionLevel) + sizeof(fCompressionStrategy));
+    }
+
+    SkIRect  fSubset;
+    uint32_t fID;
+    int32_t  fEncodingQuality;
+    int32_t  fCompressionLevel;
+    int32_t  fCompressionStrategy;
+};
+
+struct ImageRec : public SkResourceCache::Rec {
+    ImageRec(const ImageKey& key, const SkPDFResourceCache::Image& image)
+        : fKey(key)
+        , fImage(image) {}
+
+    ImageKey                  fKey;
+    SkPDFResourceCache::Image fImage;
+
+    const Key& getKey() const override { return fKey; }
+    size_t bytesUsed() const override {
+        return sizeof(*this) + fImage.fImage.fData->size()
+                             + (fImage.fSMask.fData ? fImage.fSMask.fData->size() : 0);
+    }
+    const char* getCategory() const override { return "pdf-image"; }
+
+    static bool Visitor(const SkResourceCache::Rec& baseRec, void* contextData) {
+        const ImageRec& rec = static_cast<const ImageRec&>(baseRec);
+        *static_cast<SkPDFResourceCache::Image*>(contextData) = rec.fImage;
+        return true;
+    }
+};
+
+std::vector<SkGlyphID> used_glyphs(const SkPDFGlyphUse& glyphUsage) {
+    std::vector<SkGlyphID> glyphs;
+    glyphUsage.getSetValues([&glyphs](unsigned gid) { glyphs.push_back(SkToU16(gid)); });
+    return glyphs;
+}
+
+// The glyph set is too big for the key, so the key holds its hash and the rec checks the glyphs.
+struct SubsetFontKey : public SkResourceCache::Key {
+    SubsetFontKey(const SkTypeface& typeface, int ttcIndex, SkPDF::Metadata::Subsetter subsetter,
+                  const std::vector<SkGlyphID>& glyphs)
+        : fTypefaceID(typeface.uniqueID())
+        , fTTCIndex(ttcIndex)
+        , fSubsetter(subsetter)
+        , fGlyphCount(SkToU32(glyphs.size()))
+        , fGlyphsHash(SkOpts::hash(glyphs.data(), glyphs.size() * sizeof(SkGlyphID)))
+    {
+        this->init(&gSubsetFontKeyNamespaceLabel, 0,
+                   sizeof(fTypefaceID) + sizeof(fTTCIndex) + sizeof(fSubsetter) +
+                   sizeof(fGlyphCount) + sizeof(fGlyphsHash));
+    }
+
+    uint32_t fTypefaceID;
+    int32_t  fTTCIndex;
+    uint32_t fSubsetter;
+    uint32_t fGlyphCount;
+    uint32_t fGlyphsHash;
+};
+
+struct SubsetFontValue {
+    const std::vector<SkGlyphID>* fGlyphs;
+    sk_sp<SkData> fData;
+};
+
+struct SubsetFontRec : public SkResourceCache::Rec {
+    SubsetFontRec(const SubsetFontKey& key, std::vector<SkGlyphID> glyphs, sk_sp<SkData> data)
+        : fKey(key)
+        , fGlyphs(std::move(glyphs))
+        , fData(std::move(data)) {}
+
+    SubsetFontKey          fKey;
+    std::vector<SkGlyphID> fGlyphs;
+    sk_sp<SkData>          fData;
+
+    const Key& getKey() const override { return fKey; }
+    size_t bytesUsed() const override {
+        return sizeof(*this) + fGlyphs.size() * sizeof(SkGlyphID) + fData->size();
+    }
+    const char* getCategory() const override { return "pdf-subset-font"; }
+
+    static bool Visitor(const SkResourceCache::Rec& baseRec, void* contextData) {
+        const SubsetFontRec& rec = static_cast<const SubsetFontRec&>(baseRec);
+        SubsetFontValue* result = static_cast<SubsetFontValue*>(contextData);
+        if (rec.fGlyphs != *result->fGlyphs) {
+            return false;  // A hash collision; purge it.
+        }
+        result->fData = rec.fData;
+        return true;
+    }
+};
+}  // namespace
+
+bool SkPDFResourceCache::FindImage(const SkBitmapKey& key, int encodingQuality,
+                                   int compressionLevel, int compressionStrategy,
+                                   Image* image) {
+    return SkResourceCache::Find(ImageKey(key, encodingQuality, compressionLevel,
+                                          compressionStrategy),
+                                 ImageRec::Visitor, image);
+}
+
+void SkPDFResourceCache::AddImage(const SkBitmapKey& key, int encodingQuality,
+                                  int compressionLevel, int compressionStrategy,
+                                  const Image& image) {
+    SkASSERT(image.fImage.fData);
+    SkResourceCache::Add(new ImageRec(ImageKey(key, encodingQuality, compressionLevel,
+                                                compressionStrategy), image));
+}
+
+sk_sp<SkData> SkPDFResourceCache::FindSubsetFont(const SkTypeface& typeface, int ttcIndex,
+                                                 SkPDF::Metadata::Subsetter subsetter,
+                                                 const SkPDFGlyphUse& glyphUsage) {
+    std::vector<SkGlyphID> glyphs = used_glyphs(glyphUsage);
+    SubsetFontValue result = {&glyphs, nullptr};
+    if (!SkResourceCache::Find(SubsetFontKey(typeface, ttcIndex, subsetter, glyphs),
+                               SubsetFontRec::Visitor, &result)) {
+        return nullptr;
+    }
+    return result.fData;
+}
+
+void SkPDFResourceCache::AddSubsetFont(const SkTypeface& typeface, int ttcIndex,
+                                       SkPDF::Metadata::Subsetter subsetter,
+                                       const SkPDFGlyphUse& glyphUsage,
+                                       sk_sp<SkData> subsetFont) {
+    SkASSERT(subsetFont);
+    std::vector<SkGlyphID> glyphs = used_glyphs(glyphUsage);
+    SubsetFontKey key(typeface, ttcIndex, subsetter, glyphs);
+    SkResourceCache::Add(new SubsetFontRec(key, std::move(glyphs), std::move(subsetFont)));
+}
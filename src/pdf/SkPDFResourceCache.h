@@ -0,0 +1,50 @@
+/*
+ * Copyright 2021 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+#ifndef SkPDFResourceCache_DEFINED
+#define SkPDFResourceCache_DEFINED
+
+#include "include/core/SkData.h"
+#include "include/core/SkSize.h"
+#include "include/docs/SkPDFDocument.h"
+
+class SkPDFGlyphUse;
+class SkTypeface;
+struct SkBitmapKey;
+
+/**
+ *  Entries in the global SkResourceCache through which documents made with
+ *  SkPDF::Metadata::fCacheAcrossDocuments share their most expensive objects.
+ *  The cache's byte budget and LRU purging apply to them like any other entry.
+ */
+namespace SkPDFResourceCache {
+
+// An image XObject, and its soft mask if it has one, as streams ready to emit.
+struct Image {
+    struct Stream {
+        sk_sp<SkData> fData;  // Deflated or JPEG data; null for no stream.
+        const char* fColorSpace = nullptr;
+        bool fIsJpeg = false;
+    };
+    SkISize fSize = {0, 0};
+    Stream fImage;
+    Stream fSMask;
+};
+
+bool FindImage(const SkBitmapKey&, int encodingQuality, int compressionLevel,
+               int compressionStrategy, Image*);
+void AddImage(const SkBitmapKey&, int encodingQuality, int compressionLevel,
+              int compressionStrategy, const Image&);
+
+// A font program subset to the glyphs in glyphUsage, as returned by SkPDFSubsetFont().
+sk_sp<SkData> FindSubsetFont(const SkTypeface&, int ttcIndex, SkPDF::Metadata::Subsetter,
+                             const SkPDFGlyphUse& glyphUsage);
+void AddSubsetFont(const SkTypeface&, int ttcIndex, SkPDF::Metadata::Subsetter,
+                   const SkPDFGlyphUse& glyphUsage, sk_sp<SkData> subsetFont);
+
+}  // namespace SkPDFResourceCache
+
+#endif  // SkPDFResourceCache_DEFINED
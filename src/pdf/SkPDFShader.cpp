@@ -356,10 +356,13 @@ SkPDFIndirectReference SkPDFMakeShader(SkPDFDocument* doc,
             SkBitmapKeyFromImage(skimg),
             {imageTileModes[0], imageTileModes[1]},
             paintColor};
-        SkPDFIndirectReference* shaderPtr = doc->fImageShaderMap.find(key);
-        if (shaderPtr) {
-            return *shaderPtr;
+        {
+            SkAutoMutexExclusive lock(doc->fCanonMutex);
+            if (SkPDFIndirectReference* shaderPtr = doc->fImageShaderMap.find(key)) {
+                return *shaderPtr;
+            }
         }
+        // Drawing the pattern takes the lock itself, so make the shader without holding it.
         SkPDFIndirectReference pdfShader =
                 make_image_shader(doc,
                                   finalMatrix,
@@ -368,6 +371,10 @@ SkPDFIndirectReference SkPDFMakeShader(SkPDFDocument* doc,
                                   SkRect::Make(surfaceBBox),
                                   skimg,
                                   paintColor);
+        SkAutoMutexExclusive lock(doc->fCanonMutex);
+        if (SkPDFIndirectReference* shaderPtr = doc->fImageShaderMap.find(key)) {
+            return *shaderPtr;  // Another page made the same shader first.
+        }
         doc->fImageShaderMap.set(std::move(key), pdfShader);
         return pdfShader;
     }
@@ -8,6 +8,8 @@
 #include "src/pdf/SkPDFDocumentPriv.h"
 #include "src/pdf/SkPDFTag.h"
 
+#include <algorithm>
+
 // Table 333 in PDF 32000-1:2008
 static const char* tag_name_from_type(SkPDF::DocumentStructureType type) {
     switch (type) {
@@ -320,6 +322,18 @@ SkPDFIndirectReference SkPDFTagTree::PrepareTagTreeToEmit(SkPDFIndirectReference
             kids->appendRef(PrepareTagTreeToEmit(ref, child, doc));
         }
     }
+    // Pages drawn on an executor may finish out of order; keep each node's content in page
+    // order (and in drawing order within a page).
+    std::stable_sort(node->fMarkedContent.begin(), node->fMarkedContent.end(),
+                     [](const SkPDFTagNode::MarkedContentInfo& a,
+                        const SkPDFTagNode::MarkedContentInfo& b) {
+                         return a.fPageIndex < b.fPageIndex;
+                     });
+    std::stable_sort(node->fAnnotations.begin(), node->fAnnotations.end(),
+                     [](const SkPDFTagNode::AnnotationInfo& a,
+                        const SkPDFTagNode::AnnotationInfo& b) {
+                         return a.fPageIndex < b.fPageIndex;
+                     });
     for (const SkPDFTagNode::MarkedContentInfo& info : node->fMarkedContent) {
         std::unique_ptr<SkPDFDict> mcr = SkPDFMakeDict("MCR");
         mcr->insertRef("Pg", doc->getPage(info.fPageIndex));
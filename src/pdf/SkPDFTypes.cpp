@@ -421,9 +421,23 @@ void SkPDFDict::insertString(const char key[], SkString value) {
 
 
 
+static int compression_level(const SkPDFDocument* doc, SkPDFStreamKind kind) {
+    const SkPDF::Metadata& metadata = doc->metadata();
+    return (int)(kind == SkPDFStreamKind::kFont ? metadata.fFontCompressionLevel
+                                                : metadata.fCompressionLevel);
+}
+
+static SkDeflateWStream::Strategy compression_strategy(const SkPDFDocument* doc,
+                                                       SkPDFStreamKind kind) {
+    const SkPDF::Metadata& metadata = doc->metadata();
+    return SkPDFDeflateStrategy(kind == SkPDFStreamKind::kFont ? metadata.fFontCompressionStrategy
+                                                               : metadata.fCompressionStrategy);
+}
+
 static void serialize_stream(SkPDFDict* origDict,
                              SkStreamAsset* stream,
                              bool deflate,
+                             SkPDFStreamKind kind,
                              SkPDFDocument* doc,
                              SkPDFIndirectReference ref) {
     // Code assumes that the stream starts at the beginning.
@@ -433,11 +447,19 @@ static void serialize_stream(SkPDFDict* origDict,
     SkPDFDict tmpDict;
     SkPDFDict& dict = origDict ? *origDict : tmpDict;
     static const size_t kMinimumSavings = strlen("/Filter_/FlateDecode_");
-    if (deflate && stream->getLength() > kMinimumSavings) {
+    int level = compression_level(doc, kind);
+    if (deflate && level != 0 && stream->getLength() > kMinimumSavings) {
         SkDynamicMemoryWStream compressedData;
-        SkDeflateWStream deflateWStream(&compressedData);
-        SkStreamCopy(&deflateWStream, stream);
-        deflateWStream.finalize();
+        SkDeflateWStream::Strategy strategy = compression_strategy(doc, kind);
+        if (const void* base = stream->getMemoryBase()) {
+            // Most content streams are already in memory: deflate them in one call.
+            SkAssertResult(SkDeflateWStream::Compress(base, stream->getLength(), &compressedData,
+                                                      level, strategy));
+        } else {
+            SkDeflateWStream deflateWStream(&compressedData, level, false, strategy);
+            SkStreamCopy(&deflateWStream, stream);
+            deflateWStream.finalize();
+        }
         #ifdef SK_PDF_BASE85_BINARY
         {
             SkPDFUtils::Base85Encode(compressedData.detachAsStream(), &compressedData);
@@ -468,7 +490,8 @@ static void serialize_stream(SkPDFDict* origDict,
 SkPDFIndirectReference SkPDFStreamOut(std::unique_ptr<SkPDFDict> dict,
                                       std::unique_ptr<SkStreamAsset> content,
                                       SkPDFDocument* doc,
-                                      bool deflate) {
+                                      bool deflate,
+                                      SkPDFStreamKind kind) {
     SkPDFIndirectReference ref = doc->reserveRef();
     if (SkExecutor* executor = doc->executor()) {
         SkPDFDict* dictPtr = dict.release();
@@ -476,14 +499,14 @@ SkPDFIndirectReference SkPDFStreamOut(std::unique_ptr<SkPDFDict> dict,
         // Pass ownership of both pointers into a std::function, which should
         // only be executed once.
         doc->incrementJobCount();
-        executor->add([dictPtr, contentPtr, deflate, doc, ref]() {
-            serialize_stream(dictPtr, contentPtr, deflate, doc, ref);
+        executor->add([dictPtr, contentPtr, deflate, kind, doc, ref]() {
+            serialize_stream(dictPtr, contentPtr, deflate, kind, doc, ref);
             delete dictPtr;
             delete contentPtr;
             doc->signalJobComplete();
         });
         return ref;
     }
-    serialize_stream(dict.get(), content.get(), deflate, doc, ref);
+    serialize_stream(dict.get(), content.get(), deflate, kind, doc, ref);
     return ref;
 }
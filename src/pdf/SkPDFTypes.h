@@ -197,8 +197,15 @@ static inline std::unique_ptr<SkPDFDict> SkPDFMakeDict(const char* type = nullpt
     static constexpr bool kSkPDFDefaultDoDeflate = true;
 #endif
 
+// Selects which of the document's compression levels and strategies a stream is deflated with.
+enum class SkPDFStreamKind {
+    kContent,  // SkPDF::Metadata::fCompressionLevel and fCompressionStrategy
+    kFont,     // SkPDF::Metadata::fFontCompressionLevel and fFontCompressionStrategy
+};
+
 SkPDFIndirectReference SkPDFStreamOut(std::unique_ptr<SkPDFDict> dict,
                                       std::unique_ptr<SkStreamAsset> stream,
                                       SkPDFDocument* doc,
-                                      bool deflate = kSkPDFDefaultDoDeflate);
+                                      bool deflate = kSkPDFDefaultDoDeflate,
+                                      SkPDFStreamKind kind = SkPDFStreamKind::kContent);
 #endif
@@ -11,6 +11,7 @@
 #include "include/core/SkCanvas.h"
 #include "include/core/SkColor.h"
 #include "include/core/SkColorPriv.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkMaskFilter.h"
 #include "include/core/SkMath.h"
@@ -30,12 +31,14 @@
 #include "include/gpu/GrDirectContext.h"
 #include "include/private/SkFloatBits.h"
 #include "include/private/SkTPin.h"
+#include "include/utils/SkRandom.h"
 #include "src/core/SkBlurMask.h"
 #include "src/core/SkGpuBlurUtils.h"
 #include "src/core/SkMask.h"
 #include "src/core/SkMaskFilterBase.h"
 #include "src/core/SkMathPriv.h"
 #include "src/effects/SkEmbossMaskFilter.h"
+#include "src/effects/imagefilters/SkBlurImageFilterPriv.h"
 #include "tests/Test.h"
 #include "tools/ToolUtils.h"
 #include "tools/gpu/GrContextFactory.h"
@@ -573,3 +576,100 @@ DEF_TEST(zero_blur, reporter) {
     SkIPoint offset;
     bitmap.extractAlpha(&alpha, &paint, nullptr, &offset);
 }
+
+// Large masks are blurred in bands on an executor; every band count must give the serial result.
+DEF_TEST(BlurMaskBandsMatchSerial, reporter) {
+    SkMask src;
+    src.fBounds.setWH(700, 500);
+    src.fFormat = SkMask::kA8_Format;
+    src.fRowBytes = src.fBounds.width();
+    src.fImage = SkMask::AllocImage(src.computeTotalImageSize());
+    SkAutoMaskFreeImage srcFree(src.fImage);
+    SkRandom rand;
+    for (size_t i = 0; i < src.computeTotalImageSize(); i++) {
+        src.fImage[i] = rand.nextU() & 0xff;
+    }
+
+    auto serial  = ToolUtils::make_executor(0),
+         threads = ToolUtils::make_executor(4);
+    for (SkScalar sigma : {3.0f, 20.0f}) {
+        SkMask expected, actual;
+        REPORTER_ASSERT(reporter, SkBlurMask::BoxBlur(&expected, src, sigma, kNormal_SkBlurStyle,
+                                                      nullptr, serial.get()));
+        REPORTER_ASSERT(reporter, SkBlurMask::BoxBlur(&actual, src, sigma, kNormal_SkBlurStyle,
+                                                      nullptr, threads.get()));
+        SkAutoMaskFreeImage expectedFree(expected.fImage),
+                            actualFree(actual.fImage);
+        REPORTER_ASSERT(reporter, expected.fBounds == actual.fBounds);
+        REPORTER_ASSERT(reporter, 0 == memcmp(expected.fImage, actual.fImage,
+                                              expected.computeImageSize()));
+    }
+}
+
+static SkBitmap transpose_n32(const SkBitmap& src) {
+    SkBitmap dst;
+    dst.allocN32Pixels(src.height(), src.width());
+    for (int y = 0; y < src.height(); y++) {
+        for (int x = 0; x < src.width(); x++) {
+            *dst.getAddr32(y, x) = *src.getAddr32(x, y);
+        }
+    }
+    return dst;
+}
+
+static bool equal_n32(const SkBitmap& a, const SkBitmap& b) {
+    if (a.dimensions() != b.dimensions()) {
+        return false;
+    }
+    for (int y = 0; y < a.height(); y++) {
+        if (0 != memcmp(a.getAddr32(0, y), b.getAddr32(0, y), a.width() * sizeof(uint32_t))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// The raster image filter blurs columns in strips, transposing tall ones through scratch, and
+// splits both passes into bands on an executor. Columns must blur exactly like rows do, and
+// bands must not change the serial result.
+DEF_TEST(BlurImageFilterStripsAndBands, reporter) {
+    auto serial  = ToolUtils::make_executor(0),
+         threads = ToolUtils::make_executor(4);
+    const SkScalar sigma = 10;
+    const int border = 3 * SkScalarCeilToInt(sigma);
+
+    // Short columns take the strip path, tall ones the transposed path. A width that is not a
+    // multiple of the strip width leaves a partial strip at the right.
+    for (int height : {100, 400}) {
+        SkBitmap src;
+        src.allocN32Pixels(301, height);
+        SkRandom rand;
+        for (int y = 0; y < src.height(); y++) {
+            for (int x = 0; x < src.width(); x++) {
+                *src.getAddr32(x, y) = SkPreMultiplyColor(rand.nextU());
+            }
+        }
+        const SkIRect bounds = src.bounds();
+
+        SkBitmap vertical, horizontal, banded;
+        REPORTER_ASSERT(reporter, SkBlurImageFilterPriv::BlurBitmap(
+                {0, sigma}, src, bounds, bounds.makeOutset(0, border), &vertical, serial.get()));
+        SkBitmap transposed = transpose_n32(src);
+        REPORTER_ASSERT(reporter, SkBlurImageFilterPriv::BlurBitmap(
+                {sigma, 0}, transposed, transposed.bounds(),
+                transposed.bounds().makeOutset(border, 0), &horizontal, serial.get()));
+        REPORTER_ASSERT(reporter, equal_n32(vertical, transpose_n32(horizontal)));
+
+        REPORTER_ASSERT(reporter, SkBlurImageFilterPriv::BlurBitmap(
+                {0, sigma}, src, bounds, bounds.makeOutset(0, border), &banded, threads.get()));
+        REPORTER_ASSERT(reporter, equal_n32(vertical, banded));
+
+        SkBitmap both, bothBanded;
+        const SkIRect dstBounds = bounds.makeOutset(border, border);
+        REPORTER_ASSERT(reporter, SkBlurImageFilterPriv::BlurBitmap(
+                {sigma, sigma}, src, bounds, dstBounds, &both, serial.get()));
+        REPORTER_ASSERT(reporter, SkBlurImageFilterPriv::BlurBitmap(
+                {sigma, sigma}, src, bounds, dstBounds, &bothBanded, threads.get()));
+        REPORTER_ASSERT(reporter, equal_n32(both, bothBanded));
+    }
+}
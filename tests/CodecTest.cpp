@@ -19,6 +19,7 @@
 #include "include/core/SkColorSpace.h"
 #include "include/core/SkData.h"
 #include "include/core/SkEncodedImageFormat.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkImage.h"
 #include "include/core/SkImageEncoder.h"
 #include "include/core/SkImageGenerator.h"
@@ -52,7 +53,9 @@
 #include "png.h"
 
 #include <setjmp.h>
+#include <atomic>
 #include <cstring>
+#include <functional>
 #include <initializer_list>
 #include <memory>
 #include <utility>
@@ -1839,3 +1842,273 @@ DEF_TEST(Codec_noConversion, r) {
         REPORTER_ASSERT(r, bm.getColor(0, 0) == rec.color);
     }
 }
+
+namespace {
+// Runs work on a pool of threads, counting how much work it was given.
+class CountingExecutor final : public SkExecutor {
+public:
+    CountingExecutor() : fPool(SkExecutor::MakeFIFOThreadPool(3)) {}
+
+    void add(std::function<void(void)> work) override {
+        fCount++;
+        fPool->add(std::move(work));
+    }
+
+    void borrow() override { fPool->borrow(); }
+
+    int count() const { return fCount; }
+
+private:
+    std::unique_ptr<SkExecutor> fPool;
+    std::atomic<int>            fCount{0};
+};
+}  // namespace
+
+DEF_TEST(Codec_jpeg_parallel, r) {
+    SkBitmap src;
+    if (!GetResourceAsBitmap("images/mandrill_512.png", &src)) {
+        return;
+    }
+
+    // Large enough to be split into stripes, with a height that isn't a multiple of 16.
+    auto colorSpace = SkColorSpace::MakeRGB(SkNamedTransferFn::kSRGB, SkNamedGamut::kDisplayP3);
+    SkBitmap color, gray;
+    color.allocPixels(SkImageInfo::MakeN32Premul(1800, 1500, colorSpace));
+    gray.allocPixels(SkImageInfo::Make(1800, 1500, kGray_8_SkColorType, kOpaque_SkAlphaType));
+    for (SkBitmap* bm : {&color, &gray}) {
+        SkCanvas canvas(*bm);
+        canvas.drawImageRect(src.asImage(), SkRect::Make(bm->bounds()), SkSamplingOptions());
+    }
+
+    CountingExecutor executor;
+    auto check = [&](const SkBitmap& bm, SkJpegEncoder::Downsample downsample, int restartRows) {
+        SkJpegEncoder::Options encodeOptions;
+        encodeOptions.fQuality = 90;
+        encodeOptions.fDownsample = downsample;
+        encodeOptions.fRestartRows = restartRows;
+        SkDynamicMemoryWStream stream;
+        REPORTER_ASSERT(r, SkJpegEncoder::Encode(&stream, bm.pixmap(), encodeOptions));
+        sk_sp<SkData> data = stream.detachAsData();
+
+        for (sk_sp<SkData> encoded : {data, SkData::MakeSubset(data.get(), 0, data->size() / 2)}) {
+            std::unique_ptr<SkCodec> codec = SkCodec::MakeFromData(encoded);
+            if (!codec) {
+                ERRORF(r, "Failed to create a codec");
+                return;
+            }
+
+            for (SkImageInfo info : {codec->getInfo(),
+                                     codec->getInfo().makeColorType(kRGB_565_SkColorType),
+                                     codec->getInfo().makeColorSpace(SkColorSpace::MakeSRGB())}) {
+                SkBitmap serial, parallel;
+                serial.allocPixels(info);
+                parallel.allocPixels(info);
+                SkCodec::Result serialResult =
+                        codec->getPixels(info, serial.getPixels(), serial.rowBytes());
+
+                SkCodec::Options options;
+                options.fExecutor = &executor;
+                const int countBefore = executor.count();
+                SkCodec::Result parallelResult =
+                        codec->getPixels(info, parallel.getPixels(), parallel.rowBytes(), &options);
+                REPORTER_ASSERT(r, serialResult == parallelResult);
+                if (serialResult != SkCodec::kSuccess) {
+                    REPORTER_ASSERT(r, serialResult == SkCodec::kIncompleteInput);
+                    continue;
+                }
+
+                // With restart markers the decode must have been split up.
+                REPORTER_ASSERT(r, (executor.count() > countBefore) == (restartRows > 0));
+                for (int y = 0; y < info.height(); y++) {
+                    if (0 != memcmp(serial.getAddr(0, y), parallel.getAddr(0, y),
+                                    info.minRowBytes())) {
+                        ERRORF(r, "Row %d differs (downsample %d, restart rows %d)", y,
+                               (int)downsample, restartRows);
+                        break;
+                    }
+                }
+            }
+        }
+    };
+
+    for (int restartRows : {0, 1, 3}) {
+        for (auto downsample : {SkJpegEncoder::Downsample::k420,
+                                SkJpegEncoder::Downsample::k422,
+                                SkJpegEncoder::Downsample::k444}) {
+            check(color, downsample, restartRows);
+        }
+        check(gray, SkJpegEncoder::Downsample::k420, restartRows);
+    }
+}
+
+DEF_TEST(Codec_png_parallel, r) {
+    CountingExecutor executor;
+    for (const char* path : {"images/mandrill_512.png",       // RGB
+                             "images/ducky.png",              // RGBA
+                             "images/example_3.png",          // 16-bit RGB
+                             "images/index8.png",             // palette
+                             "images/iconstrip.png",          // tall and narrow
+                             "images/plane_interlaced.png"}) {
+        sk_sp<SkData> data = GetResourceAsData(path);
+        if (!data) {
+            continue;
+        }
+
+        for (sk_sp<SkData> encoded : {data, SkData::MakeSubset(data.get(), 0, data->size() / 2)}) {
+            std::unique_ptr<SkCodec> codec = SkCodec::MakeFromData(encoded);
+            if (!codec) {
+                ERRORF(r, "Failed to create a codec for %s", path);
+                continue;
+            }
+
+            auto p3 = SkColorSpace::MakeRGB(SkNamedTransferFn::kSRGB, SkNamedGamut::kDisplayP3);
+            for (SkImageInfo info : {codec->getInfo().makeColorType(kN32_SkColorType)
+                                                     .makeAlphaType(kPremul_SkAlphaType),
+                                     codec->getInfo().makeColorType(kRGBA_F16_SkColorType),
+                                     codec->getInfo().makeColorType(kN32_SkColorType)
+                                                     .makeColorSpace(p3)}) {
+                SkBitmap serial, parallel;
+                serial.allocPixels(info);
+                parallel.allocPixels(info);
+                SkCodec::Result serialResult = codec->getPixels(info, serial.getPixels(),
+                                                                serial.rowBytes());
+                SkCodec::Options options;
+                options.fExecutor = &executor;
+                SkCodec::Result parallelResult = codec->getPixels(info, parallel.getPixels(),
+                                                                  parallel.rowBytes(), &options);
+                REPORTER_ASSERT(r, serialResult == parallelResult, "%s", path);
+                REPORTER_ASSERT(r, serialResult == SkCodec::kSuccess ||
+                                   serialResult == SkCodec::kIncompleteInput, "%s", path);
+
+                for (int y = 0; y < info.height(); y++) {
+                    if (0 != memcmp(serial.getAddr(0, y), parallel.getAddr(0, y),
+                                    info.minRowBytes())) {
+                        ERRORF(r, "%s: row %d differs", path, y);
+                        break;
+                    }
+                }
+            }
+        }
+    }
+    REPORTER_ASSERT(r, executor.count() > 0);
+}
+
+// Codecs read memory-backed streams in place. Check they decode the same as when they have to
+// copy the data out of the stream.
+DEF_TEST(Codec_readInPlace, r) {
+    for (const char* path : {"images/mandrill_512.png",
+                             "images/plane_interlaced.png",
+                             "images/randPixels.bmp",
+                             "images/rle.bmp",
+                             "images/test640x479.gif",
+                             "images/flightAnim.gif"}) {
+        sk_sp<SkData> data = GetResourceAsData(path);
+        if (!data) {
+            continue;
+        }
+
+        for (sk_sp<SkData> encoded : {data, SkData::MakeSubset(data.get(), 0, data->size() / 2)}) {
+            std::unique_ptr<SkCodec> inPlace = SkCodec::MakeFromData(encoded);
+            std::unique_ptr<SkCodec> copied =
+                    SkCodec::MakeFromStream(std::make_unique<NotAssetMemStream>(encoded));
+            if (!inPlace || !copied) {
+                // Some truncated files can't be recognized at all.
+                REPORTER_ASSERT(r, !inPlace && !copied, "%s", path);
+                continue;
+            }
+            REPORTER_ASSERT(r, inPlace->getFrameCount() == copied->getFrameCount(), "%s", path);
+
+            const SkImageInfo info = inPlace->getInfo().makeColorType(kN32_SkColorType)
+                                                       .makeAlphaType(kPremul_SkAlphaType);
+            for (int frame = 0; frame < inPlace->getFrameCount(); frame++) {
+                SkBitmap expected, actual;
+                expected.allocPixels(info);
+                actual.allocPixels(info);
+                expected.eraseColor(SK_ColorTRANSPARENT);
+                actual.eraseColor(SK_ColorTRANSPARENT);
+
+                SkCodec::Options options;
+                options.fFrameIndex = frame;
+                SkCodec::Result expectedResult = copied->getPixels(info, expected.getPixels(),
+                                                                   expected.rowBytes(), &options);
+                SkCodec::Result actualResult = inPlace->getPixels(info, actual.getPixels(),
+                                                                  actual.rowBytes(), &options);
+                REPORTER_ASSERT(r, expectedResult == actualResult, "%s frame %d", path, frame);
+                REPORTER_ASSERT(r, ToolUtils::equal_pixels(expected, actual), "%s frame %d",
+                                path, frame);
+            }
+        }
+    }
+}
+
+// BMP pixels usually start 54 bytes in, which is only 2-byte aligned.  Decoding 16- and 32-bit
+// pixels straight out of memory must not hand the swizzlers misaligned uint16_t/uint32_t rows.
+DEF_TEST(Codec_readInPlaceMisalignedBmp, r) {
+    constexpr int kW = 3, kH = 2;
+    const SkColor colors[kH][kW] = {
+        { SK_ColorRED,  SK_ColorGREEN, SK_ColorBLUE },
+        { SK_ColorBLUE, SK_ColorWHITE, SK_ColorRED  },
+    };
+
+    for (int bitsPerPixel : {16, 32}) {
+        const int rowBytes = SkAlign4(kW * bitsPerPixel / 8);
+
+        SkDynamicMemoryWStream stream;
+        // BITMAPFILEHEADER
+        stream.write8('B');
+        stream.write8('M');
+        stream.write32(54 + kH * rowBytes);
+        stream.write32(0);
+        stream.write32(54);  // Offset to the pixels, just past the headers.
+        // BITMAPINFOHEADER
+        stream.write32(40);
+        stream.write32(kW);
+        stream.write32(kH);
+        stream.write16(1);
+        stream.write16(bitsPerPixel);
+        stream.write32(0);   // BI_RGB: 16-bit pixels are 555, 32-bit pixels are BGRA.
+        stream.write32(kH * rowBytes);
+        stream.write32(0);
+        stream.write32(0);
+        stream.write32(0);
+        stream.write32(0);
+        // Rows are stored bottom up.
+        for (int y = kH - 1; y >= 0; y--) {
+            for (int x = 0; x < kW; x++) {
+                SkColor c = colors[y][x];
+                if (bitsPerPixel == 16) {
+                    stream.write16((SkColorGetR(c) >> 3) << 10 |
+                                   (SkColorGetG(c) >> 3) <<  5 |
+                                   (SkColorGetB(c) >> 3) <<  0);
+                } else {
+                    stream.write8(SkColorGetB(c));
+                    stream.write8(SkColorGetG(c));
+                    stream.write8(SkColorGetR(c));
+                    stream.write8(0xff);
+                }
+            }
+            for (int pad = kW * bitsPerPixel / 8; pad < rowBytes; pad++) {
+                stream.write8(0);
+            }
+        }
+        sk_sp<SkData> data = stream.detachAsData();
+        REPORTER_ASSERT(r, SkIsAlign4(reinterpret_cast<uintptr_t>(data->data())));
+
+        // MakeFromData() wraps data in an SkMemoryStream, which the codec can read in place.
+        std::unique_ptr<SkCodec> codec = SkCodec::MakeFromData(data);
+        if (!codec) {
+            ERRORF(r, "Could not create a codec for the %d-bit BMP", bitsPerPixel);
+            continue;
+        }
+
+        SkBitmap bm;
+        bm.allocPixels(codec->getInfo().makeColorType(kN32_SkColorType)
+                                       .makeAlphaType(kPremul_SkAlphaType));
+        REPORTER_ASSERT(r, SkCodec::kSuccess == codec->getPixels(bm.pixmap()), "%d", bitsPerPixel);
+        for (int y = 0; y < kH; y++)
+        for (int x = 0; x < kW; x++) {
+            REPORTER_ASSERT(r, bm.getColor(x, y) == colors[y][x], "%d-bit (%d,%d): 0x%08x",
+                            bitsPerPixel, x, y, bm.getColor(x, y));
+        }
+    }
+}
@@ -8,6 +8,7 @@
 #include "include/core/SkBitmap.h"
 #include "include/core/SkCanvas.h"
 #include "include/core/SkColor.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkMatrix.h"
 #include "include/core/SkPaint.h"
@@ -22,7 +23,13 @@
 #include "include/core/SkSurface.h"
 #include "include/core/SkTypes.h"
 #include "include/effects/SkDashPathEffect.h"
+#include "include/utils/SkRandom.h"
+#include "src/core/SkBlitter.h"
+#include "src/core/SkRasterClip.h"
+#include "src/core/SkScan.h"
+#include "src/core/SkSurfacePriv.h"
 #include "tests/Test.h"
+#include "tools/ToolUtils.h"
 
 // test that we can draw an aa-rect at coordinates > 32K (bigger than fixedpoint)
 static void test_big_aa_rect(skiatest::Reporter* reporter) {
@@ -371,3 +378,203 @@ DEF_TEST(DrawPath, reporter) {
     test_big_aa_rect(reporter);
     test_halfway();
 }
+
+// Writes the coverage it's handed into an A8 bitmap.
+struct CoverageBlitter : public SkBlitter {
+    CoverageBlitter(SkBitmap* bitmap) : fBitmap(bitmap) {}
+
+    void blitH(int x, int y, int width) override {
+        memset(fBitmap->getAddr8(x, y), 0xFF, width);
+    }
+
+    void blitAntiH(int x, int y, const SkAlpha antialias[], const int16_t runs[]) override {
+        for (int n; (n = *runs) > 0; runs += n, antialias += n, x += n) {
+            memset(fBitmap->getAddr8(x, y), *antialias, n);
+        }
+    }
+
+    SkBitmap* fBitmap;
+};
+
+// Each band of a banded analytic AA fill walks the same edges as the whole fill does in its rows,
+// but starts them from their exact position rather than stepping them down row by row. That moves
+// coverage by a fraction of a step, except where two edges cross and swap a step apart.
+DEF_TEST(DrawPath_BandedAnalyticAA, reporter) {
+    constexpr int kW = 200, kH = 800;
+
+    SkRandom rand;
+    auto randPt = [&] { return SkPoint{rand.nextRangeF(0, kW), rand.nextRangeF(0, kH)}; };
+    SkPath lines, quads, cubics;
+    lines.moveTo(randPt());
+    quads.moveTo(randPt());
+    cubics.moveTo(randPt());
+    // Few enough points for analytic AA to look for intersections...
+    for (int i = 0; i < 1200; i++) {
+        lines.lineTo(randPt());
+    }
+    // ... and too many.
+    for (int i = 0; i < 1000; i++) {
+        quads.quadTo(randPt(), randPt());
+    }
+    for (int i = 0; i < 700; i++) {
+        cubics.cubicTo(randPt(), randPt(), randPt());
+    }
+    quads.setFillType(SkPathFillType::kEvenOdd);
+
+    auto draw = [&](const SkPath& path, const SkIRect& clip, SkExecutor* executor) {
+        SkBitmap bm;
+        bm.allocPixels(SkImageInfo::MakeA8(kW, kH));
+        bm.eraseColor(SK_ColorTRANSPARENT);
+        CoverageBlitter blitter(&bm);
+        SkScan::AnalyticAntiFillPath(path, SkRasterClip(clip), &blitter, executor);
+        return bm;
+    };
+    // Counts the pixels of a and b more than tolerance apart.
+    auto count_diffs = [&](const SkBitmap& a, const SkBitmap& b, int tolerance) {
+        int diffs = 0;
+        for (int y = 0; y < kH; y++) {
+            for (int x = 0; x < kW; x++) {
+                diffs += std::abs(*a.getAddr8(x, y) - *b.getAddr8(x, y)) > tolerance;
+            }
+        }
+        return diffs;
+    };
+
+    std::unique_ptr<SkExecutor> serial  = ToolUtils::make_executor(0),
+                                threads = ToolUtils::make_executor(4);
+    for (SkIRect clip : {SkIRect::MakeWH(kW, kH), SkIRect::MakeLTRB(37, 51, 161, 709)}) {
+        // Where the walk skips looking for intersections, how it stepped crossing edges above a
+        // band keeps changing its coverage further down, as much in a single pass as in bands.
+        for (auto [path, tolerance] : {std::make_pair(lines, 16), std::make_pair(quads, 64),
+                                       std::make_pair(cubics, 64)}) {
+            SkBitmap onePass = draw(path, clip, nullptr),
+                     banded  = draw(path, clip, serial.get());
+            // Only a few crossings, out of over a hundred thousand pixels, may visibly differ.
+            REPORTER_ASSERT(reporter, count_diffs(onePass, banded, tolerance) < kW * kH / 1000);
+            // Bands must not depend on the threads drawing them.
+            REPORTER_ASSERT(reporter, count_diffs(banded, draw(path, clip, threads.get()), 0) == 0);
+        }
+    }
+}
+
+// Sparse scanline AA computes each pixel's exact coverage of the flattened path, except where
+// edges cross within a pixel.
+DEF_TEST(DrawPath_SparseScanlineAA, reporter) {
+    constexpr int kSize = 128, kScale = 16;
+
+    SkPath curves, glyphs, star;
+    curves.addCircle(40, 40, 30.3f);
+    curves.addOval({75.25f, 10, 120, 120.5f}, SkPathDirection::kCCW);
+    curves.moveTo(8, 120);
+    curves.cubicTo(30, 60, 60, 150, 70, 80.4f);
+    curves.quadTo(60, 125, 8, 120);
+    // Small 'o's, as text would have, with holes wound the other way.
+    for (int y = 0; y < 8; y++) {
+        for (int x = 0; x < 8; x++) {
+            const float cx = 8.3f + 16 * x, cy = 8.6f + 16 * y, r = 3 + 0.5f * x;
+            glyphs.addCircle(cx, cy, r);
+            glyphs.addCircle(cx, cy, r - 1.2f - 0.1f * y, SkPathDirection::kCCW);
+        }
+    }
+    for (int i = 0; i < 7; i++) {
+        float t = 2 * SK_ScalarPI * 3 * i / 7;
+        SkPoint p = {64.3f + 60 * std::cos(t), 64.6f + 60 * std::sin(t)};
+        i == 0 ? star.moveTo(p) : star.lineTo(p);
+    }
+
+    const SkSurfaceProps sparseProps(kSparseScanlineAA_SkSurfacePropsPrivateFlag,
+                                     kUnknown_SkPixelGeometry);
+    auto draw = [&](const SkPath& path, const SkSurfaceProps* props, const SkRect* clip,
+                    bool aaClip) {
+        auto surface = SkSurface::MakeRaster(SkImageInfo::MakeA8(kSize, kSize), props);
+        if (clip) {
+            surface->getCanvas()->rotate(aaClip ? 20 : 0, 64, 64);
+            surface->getCanvas()->clipRect(*clip, aaClip);
+            surface->getCanvas()->resetMatrix();
+        }
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        surface->getCanvas()->drawPath(path, paint);
+        SkBitmap bm;
+        bm.allocPixels(surface->imageInfo());
+        surface->readPixels(bm, 0, 0);
+        return bm;
+    };
+    // The coverage of kScale x kScale samples in each pixel.
+    auto supersample = [&](const SkPath& path) {
+        SkBitmap big, bm;
+        big.allocPixels(SkImageInfo::MakeA8(kSize * kScale, kSize * kScale));
+        big.eraseColor(SK_ColorTRANSPARENT);
+        SkCanvas canvas(big);
+        canvas.scale(kScale, kScale);
+        canvas.drawPath(path, SkPaint());
+        bm.allocPixels(SkImageInfo::MakeA8(kSize, kSize));
+        for (int y = 0; y < kSize; y++) {
+            for (int x = 0; x < kSize; x++) {
+                int sum = 0;
+                for (int sy = 0; sy < kScale; sy++) {
+                    const uint8_t* row = big.getAddr8(x * kScale, y * kScale + sy);
+                    for (int sx = 0; sx < kScale; sx++) {
+                        sum += row[sx];
+                    }
+                }
+                *bm.getAddr8(x, y) = (sum + kScale * kScale / 2) / (kScale * kScale);
+            }
+        }
+        return bm;
+    };
+    // Counts the pixels of a and b more than tolerance apart.
+    auto count_diffs = [&](const SkBitmap& a, const SkBitmap& b, int tolerance) {
+        int diffs = 0;
+        for (int y = 0; y < kSize; y++) {
+            for (int x = 0; x < kSize; x++) {
+                diffs += std::abs(*a.getAddr8(x, y) - *b.getAddr8(x, y)) > tolerance;
+            }
+        }
+        return diffs;
+    };
+
+    for (SkPathFillType fillType : {SkPathFillType::kWinding, SkPathFillType::kEvenOdd}) {
+        curves.setFillType(fillType);
+        glyphs.setFillType(fillType);
+        star.setFillType(fillType);
+
+        // Curves are flattened to within 1/32 of a pixel.
+        REPORTER_ASSERT(reporter, count_diffs(draw(curves, &sparseProps, nullptr, false),
+                                              supersample(curves), 12) == 0);
+        REPORTER_ASSERT(reporter, count_diffs(draw(glyphs, &sparseProps, nullptr, false),
+                                              supersample(glyphs), 12) == 0);
+        // Only the pixels around the star's 14 crossings may be further off.
+        REPORTER_ASSERT(reporter, count_diffs(draw(star, &sparseProps, nullptr, false),
+                                              supersample(star), 12) < 32);
+
+        for (SkPath path : {curves, glyphs, star}) {
+            const SkRect clip = {20.5f, 10, 100, 110.5f};
+            SkBitmap full = draw(path, &sparseProps, nullptr, false),
+                     rect = draw(path, &sparseProps, &clip, false);
+            for (int y = 0; y < kSize; y++) {
+                for (int x = 0; x < kSize; x++) {
+                    const bool inClip = x >= 21 && x < 100 && y >= 10 && y < 111;
+                    const int  d      = *full.getAddr8(x, y) - *rect.getAddr8(x, y);
+                    REPORTER_ASSERT(reporter,
+                                    inClip ? std::abs(d) <= 1 : d == *full.getAddr8(x, y));
+                }
+            }
+
+            // The AA clip goes through the same path as the default scan converters' does.
+            const SkRect aaClip = {30, 30, 98, 98};
+            REPORTER_ASSERT(reporter, count_diffs(draw(path, &sparseProps, &aaClip, true),
+                                                  draw(path, nullptr, &aaClip, true), 64) < 16);
+
+            path.toggleInverseFillType();
+            SkBitmap inverse = draw(path, &sparseProps, nullptr, false);
+            for (int y = 0; y < kSize; y++) {
+                for (int x = 0; x < kSize; x++) {
+                    REPORTER_ASSERT(reporter,
+                                    std::abs(*full.getAddr8(x, y) + *inverse.getAddr8(x, y) - 255)
+                                            <= 1);
+                }
+            }
+        }
+    }
+}
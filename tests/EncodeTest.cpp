@@ -8,10 +8,12 @@
 #include "tests/Test.h"
 #include "tools/Resources.h"
 
+#include "include/codec/SkCodec.h"
 #include "include/core/SkBitmap.h"
 #include "include/core/SkCanvas.h"
 #include "include/core/SkColorPriv.h"
 #include "include/core/SkEncodedImageFormat.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkImage.h"
 #include "include/core/SkStream.h"
 #include "include/core/SkSurface.h"
@@ -218,6 +220,84 @@ DEF_TEST(Encode_JpegDownsample, r) {
     REPORTER_ASSERT(r, almost_equals(bm1, bm2, 60));
 }
 
+// Pulling rows from a SkJpegEncoder::RowSource only changes the Huffman tables, so the decoded
+// pixels match those of encoding the whole pixmap at once.
+DEF_TEST(Encode_JpegRows, r) {
+    SkBitmap bitmap;
+    if (!GetResourceAsBitmap("images/mandrill_512.png", &bitmap)) {
+        return;
+    }
+
+    auto decode = [](SkDynamicMemoryWStream* stream) {
+        sk_sp<SkImage> image = SkImage::MakeFromEncoded(stream->detachAsData());
+        SkBitmap bm;
+        bm.allocPixels(image->imageInfo().makeColorType(kN32_SkColorType));
+        SkAssertResult(image->readPixels(nullptr, bm.pixmap(), 0, 0));
+        return bm;
+    };
+
+    // 501 rows is not a whole number of strips.
+    const SkImageInfo info = bitmap.info().makeWH(512, 501).makeAlphaType(kOpaque_SkAlphaType);
+    for (SkColorType colorType : {kN32_SkColorType, kRGB_565_SkColorType, kGray_8_SkColorType}) {
+        SkBitmap src;
+        src.allocPixels(info.makeColorType(colorType));
+        REPORTER_ASSERT(r, bitmap.readPixels(src.pixmap(), 0, 0));
+
+        for (auto downsample : {SkJpegEncoder::Downsample::k420,
+                                SkJpegEncoder::Downsample::k444}) {
+            SkJpegEncoder::Options options;
+            options.fQuality = 90;
+            options.fDownsample = downsample;
+
+            SkDynamicMemoryWStream whole, streamed;
+            REPORTER_ASSERT(r, SkJpegEncoder::Encode(&whole, src.pixmap(), options));
+
+            int nextRow = 0;
+            auto rows = [&](int y, const SkPixmap& dst) {
+                REPORTER_ASSERT(r, y == nextRow);
+                REPORTER_ASSERT(r, dst.height() <= 16);
+                nextRow = y + dst.height();
+                return src.readPixels(dst, 0, y);
+            };
+            REPORTER_ASSERT(r, SkJpegEncoder::Encode(&streamed, src.info(), rows, options));
+            REPORTER_ASSERT(r, nextRow == src.height());
+
+            REPORTER_ASSERT(r, almost_equals(decode(&whole), decode(&streamed), 0));
+        }
+    }
+
+    // A RowSource can stop the encode.
+    SkDynamicMemoryWStream aborted;
+    auto someRows = [&](int y, const SkPixmap& dst) {
+        return y < 100 && bitmap.readPixels(dst, 0, y);
+    };
+    REPORTER_ASSERT(r, !SkJpegEncoder::Encode(&aborted, bitmap.info(), someRows,
+                                              SkJpegEncoder::Options()));
+
+    // Transcode by pulling scanlines straight from a codec.
+    std::unique_ptr<SkCodec> codec = SkCodec::MakeFromData(
+            GetResourceAsData("images/mandrill_512_q075.jpg"));
+    if (!codec) {
+        return;
+    }
+    const SkImageInfo codecInfo = codec->getInfo().makeColorType(kN32_SkColorType);
+    SkBitmap decoded;
+    decoded.allocPixels(codecInfo);
+    REPORTER_ASSERT(r, SkCodec::kSuccess == codec->getPixels(decoded.pixmap()));
+
+    SkDynamicMemoryWStream whole, transcoded;
+    REPORTER_ASSERT(r, SkJpegEncoder::Encode(&whole, decoded.pixmap(), SkJpegEncoder::Options()));
+
+    REPORTER_ASSERT(r, SkCodec::kSuccess == codec->startScanlineDecode(codecInfo));
+    auto scanlines = [&](int, const SkPixmap& dst) {
+        return codec->getScanlines(dst.writable_addr(), dst.height(), dst.rowBytes()) ==
+               dst.height();
+    };
+    REPORTER_ASSERT(r, SkJpegEncoder::Encode(&transcoded, codecInfo, scanlines,
+                                             SkJpegEncoder::Options()));
+    REPORTER_ASSERT(r, almost_equals(decode(&whole), decode(&transcoded), 0));
+}
+
 static inline void pushComment(
         std::vector<std::string>& comments, const char* keyword, const char* text) {
     comments.push_back(keyword);
@@ -332,6 +412,72 @@ DEF_TEST(Encode_PngOptions, r) {
     REPORTER_ASSERT(r, almost_equals(bm0, bm2, 0));
 }
 
+static bool decode_as(sk_sp<SkData> data, const SkImageInfo& info, SkBitmap* dst) {
+    sk_sp<SkImage> image = SkImage::MakeFromEncoded(std::move(data));
+    return image && dst->tryAllocPixels(info) && image->readPixels(dst->pixmap(), 0, 0);
+}
+
+DEF_TEST(Encode_PngParallel, r) {
+    SkBitmap mandrill;
+    if (!GetResourceAsBitmap("images/mandrill_256.png", &mandrill)) {
+        return;
+    }
+
+    // Covering 1, 2, 4, and 8 byte pixels, the larger ones spanning several chunks.
+    std::vector<SkBitmap> sources;
+    for (SkColorType ct : {kGray_8_SkColorType, kAlpha_8_SkColorType, kRGBA_8888_SkColorType,
+                           kRGBA_F16_SkColorType}) {
+        SkAlphaType at = ct == kGray_8_SkColorType ? kOpaque_SkAlphaType : kUnpremul_SkAlphaType;
+        SkBitmap bm;
+        bm.allocPixels(mandrill.info().makeColorType(ct).makeAlphaType(at));
+        if (ct == kAlpha_8_SkColorType) {
+            for (int y = 0; y < bm.height(); y++)
+            for (int x = 0; x < bm.width(); x++) {
+                *bm.getAddr8(x, y) = (uint8_t)(x ^ y);
+            }
+        } else {
+            REPORTER_ASSERT(r, mandrill.readPixels(bm.pixmap()));
+        }
+        sources.push_back(bm);
+    }
+
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(3);
+    for (const SkBitmap& src : sources)
+    for (auto filters : {SkPngEncoder::FilterFlag::kAll, SkPngEncoder::FilterFlag::kZero,
+                         SkPngEncoder::FilterFlag::kPaeth}) {
+        SkPngEncoder::Options options;
+        options.fFilterFlags = filters;
+
+        SkDynamicMemoryWStream serial;
+        REPORTER_ASSERT(r, SkPngEncoder::Encode(&serial, src.pixmap(), options));
+        SkBitmap expected;
+        REPORTER_ASSERT(r, decode_as(serial.detachAsData(), src.info(), &expected));
+
+        options.fExecutor = executor.get();
+        for (int level : {0, 6}) {
+            options.fZLibLevel = level;
+
+            // Encoding all at once, and a few rows at a time, should decode to the same pixels.
+            SkDynamicMemoryWStream parallel, incremental;
+            REPORTER_ASSERT(r, SkPngEncoder::Encode(&parallel, src.pixmap(), options));
+            auto encoder = SkPngEncoder::Make(&incremental, src.pixmap(), options);
+            REPORTER_ASSERT(r, encoder);
+            for (int y = 0; y < src.height(); y += 37) {
+                REPORTER_ASSERT(r, encoder->encodeRows(37));
+            }
+
+            for (SkDynamicMemoryWStream* stream : {&parallel, &incremental}) {
+                SkBitmap actual;
+                REPORTER_ASSERT(r, decode_as(stream->detachAsData(), src.info(), &actual));
+                REPORTER_ASSERT(r, 0 == memcmp(expected.getPixels(), actual.getPixels(),
+                                               expected.computeByteSize()),
+                                "color type %d, filters 0x%x, level %d",
+                                src.colorType(), (int)filters, level);
+            }
+        }
+    }
+}
+
 #ifndef SK_BUILD_FOR_GOOGLE3
 DEF_TEST(Encode_WebpQuality, r) {
     SkBitmap bm;
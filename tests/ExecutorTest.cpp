@@ -0,0 +1,91 @@
+/*
+ * Copyright 2021 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/core/SkExecutor.h"
+#include "src/core/SkTaskGroup.h"
+#include "tests/Test.h"
+
+#include <atomic>
+
+DEF_TEST(Executor_WorkStealing_Nested, r) {
+    auto pool = SkExecutor::MakeWorkStealingThreadPool(4);
+
+    // Each outer task fans out more tasks and waits on them from inside the pool.
+    // This deadlocks unless wait() on a pool thread helps run pending work.
+    std::atomic<int> count{0};
+    SkTaskGroup outer(*pool);
+    outer.batch(64, [&](int) {
+        SkTaskGroup inner(*pool);
+        inner.batch(64, [&](int) { count.fetch_add(1, std::memory_order_relaxed); });
+        inner.wait();
+    });
+    outer.wait();
+
+    REPORTER_ASSERT(r, count.load() == 64 * 64);
+}
+
+DEF_TEST(Executor_WorkStealing_NoBorrowing, r) {
+    // With borrowing off, waiting from outside the pool just spins until the pool finishes.
+    auto pool = SkExecutor::MakeWorkStealingThreadPool(2, /*allowBorrowing=*/false);
+
+    std::atomic<int> count{0};
+    SkTaskGroup group(*pool);
+    for (int i = 0; i < 1000; i++) {
+        group.add([&] { count.fetch_add(1, std::memory_order_relaxed); });
+    }
+    group.wait();
+
+    REPORTER_ASSERT(r, count.load() == 1000);
+}
+
+DEF_TEST(Executor_WorkStealing_Shutdown, r) {
+    // Destroying a pool with work still queued must run all of it, including work that queued
+    // work adds to the pool's own deques, without hanging.
+    std::atomic<int> count{0};
+    {
+        auto pool = SkExecutor::MakeWorkStealingThreadPool(3);
+        SkExecutor* executor = pool.get();
+        for (int i = 0; i < 100; i++) {
+            executor->add([&count, executor] {
+                count.fetch_add(1, std::memory_order_relaxed);
+                executor->add([&count] { count.fetch_add(1, std::memory_order_relaxed); });
+            });
+        }
+    }
+    REPORTER_ASSERT(r, count.load() == 200);
+}
+
+static void test_parallel_for(skiatest::Reporter* r, SkExecutor& executor) {
+    for (int grain : {1, 7, 64, 1000}) {
+        constexpr int kBegin = 3,
+                      kEnd   = 1003;
+        std::atomic<int> hits[kEnd] = {};
+        std::atomic<bool> chunkTooBig{false};
+
+        SkTaskGroup group(executor);
+        group.parallel_for(kBegin, kEnd, grain, [&](int begin, int end) {
+            if (end - begin > grain) {
+                chunkTooBig = true;
+            }
+            for (int i = begin; i < end; i++) {
+                hits[i].fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+        group.wait();
+
+        REPORTER_ASSERT(r, !chunkTooBig);
+        for (int i = 0; i < kEnd; i++) {
+            REPORTER_ASSERT(r, hits[i].load() == (i >= kBegin ? 1 : 0), "grain %d, i %d", grain, i);
+        }
+    }
+}
+
+DEF_TEST(TaskGroup_ParallelFor, r) {
+    test_parallel_for(r, SkExecutor::GetDefault());
+    test_parallel_for(r, *SkExecutor::MakeFIFOThreadPool(3));
+    test_parallel_for(r, *SkExecutor::MakeWorkStealingThreadPool(3));
+}
@@ -1531,3 +1531,92 @@ DEF_TEST(image_subset_encode_skbug_7752, reporter) {
     check_roundtrip(image->makeSubset({W/2, H/2, W, H}));
     check_roundtrip(image->makeColorSpace(SkColorSpace::MakeSRGBLinear()));
 }
+
+// Decodes a left-red, right-blue image at its own size or any multiple of 1/8 (like JPEG),
+// recording the size of each decode.
+class EighthsGenerator : public SkImageGenerator {
+public:
+    EighthsGenerator(std::vector<SkISize>* decodes)
+            : SkImageGenerator(SkImageInfo::MakeN32Premul(800, 800)), fDecodes(decodes) {}
+
+protected:
+    SkISize onGetScaledDimensions(float desiredScale) const override {
+        int num = SkTPin(sk_float_ceil2int(desiredScale * 8), 1, 8);
+        return {this->getInfo().width() * num / 8, this->getInfo().height() * num / 8};
+    }
+
+    bool onGetPixels(const SkImageInfo& info, void* pixels, size_t rowBytes,
+                     const Options&) override {
+        fDecodes->push_back(info.dimensions());
+        SkPixmap pm(info, pixels, rowBytes);
+        const SkIRect left  = SkIRect::MakeWH(info.width() / 2, info.height()),
+                      right = SkIRect::MakeLTRB(left.right(), 0, info.width(), info.height());
+        pm.erase(SkColors::kRed, &left);
+        pm.erase(SkColors::kBlue, &right);
+        return true;
+    }
+
+private:
+    std::vector<SkISize>* fDecodes;
+};
+
+DEF_TEST(Image_lazyScaledDecode, reporter) {
+    const SkSamplingOptions linear(SkFilterMode::kLinear);
+    std::vector<SkISize> decodes;
+    auto make_image = [&] {
+        return SkImage::MakeFromGenerator(std::make_unique<EighthsGenerator>(&decodes));
+    };
+    auto surface = SkSurface::MakeRasterN32Premul(50, 50);
+    SkCanvas* canvas = surface->getCanvas();
+
+    // Drawn at 1/8 horizontally (the larger scale), we decode at twice that.
+    {
+        sk_sp<SkImage> image = make_image();
+        canvas->drawImageRect(image, SkRect::MakeLTRB(400, 0, 800, 800), SkRect::MakeWH(50, 50),
+                              linear, nullptr, SkCanvas::kStrict_SrcRectConstraint);
+        REPORTER_ASSERT(reporter, decodes.size() == 1 && decodes.back() == SkISize::Make(200, 200));
+
+        // The src rect must be mapped onto the smaller decode: we only see the blue half.
+        SkBitmap bm;
+        bm.allocPixels(SkImageInfo::MakeN32Premul(50, 50));
+        REPORTER_ASSERT(reporter, surface->readPixels(bm, 0, 0));
+        for (int y = 0; y < bm.height(); ++y) {
+            for (int x = 0; x < bm.width(); ++x) {
+                REPORTER_ASSERT(reporter, bm.getColor(x, y) == SK_ColorBLUE);
+            }
+        }
+    }
+
+    // Image shaders without mipmaps decode smaller too.
+    {
+        sk_sp<SkImage> image = make_image();
+        SkPaint paint;
+        paint.setShader(image->makeShader(linear, SkMatrix::Scale(1/16.f, 1/16.f)));
+        canvas->drawPaint(paint);
+        REPORTER_ASSERT(reporter, decodes.size() == 2 && decodes.back() == SkISize::Make(100, 100));
+    }
+
+    // Mild minification decodes at full size.
+    {
+        sk_sp<SkImage> image = make_image();
+        canvas->drawImageRect(image, SkRect::MakeWH(600, 600), linear);
+        REPORTER_ASSERT(reporter, decodes.size() == 3 && decodes.back() == SkISize::Make(800, 800));
+    }
+
+    // A real JPEG is decoded with DCT scaling, and cached at that scale.
+    if (sk_sp<SkData> data = GetResourceAsData("images/mandrill_512_q075.jpg")) {
+        sk_sp<SkImage> image = SkImage::MakeFromEncoded(data);
+        canvas->drawImageRect(image, SkRect::MakeWH(32, 32), linear);
+
+        SkBitmap cached;
+        if (SkBitmapCache::Find(SkBitmapCacheDesc::MakeScaled(image.get(), {64, 64}), &cached)) {
+            REPORTER_ASSERT(reporter, cached.dimensions() == SkISize::Make(64, 64));
+        } else {
+            // unexpected, but not really a bug, since the cache is global and this test may be
+            // run w/ other threads competing for its budget.
+            SkDebugf("Image_lazyScaledDecode : scaled decode was already purged\n");
+        }
+        REPORTER_ASSERT(reporter, !SkBitmapCache::Find(SkBitmapCacheDesc::Make(image.get()),
+                                                       &cached));
+    }
+}
@@ -6,6 +6,7 @@
  */
 
 #include "include/core/SkBitmap.h"
+#include "include/private/SkHalf.h"
 #include "include/utils/SkRandom.h"
 #include "src/core/SkMipmap.h"
 #include "tests/Test.h"
@@ -211,6 +212,107 @@ DEF_TEST(MipMap_F16, reporter) {
     sk_sp<SkMipmap> mipmap(SkMipmap::Build(bmp, nullptr));
 }
 
+// The first level of an even (or odd) sized image comes from the 2x2 box (or 3x3 triangle)
+// filter.  Check those against the filters' per-channel math, at every row length up to a few
+// vectors wide, and once at a size big enough to be filtered in parallel bands.
+static void check_first_level(skiatest::Reporter* reporter, SkColorType ct, int w, int h,
+                              SkRandom* rand) {
+    SkBitmap bm;
+    bm.allocPixels(SkImageInfo::Make(w, h, ct, kPremul_SkAlphaType));
+    const SkPixmap& src = bm.pixmap();
+    for (int y = 0; y < h; ++y) {
+        for (int x = 0; x < w; ++x) {
+            if (ct == kRGBA_F16_SkColorType) {
+                Sk4f c = {rand->nextF(), rand->nextF(), rand->nextF(), rand->nextF()};
+                SkFloatToHalf_finite_ftz(c).store(src.writable_addr64(x, y));
+            } else if (ct == kAlpha_8_SkColorType) {
+                *src.writable_addr8(x, y) = (uint8_t)rand->nextU();
+            } else {
+                *src.writable_addr32(x, y) = rand->nextU();
+            }
+        }
+    }
+
+    sk_sp<SkMipmap> mm(SkMipmap::Build(src, nullptr));
+    SkMipmap::Level level;
+    REPORTER_ASSERT(reporter, mm && mm->getLevel(0, &level));
+    const SkPixmap& dst = level.fPixmap;
+
+    const bool triangle = w & 1;
+    const int taps = triangle ? 3 : 2;
+    const int weights[2][3] = {{1, 1, 0}, {1, 2, 1}};
+    const int* k = weights[triangle];
+
+    for (int y = 0; y < dst.height(); ++y) {
+        for (int x = 0; x < dst.width(); ++x) {
+            if (ct == kRGBA_F16_SkColorType) {
+                // Float sums must be taken in the same order as SkMipmap's filters.
+                auto c = [&](int i, int j) {
+                    return SkHalfToFloat_finite_ftz(*src.addr64(2*x + i, 2*y + j));
+                };
+                Sk4f sum;
+                if (triangle) {
+                    Sk4f a = c(0, 0) + c(0, 1) + c(0, 1) + c(0, 2),
+                         b = (c(1, 0) + c(1, 1) + c(1, 1) + c(1, 2)) * 2,
+                         d = c(2, 0) + c(2, 1) + c(2, 1) + c(2, 2);
+                    sum = (a + b + d) * (1.0f / 16);
+                } else {
+                    sum = (c(0, 0) + c(0, 1) + c(1, 0) + c(1, 1)) * (1.0f / 4);
+                }
+                uint64_t expected;
+                SkFloatToHalf_finite_ftz(sum).store(&expected);
+                REPORTER_ASSERT(reporter, expected == *dst.addr64(x, y));
+                continue;
+            }
+
+            // Integer formats, as (bits, shift) of each channel.
+            struct Channel { int fBits, fShift; };
+            const Channel a8[]      = {{8, 0}},
+                          c8888[]   = {{8, 0}, {8, 8}, {8, 16}, {8, 24}},
+                          c1010102[] = {{10, 0}, {10, 10}, {10, 20}, {2, 30}};
+            const Channel* channels = ct == kAlpha_8_SkColorType ? a8 :
+                                      ct == kN32_SkColorType     ? c8888 : c1010102;
+            const int channelCount = ct == kAlpha_8_SkColorType ? 1 : 4;
+            auto read = [&](int sx, int sy, const Channel& c) -> uint32_t {
+                uint32_t px = ct == kAlpha_8_SkColorType ? *src.addr8(sx, sy)
+                                                         : *src.addr32(sx, sy);
+                return (px >> c.fShift) & ((1u << c.fBits) - 1);
+            };
+            uint32_t expected = 0;
+            for (int ch = 0; ch < channelCount; ++ch) {
+                uint32_t sum = 0;
+                for (int j = 0; j < taps; ++j) {
+                    for (int i = 0; i < taps; ++i) {
+                        sum += k[i] * k[j] * read(2*x + i, 2*y + j, channels[ch]);
+                    }
+                }
+                expected |= ((sum >> (triangle ? 4 : 2)) & ((1u << channels[ch].fBits) - 1))
+                            << channels[ch].fShift;
+            }
+            uint32_t actual = ct == kAlpha_8_SkColorType ? *dst.addr8(x, y) : *dst.addr32(x, y);
+            if (ct == kRGBA_1010102_SkColorType && triangle) {
+                // The 3x3 sum of 2-bit alphas does not fit in ColorTypeFilter_1010102's top field.
+                expected &= 0x3fffffff;
+                actual   &= 0x3fffffff;
+            }
+            REPORTER_ASSERT(reporter, expected == actual, "%d %dx%d (%d,%d): %08x != %08x",
+                            ct, w, h, x, y, expected, actual);
+        }
+    }
+}
+
+DEF_TEST(MipMap_Downsamplers, reporter) {
+    SkRandom rand;
+    for (SkColorType ct : {kN32_SkColorType, kAlpha_8_SkColorType, kRGBA_1010102_SkColorType,
+                           kRGBA_F16_SkColorType}) {
+        for (int dstW = 1; dstW <= 40; ++dstW) {
+            check_first_level(reporter, ct, 2*dstW,     4, &rand);
+            check_first_level(reporter, ct, 2*dstW + 1, 5, &rand);
+        }
+        check_first_level(reporter, ct, 1025, 1025, &rand);
+    }
+}
+
 #include "include/core/SkCanvas.h"
 #include "include/core/SkSurface.h"
 #include "src/core/SkMipmapBuilder.h"
@@ -9,6 +9,7 @@
 
 #ifdef SK_SUPPORT_PDF
 
+#include "include/core/SkData.h"
 #include "include/private/SkTo.h"
 #include "include/utils/SkRandom.h"
 #include "src/pdf/SkDeflate.h"
@@ -167,4 +168,62 @@ DEF_TEST(SkPDF_DeflateWStream, r) {
     REPORTER_ASSERT(r, !emptyDeflateWStream.writeText("FOO"));
 }
 
+static bool inflates_to(skiatest::Reporter* r, const SkData* compressed,
+                        const uint8_t* expected, size_t size) {
+    SkMemoryStream compressedStream(compressed->data(), compressed->size());
+    std::unique_ptr<SkStreamAsset> decompressed(stream_inflate(r, &compressedStream));
+    if (!decompressed || decompressed->getLength() != size) {
+        return false;
+    }
+    sk_sp<SkData> data = SkData::MakeFromStream(decompressed.get(), size);
+    return 0 == size || (data && 0 == memcmp(data->data(), expected, size));
+}
+
+DEF_TEST(SkPDF_DeflateWStream_levels, r) {
+    SkRandom random(654321);
+    // Runs of a few values, so every level finds something to compress.
+    constexpr size_t kSize = 50000;
+    SkAutoTMalloc<uint8_t> buffer(kSize);
+    for (size_t i = 0; i < kSize;) {
+        uint8_t value = random.nextULessThan(4);
+        for (uint32_t run = random.nextRangeU(1, 40); run > 0 && i < kSize; --run) {
+            buffer[i++] = value;
+        }
+    }
+    using Strategy = SkDeflateWStream::Strategy;
+    for (Strategy strategy : {Strategy::kDefault, Strategy::kFiltered, Strategy::kRLE,
+                              Strategy::kHuffmanOnly}) {
+        for (int level : {-1, 0, 1, 9}) {
+            // Mix writes that fill whole input blocks with ones that don't.
+            SkDynamicMemoryWStream dynamicMemoryWStream;
+            {
+                SkDeflateWStream deflateWStream(&dynamicMemoryWStream, level, false, strategy);
+                size_t offsets[] = {0, 9000, 9100, 30000, kSize};
+                for (size_t i = 0; i + 1 < SK_ARRAY_COUNT(offsets); ++i) {
+                    deflateWStream.write(&buffer[offsets[i]], offsets[i + 1] - offsets[i]);
+                }
+                REPORTER_ASSERT(r, deflateWStream.bytesWritten() == kSize);
+            }
+            sk_sp<SkData> streamed = dynamicMemoryWStream.detachAsData();
+            REPORTER_ASSERT(r, inflates_to(r, streamed.get(), buffer.get(), kSize));
+            REPORTER_ASSERT(r, level == 0 || streamed->size() < kSize);
+
+            // The one-shot path makes an equally valid stream.
+            SkDynamicMemoryWStream oneShotWStream;
+            REPORTER_ASSERT(r, SkDeflateWStream::Compress(buffer.get(), kSize, &oneShotWStream,
+                                                          level, strategy));
+            sk_sp<SkData> oneShot = oneShotWStream.detachAsData();
+            REPORTER_ASSERT(r, inflates_to(r, oneShot.get(), buffer.get(), kSize));
+            REPORTER_ASSERT(r, level == 0 || oneShot->size() < kSize);
+        }
+    }
+
+    SkDynamicMemoryWStream emptyWStream;
+    REPORTER_ASSERT(r, SkDeflateWStream::Compress(nullptr, 0, &emptyWStream));
+    sk_sp<SkData> empty = emptyWStream.detachAsData();
+    REPORTER_ASSERT(r, empty->size() > 0);
+    REPORTER_ASSERT(r, inflates_to(r, empty.get(), nullptr, 0));
+    REPORTER_ASSERT(r, !SkDeflateWStream::Compress(buffer.get(), kSize, nullptr));
+}
+
 #endif
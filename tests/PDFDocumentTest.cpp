@@ -6,12 +6,19 @@
  */
 #include "tests/Test.h"
 
+#include "include/core/SkAnnotation.h"
 #include "include/core/SkBitmap.h"
 #include "include/core/SkCanvas.h"
+#include "include/core/SkData.h"
 #include "include/core/SkExecutor.h"
+#include "include/core/SkFont.h"
 #include "include/core/SkStream.h"
+#include "include/core/SkTypeface.h"
 #include "include/docs/SkPDFDocument.h"
 #include "src/core/SkOSFile.h"
+#include "src/pdf/SkKeyedImage.h"
+#include "src/pdf/SkPDFGlyphUse.h"
+#include "src/pdf/SkPDFResourceCache.h"
 #include "src/utils/SkOSPath.h"
 #include "tools/Resources.h"
 
@@ -256,3 +263,207 @@ DEF_TEST(SkPDF_abort_jobs, rep) {
     doc->abort();
 }
 
+
+static int count_occurrences(const SkData* data, const char* needle) {
+    const char* haystack = static_cast<const char*>(data->data());
+    const size_t needleLength = strlen(needle);
+    int count = 0;
+    for (size_t i = 0; i + needleLength <= data->size(); ++i) {
+        count += 0 == memcmp(haystack + i, needle, needleLength);
+    }
+    return count;
+}
+
+static sk_sp<SkData> make_report(SkExecutor* executor, int pageCount, const SkImage* image) {
+    using PDFTag = SkPDF::StructureElementNode;
+    auto root = std::make_unique<PDFTag>();
+    root->fNodeId = 1;
+    root->fTypeString = "Document";
+    for (int i = 0; i < pageCount; ++i) {
+        auto paragraph = std::make_unique<PDFTag>();
+        paragraph->fNodeId = 2 + i;
+        paragraph->fTypeString = "P";
+        root->fChildVector.push_back(std::move(paragraph));
+    }
+
+    SkPDF::Metadata metadata;
+    metadata.fExecutor = executor;
+    metadata.fStructureElementTreeRoot = root.get();
+    SkDynamicMemoryWStream stream;
+    auto doc = SkPDF::MakeDocument(&stream, metadata);
+    SkFont font;
+    font.setSize(12);
+    for (int i = 0; i < pageCount; ++i) {
+        SkCanvas* canvas = doc->beginPage(612, 792);
+        SkPDF::SetNodeId(canvas, 2 + i);
+        SkString text = SkStringPrintf("Page %d of %d", i + 1, pageCount);
+        canvas->drawString(text, 72, 72, font, SkPaint());
+        // The same image on every page, and one only drawn on this page.
+        canvas->drawImage(image, 72, 100);
+        SkBitmap bitmap;
+        bitmap.allocN32Pixels(8, 8);
+        bitmap.eraseColor(SkColorSetARGB(0xFF, (uint8_t)i, 0x80, 0x40));
+        canvas->drawImage(bitmap.asImage(), 72, 300);
+        // A translucent rect in a layer, for a soft-mask graphic state.
+        SkPaint paint;
+        paint.setAlphaf(0.5f);
+        canvas->saveLayer(nullptr, &paint);
+        canvas->drawRect({300, 300, 400, 400}, SkPaint());
+        canvas->restore();
+        SkString destination = SkStringPrintf("page%d", i);
+        SkAnnotateNamedDestination(canvas, {72, 72},
+                                   SkData::MakeWithCString(destination.c_str()).get());
+        SkAnnotateRectWithURL(canvas, {72, 500, 200, 520},
+                              SkData::MakeWithCString("https://skia.org").get());
+    }
+    doc->close();
+    return stream.detachAsData();
+}
+
+// With an executor, pages are drawn on it concurrently; the document should still have every
+// page and share one copy of the objects that pages have in common.
+DEF_TEST(SkPDF_parallel_pages, r) {
+    REQUIRE_PDF_DOCUMENT(SkPDF_parallel_pages, r);
+    constexpr int kPageCount = 24;
+    SkBitmap shared;
+    shared.allocN32Pixels(64, 64);
+    shared.eraseColor(0xFF4080C0);
+    sk_sp<SkImage> image = shared.asImage();
+
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+    sk_sp<SkData> serial = make_report(nullptr, kPageCount, image.get());
+    sk_sp<SkData> parallel = make_report(executor.get(), kPageCount, image.get());
+
+    for (const char* needle : {"/Type /Page\n", "/Type /Pages\n", "/Subtype /Image\n",
+                               "/Type /Font\n", "/Subtype /Link\n", "/Type /MCR\n", "/MCID ",
+                               "/Type /ExtGState\n"}) {
+        int serialCount = count_occurrences(serial.get(), needle),
+            parallelCount = count_occurrences(parallel.get(), needle);
+        REPORTER_ASSERT(r, serialCount == parallelCount, "%s: %d != %d",
+                        needle, serialCount, parallelCount);
+    }
+    REPORTER_ASSERT(r, count_occurrences(parallel.get(), "/Type /Page\n") == kPageCount);
+    REPORTER_ASSERT(r, count_occurrences(parallel.get(), "/Subtype /Link\n") == kPageCount);
+    // One shared image, plus one per page.
+    REPORTER_ASSERT(r, count_occurrences(parallel.get(), "/Subtype /Image\n") == kPageCount + 1);
+    for (int i = 0; i < kPageCount; ++i) {
+        SkString destination = SkStringPrintf("/page%d ", i);
+        REPORTER_ASSERT(r, count_occurrences(parallel.get(), destination.c_str()) == 1);
+    }
+}
+
+static sk_sp<SkData> make_cached_document(const SkImage* image) {
+    SkDynamicMemoryWStream stream;
+    SkPDF::Metadata metadata;
+    metadata.fCacheAcrossDocuments = true;
+    auto doc = SkPDF::MakeDocument(&stream, metadata);
+    SkCanvas* canvas = doc->beginPage(200, 200);
+    canvas->drawImage(image, 10, 10);
+    canvas->drawString("Cached", 10, 150, SkFont(), SkPaint());
+    doc->close();
+    return stream.detachAsData();
+}
+
+DEF_TEST(SkPDF_cache_across_documents, r) {
+    REQUIRE_PDF_DOCUMENT(SkPDF_cache_across_documents, r);
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(32, 32);
+    bitmap.eraseColor(0x804080C0);  // Translucent, so the image also has a soft mask.
+    sk_sp<SkImage> image = bitmap.asImage();
+
+    SkPDFResourceCache::Image cached;
+    SkBitmapKey key = SkBitmapKeyFromImage(image.get());
+    REPORTER_ASSERT(r, !SkPDFResourceCache::FindImage(key, 101, -1, 0, &cached));
+    sk_sp<SkData> first = make_cached_document(image.get());
+    if (SkPDFResourceCache::FindImage(key, 101, -1, 0, &cached)) {
+        REPORTER_ASSERT(r, cached.fSize == image->dimensions());
+        REPORTER_ASSERT(r, cached.fImage.fData && cached.fSMask.fData);
+    } else {
+        // unexpected, but not really a bug, since the cache is global and this test may be
+        // run w/ other threads competing for its budget.
+        SkDebugf("SkPDF_cache_across_documents : cached image was already purged\n");
+    }
+
+    sk_sp<SkData> second = make_cached_document(image.get());
+    REPORTER_ASSERT(r, first->equals(second.get()));
+}
+
+DEF_TEST(SkPDF_cache_subset_fonts, r) {
+    REQUIRE_PDF_DOCUMENT(SkPDF_cache_subset_fonts, r);
+    sk_sp<SkTypeface> typeface = SkTypeface::MakeDefault();
+    const auto subsetter = SkPDF::Metadata::kHarfbuzz_Subsetter;
+    SkPDFGlyphUse used(1, 1000), fewer(1, 1000);
+    for (SkGlyphID gid : {991, 997, 999}) {
+        used.set(gid);
+    }
+    fewer.set(991);
+
+    REPORTER_ASSERT(r, !SkPDFResourceCache::FindSubsetFont(*typeface, 0, subsetter, used));
+    sk_sp<SkData> font = SkData::MakeWithCString("subset font");
+    SkPDFResourceCache::AddSubsetFont(*typeface, 0, subsetter, used, font);
+    if (sk_sp<SkData> found = SkPDFResourceCache::FindSubsetFont(*typeface, 0, subsetter, used)) {
+        REPORTER_ASSERT(r, found->equals(font.get()));
+    } else {
+        // unexpected, but not really a bug, since the cache is global and this test may be
+        // run w/ other threads competing for its budget.
+        SkDebugf("SkPDF_cache_subset_fonts : subset font was already purged\n");
+    }
+
+    // Any other glyphs, face index, or subsetter needs a subset of its own.
+    REPORTER_ASSERT(r, !SkPDFResourceCache::FindSubsetFont(*typeface, 0, subsetter, fewer));
+    REPORTER_ASSERT(r, !SkPDFResourceCache::FindSubsetFont(*typeface, 1, subsetter, used));
+    REPORTER_ASSERT(r, !SkPDFResourceCache::FindSubsetFont(
+            *typeface, 0, SkPDF::Metadata::kSfntly_Subsetter, used));
+}
+
+static sk_sp<SkData> make_compressed_document(
+        SkPDF::Metadata::CompressionLevel level,
+        SkPDF::Metadata::CompressionStrategy strategy =
+                SkPDF::Metadata::CompressionStrategy::Default) {
+    SkDynamicMemoryWStream stream;
+    SkPDF::Metadata metadata;
+    metadata.fCompressionLevel = level;
+    metadata.fCompressionStrategy = strategy;
+    auto doc = SkPDF::MakeDocument(&stream, metadata);
+    SkCanvas* canvas = doc->beginPage(200, 200);
+    for (int i = 0; i < 100; ++i) {
+        canvas->drawRect(SkRect::MakeXYWH(i, i, 10, 10), SkPaint());
+    }
+    doc->close();
+    return stream.detachAsData();
+}
+
+DEF_TEST(SkPDF_compression_levels, r) {
+    REQUIRE_PDF_DOCUMENT(SkPDF_compression_levels, r);
+    using CompressionLevel = SkPDF::Metadata::CompressionLevel;
+    sk_sp<SkData> none = make_compressed_document(CompressionLevel::None);
+    REPORTER_ASSERT(r, count_occurrences(none.get(), " re\n") == 100);
+    REPORTER_ASSERT(r, count_occurrences(none.get(), "/FlateDecode") == 0);
+    for (CompressionLevel level : {CompressionLevel::Default, CompressionLevel::LowButFast,
+                                   CompressionLevel::HighButSlow}) {
+        sk_sp<SkData> compressed = make_compressed_document(level);
+        REPORTER_ASSERT(r, count_occurrences(compressed.get(), " re\n") == 0);
+        REPORTER_ASSERT(r, count_occurrences(compressed.get(), "/FlateDecode") == 1);
+        REPORTER_ASSERT(r, compressed->size() < none->size());
+    }
+}
+
+DEF_TEST(SkPDF_compression_strategies, r) {
+    REQUIRE_PDF_DOCUMENT(SkPDF_compression_strategies, r);
+    using CompressionLevel = SkPDF::Metadata::CompressionLevel;
+    using CompressionStrategy = SkPDF::Metadata::CompressionStrategy;
+    sk_sp<SkData> none = make_compressed_document(CompressionLevel::None);
+    sk_sp<SkData> deflated = make_compressed_document(CompressionLevel::Default);
+    sk_sp<SkData> huffman = make_compressed_document(CompressionLevel::Default,
+                                                     CompressionStrategy::HuffmanOnly);
+    // Huffman coding alone still compresses, but finds none of the repeated operators.
+    REPORTER_ASSERT(r, count_occurrences(huffman.get(), "/FlateDecode") == 1);
+    REPORTER_ASSERT(r, huffman->size() < none->size());
+    REPORTER_ASSERT(r, huffman->size() > deflated->size());
+    for (CompressionStrategy strategy : {CompressionStrategy::Filtered,
+                                         CompressionStrategy::RLE}) {
+        sk_sp<SkData> compressed = make_compressed_document(CompressionLevel::Default, strategy);
+        REPORTER_ASSERT(r, count_occurrences(compressed.get(), "/FlateDecode") == 1);
+        REPORTER_ASSERT(r, compressed->size() < none->size());
+    }
+}
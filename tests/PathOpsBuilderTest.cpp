@@ -6,9 +6,13 @@
  */
 
 #include "include/core/SkBitmap.h"
+#include "include/core/SkCanvas.h"
+#include "include/core/SkExecutor.h"
+#include "include/utils/SkRandom.h"
 #include "tests/PathOpsExtendedTest.h"
 #include "tests/PathOpsTestCommon.h"
 #include "tests/Test.h"
+#include "tools/ToolUtils.h"
 
 DEF_TEST(PathOpsBuilder, reporter) {
     SkOpBuilder builder;
@@ -361,3 +365,73 @@ SkOpBuilder builder;
     builder.add(path1, SkPathOp::kUnion_SkPathOp);
     builder.resolve(&path);
 }
+
+DEF_TEST(SkOpBuilderResolveInParallel, reporter) {
+    constexpr int kSize = 512;
+
+    // Clusters of overlapping circles, rects and triangles, like map features, and strays.
+    SkRandom rand;
+    SkTArray<SkPath> paths;
+    for (int cluster = 0; cluster < 12; ++cluster) {
+        const float cx = rand.nextRangeF(40, kSize - 40), cy = rand.nextRangeF(40, kSize - 40);
+        for (int i = 0; i < 25; ++i) {
+            const float x = cx + rand.nextRangeF(-30, 30), y = cy + rand.nextRangeF(-30, 30),
+                        r = rand.nextRangeF(2, 12);
+            SkPath& path = paths.push_back();
+            switch (i % 3) {
+                case 0: path.addCircle(x, y, r); break;
+                case 1: path.addRect({x - r, y - r / 2, x + r, y + r / 2}); break;
+                case 2: path.moveTo(x, y - r);
+                        path.lineTo(x + r, y + r);
+                        path.lineTo(x - r, y + r * 0.5f);
+                        break;
+            }
+        }
+    }
+    for (int i = 0; i < 40; ++i) {
+        paths.push_back().addCircle(rand.nextRangeF(0, kSize), rand.nextRangeF(0, kSize), 3);
+    }
+
+    auto rasterize = [&](const SkPath& path) {
+        SkBitmap bitmap;
+        bitmap.allocPixels(SkImageInfo::MakeA8(kSize, kSize));
+        bitmap.eraseColor(SK_ColorTRANSPARENT);
+        SkCanvas(bitmap).drawPath(path, SkPaint());
+        return bitmap;
+    };
+    auto union_of = [&](SkExecutor* executor) {
+        SkOpBuilder builder;
+        for (const SkPath& path : paths) {
+            builder.add(path, kUnion_SkPathOp);
+        }
+        SkPath result;
+        REPORTER_ASSERT(reporter, executor ? builder.resolveInParallel(&result, executor)
+                                           : builder.resolve(&result));
+        return result;
+    };
+
+    // The result doesn't depend on the threads, and covers exactly what resolve()'s does.
+    const SkPath parallel = union_of(ToolUtils::make_executor(4).get());
+    REPORTER_ASSERT(reporter, parallel == union_of(ToolUtils::make_executor(0).get()));
+    SkBitmap expected = rasterize(union_of(nullptr)), actual = rasterize(parallel);
+    int diffs = 0;
+    for (int y = 0; y < kSize; ++y) {
+        for (int x = 0; x < kSize; ++x) {
+            diffs += *expected.getAddr8(x, y) != *actual.getAddr8(x, y);
+        }
+    }
+    REPORTER_ASSERT(reporter, diffs == 0);
+
+    // Any other op falls back to resolve().
+    SkOpBuilder builder;
+    for (const SkPath& path : paths) {
+        builder.add(path, &path == &paths.back() ? kDifference_SkPathOp : kUnion_SkPathOp);
+    }
+    SkPath fallback, serial;
+    REPORTER_ASSERT(reporter, builder.resolveInParallel(&fallback));
+    for (const SkPath& path : paths) {
+        builder.add(path, &path == &paths.back() ? kDifference_SkPathOp : kUnion_SkPathOp);
+    }
+    REPORTER_ASSERT(reporter, builder.resolve(&serial));
+    REPORTER_ASSERT(reporter, fallback == serial);
+}
@@ -5,6 +5,7 @@
  * found in the LICENSE file.
  */
 #include "tests/PathOpsExtendedTest.h"
+#include "tools/ToolUtils.h"
 
 #define TEST(name) { name, #name }
 
@@ -9854,3 +9855,14 @@ DEF_TEST(PathOpsSimplify, reporter) {
         RunTestSet(reporter, subTests, subTestCount, firstSubTest, nullptr, stopTest, runReverse);
     }
 }
+
+// Contours with enough segments that their intersections are found by sweeping their bounds.
+DEF_TEST(PathOpsBigContours, reporter) {
+    SkPath one = ToolUtils::make_coastline({500, 500}, 300, 512, 1),
+           two = ToolUtils::make_coastline({560, 530}, 280, 512, 2);
+    testPathOp(reporter, one, two, kUnion_SkPathOp, "bigContoursUnion");
+    testPathOp(reporter, one, two, kIntersect_SkPathOp, "bigContoursIntersect");
+    testPathOp(reporter, one, two, kDifference_SkPathOp, "bigContoursDifference");
+    one.addPath(two);
+    testSimplify(reporter, one, "bigContoursSimplify");
+}
@@ -6,6 +6,7 @@
  */
 
 #include "include/utils/SkRandom.h"
+#include "src/core/SkPackedRTree.h"
 #include "src/core/SkRTree.h"
 #include "tests/Test.h"
 
@@ -25,10 +26,11 @@ static SkRect random_rect(SkRandom& rand) {
     return rect;
 }
 
-static bool verify_query(SkRect query, SkRect rects[], const std::vector<int>& found) {
+static bool verify_query(SkRect query, SkRect rects[], const std::vector<int>& found,
+                         int numRects = NUM_RECTS) {
     std::vector<int> expected;
     // manually intersect with every rectangle
-    for (int i = 0; i < NUM_RECTS; ++i) {
+    for (int i = 0; i < numRects; ++i) {
         if (SkRect::Intersects(query, rects[i])) {
             expected.push_back(i);
         }
@@ -44,12 +46,12 @@ static bool verify_query(SkRect query, SkRect rects[], const std::vector<int>& f
 }
 
 static void run_queries(skiatest::Reporter* reporter, SkRandom& rand, SkRect rects[],
-                        const SkRTree& tree) {
+                        const SkBBoxHierarchy& tree, int numRects = NUM_RECTS) {
     for (size_t i = 0; i < NUM_QUERIES; ++i) {
         std::vector<int> hits;
         SkRect query = random_rect(rand);
         tree.search(query, &hits);
-        REPORTER_ASSERT(reporter, verify_query(query, rects, hits));
+        REPORTER_ASSERT(reporter, verify_query(query, rects, hits, numRects));
     }
 }
 
@@ -89,3 +91,40 @@ DEF_TEST(RTree, reporter) {
                                   expectedDepthMax >= rtree.getDepth());
     }
 }
+
+DEF_TEST(PackedRTree, reporter) {
+    SkRandom rand;
+    for (int numRects : {1, 16, 17, NUM_RECTS, 5000}) {
+        SkAutoTMalloc<SkRect> rects(numRects);
+        for (size_t i = 0; i < NUM_ITERATIONS / 10; ++i) {
+            for (int j = 0; j < numRects; j++) {
+                rects[j] = random_rect(rand);
+            }
+            SkPackedRTree tree;
+            tree.insert(rects.get(), numRects);
+
+            // Results must come back in op order, even though the tree reorders rects.
+            run_queries(reporter, rand, rects, tree, numRects);
+            REPORTER_ASSERT(reporter, numRects == tree.getCount());
+
+            int expectedDepth = 1;
+            for (int n = numRects; n > SkPackedRTree::kFanout;
+                 n = (n + SkPackedRTree::kFanout - 1) / SkPackedRTree::kFanout) {
+                expectedDepth++;
+            }
+            REPORTER_ASSERT(reporter, expectedDepth == tree.getDepth());
+        }
+    }
+
+    // Empty rects are never found, and an empty query finds nothing.
+    SkRect rects[] = {{0, 0, 10, 10}, {5, 5, 5, 20}, {0, 0, 100, 100}};
+    SkPackedRTree tree;
+    tree.insert(rects, SK_ARRAY_COUNT(rects));
+    REPORTER_ASSERT(reporter, 2 == tree.getCount());
+    std::vector<int> hits;
+    tree.search(SkRect::MakeLTRB(4, 4, 6, 6), &hits);
+    REPORTER_ASSERT(reporter, (hits == std::vector<int>{0, 2}));
+    hits.clear();
+    tree.search(SkRect::MakeLTRB(4, 4, 4, 6), &hits);
+    REPORTER_ASSERT(reporter, hits.empty());
+}
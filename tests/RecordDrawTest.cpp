@@ -175,6 +175,41 @@ DEF_TEST(RecordDraw_PartialStartStop, r) {
     REPORTER_ASSERT(r, drawRect->rect == r2);
 }
 
+// Each canvas should replay just the draws that touch it, plus any state that outlives the record.
+DEF_TEST(RecordDraw_Threaded, r) {
+    SkRecord record;
+    SkRecorder recorder(&record, W, H);
+    recorder.drawRect(SkRect::MakeWH(100, 100), SkPaint());  // Top tile only.
+    recorder.save();
+    recorder.translate(0, 600);
+    recorder.drawRect(SkRect::MakeWH(100, 100), SkPaint());  // Bottom tile only.
+    recorder.restore();
+    recorder.scale(2, 2);                                     // Outlives the record.
+    recorder.save();                                          // Left open...
+    recorder.clipRect(SkRect::MakeWH(50, 50));                // ...so this outlives it too.
+
+    SkRecord top, bottom;
+    SkRecorder topCanvas(&top, W, H), bottomCanvas(&bottom, W, H);
+    topCanvas.clipRect(SkRect::MakeWH(W, H/2));
+    bottomCanvas.clipRect(SkRect::MakeLTRB(0, H/2, W, H));
+    SkCanvas* canvases[] = {&topCanvas, &bottomCanvas};
+    SkRecordDrawThreaded(record, SkRect::MakeWH(W, H), canvases, nullptr, 2, nullptr, 0,
+                         SkM44(), nullptr);
+
+    REPORTER_ASSERT(r, 1 == count_instances_of_type<SkRecords::DrawRect>(top));
+    REPORTER_ASSERT(r, 0 == count_instances_of_type<SkRecords::Translate>(top));
+    REPORTER_ASSERT(r, 0 == count_instances_of_type<SkRecords::Restore>(top));
+    REPORTER_ASSERT(r, 1 == count_instances_of_type<SkRecords::DrawRect>(bottom));
+    REPORTER_ASSERT(r, 1 == count_instances_of_type<SkRecords::Translate>(bottom));
+    REPORTER_ASSERT(r, 1 == count_instances_of_type<SkRecords::Restore>(bottom));
+    for (SkRecorder* canvas : {&topCanvas, &bottomCanvas}) {
+        REPORTER_ASSERT(r, 2 == canvas->getSaveCount());
+        REPORTER_ASSERT(r, canvas->getTotalMatrix() == SkMatrix::Scale(2, 2));
+    }
+    REPORTER_ASSERT(r, topCanvas.getDeviceClipBounds() == SkIRect::MakeWH(100, 100));
+    REPORTER_ASSERT(r, bottomCanvas.getDeviceClipBounds().isEmpty());
+}
+
 // A regression test for crbug.com/415468 and https://bug.skia.org/2957 .
 //
 // This also now serves as a regression test for crbug.com/418417.  We used to adjust the
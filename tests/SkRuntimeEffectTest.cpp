@@ -9,11 +9,14 @@
 #include "include/core/SkCanvas.h"
 #include "include/core/SkColorFilter.h"
 #include "include/core/SkData.h"
+#include "include/core/SkExecutor.h"
+#include "include/core/SkGraphics.h"
 #include "include/core/SkPaint.h"
 #include "include/core/SkSurface.h"
 #include "include/effects/SkRuntimeEffect.h"
 #include "include/gpu/GrDirectContext.h"
 #include "src/core/SkColorSpacePriv.h"
+#include "src/core/SkCoreBlitters.h"
 #include "src/core/SkRuntimeEffectPriv.h"
 #include "src/core/SkTLazy.h"
 #include "src/gpu/GrColor.h"
@@ -579,6 +582,76 @@ DEF_TEST(SkRuntimeColorFilterFlags, r) {
     }
 }
 
+DEF_TEST(SkRuntimeEffectPrecompile, r) {
+    // Shaders no other test uses, so their programs can only come from this test.
+    // Each swizzles color = {0,1,0,1} to red.
+    auto make_paint = [&](const char* sksl) {
+        auto [effect, err] = SkRuntimeEffect::MakeForShader(SkString{sksl});
+        REPORTER_ASSERT(r, effect && err.isEmpty());
+
+        const SkV4 color = {0, 1, 0, 1};
+        SkPaint paint;
+        paint.setShader(effect->makeShader(SkData::MakeWithCopy(&color, sizeof(color)),
+                                           nullptr, 0, nullptr, /*isOpaque=*/false));
+        paint.setBlendMode(SkBlendMode::kSrc);
+        return paint;
+    };
+
+    auto draw_and_check = [&](const SkRuntimeEffect::PrecompileTarget& target) {
+        sk_sp<SkSurface> surface = SkSurface::MakeRaster(target.info.makeWH(2, 2));
+        surface->getCanvas()->drawPaint(target.paint);
+
+        SkBitmap bitmap;
+        bitmap.allocPixels(SkImageInfo::MakeN32Premul(2, 2));
+        REPORTER_ASSERT(r, surface->readPixels(bitmap, 0, 0));
+        for (int y = 0; y < 2; y++)
+        for (int x = 0; x < 2; x++) {
+            REPORTER_ASSERT(r, bitmap.getColor(x, y) == SK_ColorRED,
+                            "0x%08x", bitmap.getColor(x, y));
+        }
+
+        // An anti-aliased edge needs the partial coverage program too.
+        SkPaint aa = target.paint;
+        aa.setAntiAlias(true);
+        surface->getCanvas()->drawRect(SkRect::MakeLTRB(0.5f, 0.5f, 1.5f, 1.5f), aa);
+    };
+
+    {
+        SkPaint paint = make_paint(
+                "uniform half4 color; half4 main(float2 p) { return color.gbra; }");
+        SkRuntimeEffect::PrecompileTarget targets[] = {
+            {paint, SkImageInfo::MakeN32Premul(1, 1)},
+            {paint, SkImageInfo::Make(1, 1, kRGBA_F16_SkColorType, kPremul_SkAlphaType)},
+        };
+        SkRuntimeEffect::Precompile(targets, SK_ARRAY_COUNT(targets));
+
+        // Everything these draws need was just compiled, so they must not miss at all.
+        // Lookups are counted on this thread alone, so other tests can't disturb the counts.
+        SkGraphics::ProgramCacheStats before = SkVMBlitterThreadProgramCacheStats();
+        for (const auto& target : targets) {
+            draw_and_check(target);
+        }
+        SkGraphics::ProgramCacheStats after = SkVMBlitterThreadProgramCacheStats();
+        REPORTER_ASSERT(r, after.fMisses == before.fMisses);
+        REPORTER_ASSERT(r, after.fHits   >  before.fHits);
+    }
+
+    {
+        // Draws racing with an asynchronous precompile must wait for it, not see half a program.
+        SkPaint paint = make_paint(
+                "uniform half4 color; half4 main(float2 p) { return color.grba; }");
+        SkRuntimeEffect::PrecompileTarget targets[] = {
+            {paint, SkImageInfo::MakeN32Premul(1, 1)},
+            {paint, SkImageInfo::Make(1, 1, kRGBA_F16_SkColorType, kPremul_SkAlphaType)},
+        };
+        std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(2);
+        SkRuntimeEffect::Precompile(targets, SK_ARRAY_COUNT(targets), executor.get());
+        for (const auto& target : targets) {
+            draw_and_check(target);
+        }
+    }
+}
+
 DEF_TEST(SkRuntimeShaderSampleCoords, r) {
     // This test verifies that we detect calls to sample where the coords are the same as those
     // passed to main. In those cases, it's safe to turn the "explicit" sampling into "passthrough"
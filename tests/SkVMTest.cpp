@@ -5,10 +5,21 @@
  * found in the LICENSE file.
  */
 
+#include "include/core/SkBitmap.h"
 #include "include/core/SkColorPriv.h"
+#include "include/core/SkColorSpace.h"
+#include "include/core/SkData.h"
+#include "include/core/SkExecutor.h"
+#include "include/core/SkGraphics.h"
+#include "include/core/SkPaint.h"
 #include "include/private/SkColorData.h"
+#include "src/core/SkArenaAlloc.h"
+#include "src/core/SkAutoMalloc.h"
+#include "src/core/SkCoreBlitters.h"
 #include "src/core/SkCpu.h"
 #include "src/core/SkMSAN.h"
+#include "src/core/SkMatrixProvider.h"
+#include "src/core/SkTaskGroup.h"
 #include "src/core/SkVM.h"
 #include "tests/Test.h"
 
@@ -135,6 +146,58 @@ DEF_TEST(SkVM_LoopCounts, r) {
     });
 }
 
+DEF_TEST(SkVM_Serialize, r) {
+    // buf[i] = buf[i] * 3 + uniform
+    skvm::Builder b;
+    skvm::Ptr uniforms = b.uniform(),
+              arg      = b.varying<int>();
+    b.store32(arg, b.add(b.mul(b.load32(arg), b.splat(3)),
+                         b.uniform32(uniforms, 0)));
+
+    // Only Programs built to be serialized keep what serialize() needs.
+    REPORTER_ASSERT(r, !b.done().serialize());
+
+    auto test = [&](const skvm::Program& program) {
+        sk_sp<SkData> data = program.serialize();
+        REPORTER_ASSERT(r, data);
+
+        for (bool allow_jit : {false, true}) {
+            skvm::Program copy = skvm::Program::Deserialize(data->data(), data->size(),
+                                                            nullptr, allow_jit);
+            REPORTER_ASSERT(r, !copy.empty());
+            if (!allow_jit) {
+                REPORTER_ASSERT(r, !copy.hasJIT());
+            }
+
+            int uniform = 7;
+            int buf[37];
+            for (int i = 0; i < (int)SK_ARRAY_COUNT(buf); i++) {
+                buf[i] = i;
+            }
+            copy.eval(SK_ARRAY_COUNT(buf), &uniform, buf);
+            for (int i = 0; i < (int)SK_ARRAY_COUNT(buf); i++) {
+                REPORTER_ASSERT(r, buf[i] == i*3 + 7);
+            }
+        }
+
+        // Any corruption or truncation should be caught, leaving an empty Program.
+        SkAutoMalloc copy(data->size());
+        for (size_t i = 0; i < data->size(); i += 4) {
+            memcpy(copy.get(), data->data(), data->size());
+            static_cast<uint8_t*>(copy.get())[i] ^= 0x40;
+            REPORTER_ASSERT(r, skvm::Program::Deserialize(copy.get(), data->size()).empty());
+        }
+        REPORTER_ASSERT(r, skvm::Program::Deserialize(data->data(), data->size() - 4).empty());
+    };
+    test(b.done(/*debug_name=*/nullptr, /*allow_jit=*/true,  /*serializable=*/true));
+    test(b.done(/*debug_name=*/nullptr, /*allow_jit=*/false, /*serializable=*/true));
+
+    // Only the instructions are persisted, never machine code, so JITting can't change the bytes.
+    sk_sp<SkData> jit   = b.done(nullptr, /*allow_jit=*/true,  /*serializable=*/true).serialize(),
+                  nojit = b.done(nullptr, /*allow_jit=*/false, /*serializable=*/true).serialize();
+    REPORTER_ASSERT(r, jit->equals(nojit.get()));
+}
+
 DEF_TEST(SkVM_gather32, r) {
     skvm::Builder b;
     {
@@ -1485,6 +1548,94 @@ DEF_TEST(SkVM_Assembler, r) {
         0xc4,0xe2,0x1d,0x92,0x04,0xd0,
     });
 
+    test_asm(r, [&](A& a) {
+        a.vinserti128(A::ymm1, A::ymm2, A::xmm3, 1);
+        a.bzhi(A::rax, A::rax, A::rdi);
+        a.kmovw(A::k1, A::rax);
+        a.kmovw(A::k2, A::k1);
+    },{
+        0xc4,0xe3,0x6d, 0x38,0xcb, 0x01,
+        0xc4,0xe2,0xc0, 0xf5,0xc0,
+        0xc5,     0xf8, 0x92,0xc8,
+        0xc5,     0xf8, 0x90,0xd1,
+    });
+
+    // With use_zmm(true), Ymm instructions are EVEX encoded for 512-bit zmm registers.
+    // EVEX memory operands always use a 32-bit displacement (mod=10) when there is one.
+    test_asm(r, [&](A& a) {
+        a.use_zmm(true);
+        a.vpaddd(A::ymm0, A::ymm1, A::ymm2);
+        a.vpaddd(A::ymm8, A::ymm9, A::ymm10);
+        a.vaddps(A::ymm1, A::ymm2, A::Mem{A::rsp, 64});
+        a.vmovups(A::Mem{A::rsp, 128}, A::ymm12);
+        a.vpslld(A::ymm15, A::ymm2, 8);
+        a.vbroadcastss(A::ymm1, A::xmm1);
+        a.vextracti128(A::xmm2, A::ymm3, 3);
+        a.vinserti128(A::ymm1, A::ymm2, A::xmm3, 1);
+        a.vcvtps2ph(A::ymm4, A::ymm5, A::CURRENT);
+        a.vmovd(A::xmm1, A::rax);
+    },{
+        0x62,0xf1,0x75,0x48, 0xfe,0xc2,
+        0x62,0x51,0x35,0x48, 0xfe,0xc2,
+        0x62,0xf1,0x6c,0x48, 0x58,0x8c,0x24, 0x40,0x00,0x00,0x00,
+        0x62,0x71,0x7c,0x48, 0x11,0xa4,0x24, 0x80,0x00,0x00,0x00,
+        0x62,0xf1,0x05,0x48, 0x72,0xf2, 0x08,
+        0x62,0xf2,0x7d,0x48, 0x18,0xc9,
+        0x62,0xf3,0x7d,0x48, 0x39,0xda, 0x03,
+        0x62,0xf3,0x6d,0x48, 0x38,0xcb, 0x01,
+        0x62,0xf3,0x7d,0x48, 0x1d,0xec, 0x04,
+        0xc5,0xf9, 0x6e,0xc8,
+    });
+
+    test_asm(r, [&](A& a) {
+        a.use_zmm(true);
+        a.vmovdqu32(A::ymm1 , A::Mem{A::rsi}, A::k1);
+        a.vmovdqu32(A::Mem{A::rsi}, A::ymm9 , A::k1);
+        a.vpmovzxbd(A::ymm2 , A::Mem{A::rdx}, A::k1);
+        a.vpmovzxwd(A::ymm10, A::Mem{A::r8 }, A::k1);
+        a.vpmovdb  (A::Mem{A::rcx}, A::ymm3 , A::k1);
+        a.vpmovdw  (A::Mem{A::r9 }, A::ymm11, A::k1);
+        a.vpmovdw  (A::ymm2, A::ymm3, A::k0);
+    },{
+        0x62,0xf1,0x7e,0xc9, 0x6f,0x0e,
+        0x62,0x71,0x7e,0x49, 0x7f,0x0e,
+        0x62,0xf2,0x7d,0xc9, 0x31,0x12,
+        0x62,0x52,0x7d,0xc9, 0x33,0x10,
+        0x62,0xf2,0x7e,0x49, 0x31,0x19,
+        0x62,0x52,0x7e,0x49, 0x33,0x19,
+        0x62,0xf2,0x7e,0x48, 0x33,0xda,
+    });
+
+    test_asm(r, [&](A& a) {
+        a.use_zmm(true);
+        a.vpcmpeqd(A::k2, A::ymm1, A::ymm2);
+        a.vpcmpgtd(A::k2, A::ymm9, A::Mem{A::rsp, 64});
+        a.vcmpps  (A::k2, A::ymm1, A::ymm12, 1);
+        a.vpmovm2d(A::ymm3, A::k2);
+        a.vpmovd2m(A::k2, A::ymm11);
+        a.vpblendmd(A::ymm1, A::k2, A::ymm2, A::ymm3);
+    },{
+        0x62,0xf1,0x75,0x48, 0x76,0xd2,
+        0x62,0xf1,0x35,0x48, 0x66,0x94,0x24, 0x40,0x00,0x00,0x00,
+        0x62,0xd1,0x74,0x48, 0xc2,0xd4, 0x01,
+        0x62,0xf2,0x7e,0x48, 0x38,0xda,
+        0x62,0xd2,0x7e,0x48, 0x39,0xd3,
+        0x62,0xf2,0x6d,0x4a, 0x64,0xcb,
+    });
+
+    test_asm(r, [&](A& a) {
+        a.use_zmm(true);
+        a.vpgatherdd (A::ymm1, A::FOUR, A::ymm2 , A::rax, 0, A::k2);
+        a.vpgatherdd (A::ymm9, A::FOUR, A::ymm12, A::r10, 4, A::k2);
+        a.vpscatterdd(A::FOUR, A::ymm2 , A::rsi, 0, A::ymm3 , A::k2);
+        a.vpscatterdd(A::FOUR, A::ymm10, A::r9 , 8, A::ymm11, A::k2);
+    },{
+        0x62,0xf2,0x7d,0x4a, 0x90,0x0c,0x90,
+        0x62,0x12,0x7d,0x4a, 0x90,0x8c,0xa2, 0x04,0x00,0x00,0x00,
+        0x62,0xf2,0x7d,0x4a, 0xa0,0x1c,0x96,
+        0x62,0x12,0x7d,0x4a, 0xa0,0x9c,0x91, 0x08,0x00,0x00,0x00,
+    });
+
     test_asm(r, [&](A& a) {
         a.mov(A::rax, A::Mem{A::rdi,   0});
         a.mov(A::rax, A::Mem{A::rdi,   1});
@@ -2538,3 +2689,332 @@ DEF_TEST(SkVM_fast_mul, r) {
         }
     });
 }
+
+DEF_TEST(SkVM_JIT_matches_interpreter, r) {
+    // Each case is one op (or a short idiom) that the blitters or SkSL code generator use,
+    // run through the JIT and the interpreter and compared bit for bit.  The inputs are small
+    // multiples of powers of two so every result is exact, and 37 lanes exercise the vector
+    // loop and the scalar tail for any lane width.
+    using Op = skvm::I32(*)(skvm::Builder*, skvm::F32, skvm::F32, skvm::F32);
+    struct {
+        const char* name;
+        Op          op;
+    } cases[] = {
+        {"add_f32",  [](skvm::Builder* b, skvm::F32 x, skvm::F32 y, skvm::F32) {
+            return b->pun_to_I32(x + y); }},
+        {"sub_f32",  [](skvm::Builder* b, skvm::F32 x, skvm::F32 y, skvm::F32) {
+            return b->pun_to_I32(x - y); }},
+        {"mul_f32",  [](skvm::Builder* b, skvm::F32 x, skvm::F32 y, skvm::F32) {
+            return b->pun_to_I32(x * y); }},
+        {"div_f32",  [](skvm::Builder* b, skvm::F32 x, skvm::F32 y, skvm::F32) {
+            return b->pun_to_I32(x / y); }},
+        {"min_f32",  [](skvm::Builder* b, skvm::F32 x, skvm::F32 y, skvm::F32) {
+            return b->pun_to_I32(min(x, y)); }},
+        {"max_f32",  [](skvm::Builder* b, skvm::F32 x, skvm::F32 y, skvm::F32) {
+            return b->pun_to_I32(max(x, y)); }},
+        {"fma_f32",  [](skvm::Builder* b, skvm::F32 x, skvm::F32 y, skvm::F32 z) {
+            return b->pun_to_I32(x * y + z); }},
+        {"fms_f32",  [](skvm::Builder* b, skvm::F32 x, skvm::F32 y, skvm::F32 z) {
+            return b->pun_to_I32(x * y - z); }},
+        {"fnma_f32", [](skvm::Builder* b, skvm::F32 x, skvm::F32 y, skvm::F32 z) {
+            return b->pun_to_I32(z - x * y); }},
+        {"sqrt_f32", [](skvm::Builder* b, skvm::F32 x, skvm::F32, skvm::F32) {
+            return b->pun_to_I32(sqrt(abs(x))); }},
+        {"ceil",     [](skvm::Builder* b, skvm::F32 x, skvm::F32, skvm::F32) {
+            return b->pun_to_I32(ceil(x)); }},
+        {"floor",    [](skvm::Builder* b, skvm::F32 x, skvm::F32, skvm::F32) {
+            return b->pun_to_I32(floor(x)); }},
+        {"trunc",    [](skvm::Builder*, skvm::F32 x, skvm::F32, skvm::F32) {
+            return trunc(x); }},
+        {"round",    [](skvm::Builder*, skvm::F32 x, skvm::F32, skvm::F32) {
+            return round(x); }},
+        {"to_f32",   [](skvm::Builder* b, skvm::F32 x, skvm::F32, skvm::F32) {
+            return b->pun_to_I32(to_F32(trunc(x * 7.0f))); }},
+        {"eq_f32",   [](skvm::Builder*, skvm::F32 x, skvm::F32 y, skvm::F32) { return x == y; }},
+        {"neq_f32",  [](skvm::Builder*, skvm::F32 x, skvm::F32 y, skvm::F32) { return x != y; }},
+        {"gt_f32",   [](skvm::Builder*, skvm::F32 x, skvm::F32 y, skvm::F32) { return x >  y; }},
+        {"gte_f32",  [](skvm::Builder*, skvm::F32 x, skvm::F32 y, skvm::F32) { return x >= y; }},
+        {"add_i32",  [](skvm::Builder*, skvm::F32 x, skvm::F32 y, skvm::F32) {
+            return trunc(x * 4.0f) + trunc(y * 4.0f); }},
+        {"sub_i32",  [](skvm::Builder*, skvm::F32 x, skvm::F32 y, skvm::F32) {
+            return trunc(x * 4.0f) - trunc(y * 4.0f); }},
+        {"mul_i32",  [](skvm::Builder*, skvm::F32 x, skvm::F32 y, skvm::F32) {
+            return trunc(x * 4.0f) * trunc(y * 4.0f); }},
+        {"shl_i32",  [](skvm::Builder*, skvm::F32 x, skvm::F32, skvm::F32) {
+            return shl(trunc(x * 4.0f), 3); }},
+        {"shr_i32",  [](skvm::Builder*, skvm::F32 x, skvm::F32, skvm::F32) {
+            return shr(trunc(x * 4.0f), 3); }},
+        {"sra_i32",  [](skvm::Builder*, skvm::F32 x, skvm::F32, skvm::F32) {
+            return sra(trunc(x * 4.0f), 3); }},
+        {"eq_i32",   [](skvm::Builder*, skvm::F32 x, skvm::F32 y, skvm::F32) {
+            return trunc(x) == trunc(y); }},
+        {"gt_i32",   [](skvm::Builder*, skvm::F32 x, skvm::F32 y, skvm::F32) {
+            return trunc(x) > trunc(y); }},
+        {"bit_ops",  [](skvm::Builder* b, skvm::F32 x, skvm::F32 y, skvm::F32 z) {
+            skvm::I32 X = b->pun_to_I32(x),
+                      Y = b->pun_to_I32(y),
+                      Z = b->pun_to_I32(z);
+            return bit_clear((X & Y) | Z, X ^ Y); }},
+        {"select",   [](skvm::Builder*, skvm::F32 x, skvm::F32 y, skvm::F32 z) {
+            return select(x > y, trunc(x), trunc(z)); }},
+        {"to_fp16",  [](skvm::Builder*, skvm::F32 x, skvm::F32, skvm::F32) {
+            return to_fp16(x); }},
+        {"fp16",     [](skvm::Builder* b, skvm::F32 x, skvm::F32, skvm::F32) {
+            return b->pun_to_I32(from_fp16(to_fp16(x))); }},
+    };
+
+    constexpr int N = 37;
+    float X[N], Y[N], Z[N];
+    for (int i = 0; i < N; i++) {
+        X[i] = (i - 20) * 0.25f;
+        Y[i] = (i % 7 + 1) * 0.5f;  // Never zero, so div_f32 stays finite.
+        Z[i] = (i % 5 - 2) * 0.75f;
+    }
+
+    for (const auto& c : cases) {
+        skvm::Builder b;
+        {
+            skvm::Ptr px = b.varying<float>(),
+                      py = b.varying<float>(),
+                      pz = b.varying<float>(),
+                      pd = b.varying<int>();
+            b.store32(pd, c.op(&b, b.loadF(px), b.loadF(py), b.loadF(pz)));
+        }
+
+        // The interpreter's results are the reference the JIT must match.
+        int expected[N];
+        b.done(c.name, /*allow_jit=*/false).eval(N, X, Y, Z, expected);
+
+        test_jit_and_interpreter(b, [&](const skvm::Program& program) {
+            int actual[N];
+            program.eval(N, X, Y, Z, actual);
+            for (int i = 0; i < N; i++) {
+                if (actual[i] != expected[i]) {
+                    ERRORF(r, "%s lane %d: %s %08x, interpreter %08x", c.name, i,
+                           program.hasJIT() ? "JIT" : "interpreter", actual[i], expected[i]);
+                }
+            }
+        });
+    }
+}
+
+DEF_TEST(SkVM_tail_stays_in_bounds, r) {
+    // With AVX-512 the last few lanes run under a mask instead of one at a time.
+    // Whatever the lane width, no store may write past N, for every store width.
+    skvm::Builder b;
+    {
+        skvm::Ptr src   = b.varying<int>(),
+                  dst8  = b.varying<uint8_t>(),
+                  dst16 = b.varying<uint16_t>(),
+                  dst32 = b.varying<int>(),
+                  dst64 = b.varying<uint64_t>(),
+                  dst128 = b.arg(16);
+        skvm::I32 x = b.load32(src);
+        b.store8  (dst8 , x);
+        b.store16 (dst16, x);
+        b.store32 (dst32, x);
+        b.store64 (dst64, x, x);
+        b.store128(dst128, x,x,x,x);
+    }
+
+    test_jit_and_interpreter(b, [&](const skvm::Program& program) {
+        constexpr int kMax = 40;
+        int src[kMax];
+        for (int i = 0; i < kMax; i++) {
+            src[i] = i+1;
+        }
+
+        for (int N = 0; N < kMax; N++) {
+            uint8_t  d8  [kMax];
+            uint16_t d16 [kMax];
+            int      d32 [kMax];
+            int      d64 [2*kMax];
+            int      d128[4*kMax];
+            memset(d8  , 0, sizeof(d8  ));
+            memset(d16 , 0, sizeof(d16 ));
+            memset(d32 , 0, sizeof(d32 ));
+            memset(d64 , 0, sizeof(d64 ));
+            memset(d128, 0, sizeof(d128));
+
+            program.eval(N, src, d8, d16, d32, d64, d128);
+            for (int i = 0; i < kMax; i++) {
+                int want = i < N ? i+1 : 0;
+                REPORTER_ASSERT(r, d8  [i] == want);
+                REPORTER_ASSERT(r, d16 [i] == want);
+                REPORTER_ASSERT(r, d32 [i] == want);
+                for (int j = 0; j < 2; j++) { REPORTER_ASSERT(r, d64 [2*i+j] == want); }
+                for (int j = 0; j < 4; j++) { REPORTER_ASSERT(r, d128[4*i+j] == want); }
+            }
+        }
+    });
+}
+
+extern bool gSkVMAllowAVX512;
+
+DEF_TEST(SkVM_AVX512_matches_AVX2, r) {
+    // On CPUs with AVX-512 the JIT runs 16 lanes at a time under an opmask; turning
+    // gSkVMAllowAVX512 off makes it emit the 8-lane AVX2 code instead.  The same programs must
+    // produce identical results either way, for every tail length.  Elsewhere this compares
+    // AVX2 (or the interpreter) with itself, which is still a fine test of determinism.
+    constexpr int kMax = 40;
+    uint8_t  s8  [kMax];
+    uint16_t s16 [kMax];
+    int      s32 [kMax],
+             s64 [2*kMax],
+             s128[4*kMax];
+    for (int i = 0; i < kMax; i++) {
+        s8 [i] = (uint8_t)(i * 37);
+        s16[i] = (uint16_t)(i * 1009);
+        s32[i] = i * 65537 - 1000;
+        for (int j = 0; j < 2; j++) { s64 [2*i+j] = i * 31 + j * 97 - 500; }
+        for (int j = 0; j < 4; j++) { s128[4*i+j] = i * 7 - j * 13; }
+    }
+
+    // A table we gather from through a pointer stored in the uniforms.
+    int table[16];
+    for (int i = 0; i < 16; i++) {
+        table[i] = i * 0x01030507;
+    }
+    struct { int u; int pad; const int* table; } uniforms = {42, 0, table};
+    static_assert(offsetof(decltype(uniforms), table) == 8, "");
+
+    struct Outputs {
+        uint8_t  d8  [kMax];
+        uint16_t d16 [kMax];
+        int      d32 [kMax],
+                 d64 [2*kMax],
+                 d128[4*kMax];
+    };
+
+    // The x86 JIT takes at most six arguments, so we split the ops across two programs.
+    skvm::Builder narrow;
+    {
+        skvm::Ptr uniforms = narrow.uniform(),
+                  src8     = narrow.varying<uint8_t>(),
+                  src16    = narrow.varying<uint16_t>(),
+                  dst8     = narrow.varying<uint8_t>(),
+                  dst16    = narrow.varying<uint16_t>(),
+                  dst32    = narrow.varying<int>();
+        skvm::I32 x8  = narrow.load8 (src8),
+                  x16 = narrow.load16(src16),
+                  u   = narrow.uniform32(uniforms, 0),
+                  ix  = x8 & 15;
+
+        skvm::F32 f = to_F32(x16 - u) * 0.125f,
+                  h = from_fp16(to_fp16(f * f - to_F32(x8)));
+        skvm::I32 m = select(f > h, trunc(f), round(h));
+
+        // store8 and store16 are only defined for values that fit (AVX2 saturates, AVX-512
+        // and the interpreter truncate), so we mask what we store to their width.
+        narrow.store8 (dst8 , (narrow.gather8 (uniforms, 8, ix) ^ x16) & 0xff);
+        narrow.store16(dst16, (narrow.gather16(uniforms, 8, ix) + shl(x8, 4)) & 0xffff);
+        narrow.store32(dst32, narrow.gather32(uniforms, 8, ix) ^ pun_to_I32(h) ^ m);
+    }
+    skvm::Builder wide;
+    {
+        skvm::Ptr uniforms = wide.uniform(),
+                  src32    = wide.varying<int>(),
+                  src64    = wide.varying<uint64_t>(),
+                  src128   = wide.arg(16),
+                  dst64    = wide.varying<uint64_t>(),
+                  dst128   = wide.arg(16);
+        skvm::I32 x  = wide.load32(src32),
+                  lo = wide.load64(src64, 0),
+                  hi = wide.load64(src64, 1),
+                  q0 = wide.load128(src128, 0),
+                  q3 = wide.load128(src128, 3),
+                  u  = wide.uniform32(uniforms, 0);
+        skvm::F32 f = to_F32(x) * 0.25f;
+
+        wide.store64 (dst64 , lo + x, sra(hi, 3) - u);
+        wide.store128(dst128, q0 * x, shr(q3, 1), (lo == hi) | x, pun_to_I32(sqrt(abs(f))));
+    }
+
+    auto run = [&](bool allowAVX512, Outputs out[kMax]) {
+        gSkVMAllowAVX512 = allowAVX512;
+        skvm::Program n = narrow.done(),
+                      w = wide  .done();
+        gSkVMAllowAVX512 = true;
+
+        for (int N = 0; N < kMax; N++) {
+            memset(&out[N], 0, sizeof(Outputs));
+            n.eval(N, &uniforms, s8, s16, out[N].d8, out[N].d16, out[N].d32);
+            w.eval(N, &uniforms, s32, s64, s128, out[N].d64, out[N].d128);
+        }
+        REPORTER_ASSERT(r, n.hasJIT() == w.hasJIT());
+        return n.hasJIT();
+    };
+
+    std::unique_ptr<Outputs[]> avx512(new Outputs[kMax]),
+                               avx2  (new Outputs[kMax]);
+    bool jit512 = run(true , avx512.get()),
+         jit2   = run(false, avx2  .get());
+    REPORTER_ASSERT(r, jit512 == jit2);
+
+    for (int N = 0; N < kMax; N++) {
+        if (0 != memcmp(&avx512[N], &avx2[N], sizeof(Outputs))) {
+            ERRORF(r, "AVX-512 and AVX2 results differ with N=%d", N);
+        }
+    }
+}
+
+DEF_TEST(SkVM_ProgramCacheSharedAcrossThreads, r) {
+    // A color space no other test (or earlier run of this one) uses gives our blitters a Key
+    // of their own.
+    static std::atomic<int> runs{0};
+    float g = 2.345f + 0.001f * runs++;
+    sk_sp<SkColorSpace> cs = SkColorSpace::MakeRGB({g, 1,0,0,0,0,0}, SkNamedGamut::kSRGB);
+    SkImageInfo info = SkImageInfo::Make(16, 16, kRGBA_8888_SkColorType, kPremul_SkAlphaType, cs);
+
+    SkPaint paint;
+    paint.setColor(SK_ColorWHITE);
+    paint.setBlendMode(SkBlendMode::kSrc);
+
+    constexpr int kThreads = 4;
+    SkBitmap bitmaps[kThreads];
+    uint64_t hits  [kThreads] = {0},
+             misses[kThreads] = {0};
+    std::atomic<bool> skvm{true};
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(kThreads);
+    SkTaskGroup(*executor).batch(kThreads, [&](int i) {
+        bitmaps[i].allocPixels(info);
+        bitmaps[i].eraseColor(SK_ColorTRANSPARENT);
+
+        // Other tests may share the cache, so count only the lookups made by this task.
+        SkGraphics::ProgramCacheStats before = SkVMBlitterThreadProgramCacheStats();
+
+        SkSTArenaAlloc<256> alloc;
+        SkSimpleMatrixProvider matrices{SkMatrix::I()};
+        if (SkBlitter* blitter = SkCreateSkVMBlitter(bitmaps[i].pixmap(), paint, matrices,
+                                                     &alloc, /*clipShader=*/nullptr)) {
+            for (int y = 0; y < info.height(); y++) {
+                blitter->blitH(0, y, info.width());
+            }
+        } else {
+            bitmaps[i].eraseColor(SK_ColorWHITE);  // No SkVM support here; nothing to test.
+            skvm = false;
+        }
+        SkGraphics::ProgramCacheStats after = SkVMBlitterThreadProgramCacheStats();
+        hits  [i] = after.fHits   - before.fHits;
+        misses[i] = after.fMisses - before.fMisses;
+    });
+
+    for (const SkBitmap& bitmap : bitmaps) {
+        for (int y = 0; y < info.height(); y++)
+        for (int x = 0; x < info.width(); x++) {
+            REPORTER_ASSERT(r, *bitmap.getAddr32(x,y) == 0xffffffff);
+        }
+    }
+
+    // Our Key is unique to this test, so exactly one task compiles it and the rest share it.
+    if (skvm) {
+        uint64_t totalHits = 0, totalMisses = 0;
+        for (int i = 0; i < kThreads; i++) {
+            totalHits   += hits  [i];
+            totalMisses += misses[i];
+        }
+        REPORTER_ASSERT(r, totalMisses == 1);
+        REPORTER_ASSERT(r, totalHits   == kThreads - 1);
+    }
+    REPORTER_ASSERT(r, SkGraphics::GetProgramCacheUsed() <= SkGraphics::GetProgramCacheLimit());
+}
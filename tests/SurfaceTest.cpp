@@ -7,11 +7,14 @@
 
 #include "include/core/SkCanvas.h"
 #include "include/core/SkData.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkOverdrawCanvas.h"
 #include "include/core/SkPath.h"
+#include "include/core/SkPictureRecorder.h"
 #include "include/core/SkRRect.h"
 #include "include/core/SkRegion.h"
 #include "include/core/SkSurface.h"
+#include "include/effects/SkImageFilters.h"
 #include "include/gpu/GrBackendSurface.h"
 #include "include/gpu/GrDirectContext.h"
 #include "src/core/SkAutoPixmapStorage.h"
@@ -1184,3 +1187,190 @@ DEF_TEST(surface_image_unity, reporter) {
         }
     }
 }
+
+static void draw_threaded_scene(SkCanvas* canvas, int step) {
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    paint.setColor(SkColorSetARGB(0xC0, 0x20 * step, 0x80, 0xF0 - 0x20 * step));
+    canvas->save();
+    canvas->rotate(7.0f * step);
+    canvas->drawCircle(150 + 20 * step, 300, 140, paint);
+    canvas->restore();
+
+    paint.setStyle(SkPaint::kStroke_Style);
+    paint.setStrokeWidth(5);
+    canvas->drawRRect(SkRRect::MakeRectXY(SkRect::MakeXYWH(20, 100 + 50 * step, 300, 400), 40, 40),
+                      paint);
+    // Leave a translate behind, so state must survive across resolves.
+    canvas->translate(3, 11);
+}
+
+// Anti-aliased edges are chopped where they cross a band, so the reference draws each 128-row
+// band separately with the same clip, undoing the translate the scene leaves behind.
+static void draw_threaded_scene_banded(SkCanvas* canvas, int step) {
+    const SkISize size = canvas->getBaseLayerSize();
+    for (int top = 0; top < size.height(); top += 128) {
+        SkAutoCanvasRestore acr(canvas, true);
+        canvas->clipRect(SkRect::MakeLTRB(0, top, size.width(), top + 128));
+        canvas->translate(3 * step, 11 * step);
+        draw_threaded_scene(canvas, step);
+    }
+}
+
+DEF_TEST(SurfaceRasterThreaded, reporter) {
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+    const SkImageInfo info = SkImageInfo::MakeN32Premul(400, 1000);
+
+    auto serial   = SkSurface::MakeRaster(info);
+    auto threaded = SkSurface::MakeRasterThreaded(info, executor.get());
+    REPORTER_ASSERT(reporter, threaded);
+    REPORTER_ASSERT(reporter, threaded->imageInfo() == info);
+
+    sk_sp<SkImage> serialSnaps[3], threadedSnaps[3];
+    for (int step = 0; step < 3; step++) {
+        draw_threaded_scene_banded(serial->getCanvas(), step);
+        draw_threaded_scene(threaded->getCanvas(), step);
+        serialSnaps[step]   = serial->makeImageSnapshot();
+        threadedSnaps[step] = threaded->makeImageSnapshot();
+    }
+
+    // Every snapshot must match, including the ones forked away by copy-on-write.
+    for (int step = 0; step < 3; step++) {
+        SkPixmap expected, actual;
+        REPORTER_ASSERT(reporter, serialSnaps[step]->peekPixels(&expected));
+        REPORTER_ASSERT(reporter, threadedSnaps[step]->peekPixels(&actual));
+        for (int y = 0; y < info.height(); y++) {
+            if (0 != memcmp(expected.addr32(0, y), actual.addr32(0, y), info.minRowBytes())) {
+                ERRORF(reporter, "snapshot %d differs at row %d", step, y);
+                break;
+            }
+        }
+    }
+
+    // readPixels() must resolve pending draws too.
+    threaded->getCanvas()->clear(SK_ColorRED);
+    SkColor color = 0;
+    SkPixmap pm(SkImageInfo::Make(1, 1, kBGRA_8888_SkColorType, kUnpremul_SkAlphaType), &color, 4);
+    REPORTER_ASSERT(reporter, threaded->readPixels(pm, 200, 999));
+    REPORTER_ASSERT(reporter, color == SK_ColorRED);
+}
+
+// Pictures are unrolled into the threaded surface's record, and each band replays only the ops
+// that touch it.
+DEF_TEST(SurfaceRasterThreaded_picture, reporter) {
+    SkPictureRecorder inner;
+    SkCanvas* innerCanvas = inner.beginRecording(SkRect::MakeWH(100, 100));
+    innerCanvas->drawOval(SkRect::MakeXYWH(10, 20, 80, 60), SkPaint(SkColors::kMagenta));
+
+    SkPictureRecorder recorder;
+    SkCanvas* canvas = recorder.beginRecording(SkRect::MakeWH(400, 1000));
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    for (int y = 0; y < 1000; y += 37) {
+        canvas->save();
+        canvas->translate(0, y);
+        canvas->clipRect(SkRect::MakeWH(380, 30), true);
+        for (int x = 0; x < 400; x += 45) {
+            paint.setColor(SkColorSetARGB(0xA0, x / 2, y / 4, 0x80));
+            canvas->drawCircle(x + 20, 15, 22, paint);
+        }
+        canvas->restore();
+    }
+    const SkRect layerBounds = SkRect::MakeXYWH(50, 400, 300, 300);
+    canvas->saveLayerAlpha(&layerBounds, 0x80);
+    canvas->drawPicture(inner.finishRecordingAsPicture(), nullptr, nullptr);
+    canvas->rotate(10);
+    canvas->drawRect(SkRect::MakeXYWH(100, 420, 200, 200), paint);
+    canvas->restore();
+    sk_sp<SkPicture> picture = recorder.finishRecordingAsPicture();
+
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+    const SkImageInfo info = SkImageInfo::MakeN32Premul(400, 1000);
+    auto serial   = SkSurface::MakeRaster(info);
+    auto threaded = SkSurface::MakeRasterThreaded(info, executor.get());
+    const SkMatrix matrix = SkMatrix::Translate(30, 200);
+    threaded->getCanvas()->drawPicture(picture);
+    threaded->getCanvas()->drawPicture(picture, &matrix, nullptr);
+
+    // Anti-aliased edges are chopped at band boundaries, so the reference replays everything
+    // into the same 128-row bands; only the culling of ops per band is under test.
+    for (int top = 0; top < info.height(); top += 128) {
+        SkAutoCanvasRestore acr(serial->getCanvas(), true);
+        serial->getCanvas()->clipRect(SkRect::MakeLTRB(0, top, info.width(), top + 128));
+        serial->getCanvas()->drawPicture(picture);
+        serial->getCanvas()->drawPicture(picture, &matrix, nullptr);
+    }
+
+    SkPixmap expected, actual;
+    REPORTER_ASSERT(reporter, serial->peekPixels(&expected));
+    REPORTER_ASSERT(reporter, threaded->peekPixels(&actual));
+    for (int y = 0; y < info.height(); y++) {
+        if (0 != memcmp(expected.addr32(0, y), actual.addr32(0, y), info.minRowBytes())) {
+            ERRORF(reporter, "differs at row %d", y);
+            break;
+        }
+    }
+}
+
+// Backdrop filters, layers initialized with what lies under them, and SaveBehind all read back
+// destination pixels across band boundaries, which must already hold everything drawn before.
+DEF_TEST(SurfaceRasterThreaded_dstReads, reporter) {
+    auto draw = [](SkCanvas* canvas) {
+        // Non-AA stripes, so that the only differences band boundaries could make are in what
+        // the filters read.
+        SkPaint paint;
+        for (int y = 0; y < 1000; y += 16) {
+            paint.setColor(SkColorSetARGB(0xFF, y / 4, 0xFF - y / 4, (y * 7) & 0xFF));
+            canvas->drawRect(SkRect::MakeXYWH(0, y, 400, 9), paint);
+        }
+        for (int x = 0; x < 400; x += 50) {
+            paint.setColor(SkColorSetARGB(0xC0, 0x20, x / 2, 0x80));
+            canvas->drawRect(SkRect::MakeXYWH(x, 0, 20, 1000), paint);
+        }
+
+        sk_sp<SkImageFilter> blur = SkImageFilters::Blur(6, 6, nullptr);
+        canvas->save();
+        canvas->clipRect(SkRect::MakeLTRB(20, 100, 380, 300));
+        canvas->saveLayer(SkCanvas::SaveLayerRec(nullptr, nullptr, blur.get(), 0));
+        paint.setColor(SkColorSetARGB(0x60, 0xFF, 0, 0));
+        canvas->drawRect(SkRect::MakeLTRB(60, 120, 340, 280), paint);
+        canvas->restore();
+        canvas->restore();
+
+        SkPaint layerPaint;
+        layerPaint.setImageFilter(SkImageFilters::Blur(4, 10, nullptr));
+        const SkRect layerBounds = SkRect::MakeLTRB(40, 340, 360, 430);
+        canvas->saveLayer(SkCanvas::SaveLayerRec(&layerBounds, &layerPaint,
+                                                 SkCanvas::kInitWithPrevious_SaveLayerFlag));
+        canvas->drawRect(SkRect::MakeLTRB(100, 360, 300, 410), paint);
+        canvas->restore();
+
+        const SkRect behindBounds = SkRect::MakeLTRB(10, 600, 390, 700);
+        SkCanvasPriv::SaveBehind(canvas, &behindBounds);
+        paint.setColor(SkColorSetARGB(0x80, 0, 0, 0xFF));
+        canvas->drawRect(SkRect::MakeLTRB(0, 620, 400, 680), paint);
+        SkCanvasPriv::DrawBehind(canvas, SkPaint(SkColors::kYellow));
+        canvas->restore();
+
+        // Draws after each of those must land after them in every band.
+        paint.setColor(SkColorSetARGB(0x40, 0, 0xFF, 0));
+        canvas->drawRect(SkRect::MakeLTRB(0, 0, 200, 1000), paint);
+    };
+
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+    const SkImageInfo info = SkImageInfo::MakeN32Premul(400, 1000);
+    auto serial   = SkSurface::MakeRaster(info);
+    auto threaded = SkSurface::MakeRasterThreaded(info, executor.get());
+    draw(serial->getCanvas());
+    draw(threaded->getCanvas());
+
+    SkPixmap expected, actual;
+    REPORTER_ASSERT(reporter, serial->peekPixels(&expected));
+    REPORTER_ASSERT(reporter, threaded->peekPixels(&actual));
+    for (int y = 0; y < info.height(); y++) {
+        if (0 != memcmp(expected.addr32(0, y), actual.addr32(0, y), info.minRowBytes())) {
+            ERRORF(reporter, "differs at row %d", y);
+            break;
+        }
+    }
+}
@@ -9,6 +9,7 @@
 #include "include/core/SkBlendMode.h"
 #include "include/core/SkCanvas.h"
 #include "include/core/SkColorPriv.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkImage.h"
 #include "include/core/SkMatrix.h"
 #include "include/core/SkPaint.h"
@@ -380,6 +381,31 @@ SkPath make_big_path() {
     return path.detach();
 }
 
+SkPath make_coastline(SkPoint center, float radius, int points, uint32_t seed) {
+    SkRandom      rand(seed);
+    SkPathBuilder path;
+    for (int i = 0; i < points; ++i) {
+        float t = 2 * SK_ScalarPI * i / points,
+              r = radius * (1 + 0.3f * sinf(37 * t) + rand.nextRangeF(0, 0.1f));
+        SkPoint p = {center.fX + r * cosf(t), center.fY + r * sinf(t)};
+        i ? path.lineTo(p) : path.moveTo(p);
+    }
+    return path.close().detach();
+}
+
+namespace {
+class SerialExecutor final : public SkExecutor {
+    void add(std::function<void(void)> work) override { work(); }
+};
+}  // namespace
+
+std::unique_ptr<SkExecutor> make_executor(int threads) {
+    if (threads == 0) {
+        return std::make_unique<SerialExecutor>();
+    }
+    return SkExecutor::MakeFIFOThreadPool(threads);
+}
+
 bool copy_to(SkBitmap* dst, SkColorType dstColorType, const SkBitmap& src) {
     SkPixmap srcPM;
     if (!src.peekPixels(&srcPM)) {
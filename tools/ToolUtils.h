@@ -31,6 +31,7 @@
 
 class SkBitmap;
 class SkCanvas;
+class SkExecutor;
 class SkFontStyle;
 class SkImage;
 class SkPath;
@@ -151,6 +152,15 @@ void create_tetra_normal_map(SkBitmap* bm, const SkIRect& dst);
 
 SkPath make_big_path();
 
+// A closed, ragged coastline of that many line segments around center, at about radius. It doesn't
+// cross itself, but two with different seeds and nearby centers cross each other many times.
+SkPath make_coastline(SkPoint center, float radius, int points, uint32_t seed);
+
+// Benches and tests of code that splits its work across an SkExecutor pass this one explicitly,
+// rather than swapping SkExecutor::GetDefault(). It is a pool of that many threads, or, when
+// threads is 0, runs each task on the calling thread as soon as it is added.
+std::unique_ptr<SkExecutor> make_executor(int threads);
+
 // A helper object to test the topological sorting code (TopoSortBench.cpp & TopoSortTest.cpp)
 class TopoTestNode : public SkRefCnt {
 public: